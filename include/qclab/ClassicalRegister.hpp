@@ -0,0 +1,105 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/random.hpp"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \class ClassicalRegister
+   * \brief Classical bits and random number stream of the simulation of a
+   *        dynamic quantum circuit, i.e., a circuit with measurements,
+   *        resets, or classically conditioned gates.
+   *
+   * The k-th random number is drawn by the k-th measurement or reset of the
+   * simulation, such that the outcomes only depend on the seed and not on
+   * the number of threads. The register grows when a bit beyond its size is
+   * set, and unset bits read as 0.
+   */
+  class ClassicalRegister
+  {
+
+    public:
+      /// Maximum number of partial sums of a reduction over a vector.
+      static constexpr int maxPartials = 256 ;
+
+      /**
+       * \brief Constructs a classical register of `nbBits` bits set to 0,
+       *        with the random number stream of seed `seed`.
+       */
+      ClassicalRegister( const int nbBits = 0 , const uint64_t seed = 0 )
+      : bits_( nbBits , 0 )
+      , random_( seed )
+      , counter_( 0 )
+      , partials_( maxPartials , 0.0 )
+      {
+        assert( nbBits >= 0 ) ;
+      } // ClassicalRegister(nbBits,seed)
+
+      /// Returns the number of bits of this classical register.
+      inline int nbBits() const { return bits_.size() ; }
+
+      /// Returns the bit `bit` of this classical register.
+      inline int operator[]( const int bit ) const {
+        assert( bit >= 0 ) ;
+        return ( bit < nbBits() ) ? bits_[ bit ] : 0 ;
+      }
+
+      /// Sets the bit `bit` of this classical register to `value`.
+      void set( const int bit , const int value ) {
+        assert( bit >= 0 ) ;
+        if ( bit >= nbBits() ) bits_.resize( bit + 1 , 0 ) ;
+        bits_[ bit ] = value ? 1 : 0 ;
+      }
+
+      /**
+       * \brief Returns the value of the bits `bits`, where `bits[0]` is the
+       *        least significant bit.
+       */
+      uint64_t value( const std::vector< int >& bits ) const {
+        assert( bits.size() <= 64 ) ;
+        uint64_t value = 0 ;
+        for ( size_t i = 0; i < bits.size(); i++ ) {
+          value |= uint64_t( (*this)[ bits[i] ] ) << i ;
+        }
+        return value ;
+      }
+
+      /// Returns the bits of this classical register.
+      inline const std::vector< int >& bits() const { return bits_ ; }
+
+      /// Returns the number of random numbers drawn from this register.
+      inline uint64_t counter() const { return counter_ ; }
+
+      /**
+       * \brief Returns the next random number of this register, uniformly
+       *        distributed in (0, 1), without drawing it, see advance.
+       */
+      inline double next() const { return random_.uniform( counter_ ) ; }
+
+      /// Draws the next random number of this register.
+      inline void advance() { counter_++ ; }
+
+      /**
+       * \brief Returns the workspace of maxPartials partial sums of the
+       *        reductions of the dynamic operations.
+       */
+      inline double* partials() { return partials_.data() ; }
+
+    private:
+      /// Classical bits of this register.
+      std::vector< int >     bits_ ;
+      /// Random number stream of this register.
+      Random                 random_ ;
+      /// Number of random numbers drawn.
+      uint64_t               counter_ ;
+      /// Partial sums of the reductions of the dynamic operations.
+      std::vector< double >  partials_ ;
+
+  } ; // class ClassicalRegister
+
+} // namespace qclab
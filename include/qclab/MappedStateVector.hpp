@@ -0,0 +1,150 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/sim/Options.hpp"
+#include "qclab/sim/Schedule.hpp"
+#include <string>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \class MappedStateVector
+   * \brief State vector of a quantum register stored in a memory-mapped
+   *        file, for registers that exceed the main memory.
+   *
+   * The amplitudes are stored in the order of a `std::vector< T >` and are
+   * processed in chunks of 2^`chunkQubits` consecutive amplitudes, i.e., the
+   * `chunkQubits` least significant qubits are low qubits and the other
+   * qubits are high qubits. A schedule is split into sweeps of consecutive
+   * items that act on at most `maxGroupQubits` high qubits together. Every
+   * sweep streams once through the file: the chunks are visited in groups of
+   * the 2^k chunks that only differ in the k high qubits of the sweep, every
+   * group is copied into a buffer, and all items of the sweep are applied to
+   * the buffer as an ordinary vector of `chunkQubits + k` qubits, with the
+   * high qubits of the sweep relabeled to its most significant qubits. Hence,
+   * gates on low qubits stream chunk by chunk, gates on a single high qubit
+   * pair two chunks at a time, and the gate kernels are used unchanged. An
+   * item on more than `maxGroupQubits` high qubits, e.g., a multi-controlled
+   * gate, forms a sweep on its own with a correspondingly larger buffer.
+   */
+  template <typename T>
+  class MappedStateVector
+  {
+
+    public:
+      /// Value type of this state vector.
+      using value_type = T ;
+
+      /// Maximum number of high qubits of a sweep.
+      static constexpr int maxGroupQubits = 3 ;
+
+      /**
+       * \brief Constructs a state vector of `nbQubits` qubits in the all zero
+       *        state, stored in the file `filename`, which is created or
+       *        truncated, with chunks of 2^`chunkQubits` amplitudes. The file
+       *        is kept when this state vector is destroyed. Throws a
+       *        `std::system_error` if the file can not be created or mapped.
+       */
+      MappedStateVector( const std::string& filename , const int nbQubits ,
+                         const int chunkQubits = 20 ) ;
+
+      MappedStateVector( const MappedStateVector< T >& ) = delete ;
+      MappedStateVector< T >& operator=( const MappedStateVector< T >& )
+                                                                    = delete ;
+
+      /// Unmaps and closes the file of this state vector.
+      ~MappedStateVector() ;
+
+      /// Returns the number of qubits of this state vector.
+      inline int nbQubits() const { return nbQubits_ ; }
+
+      /// Returns the number of low qubits of this state vector.
+      inline int chunkQubits() const { return chunkQubits_ ; }
+
+      /// Returns the number of amplitudes of this state vector.
+      inline int64_t size() const { return int64_t(1) << nbQubits_ ; }
+
+      /// Returns the name of the file of this state vector.
+      inline const std::string& filename() const { return filename_ ; }
+
+      /// Returns the amplitudes of this state vector.
+      inline T* data() { return data_ ; }
+
+      /// Returns the amplitudes of this state vector.
+      inline const T* data() const { return data_ ; }
+
+      /// Returns the amplitude `i` of this state vector.
+      inline T operator()( const int64_t i ) const {
+        assert( i >= 0 && i < size() ) ;
+        return data_[i] ;
+      }
+
+      /// Sets the amplitude `i` of this state vector to `value`.
+      inline void set( const int64_t i , const T value ) {
+        assert( i >= 0 && i < size() ) ;
+        data_[i] = value ;
+      }
+
+      /// Returns the amplitudes of this state vector as a vector.
+      std::vector< T > vector() const {
+        return std::vector< T >( data_ , data_ + size() ) ;
+      }
+
+      /// Sets the amplitudes of this state vector to the vector `vector`.
+      void assign( const std::vector< T >& vector ) {
+        assert( vector.size() == size() ) ;
+        std::copy( vector.begin() , vector.end() , data_ ) ;
+      }
+
+      /// Returns the number of sweeps of the last simulation.
+      inline int64_t nbSweeps() const { return nbSweeps_ ; }
+
+      /**
+       * \brief Simulates the quantum circuit `circuit` on this state vector
+       *        with the fusion and cache blocking options of `options`. The
+       *        circuit must not be dynamic.
+       */
+      void simulate( const qclab::QCircuit< T >& circuit ,
+                     const sim::Options& options = sim::Options() ) ;
+
+      /**
+       * \brief Applies the schedule `schedule` to this state vector, sweep by
+       *        sweep, with cache blocking of the buffers on `blockQubits`
+       *        qubits if nonzero.
+       */
+      void apply( const sim::Schedule< T >& schedule ,
+                  const int blockQubits = 0 ) ;
+
+      /// Writes the modified amplitudes back to the file. Throws a
+      /// `std::system_error` if the amplitudes can not be written.
+      void sync() ;
+
+    private:
+      /**
+       * \brief Applies the items [`first`, `last`) of a schedule, which act
+       *        on the high qubits `high` only, in one sweep.
+       */
+      void applySweep( typename sim::Schedule< T >::const_iterator first ,
+                       typename sim::Schedule< T >::const_iterator last ,
+                       const std::vector< int >& high ,
+                       const int blockQubits ) ;
+
+      /// Number of qubits.
+      int          nbQubits_ ;
+      /// Number of low qubits.
+      int          chunkQubits_ ;
+      /// Name of the file.
+      std::string  filename_ ;
+      /// File descriptor of the file.
+      int          fd_ ;
+      /// Mapped amplitudes.
+      T*           data_ ;
+      /// Number of sweeps of the last simulation.
+      int64_t      nbSweeps_ ;
+
+  } ; // class MappedStateVector
+
+} // namespace qclab
@@ -0,0 +1,164 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/sample.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \class MatrixProductState
+   * \brief Matrix product state of a quantum register, for the simulation of
+   *        circuits with little entanglement on many qubits.
+   *
+   * Every qubit `q` holds a tensor of shape `bondDimension( q - 1 )` x 2 x
+   * `bondDimension( q )`, stored row by row, where the outer bonds have
+   * dimension 1. The state is kept in mixed canonical form around one
+   * orthogonality center.
+   *
+   * A 1-qubit gate multiplies the tensor of its qubit by the gate matrix. A
+   * 2-qubit gate on neighbouring qubits moves the center to the first qubit,
+   * contracts both tensors with the gate matrix, and splits the result again
+   * by a singular value decomposition, see dense::svd. The smallest singular
+   * values are dropped such that the bond dimension does not exceed
+   * `maxBond()` and the relative weight of the dropped singular values does
+   * not exceed `truncation()`, after which the state is renormalized. Gates
+   * on qubits that are not neighbours are applied between SWAP gates that
+   * move the second qubit next to the first one and back.
+   */
+  template <typename T>
+  class MatrixProductState
+  {
+
+    public:
+      /// Value type of this matrix product state.
+      using value_type = T ;
+      /// Real value type of this matrix product state.
+      using real_type  = qclab::real_t< T > ;
+
+      /// Maximum number of qubits of the dense vector of a state.
+      static constexpr int maxDenseQubits = 30 ;
+
+      /// Constructs a matrix product state of `nbQubits` qubits in state 0.
+      MatrixProductState( const int nbQubits ) ;
+
+      /// Returns the number of qubits of this matrix product state.
+      inline int nbQubits() const { return nbQubits_ ; }
+
+      /// Returns the maximum bond dimension, 256 by default.
+      inline int maxBond() const { return maxBond_ ; }
+
+      /// Sets the maximum bond dimension.
+      inline void setMaxBond( const int maxBond ) {
+        assert( maxBond >= 1 ) ;
+        maxBond_ = maxBond ;
+      }
+
+      /**
+       * \brief Returns the maximum relative weight of the singular values
+       *        dropped by a truncation, the squared machine precision by
+       *        default.
+       */
+      inline real_type truncation() const { return truncation_ ; }
+
+      /**
+       * \brief Sets the maximum relative weight of the singular values
+       *        dropped by a truncation.
+       */
+      inline void setTruncation( const real_type truncation ) {
+        assert( truncation >= 0 ) ;
+        truncation_ = truncation ;
+      }
+
+      /// Returns the dimension of the bond between the qubits `q` and q + 1.
+      inline int64_t bondDimension( const int q ) const {
+        assert( q >= 0 && q < nbQubits_ - 1 ) ;
+        return bonds_[ q + 1 ] ;
+      }
+
+      /// Returns the largest bond dimension of this matrix product state.
+      int64_t maxBondDimension() const ;
+
+      /**
+       * \brief Returns the sum of the relative weights of all singular values
+       *        dropped so far, an estimate of the infidelity of this state.
+       */
+      inline double truncationError() const { return truncationError_ ; }
+
+      /**
+       * \brief Returns the amplitude of the basis state of the bits
+       *        `bitstring`, where `bitstring[q]` is the bit of the qubit `q`.
+       */
+      T amplitude( const std::vector< int >& bitstring ) const ;
+
+      /**
+       * \brief Returns the amplitude of the basis state `index`, in which the
+       *        qubit `q` is bit `nbQubits - q - 1`.
+       */
+      T operator()( const uint64_t index ) const ;
+
+      /// Returns the amplitudes of this state as a dense vector.
+      std::vector< T > vector() const ;
+
+      /**
+       * \brief Applies the 1- or 2-qubit gate `object`, shifted by `offset`
+       *        qubits.
+       */
+      void apply( const qclab::QObject< T >& object , const int offset = 0 ) ;
+
+      /**
+       * \brief Simulates the quantum circuit `circuit` of 1- and 2-qubit
+       *        gates on this state. The circuit must not be dynamic.
+       */
+      void simulate( const qclab::QCircuit< T >& circuit ) ;
+
+      /**
+       * \brief Samples `nbShots` measurements of the qubits `qubits` with the
+       *        random number stream of seed `seed`, see qclab::sample.
+       *
+       * The center is moved to the first qubit, after which every shot
+       * draws the qubits from left to right from their conditional
+       * probabilities, up to the last measured qubit. The shots are
+       * distributed over the threads.
+       */
+      Counts sample( const int64_t nbShots ,
+                     const std::vector< int >& qubits = {} ,
+                     const uint64_t seed = 0 ) ;
+
+    private:
+      /// Applies the 2 x 2 matrix `mat` to the qubit `q`.
+      void apply1( const int q , const qclab::dense::SquareMatrix< T >& mat ) ;
+
+      /// Applies the 4 x 4 matrix `mat` to the qubits `q` and q + 1.
+      void apply2( const int q , const qclab::dense::SquareMatrix< T >& mat ) ;
+
+      /// Moves the orthogonality center to the qubit `q`.
+      void moveCenter( const int q ) ;
+
+      /**
+       * \brief Truncates the singular values `S` and returns the number of
+       *        singular values that are kept.
+       */
+      int64_t truncate( std::vector< real_type >& S ) ;
+
+      /// Number of qubits.
+      int                              nbQubits_ ;
+      /// Maximum bond dimension.
+      int                              maxBond_ ;
+      /// Maximum relative weight of the dropped singular values.
+      real_type                        truncation_ ;
+      /// Sum of the relative weights of the dropped singular values.
+      double                           truncationError_ ;
+      /// Orthogonality center.
+      int                              center_ ;
+      /// Bond dimensions, including the trivial outer bonds.
+      std::vector< int64_t >           bonds_ ;
+      /// Tensors of the qubits.
+      std::vector< std::vector< T > >  tensors_ ;
+
+  } ; // class MatrixProductState
+
+} // namespace qclab
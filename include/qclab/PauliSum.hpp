@@ -0,0 +1,140 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/util.hpp"
+#include "qclab/StateVector.hpp"
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \class PauliSum
+   * \brief Observable that is a weighted sum of Pauli strings.
+   *
+   * A term \f$c P\f$ of the sum consists of a real coefficient \f$c\f$ and a
+   * Pauli string \f$P\f$ with a Pauli operator I, X, Y, or Z on every qubit.
+   * The expectation values are computed directly on the state vector: the
+   * terms are grouped by their X/Y pattern, such that a single sweep over the
+   * state evaluates all terms of a group, and the Z-only terms reduce to a
+   * single parity-weighted sum over the probabilities.
+   */
+  template <typename T>
+  class PauliSum
+  {
+
+    public:
+      /// Value type of this Pauli sum.
+      using value_type = T ;
+      /// Real value type of this Pauli sum.
+      using real_type = qclab::real_t< T > ;
+
+      /**
+       * \struct Term
+       * \brief Term of a Pauli sum. Bit q of the masks corresponds to qubit q.
+       */
+      struct Term {
+        real_type  coefficient ;  ///< Coefficient of the term.
+        uint64_t   xMask ;        ///< Qubits with a Pauli X or Y.
+        uint64_t   zMask ;        ///< Qubits with a Pauli Z or Y.
+      } ;
+
+      /// Constructs an empty Pauli sum on `nbQubits` qubits.
+      PauliSum( const int nbQubits )
+      : nbQubits_( nbQubits )
+      {
+        assert( nbQubits > 0 ) ;
+        assert( nbQubits <= 64 ) ;
+      } // PauliSum(nbQubits)
+
+      /// Returns the number of qubits of this Pauli sum.
+      inline int nbQubits() const { return nbQubits_ ; }
+
+      /// Returns the number of terms of this Pauli sum.
+      inline int nbTerms() const { return terms_.size() ; }
+
+      /// Returns the terms of this Pauli sum.
+      inline const std::vector< Term >& terms() const { return terms_ ; }
+
+      /**
+       * \brief Adds the term `coefficient` times the Pauli string `paulis`,
+       *        where character q of `paulis` is the Pauli operator I, X, Y, or
+       *        Z on qubit q.
+       */
+      void add( const real_type coefficient , const std::string& paulis ) {
+        assert( paulis.size() == nbQubits_ ) ;
+        std::vector< int > qubits( nbQubits_ ) ;
+        for ( int q = 0; q < nbQubits_; q++ ) qubits[q] = q ;
+        add( coefficient , qubits , paulis ) ;
+      }
+
+      /**
+       * \brief Adds the term `coefficient` times the Pauli string with Pauli
+       *        operator `paulis[i]` on qubit `qubits[i]`, and the identity on
+       *        all other qubits.
+       */
+      void add( const real_type coefficient , const std::vector< int >& qubits ,
+                const std::string& paulis ) {
+        assert( qubits.size() == paulis.size() ) ;
+        Term term = { coefficient , 0 , 0 } ;
+        for ( size_t i = 0; i < qubits.size(); i++ ) {
+          assert( qubits[i] >= 0 && qubits[i] < nbQubits_ ) ;
+          const uint64_t bit = uint64_t(1) << qubits[i] ;
+          const char p = paulis[i] ;
+          assert( p == 'I' || p == 'X' || p == 'Y' || p == 'Z' ) ;
+          if ( p == 'X' || p == 'Y' ) term.xMask |= bit ;
+          if ( p == 'Z' || p == 'Y' ) term.zMask |= bit ;
+        }
+        terms_.push_back( term ) ;
+      }
+
+      /// Returns the expectation value of this Pauli sum for `vector`.
+      real_type expectation( const std::vector< T >& vector ) const ;
+
+      /// Returns the expectation value of this Pauli sum for `state`.
+      real_type expectation( const qclab::StateVector< T >& state ) const ;
+
+      /**
+       * \brief Applies the operation `op` of this Pauli sum to the qubits
+       *        `offset`, ..., `offset` + nbQubits() - 1 of the vector `vector`
+       *        of `nbQubits` qubits, e.g., as the observable of
+       *        QCircuit::gradient. Terms with an odd number of Pauli Y
+       *        operators require a complex type.
+       */
+      void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                  const int offset = 0 ) const ;
+
+      /// Prints this Pauli sum.
+      void print() const ;
+
+    private:
+      /**
+       * \brief Group of terms with the same X/Y pattern, with the masks of
+       *        the physical bits of a vector.
+       */
+      struct Group {
+        uint64_t                  xMask ;         ///< Flipped bits.
+        std::vector< uint64_t >   zMasks ;        ///< Bits with a phase -1.
+        std::vector< int >        nbY ;           ///< Number of Pauli Y.
+        std::vector< real_type >  coefficients ;  ///< Coefficients.
+      } ;
+
+      /**
+       * \brief Returns the terms grouped by their X/Y pattern, mapped to the
+       *        physical bits of a vector of `nbQubits` qubits with offset
+       *        `offset`.
+       */
+      std::vector< Group > groups( const int nbQubits ,
+                                   const int offset ) const ;
+
+      /// Number of qubits of this Pauli sum.
+      int                  nbQubits_ ;
+      /// Terms of this Pauli sum.
+      std::vector< Term >  terms_ ;
+
+  } ; // class PauliSum
+
+} // namespace qclab
@@ -7,8 +7,17 @@
 #include "qclab/dense/kron.hpp"
 #include "qclab/dense/transpose.hpp"
 #include "qclab/io/QASMFile.hpp"
+#include "qclab/sim/Options.hpp"
+#include "qclab/sim/Schedule.hpp"
+#include "qclab/sim/fusion.hpp"
+#include "qclab/sim/blocking.hpp"
+#include "qclab/sim/remap.hpp"
+#include "qclab/sim/batch.hpp"
+#include "qclab/sim/adjoint.hpp"
+#include "qclab/parallel.hpp"
 #include <cassert>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 namespace qclab {
@@ -101,6 +110,9 @@ namespace qclab {
       // controlled
       inline bool controlled() const override { return false ; }
 
+      // teamAware
+      inline bool teamAware() const override { return true ; }
+
       // qubit
       inline int qubit() const override { return offset_ ; }
 
@@ -117,12 +129,33 @@ namespace qclab {
       // setQubits
       inline void setQubits( const int* qubits ) override { assert( false ) ; }
 
-      // matrix
+      /**
+       * \brief Returns the matrix of this quantum circuit.
+       *
+       * The columns are simulated as a single batch: the transposed circuit
+       * applied to the identity in a batch-innermost layout, see sim::pack,
+       * yields the transpose of the row-major matrix, i.e., the column-major
+       * matrix itself. Dynamic circuits throw a std::logic_error.
+       */
       qclab::dense::SquareMatrix< T > matrix() const override {
-        auto mat = qclab::dense::eye< T >( 1 << nbQubits_ ) ;
-        for ( auto it = begin(); it != end(); ++it ) {
-          (*it)->apply( Side::Right , Op::NoTrans , nbQubits_ , mat ) ;
+        if ( dynamic() ) {
+          throw std::logic_error( "a dynamic circuit is not unitary" ) ;
         }
+        const int64_t size = int64_t(1) << nbQubits_ ;
+        std::vector< T > batch( size * size , T(0) ) ;
+        for ( int64_t i = 0; i < size; i++ ) batch[ i * size + i ] = 1 ;
+        parallel::run( size * size , [&] () {
+          for ( auto it = rbegin(); it != rend(); ++it ) {
+            parallel::call( (*it)->teamAware() , [&] () {
+              (*it)->apply( Op::Trans , 2 * nbQubits_ , batch ) ;
+            } ) ;
+          }
+        } ) ;
+        qclab::dense::SquareMatrix< T > mat( size ) ;
+        T* data = mat.ptr() ;
+        parallel::forEach( size * size , [&] ( const int64_t i ) {
+          data[i] = batch[i] ;
+        } ) ;
         return mat ;
       }
 
@@ -132,16 +165,59 @@ namespace qclab {
         if ( op == Op::NoTrans ) {
           // NoTrans
           for ( auto it = begin(); it != end(); ++it ) {
-            (*it)->apply( op , nbQubits , vector , offset_ + offset ) ;
+            parallel::call( (*it)->teamAware() , [&] () {
+              (*it)->apply( op , nbQubits , vector , offset_ + offset ) ;
+            } ) ;
+          }
+        } else {
+          // [Conj]Trans
+          for ( auto it = rbegin(); it != rend(); ++it ) {
+            parallel::call( (*it)->teamAware() , [&] () {
+              (*it)->apply( op , nbQubits , vector , offset_ + offset ) ;
+            } ) ;
+          }
+        }
+      }
+
+      // apply
+      void apply( Op op , const int nbQubits , qclab::StateVector< T >& state ,
+                  const int offset = 0 ) const override {
+        if ( op == Op::NoTrans ) {
+          // NoTrans
+          for ( auto it = begin(); it != end(); ++it ) {
+            parallel::call( (*it)->teamAware() , [&] () {
+              (*it)->apply( op , nbQubits , state , offset_ + offset ) ;
+            } ) ;
           }
         } else {
           // [Conj]Trans
           for ( auto it = rbegin(); it != rend(); ++it ) {
-            (*it)->apply( op , nbQubits , vector , offset_ + offset ) ;
+            parallel::call( (*it)->teamAware() , [&] () {
+              (*it)->apply( op , nbQubits , state , offset_ + offset ) ;
+            } ) ;
           }
         }
       }
 
+      // dynamic
+      bool dynamic() const override {
+        for ( auto it = begin(); it != end(); ++it ) {
+          if ( (*it)->dynamic() ) return true ;
+        }
+        return false ;
+      }
+
+      // apply
+      void apply( const int nbQubits , std::vector< T >& vector ,
+                  qclab::ClassicalRegister& creg ,
+                  const int offset = 0 ) const override {
+        for ( auto it = begin(); it != end(); ++it ) {
+          parallel::call( (*it)->teamAware() , [&] () {
+            (*it)->apply( nbQubits , vector , creg , offset_ + offset ) ;
+          } ) ;
+        }
+      }
+
     #ifdef QCLAB_OMP_OFFLOADING
       // apply_device
       void apply_device( Op op , const int nbQubits , T* vector ,
@@ -160,9 +236,227 @@ namespace qclab {
       }
     #endif
 
-      /// Simulates this quantum circuit for the given vector `vector`.
+      /**
+       * \brief Simulates this quantum circuit for the given vector `vector`.
+       *        All gates are applied by a single persistent team of threads,
+       *        see qclab::parallel::run. Dynamic circuits are simulated with a
+       *        classical register of seed 0, see simulate(vector,creg).
+       */
       void simulate( std::vector< T >& vector ) const {
-        apply( Op::NoTrans , nbQubits_ , vector ) ;
+        if ( dynamic() ) {
+          qclab::ClassicalRegister creg ;
+          simulate( vector , creg ) ;
+          return ;
+        }
+        parallel::run( int64_t(1) << nbQubits_ , [&] () {
+          apply( Op::NoTrans , nbQubits_ , vector ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates a single trajectory of this quantum circuit for the
+       *        given vector `vector` with the classical register `creg`.
+       *
+       * Measurements and resets draw the next random number of `creg`, and
+       * measurements store their outcome in `creg`, on which the classically
+       * conditioned gates depend. All gates are applied by a single
+       * persistent team of threads, and the outcomes do not depend on the
+       * number of threads.
+       */
+      void simulate( std::vector< T >& vector ,
+                     qclab::ClassicalRegister& creg ) const {
+        assert( vector.size() == int64_t(1) << nbQubits_ ) ;
+        parallel::run( int64_t(1) << nbQubits_ , [&] () {
+          apply( nbQubits_ , vector , creg ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates a single trajectory of this quantum circuit for the
+       *        given vector `vector` with the classical register `creg` and
+       *        the simulation options `options`.
+       *
+       * The unitary gates between the dynamic objects form segments that are
+       * fused and cache blocked on their own, and the dynamic objects are
+       * applied in between by the same persistent team of threads.
+       */
+      void simulate( std::vector< T >& vector , qclab::ClassicalRegister& creg ,
+                     const sim::Options& options ) const {
+        assert( vector.size() == int64_t(1) << nbQubits_ ) ;
+        sim::Schedule< T > schedule ;
+        flatten( schedule ) ;
+        std::vector< sim::Schedule< T > > segments( 1 ) ;
+        std::vector< typename sim::Schedule< T >::Item > dynamics ;
+        for ( const auto& item : schedule ) {
+          if ( item.object->dynamic() ) {
+            dynamics.push_back( item ) ;
+            segments.emplace_back() ;
+          } else {
+            segments.back().push_back( item.object , item.offset ) ;
+          }
+        }
+        for ( auto& segment : segments ) fuse( segment , options ) ;
+        parallel::run( int64_t(1) << nbQubits_ , [&] () {
+          for ( size_t s = 0; s < segments.size(); s++ ) {
+            applySchedule( segments[s] , nbQubits_ , vector , options ) ;
+            if ( s < dynamics.size() ) {
+              const auto& item = dynamics[s] ;
+              parallel::call( item.object->teamAware() , [&] () {
+                item.object->apply( nbQubits_ , vector , creg , item.offset ) ;
+              } ) ;
+            }
+          }
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for the given vector `vector`
+       *        with the simulation options `options`.
+       */
+      void simulate( std::vector< T >& vector ,
+                     const sim::Options& options ) const {
+        simulateBatch( 0 , vector , options ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for every vector of the batch
+       *        `vectors`. The vectors are packed into batches of at most
+       *        2^sim::maxBatchQubits amplitudes that are simulated at once,
+       *        see simulateBatch.
+       */
+      void simulate( std::vector< std::vector< T > >& vectors ) const {
+        simulateBatches( vectors , [this] ( const int k ,
+                                            std::vector< T >& batch ) {
+          simulateBatch( k , batch ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for every vector of the batch
+       *        `vectors` with the simulation options `options`, see
+       *        simulate(vectors).
+       */
+      void simulate( std::vector< std::vector< T > >& vectors ,
+                     const sim::Options& options ) const {
+        simulateBatches( vectors , [&] ( const int k ,
+                                         std::vector< T >& batch ) {
+          simulateBatch( k , batch , options ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for the batch `batch` of
+       *        2^`batchQubits` vectors in a batch-innermost layout, see
+       *        sim::pack.
+       *
+       * The gates are applied once to the vector of `nbQubits()` +
+       * `batchQubits` qubits, such that their coefficients are set up once
+       * for the whole batch and their kernels run over contiguous runs of at
+       * least 2^`batchQubits` amplitudes.
+       */
+      void simulateBatch( const int batchQubits ,
+                          std::vector< T >& batch ) const {
+        assert( batchQubits >= 0 ) ;
+        if ( dynamic() ) {
+          // the vectors of a batch have different trajectories
+          assert( batchQubits == 0 ) ;
+          qclab::ClassicalRegister creg ;
+          simulate( batch , creg ) ;
+          return ;
+        }
+        const int nbQubits = nbQubits_ + batchQubits ;
+        parallel::run( int64_t(1) << nbQubits , [&] () {
+          apply( Op::NoTrans , nbQubits , batch ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for the batch `batch` of
+       *        2^`batchQubits` vectors in a batch-innermost layout with the
+       *        simulation options `options`. The cache blocking options
+       *        count the batch qubits, i.e., `options.blockQubits` must
+       *        exceed `batchQubits` for blocks to contain circuit qubits.
+       */
+      void simulateBatch( const int batchQubits , std::vector< T >& batch ,
+                          const sim::Options& options ) const {
+        assert( batchQubits >= 0 ) ;
+        if ( dynamic() ) {
+          // the vectors of a batch have different trajectories
+          assert( batchQubits == 0 ) ;
+          qclab::ClassicalRegister creg ;
+          simulate( batch , creg , options ) ;
+          return ;
+        }
+        const int nbQubits = nbQubits_ + batchQubits ;
+        assert( batch.size() == int64_t(1) << nbQubits ) ;
+        sim::Schedule< T > schedule ;
+        flatten( schedule ) ;
+        fuse( schedule , options ) ;
+        parallel::run( int64_t(1) << nbQubits , [&] () {
+          applySchedule( schedule , nbQubits , batch , options ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for the given state vector
+       *        `state`. Dynamic circuits are not supported.
+       */
+      void simulate( qclab::StateVector< T >& state ) const {
+        assert( !dynamic() ) ;
+        parallel::run( int64_t(1) << nbQubits_ , [&] () {
+          apply( Op::NoTrans , nbQubits_ , state ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Simulates this quantum circuit for the given state vector
+       *        `state` with the simulation options `options`. Cache blocking
+       *        is not supported for state vectors and `options.blockQubits`
+       *        and `options.remapWindow` are ignored.
+       */
+      void simulate( qclab::StateVector< T >& state ,
+                     const sim::Options& options ) const {
+        assert( !dynamic() ) ;
+        sim::Schedule< T > schedule ;
+        flatten( schedule ) ;
+        fuse( schedule , options ) ;
+        parallel::run( int64_t(1) << nbQubits_ , [&] () {
+          schedule.apply( nbQubits_ , state ) ;
+        } ) ;
+      }
+
+      /**
+       * \brief Appends the gates of this quantum circuit to the schedule
+       *        `schedule`. Sub-circuits are flattened recursively.
+       */
+      void flatten( sim::Schedule< T >& schedule ,
+                    const int offset = 0 ) const {
+        using C = QCircuit< T > ;
+        for ( auto it = begin(); it != end(); ++it ) {
+          if ( const C* circuit = dynamic_cast< const C* >( it->get() ) ) {
+            circuit->flatten( schedule , offset_ + offset ) ;
+          } else {
+            schedule.push_back( it->get() , offset_ + offset ) ;
+          }
+        }
+      }
+
+      /**
+       * \brief Returns the expectation value of the observable `observable`
+       *        for this quantum circuit applied to the vector `vector`, and
+       *        computes its gradient `grad` with respect to the angles of the
+       *        variable gates of this quantum circuit, in order, with the
+       *        adjoint method, see sim::adjoint.
+       */
+      template <typename O>
+      qclab::real_t< T > gradient( const std::vector< T >& vector ,
+                                   const O& observable ,
+                                   std::vector< qclab::real_t< T > >& grad )
+                                   const {
+        sim::Schedule< T > schedule ;
+        flatten( schedule ) ;
+        std::vector< T > work( vector ) ;
+        return sim::adjoint( schedule , nbQubits_ , observable , work , grad ) ;
       }
 
     #ifdef QCLAB_OMP_OFFLOADING
@@ -389,6 +683,70 @@ namespace qclab {
       }
 
     protected:
+      /**
+       * \brief Splits the vectors `vectors` into batches of 2^k vectors with
+       *        `nbQubits()` + k <= sim::maxBatchQubits, and calls
+       *        `f( k , batch )` for every packed batch. If k = 0, the vectors
+       *        are simulated one by one without packing.
+       */
+      template <typename F>
+      void simulateBatches( std::vector< std::vector< T > >& vectors ,
+                            F&& f ) const {
+        const int64_t nb = vectors.size() ;
+        if ( nb == 0 ) return ;
+        const int k = dynamic() ? 0 :
+                      std::min( sim::batchQubits( nb ) ,
+                                std::max( 0 , sim::maxBatchQubits -
+                                              nbQubits_ ) ) ;
+        if ( k == 0 ) {
+          for ( auto& vector : vectors ) f( 0 , vector ) ;
+          return ;
+        }
+        std::vector< T > batch ;
+        for ( int64_t first = 0; first < nb; first += int64_t(1) << k ) {
+          const int64_t count = std::min( int64_t(1) << k , nb - first ) ;
+          const int kb = sim::batchQubits( count ) ;
+          sim::pack( nbQubits_ , count , vectors.data() + first , batch ) ;
+          f( kb , batch ) ;
+          sim::unpack( nbQubits_ , batch , count , vectors.data() + first ) ;
+        }
+      }
+
+      /// Applies the fusion passes of the options `options` to `schedule`.
+      static void fuse( sim::Schedule< T >& schedule ,
+                        const sim::Options& options ) {
+        if ( options.fuseDiagonal ) sim::fuseDiagonal( schedule ) ;
+        if ( options.fuseMonomial ) sim::fuseMonomial( schedule ) ;
+        if ( options.fuse1 ) sim::fuse1( schedule ) ;
+        if ( options.fuseK >= 2 ) sim::fuseK( schedule , options.fuseK ) ;
+      }
+
+      /**
+       * \brief Applies the schedule `schedule` to the vector `vector` of
+       *        `nbQubits` qubits with the cache blocking options of
+       *        `options`. Must be called by all threads of a persistent team.
+       */
+      static void applySchedule( const sim::Schedule< T >& schedule ,
+                                 const int nbQubits , std::vector< T >& vector ,
+                                 const sim::Options& options ) {
+        if ( ( options.blockQubits > 0 ) &&
+             ( options.blockQubits < nbQubits ) &&
+             ( options.remapWindow > 0 ) ) {
+          std::vector< int > perm( nbQubits ) ;
+          std::iota( perm.begin() , perm.end() , 0 ) ;
+          sim::applyRemapped( schedule , nbQubits , vector ,
+                              options.blockQubits , options.remapWindow ,
+                              perm ) ;
+          sim::unpermute( nbQubits , vector , perm ) ;
+        } else if ( ( options.blockQubits > 0 ) &&
+                    ( options.blockQubits < nbQubits ) ) {
+          sim::applyBlocked( schedule , nbQubits , vector ,
+                             options.blockQubits ) ;
+        } else {
+          schedule.apply( nbQubits , vector ) ;
+        }
+      }
+
       /// Number of qubits of this quantum circuit.
       int          nbQubits_ ;
       /// Qubit offset of this quantum circuit.
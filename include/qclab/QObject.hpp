@@ -5,6 +5,8 @@
 #include "qclab/util.hpp"
 #include "qclab/qasm.hpp"
 #include "qclab/dense/SquareMatrix.hpp"
+#include "qclab/StateVector.hpp"
+#include "qclab/ClassicalRegister.hpp"
 #include <vector>
 
 /**
@@ -48,10 +50,58 @@ namespace qclab {
       /// Returns the unitary matrix corresponding to this quantum object.
       virtual qclab::dense::SquareMatrix< T > matrix() const = 0 ;
 
-      /// Applies this quantum object to the given vector.
+      /**
+       * \brief Applies this quantum object to the given vector.
+       *
+       * Inside a persistent team (see parallel::run), the library calls the
+       * apply functions of this quantum object from every thread of the team
+       * if teamAware is true, and from a single thread otherwise.
+       */
       virtual void apply( Op op , const int size , std::vector< T >& vector ,
                           const int offset = 0 ) const = 0 ;
 
+      /**
+       * \brief Checks if the apply functions of this quantum object can be
+       *        called by every thread of a persistent team, i.e., if they
+       *        share all their loops with parallel::forRange or
+       *        parallel::forEach and only write to shared data inside these
+       *        loops. Quantum objects that override apply with plain loops or
+       *        their own parallel regions must return false.
+       */
+      virtual bool teamAware() const { return false ; }
+
+      /**
+       * \brief Applies this quantum object to the given state vector. The
+       *        default implementation applies the matrix of this quantum
+       *        object to its qubits.
+       */
+      virtual void apply( Op op , const int nbQubits ,
+                          qclab::StateVector< T >& state ,
+                          const int offset = 0 ) const {
+        assert( nbQubits == state.nbQubits() ) ;
+        auto qubits = this->qubits() ;
+        for ( auto& q : qubits ) q += offset ;
+        state.applyMatrix( op , qubits , this->matrix() ) ;
+      }
+
+      /**
+       * \brief Checks if this quantum object is dynamic, i.e., a measurement,
+       *        a reset, or a classically conditioned gate, or contains one.
+       *        Dynamic objects are only applied with a classical register.
+       */
+      virtual bool dynamic() const { return false ; }
+
+      /**
+       * \brief Applies this quantum object to the given vector with the
+       *        classical register `creg`. The default implementation applies
+       *        this quantum object without the classical register.
+       */
+      virtual void apply( const int nbQubits , std::vector< T >& vector ,
+                          qclab::ClassicalRegister& ,
+                          const int offset = 0 ) const {
+        apply( Op::NoTrans , nbQubits , vector , offset ) ;
+      }
+
       /// Applies this quantum object to the given device vector.
     #ifdef QCLAB_OMP_OFFLOADING
       virtual void apply_device( Op op , const int size , T* vector ,
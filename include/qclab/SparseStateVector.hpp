@@ -0,0 +1,133 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \class SparseStateVector
+   * \brief State vector of a quantum register of up to 64 qubits that only
+   *        stores its nonzero amplitudes.
+   *
+   * The nonzero amplitudes are stored as an unsorted array of pairs of basis
+   * indices and amplitudes, in which the basis index `i` has the qubit `q` as
+   * bit `nbQubits - q - 1`. Gates only visit the stored amplitudes:
+   *  - monomial gates, e.g., Pauli, phase, CNOT, SWAP and multi-controlled X
+   *    gates, map every amplitude to a single amplitude and update the array
+   *    in place;
+   *  - other gates gather the amplitudes that differ only in their target
+   *    qubits, multiply them by the target matrix, and drop the results with
+   *    a magnitude not larger than `tolerance()`.
+   *
+   * Amplitudes that do not satisfy the controls of a controlled gate are not
+   * touched. Once the fraction of nonzero amplitudes exceeds `density()`,
+   * the state vector switches to a dense vector and the gates are applied by
+   * their usual vector kernels, provided that the register has at most
+   * `maxDenseQubits` qubits.
+   */
+  template <typename T>
+  class SparseStateVector
+  {
+
+    public:
+      /// Value type of this state vector.
+      using value_type = T ;
+      /// Real value type of this state vector.
+      using real_type  = qclab::real_t< T > ;
+      /// Basis index and amplitude of a nonzero amplitude.
+      using entry_type = std::pair< uint64_t , T > ;
+
+      /// Maximum number of qubits of a sparse state vector.
+      static constexpr int maxQubits = 64 ;
+
+      /// Maximum number of qubits of a state vector that switches to dense.
+      static constexpr int maxDenseQubits = 30 ;
+
+      /**
+       * \brief Constructs a state vector of `nbQubits` qubits in the basis
+       *        state `basis`, i.e., the all zero state by default.
+       */
+      SparseStateVector( const int nbQubits , const uint64_t basis = 0 ) ;
+
+      /// Returns the number of qubits of this state vector.
+      inline int nbQubits() const { return nbQubits_ ; }
+
+      /// Checks if this state vector has switched to a dense vector.
+      inline bool isDense() const { return isDense_ ; }
+
+      /// Returns the number of stored amplitudes of this state vector.
+      inline int64_t nbNonzeros() const {
+        return isDense_ ? dense_.size() : entries_.size() ;
+      }
+
+      /// Returns the magnitude below which amplitudes are dropped.
+      inline real_type tolerance() const { return tolerance_ ; }
+
+      /// Sets the magnitude below which amplitudes are dropped.
+      inline void setTolerance( const real_type tolerance ) {
+        assert( tolerance >= 0 ) ;
+        tolerance_ = tolerance ;
+      }
+
+      /**
+       * \brief Returns the fraction of nonzero amplitudes above which this
+       *        state vector switches to a dense vector.
+       */
+      inline double density() const { return density_ ; }
+
+      /**
+       * \brief Sets the fraction of nonzero amplitudes above which this
+       *        state vector switches to a dense vector, e.g., 1 to never
+       *        switch.
+       */
+      inline void setDensity( const double density ) {
+        assert( density >= 0 ) ;
+        density_ = density ;
+      }
+
+      /// Returns the amplitude of the basis state `index`, in O(nnz) time.
+      T operator()( const uint64_t index ) const ;
+
+      /// Returns the nonzero amplitudes of this state vector, sorted by index.
+      std::vector< entry_type > entries() const ;
+
+      /// Returns the amplitudes of this state vector as a dense vector.
+      std::vector< T > vector() const ;
+
+      /// Applies the quantum object `object`, shifted by `offset` qubits.
+      void apply( const qclab::QObject< T >& object , const int offset = 0 ) ;
+
+      /**
+       * \brief Simulates the quantum circuit `circuit` on this state vector.
+       *        The circuit must not be dynamic.
+       */
+      void simulate( const qclab::QCircuit< T >& circuit ) ;
+
+    private:
+      /// Applies a sparse gate without switching to a dense vector.
+      void applySparse( const qclab::QObject< T >& object , const int offset ) ;
+
+      /// Switches to a dense vector if the density is exceeded.
+      void updateDensity() ;
+
+      /// Number of qubits.
+      int                        nbQubits_ ;
+      /// Magnitude below which amplitudes are dropped.
+      real_type                  tolerance_ ;
+      /// Fraction of nonzero amplitudes above which to switch to dense.
+      double                     density_ ;
+      /// Checks if this state vector is dense.
+      bool                       isDense_ ;
+      /// Nonzero amplitudes of a sparse state vector.
+      std::vector< entry_type >  entries_ ;
+      /// Amplitudes of a dense state vector.
+      std::vector< T >           dense_ ;
+
+  } ; // class SparseStateVector
+
+} // namespace qclab
@@ -0,0 +1,167 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/ClassicalRegister.hpp"
+#include "qclab/sample.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \class StabilizerTableau
+   * \brief Stabilizer tableau of a quantum register in a stabilizer state,
+   *        for the simulation of Clifford circuits in polynomial time.
+   *
+   * The tableau of Aaronson and Gottesman stores n destabilizer rows, n
+   * stabilizer rows and a scratch row, where every row is a Pauli string of
+   * n qubits with a sign. The X and Z bits of a row are packed into 64-bit
+   * words, such that the products of rows of a measurement, including their
+   * phases, are computed 64 qubits at a time. Gates update one or two bits
+   * of every row.
+   *
+   * The supported gates are Identity, Hadamard, Phase90, PauliX, PauliY,
+   * PauliZ, CX, CY, CZ (with either control state), SWAP and iSWAP, as well
+   * as measurements, resets, and classically conditioned Clifford gates.
+   */
+  class StabilizerTableau
+  {
+
+    public:
+      /// Constructs the tableau of `nbQubits` qubits in the all zero state.
+      StabilizerTableau( const int nbQubits ) ;
+
+      /// Returns the number of qubits of this tableau.
+      inline int nbQubits() const { return nbQubits_ ; }
+
+      /// Applies a Hadamard gate to the qubit `q`.
+      void h( const int q ) ;
+
+      /// Applies a Phase90 gate, i.e., S = diag(1, i), to the qubit `q`.
+      void s( const int q ) ;
+
+      /// Applies a Pauli-X gate to the qubit `q`.
+      void x( const int q ) ;
+
+      /// Applies a Pauli-Y gate to the qubit `q`.
+      void y( const int q ) ;
+
+      /// Applies a Pauli-Z gate to the qubit `q`.
+      void z( const int q ) ;
+
+      /// Applies a CX gate with control `c` and target `t`.
+      void cx( const int c , const int t ) ;
+
+      /// Applies a CY gate with control `c` and target `t`.
+      void cy( const int c , const int t ) ;
+
+      /// Applies a CZ gate to the qubits `a` and `b`.
+      void cz( const int a , const int b ) ;
+
+      /// Applies a SWAP gate to the qubits `a` and `b`.
+      void swap( const int a , const int b ) ;
+
+      /// Applies an iSWAP gate to the qubits `a` and `b`.
+      void iswap( const int a , const int b ) ;
+
+      /// Checks if the outcome of a measurement of the qubit `q` is random.
+      bool isRandom( const int q ) const ;
+
+      /**
+       * \brief Measures the qubit `q` in the computational basis and returns
+       *        the outcome. A random outcome is 1 if `u` < 1/2.
+       */
+      int measure( const int q , const double u ) ;
+
+      /**
+       * \brief Returns the stabilizers of this tableau as strings of a sign
+       *        followed by the Paulis I, X, Y, Z of the qubits in order.
+       */
+      std::vector< std::string > stabilizers() const ;
+
+      /// Checks if the quantum object `object` is supported by the tableau.
+      template <typename T>
+      static bool isClifford( const qclab::QObject< T >& object ) ;
+
+      /**
+       * \brief Applies the quantum object `object`, shifted by `offset`
+       *        qubits, with the classical register `creg`. Measurements and
+       *        resets draw the next random number of `creg` as in the vector
+       *        simulation.
+       */
+      template <typename T>
+      void apply( const qclab::QObject< T >& object ,
+                  qclab::ClassicalRegister& creg , const int offset = 0 ) ;
+
+      /**
+       * \brief Simulates the Clifford circuit `circuit` with the classical
+       *        register `creg`.
+       */
+      template <typename T>
+      void simulate( const qclab::QCircuit< T >& circuit ,
+                     qclab::ClassicalRegister& creg ) ;
+
+      /**
+       * \brief Samples `nbShots` measurements of the qubits `qubits` with the
+       *        random number stream of seed `seed`, see qclab::sample. The
+       *        shots are distributed over the threads and every shot measures
+       *        its own copy of the tableau.
+       */
+      Counts sample( const int64_t nbShots ,
+                     const std::vector< int >& qubits = {} ,
+                     const uint64_t seed = 0 ) const ;
+
+    private:
+      /// Returns the X bits of row `i`.
+      inline uint64_t* xs( const int i ) { return x_.data() + i * words_ ; }
+      /// Returns the Z bits of row `i`.
+      inline uint64_t* zs( const int i ) { return z_.data() + i * words_ ; }
+
+      /// Returns the X bit of the qubit `q` of row `i`.
+      inline bool xbit( const int i , const int q ) const {
+        return ( x_[ i * words_ + q / 64 ] >> ( q % 64 ) ) & 1 ;
+      }
+      /// Returns the Z bit of the qubit `q` of row `i`.
+      inline bool zbit( const int i , const int q ) const {
+        return ( z_[ i * words_ + q / 64 ] >> ( q % 64 ) ) & 1 ;
+      }
+
+      /// Multiplies the row `h` by the row `i`, including the signs.
+      void rowsum( const int h , const int i ) ;
+
+      /// Number of qubits.
+      int                      nbQubits_ ;
+      /// Number of words of a row.
+      int                      words_ ;
+      /// X bits of the rows.
+      std::vector< uint64_t >  x_ ;
+      /// Z bits of the rows.
+      std::vector< uint64_t >  z_ ;
+      /// Signs of the rows.
+      std::vector< uint8_t >   r_ ;
+
+  } ; // class StabilizerTableau
+
+
+  /// Checks if all objects of the quantum circuit `circuit` are Clifford.
+  template <typename T>
+  bool isClifford( const qclab::QCircuit< T >& circuit ) ;
+
+  /**
+   * \brief Samples `nbShots` measurements of the qubits `qubits` of the
+   *        quantum circuit `circuit` applied to the all zero state, with the
+   *        random number stream of seed `seed`, see qclab::sample.
+   *
+   * Clifford circuits are simulated with a stabilizer tableau and other
+   * circuits with a state vector. Dynamic circuits are simulated once per
+   * shot, with the classical register of seed `Random( seed )( 2 * shot )`.
+   */
+  template <typename T>
+  Counts sample( const qclab::QCircuit< T >& circuit , const int64_t nbShots ,
+                 const std::vector< int >& qubits = {} ,
+                 const uint64_t seed = 0 ) ;
+
+} // namespace qclab
@@ -0,0 +1,246 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/util.hpp"
+#include "qclab/dense/memory.hpp"
+#include "qclab/dense/SquareMatrix.hpp"
+#include "qclab/dense/SmallMatrix.hpp"
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * Memory layout of a state vector.
+   * \ingroup Enumerations
+   */
+  enum class Layout : char
+  {
+    Interleaved = 'I' ,  ///< Interleaved real and imaginary parts
+    Split       = 'S'    ///< Separate arrays of real and imaginary parts
+  } ; // enum class Layout
+
+  /**
+   * \class StateVector
+   * \brief State vector of a quantum register.
+   *
+   * The amplitudes are either stored interleaved, i.e., as an array of
+   * complex numbers compatible with `std::vector< T >`, or split, i.e., as an
+   * array of real parts followed by an array of imaginary parts. The split
+   * layout avoids the shuffles of complex arithmetic in the vector kernels
+   * and is only available for complex types. The memory is aligned to
+   * `alignment` bytes for both layouts.
+   */
+  template <typename T>
+  class StateVector
+  {
+
+    public:
+      /// Value type of this state vector.
+      using value_type = T ;
+      /// Real value type of this state vector.
+      using real_type = qclab::real_t< T > ;
+
+      /// Alignment of the memory of a state vector in bytes.
+      static constexpr std::size_t alignment = 64 ;
+
+      /**
+       * \brief Constructs a state vector of `nbQubits` qubits in the all zero
+       *        state with layout `layout`.
+       */
+      StateVector( const int nbQubits ,
+                   const Layout layout = Layout::Interleaved )
+      : nbQubits_( nbQubits )
+      , layout_( layout )
+      , data_( alloc() )
+      {
+        assert( nbQubits >= 1 ) ;
+        assert( qclab::is_complex_v< T > || layout == Layout::Interleaved ) ;
+        std::fill( data_.get() , data_.get() + length() , real_type(0) ) ;
+        data_[0] = 1 ;
+      } // StateVector(nbQubits,layout)
+
+      /**
+       * \brief Constructs a state vector from the given vector `vector` with
+       *        layout `layout`.
+       */
+      StateVector( const std::vector< T >& vector ,
+                   const Layout layout = Layout::Interleaved )
+      : nbQubits_( nbQubitsOf( vector.size() ) )
+      , layout_( layout )
+      , data_( alloc() )
+      {
+        assert( qclab::is_complex_v< T > || layout == Layout::Interleaved ) ;
+        for ( int64_t i = 0; i < size(); i++ ) {
+          set( i , vector[i] ) ;
+        }
+      } // StateVector(vector,layout)
+
+      /// Copy constructor
+      StateVector( const StateVector< T >& other )
+      : nbQubits_( other.nbQubits_ )
+      , layout_( other.layout_ )
+      , data_( alloc() )
+      {
+        std::copy( other.data_.get() , other.data_.get() + length() ,
+                   data_.get() ) ;
+      } // StateVector(other)
+
+      /// Move constructor
+      StateVector( StateVector< T >&& other ) = default ;
+
+      /// Copy assignment
+      StateVector< T >& operator=( const StateVector< T >& other ) {
+        if ( this != &other ) *this = StateVector< T >( other ) ;
+        return *this ;
+      }
+
+      /// Move assignment
+      StateVector< T >& operator=( StateVector< T >&& other ) = default ;
+
+      /// Returns the number of qubits of this state vector.
+      inline int nbQubits() const { return nbQubits_ ; }
+
+      /// Returns the number of amplitudes of this state vector.
+      inline int64_t size() const { return int64_t(1) << nbQubits_ ; }
+
+      /// Returns the memory layout of this state vector.
+      inline Layout layout() const { return layout_ ; }
+
+      /// Returns the amplitude `i` of this state vector.
+      inline T operator()( const int64_t i ) const {
+        assert( i >= 0 && i < size() ) ;
+        if constexpr ( qclab::is_complex_v< T > ) {
+          if ( layout_ == Layout::Split ) {
+            return T( data_[i] , data_[ stride() + i ] ) ;
+          }
+        }
+        return data()[i] ;
+      }
+
+      /// Sets the amplitude `i` of this state vector to `value`.
+      inline void set( const int64_t i , const T value ) {
+        assert( i >= 0 && i < size() ) ;
+        if constexpr ( qclab::is_complex_v< T > ) {
+          if ( layout_ == Layout::Split ) {
+            data_[i] = std::real( value ) ;
+            data_[ stride() + i ] = std::imag( value ) ;
+            return ;
+          }
+        }
+        data()[i] = value ;
+      }
+
+      /// Returns the amplitudes of this state vector as a vector.
+      std::vector< T > vector() const {
+        std::vector< T > vec( size() ) ;
+        for ( int64_t i = 0; i < size(); i++ ) {
+          vec[i] = (*this)(i) ;
+        }
+        return vec ;
+      }
+
+      /// Converts this state vector to the memory layout `layout`.
+      void setLayout( const Layout layout ) {
+        if ( layout == layout_ ) return ;
+        StateVector< T > other( nbQubits_ , layout ) ;
+        for ( int64_t i = 0; i < size(); i++ ) {
+          other.set( i , (*this)(i) ) ;
+        }
+        *this = std::move( other ) ;
+      }
+
+      /// Returns the amplitudes of an interleaved state vector.
+      inline T* data() {
+        assert( layout_ == Layout::Interleaved ) ;
+        return reinterpret_cast< T* >( data_.get() ) ;
+      }
+
+      /// Returns the amplitudes of an interleaved state vector.
+      inline const T* data() const {
+        assert( layout_ == Layout::Interleaved ) ;
+        return reinterpret_cast< const T* >( data_.get() ) ;
+      }
+
+      /// Returns the real parts of a split state vector.
+      inline real_type* real() {
+        assert( layout_ == Layout::Split ) ;
+        return data_.get() ;
+      }
+
+      /// Returns the imaginary parts of a split state vector.
+      inline real_type* imag() {
+        assert( layout_ == Layout::Split ) ;
+        return data_.get() + stride() ;
+      }
+
+      /// Returns the real parts of a split state vector.
+      inline const real_type* real() const {
+        assert( layout_ == Layout::Split ) ;
+        return data_.get() ;
+      }
+
+      /// Returns the imaginary parts of a split state vector.
+      inline const real_type* imag() const {
+        assert( layout_ == Layout::Split ) ;
+        return data_.get() + stride() ;
+      }
+
+      /**
+       * \brief Applies the operation `op` of the matrix `matrix` to the qubits
+       *        `qubits`, in ascending order, of this state vector.
+       */
+      void applyMatrix( Op op , const std::vector< int >& qubits ,
+                        const qclab::dense::SquareMatrix< T >& matrix ) ;
+
+      /**
+       * \brief Applies the operation `op` of the 2x2 matrix `matrix` to the
+       *        qubit `qubit` of this state vector.
+       */
+      void applyMatrix( Op op , const int qubit ,
+                        const qclab::dense::SmallMatrix< T , 2 >& matrix ) ;
+
+      /**
+       * \brief Applies the operation `op` of the 4x4 matrix `matrix` to the
+       *        ascending qubits `qubit0` and `qubit1` of this state vector.
+       */
+      void applyMatrix( Op op , const int qubit0 , const int qubit1 ,
+                        const qclab::dense::SmallMatrix< T , 4 >& matrix ) ;
+
+    private:
+      /// Returns the number of real numbers stored by this state vector.
+      inline int64_t length() const {
+        return qclab::is_complex_v< T > ? 2 * stride() : size() ;
+      }
+
+      /// Returns the offset of the imaginary parts of a split state vector,
+      /// such that they are aligned to `alignment` bytes.
+      inline int64_t stride() const {
+        constexpr int64_t k = alignment / sizeof( real_type ) ;
+        return ( ( size() + k - 1 ) / k ) * k ;
+      }
+
+      /// Allocates the memory of this state vector.
+      auto alloc() const {
+        return qclab::dense::alloc_aligned_array< real_type >( length() ,
+                                                               alignment ) ;
+      }
+
+      /// Returns the number of qubits of a vector of size `size`.
+      static int nbQubitsOf( const std::size_t size ) {
+        int nbQubits = 0 ;
+        while ( ( std::size_t(1) << nbQubits ) < size ) ++nbQubits ;
+        assert( ( std::size_t(1) << nbQubits ) == size ) ;
+        return nbQubits ;
+      }
+
+      /// Number of qubits of this state vector.
+      int  nbQubits_ ;
+      /// Memory layout of this state vector.
+      Layout  layout_ ;
+      /// Memory of this state vector.
+      std::unique_ptr< real_type[] , qclab::dense::aligned_deleter >  data_ ;
+
+  } ; // class StateVector
+
+} // namespace qclab
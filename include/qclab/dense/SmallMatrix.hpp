@@ -0,0 +1,146 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/util.hpp"
+#include "qclab/dense/SquareMatrix.hpp"
+#include <array>
+
+namespace qclab {
+
+  namespace dense {
+
+    /**
+     * \class SmallMatrix
+     * \brief Class for representing a small square matrix of fixed size.
+     *
+     * This class stores the data of an N x N matrix in column-major order on
+     * the stack, such that the 2x2 and 4x4 matrices of 1-qubit and 2-qubit
+     * gates can be passed around without heap allocations.
+     */
+    template <typename T, int N>
+    class SmallMatrix
+    {
+
+      public:
+        /// Value type of this small matrix.
+        using value_type = T ;
+        /// Size type of this small matrix.
+        using size_type  = int64_t ;
+        /// Data type of this small matrix.
+        using data_type  = std::array< T , N*N > ;
+
+        /// Default constructor. Constructs a zero small matrix.
+        SmallMatrix()
+        : data_()
+        { } // SmallMatrix()
+
+        /// Constructs a 2x2 small matrix with the given elements.
+        SmallMatrix( const T m00 , const T m01 ,
+                     const T m10 , const T m11 )
+        : data_( { m00 , m10 , m01 , m11 } )
+        {
+          static_assert( N == 2 ) ;
+        } // SmallMatrix(m00,m10,m01,m11)
+
+        /// Constructs a 4x4 small matrix with the given elements.
+        SmallMatrix( const T m00 , const T m01 , const T m02 , const T m03 ,
+                     const T m10 , const T m11 , const T m12 , const T m13 ,
+                     const T m20 , const T m21 , const T m22 , const T m23 ,
+                     const T m30 , const T m31 , const T m32 , const T m33 )
+        : data_( { m00 , m10 , m20 , m30 , m01 , m11 , m21 , m31 ,
+                   m02 , m12 , m22 , m32 , m03 , m13 , m23 , m33 } )
+        {
+          static_assert( N == 4 ) ;
+        } // SmallMatrix(m00,m10,m20,m30,...,m33)
+
+        /// Constructs a small matrix from the square matrix `matrix`.
+        explicit SmallMatrix( const SquareMatrix< T >& matrix )
+        {
+          assert( matrix.size() == N ) ;
+          std::copy( matrix.ptr() , matrix.ptr() + N*N , data_.begin() ) ;
+        } // SmallMatrix(matrix)
+
+        /// Converts this small matrix to a square matrix.
+        explicit operator SquareMatrix< T >() const {
+          SquareMatrix< T > matrix( N ) ;
+          std::copy( data_.begin() , data_.end() , matrix.ptr() ) ;
+          return matrix ;
+        }
+
+        /// Returns the size of this small matrix.
+        static constexpr int64_t size() { return N ; }
+
+        /// Returns the number of rows of this small matrix.
+        static constexpr int64_t rows() { return N ; }
+
+        /// Returns the number of columns of this small matrix.
+        static constexpr int64_t cols() { return N ; }
+
+        /// Returns the leading dimension of this small matrix.
+        static constexpr int64_t ld() { return N ; }
+
+        /// Returns a pointer to this small matrix.
+        inline T* ptr() { return data_.data() ; }
+
+        /// Returns a const pointer to this small matrix.
+        inline const T* ptr() const { return data_.data() ; }
+
+        /// Returns the value of this small matrix at row `i` and column `j`.
+        inline T& operator()( const int64_t i , const int64_t j ) {
+          return data_[ i + j*N ] ;
+        }
+
+        /// Returns the value of this small matrix at row `i` and column `j`.
+        inline const T& operator()( const int64_t i , const int64_t j ) const {
+          return data_[ i + j*N ] ;
+        }
+
+        /// Checks if `other` is equal to this small matrix.
+        inline bool operator==( const SmallMatrix< T , N >& other ) const {
+          return data_ == other.data_ ;
+        }
+
+        /// Checks if `other` is different from this small matrix.
+        inline bool operator!=( const SmallMatrix< T , N >& other ) const {
+          return !( *this == other ) ;
+        }
+
+      private:
+        data_type  data_ ;
+
+    } ; // class SmallMatrix
+
+
+    /**
+     * \brief Performs the operation `op` in-place on the small matrix `A`
+     *        without opening a parallel region.
+     */
+    template <typename T, int N>
+    void operateInPlace( Op op , SmallMatrix< T , N >& A ) {
+      if ( op == Op::NoTrans ) return ;
+      for ( int j = 0; j < N; j++ ) {
+        for ( int i = j + 1; i < N; i++ ) {
+          std::swap( A(i,j) , A(j,i) ) ;
+        }
+      }
+      if constexpr ( qclab::is_complex_v< T > ) {
+        if ( op == Op::ConjTrans ) {
+          for ( int k = 0; k < N*N; k++ ) {
+            A.ptr()[k] = std::conj( A.ptr()[k] ) ;
+          }
+        }
+      }
+    }
+
+    /// Performs the operation `op` on the small matrix `A`.
+    template <typename T, int N>
+    SmallMatrix< T , N > operate( Op op , const SmallMatrix< T , N >& A ) {
+      SmallMatrix< T , N > Aop( A ) ;
+      operateInPlace( op , Aop ) ;
+      return Aop ;
+    }
+
+  } // namespace dense
+
+} // namespace qclab
@@ -83,7 +83,7 @@ namespace qclab {
         , data_( alloc_unique_array< T >( size_ * size_ ) )
         {
           const T* data = matrix.ptr() ;
-          #pragma omp parallel for
+          #pragma omp parallel for if ( size_*size_ >= parallel_size )
           for ( int64_t i = 0; i < size_*size_; i++ ) {
             data_[i] = data[i] ;
           }
@@ -96,7 +96,7 @@ namespace qclab {
             data_ = std::move( alloc_unique_array< T >( size_ * size_ ) ) ;
           }
           const T* data = matrix.ptr() ;
-          #pragma omp parallel for
+          #pragma omp parallel for if ( size_*size_ >= parallel_size )
           for ( int64_t i = 0; i < size_*size_; i++ ) {
             data_[i] = data[i] ;
           }
@@ -150,7 +150,7 @@ namespace qclab {
         /// Adds `rhs` to this square matrix.
         inline SquareMatrix< T >& operator+=( const SquareMatrix< T >& rhs ) {
           assert( rhs.size() == size_ ) ;
-          #pragma omp parallel for
+          #pragma omp parallel for if ( size_*size_ >= parallel_size )
           for ( int64_t j = 0; j < size_; j++ ) {
             for ( int64_t i = 0; i < size_; i++ ) {
               (*this)(i,j) += rhs(i,j) ;
@@ -162,7 +162,7 @@ namespace qclab {
         /// Substracts `rhs` from this square matrix.
         inline SquareMatrix< T >& operator-=( const SquareMatrix< T >& rhs ) {
           assert( rhs.size() == size_ ) ;
-          #pragma omp parallel for
+          #pragma omp parallel for if ( size_*size_ >= parallel_size )
           for ( int64_t j = 0; j < size_; j++ ) {
             for ( int64_t i = 0; i < size_; i++ ) {
               (*this)(i,j) -= rhs(i,j) ;
@@ -175,7 +175,7 @@ namespace qclab {
         inline SquareMatrix< T >& operator*=( const SquareMatrix< T >& rhs ) {
           assert( size_ == rhs.size() ) ;
           auto new_data = init_unique_array< T >( size_ * size_ ) ;
-          #pragma omp parallel for
+          #pragma omp parallel for if ( size_*size_*size_ >= parallel_size )
           for ( int64_t j = 0; j < size_; j++ ) {
             for ( int64_t i = 0; i < size_; i++ ) {
               for ( int64_t k = 0; k < size_; k++ ) {
@@ -209,6 +209,14 @@ namespace qclab {
         }
 
       private:
+        /**
+         * \brief Minimum amount of work for which the loops over the elements
+         *        of a square matrix run in parallel. Smaller matrices, such
+         *        as the matrices of 1-qubit and 2-qubit gates, are processed
+         *        serially to avoid the cost of opening a parallel region.
+         */
+        static constexpr int64_t parallel_size = 4096 ;
+
         size_type  size_ ;
         data_type  data_ ;
 
@@ -5,6 +5,8 @@
 #include <cassert>
 #include <memory>
 #include <algorithm>
+#include <new>
+#include <type_traits>
 
 namespace qclab {
 
@@ -43,6 +45,33 @@ namespace qclab {
       return mem ;
     } // init_unique_array
 
+    /// Deleter of the arrays allocated by `alloc_aligned_array`.
+    struct aligned_deleter {
+      std::size_t  alignment ;  ///< Alignment of the array in bytes.
+      /// Deallocates the array `ptr`.
+      template <typename T>
+      void operator()( T* ptr ) const {
+        ::operator delete[]( ptr , std::align_val_t( alignment ) ) ;
+      }
+    } ;
+
+    /**
+     * \brief Allocates an uninitialized array of size `size` of a trivial
+     *        type, aligned to `alignment` bytes.
+     */
+    template <typename T>
+    inline auto alloc_aligned_array( const int64_t size ,
+                                     const std::size_t alignment = 64 ) {
+      static_assert( std::is_trivial_v< T > ) ;
+      assert( size > 0 ) ;
+      const auto align = std::align_val_t( alignment ) ;
+      T* ptr = static_cast< T* >( ::operator new[]( size * sizeof( T ) ,
+                                                    align ) ) ;
+      std::unique_ptr< T[] , aligned_deleter > mem( ptr , { alignment } ) ;
+      assert( mem.get() != nullptr ) ;
+      return mem ;
+    } // alloc_aligned_array
+
   } // namespace qclab
 
 } // namespace dense
@@ -0,0 +1,159 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/util.hpp"
+#include "qclab/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace qclab {
+
+  namespace dense {
+
+    /**
+     * \brief Computes the thin singular value decomposition A = U S Vh of
+     *        the `m` x `n` matrix `A`, where k = min(`m`, `n`), `U` is the
+     *        `m` x k matrix of left singular vectors, `S` holds the k
+     *        singular values in decreasing order, and `Vh` is the k x `n`
+     *        matrix of conjugated right singular vectors. All matrices are
+     *        stored row by row.
+     *
+     * The one-sided Jacobi method orthogonalizes the columns of A, or of its
+     * conjugate transpose if `m` < `n`, by plane rotations. Every sweep visits
+     * all pairs of columns in rounds of disjoint pairs, and the pairs of a
+     * round are rotated in parallel. Singular vectors of zero singular
+     * values may be zero.
+     */
+    template <typename T>
+    void svd( const int64_t m , const int64_t n , const std::vector< T >& A ,
+              std::vector< T >& U , std::vector< qclab::real_t< T > >& S ,
+              std::vector< T >& Vh ) {
+      using R = qclab::real_t< T > ;
+      assert( m >= 1 && n >= 1 ) ;
+      assert( A.size() == m * n ) ;
+      auto conj = [] ( const T& x ) {
+        if constexpr ( qclab::is_complex_v< T > ) {
+          return std::conj( x ) ;
+        } else {
+          return x ;
+        }
+      } ;
+
+      // columns of A, or of the conjugate transpose of A
+      const bool wide = m < n ;
+      const int64_t rows = wide ? n : m ;
+      const int64_t cols = wide ? m : n ;
+      std::vector< T > W( rows * cols ) ;
+      for ( int64_t i = 0; i < m; i++ ) {
+        for ( int64_t j = 0; j < n; j++ ) {
+          if ( wide ) {
+            W[ i * rows + j ] = conj( A[ i * n + j ] ) ;
+          } else {
+            W[ j * rows + i ] = A[ i * n + j ] ;
+          }
+        }
+      }
+      std::vector< T > V( cols * cols , T(0) ) ;
+      for ( int64_t j = 0; j < cols; j++ ) V[ j * cols + j ] = 1 ;
+
+      // sweeps of rounds of disjoint pairs (round robin)
+      const R eps = std::numeric_limits< R >::epsilon() ;
+      const int64_t pairs = ( cols + 1 ) / 2 ;
+      const int64_t players = 2 * pairs ;
+      std::vector< char > rotated( pairs ) ;
+      const int maxSweeps = 100 ;
+      for ( int sweep = 0; sweep < maxSweeps; sweep++ ) {
+        bool converged = true ;
+        for ( int64_t round = 0; round < players - 1; round++ ) {
+          auto player = [&] ( const int64_t i ) -> int64_t {
+            return ( i == 0 ) ? 0 : 1 + ( i - 1 + round ) % ( players - 1 ) ;
+          } ;
+          parallel::forEach( pairs , [&] ( const int64_t k ) {
+            rotated[k] = 0 ;
+            int64_t p = player( k ) ;
+            int64_t q = player( players - 1 - k ) ;
+            if ( ( p >= cols ) || ( q >= cols ) ) return ;
+            if ( p > q ) std::swap( p , q ) ;
+            T* wp = W.data() + p * rows ;
+            T* wq = W.data() + q * rows ;
+            R alpha = 0 ;
+            R beta = 0 ;
+            T gamma = 0 ;
+            for ( int64_t i = 0; i < rows; i++ ) {
+              alpha += std::norm( wp[i] ) ;
+              beta  += std::norm( wq[i] ) ;
+              gamma += conj( wp[i] ) * wq[i] ;
+            }
+            const R g = std::abs( gamma ) ;
+            if ( ( g == 0 ) || ( g <= eps * std::sqrt( alpha * beta ) ) ) {
+              return ;
+            }
+            rotated[k] = 1 ;
+            // rotation that makes the columns p and q orthogonal
+            const R zeta = ( beta - alpha ) / ( 2 * g ) ;
+            const R t = ( ( zeta >= 0 ) ? 1 : -1 ) /
+                        ( std::abs( zeta ) + std::sqrt( 1 + zeta * zeta ) ) ;
+            const R c = 1 / std::sqrt( 1 + t * t ) ;
+            const R s = c * t ;
+            const T e = conj( gamma ) / g ;
+            auto rotate = [&] ( T* x , T* y , const int64_t size ) {
+              for ( int64_t i = 0; i < size; i++ ) {
+                const T xi = x[i] ;
+                const T yi = e * y[i] ;
+                x[i] = c * xi - s * yi ;
+                y[i] = s * xi + c * yi ;
+              }
+            } ;
+            rotate( wp , wq , rows ) ;
+            rotate( V.data() + p * cols , V.data() + q * cols , cols ) ;
+          } , rows + cols ) ;
+          for ( const char r : rotated ) converged = converged && !r ;
+        }
+        if ( converged ) break ;
+      }
+
+      // singular values in decreasing order
+      std::vector< R > sigma( cols ) ;
+      for ( int64_t j = 0; j < cols; j++ ) {
+        R sum = 0 ;
+        for ( int64_t i = 0; i < rows; i++ ) {
+          sum += std::norm( W[ j * rows + i ] ) ;
+        }
+        sigma[j] = std::sqrt( sum ) ;
+      }
+      std::vector< int64_t > order( cols ) ;
+      std::iota( order.begin() , order.end() , 0 ) ;
+      std::stable_sort( order.begin() , order.end() ,
+                        [&] ( const int64_t a , const int64_t b ) {
+                          return sigma[a] > sigma[b] ; } ) ;
+
+      // singular vectors
+      const int64_t k = cols ;
+      U.assign( m * k , T(0) ) ;
+      S.resize( k ) ;
+      Vh.assign( k * n , T(0) ) ;
+      for ( int64_t l = 0; l < k; l++ ) {
+        const int64_t j = order[l] ;
+        S[l] = sigma[j] ;
+        const R scale = ( sigma[j] > 0 ) ? 1 / sigma[j] : 0 ;
+        const T* w = W.data() + j * rows ;
+        const T* v = V.data() + j * cols ;
+        if ( wide ) {
+          for ( int64_t i = 0; i < m; i++ ) U[ i * k + l ] = v[i] ;
+          for ( int64_t i = 0; i < n; i++ ) {
+            Vh[ l * n + i ] = conj( w[i] ) * scale ;
+          }
+        } else {
+          for ( int64_t i = 0; i < m; i++ ) U[ i * k + l ] = w[i] * scale ;
+          for ( int64_t i = 0; i < n; i++ ) Vh[ l * n + i ] = conj( v[i] ) ;
+        }
+      }
+    }
+
+  } // namespace dense
+
+} // namespace qclab
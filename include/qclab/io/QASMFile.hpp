@@ -15,9 +15,17 @@
 #include "qclab/qgates/CY.hpp"
 #include "qclab/qgates/CZ.hpp"
 #include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/MCX.hpp"
+#include "qclab/qgates/MCSWAP.hpp"
+#include "qclab/qgates/Measurement.hpp"
+#include "qclab/qgates/Reset.hpp"
+#include "qclab/qgates/Conditional.hpp"
+#include <algorithm>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <iostream>
+#include <type_traits>
 
 /**
  * Namespace qclab::io.
@@ -38,9 +46,103 @@ namespace qclab::io {
       /// Returns the number of qubits.
       int nbQubits() const { return nbQubits_ ; }
 
-      /// Returns the gates.
+      /**
+       * \brief Returns the number of classical bits, i.e., the total size of
+       *        the classical registers, which are stored one after the other.
+       */
+      int nbBits() const { return nbBits_ ; }
+
+      /**
+       * \brief Returns the gates. Measurements, resets, and classically
+       *        conditioned gates are only parsed if `G` is a base class of
+       *        them, e.g., QObject.
+       */
       template <typename G>
       std::vector< std::unique_ptr< G > > gates() const {
+        std::vector< std::unique_ptr< G > > gates ;
+        try {
+          for ( auto command : gateCommands_ ) {
+            parseCommand( command , gates ) ;
+          }
+        } catch ( const std::exception& e ) {
+          std::cerr << "Failed parsing QASM file!" << std::endl ;
+        }
+        return gates ;
+      }
+
+      /**
+       * \brief Parses the command `command` and appends its gates to `gates`.
+       *        Unknown commands are skipped.
+       */
+      template <typename G>
+      void parseCommand( std::string& command ,
+                         std::vector< std::unique_ptr< G > >& gates ) const {
+
+        // types
+        using T = typename G::value_type ;
+        using M = qclab::qgates::Measurement< T > ;
+        using R = qclab::qgates::Reset< T > ;
+        using C = qclab::qgates::Conditional< T > ;
+
+        if constexpr ( std::is_base_of_v< G , M > &&
+                       std::is_base_of_v< G , R > &&
+                       std::is_base_of_v< G , C > ) {
+          const auto n2 = qregName_.length() ;
+          if ( command.substr( 0 , 7 + n2 ) == "measure" + qregName_ ) {
+            // measurement
+            command.erase( 0 , 7 + n2 ) ;
+            if ( command[0] == '[' ) {
+              const auto qubit = parseQubit( command.erase( 0 , 1 ) ) ;
+              const auto bit = parseBit( command.erase( 0 , 2 ) ) ;
+              gates.push_back( std::make_unique< M >( qubit , bit ) ) ;
+            } else {
+              const auto& [ offset , size ] = cregs_.at( command.substr( 2 ) ) ;
+              assert( size == nbQubits_ ) ;
+              for ( int qubit = 0; qubit < nbQubits_; qubit++ ) {
+                gates.push_back( std::make_unique< M >( qubit ,
+                                                        offset + qubit ) ) ;
+              }
+            }
+            return ;
+          } else if ( command.substr( 0 , 5 + n2 ) == "reset" + qregName_ ) {
+            // reset
+            command.erase( 0 , 5 + n2 ) ;
+            if ( command.empty() ) {
+              for ( int qubit = 0; qubit < nbQubits_; qubit++ ) {
+                gates.push_back( std::make_unique< R >( qubit ) ) ;
+              }
+            } else {
+              const auto qubit = parseQubit( command.erase( 0 , 1 ) ) ;
+              gates.push_back( std::make_unique< R >( qubit ) ) ;
+            }
+            return ;
+          } else if ( command.substr( 0 , 3 ) == "if(" ) {
+            // classically conditioned gates
+            command.erase( 0 , 3 ) ;
+            const auto name = left_of( command , "=" ) ;
+            const auto value = read_value< int >( left_of( command.erase( 0 ,
+                                                           1 ) , ")" ) ) ;
+            const auto& [ offset , size ] = cregs_.at( name ) ;
+            std::vector< int > bits( size ) ;
+            for ( int i = 0; i < size; i++ ) bits[i] = offset + i ;
+            std::vector< std::unique_ptr< G > > conditioned ;
+            parseCommand( command , conditioned ) ;
+            for ( auto& gate : conditioned ) {
+              gates.push_back( std::make_unique< C >( std::move( gate ) , bits ,
+                                                      value ) ) ;
+            }
+            return ;
+          }
+        }
+
+        // unitary gates
+        std::unique_ptr< G > gate = parseGate< G >( command ) ;
+        if ( gate ) gates.push_back( std::move( gate ) ) ;
+      }
+
+      /// Parses the unitary gate `command`, or returns nullptr if unknown.
+      template <typename G>
+      std::unique_ptr< G > parseGate( std::string& command ) const {
 
         // types
         using T = typename G::value_type ;
@@ -56,42 +158,57 @@ namespace qclab::io {
         using CY = qclab::qgates::CY< T > ;
         using CZ = qclab::qgates::CZ< T > ;
         using SWAP = qclab::qgates::SWAP< T > ;
+        using MCX  = qclab::qgates::MCX< T > ;
+        using MCSWAP = qclab::qgates::MCSWAP< T > ;
+
+        // multi-controlled Pauli-X gate on the qubits `qubits`, the last
+        // qubit is the target
+        auto mcx = [] ( std::vector< int >& qubits ) {
+          const int target = qubits.back() ;
+          qubits.pop_back() ;
+          std::sort( qubits.begin() , qubits.end() ) ;
+          return std::make_unique< MCX >( qubits , target ) ;
+        } ;
 
-        // loop over commands
+        // parse gate
         std::unique_ptr< G > gate ;
-        std::vector< std::unique_ptr< G > > gates ;
-        try {
-          for ( auto command : gateCommands_ ) {
-            if ( parse1const< H >( "h" , command , gate ) ) {       // Hadamard
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1const< X >( "x" , command , gate ) ) {// PauliX
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1const< Y >( "y" , command , gate ) ) {// PauliY
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1const< Z >( "z" , command , gate ) ) {// PauliZ
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1a< RX >( "rx" , command , gate ) ) {  // RotationX
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1a< RY >( "ry" , command , gate ) ) {  // RotationY
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1a< RZ >( "rz" , command , gate ) ) {  // RotationZ
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse1a< P >( "p" , command , gate ) ) {    // Phase
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse2const< CX >( "cx" , command , gate ) ) { // CX
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse2const< CY >( "cy" , command , gate ) ) { // CY
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse2const< CZ >( "cz" , command , gate ) ) { // CZ
-              gates.push_back( std::move( gate ) ) ;
-            } else if ( parse2const< SWAP >( "swap" , command , gate ) ) {//SWAP
-              gates.push_back( std::move( gate ) ) ;
-            }
-          }
-        } catch ( const std::exception& e ) {
-          std::cerr << "Failed parsing QASM file!" << std::endl ;
+        std::vector< int > qubits ;
+        if ( parse1const< H >( "h" , command , gate ) ) {       // Hadamard
+          return gate ;
+        } else if ( parse1const< X >( "x" , command , gate ) ) {// PauliX
+          return gate ;
+        } else if ( parse1const< Y >( "y" , command , gate ) ) {// PauliY
+          return gate ;
+        } else if ( parse1const< Z >( "z" , command , gate ) ) {// PauliZ
+          return gate ;
+        } else if ( parse1a< RX >( "rx" , command , gate ) ) {  // RotationX
+          return gate ;
+        } else if ( parse1a< RY >( "ry" , command , gate ) ) {  // RotationY
+          return gate ;
+        } else if ( parse1a< RZ >( "rz" , command , gate ) ) {  // RotationZ
+          return gate ;
+        } else if ( parse1a< P >( "p" , command , gate ) ) {    // Phase
+          return gate ;
+        } else if ( parse2const< CX >( "cx" , command , gate ) ) { // CX
+          return gate ;
+        } else if ( parse2const< CY >( "cy" , command , gate ) ) { // CY
+          return gate ;
+        } else if ( parse2const< CZ >( "cz" , command , gate ) ) { // CZ
+          return gate ;
+        } else if ( parse2const< SWAP >( "swap" , command , gate ) ) {//SWAP
+          return gate ;
+        } else if ( parseNconst( "ccx" , command , qubits ) ) { // Toffoli
+          assert( qubits.size() == 3 ) ;
+          return mcx( qubits ) ;
+        } else if ( parseNconst( "mcx" , command , qubits ) ) { // MCX
+          assert( qubits.size() >= 2 ) ;
+          return mcx( qubits ) ;
+        } else if ( parseNconst( "cswap" , command , qubits ) ) {//Fredkin
+          assert( qubits.size() == 3 ) ;
+          return std::make_unique< MCSWAP >(
+            std::vector< int >( { qubits[0] } ) , qubits[1] , qubits[2] ) ;
         }
-        return gates ;
+        return nullptr ;
       }
 
       /// Parses a qubit.
@@ -99,6 +216,13 @@ namespace qclab::io {
         return read_value< int >( left_of( str , "]" ) ) ;
       }
 
+      /// Parses a classical bit, e.g., `c[1]`, of the classical registers.
+      int parseBit( std::string& str ) const {
+        const auto name = left_of( str , "[" ) ;
+        return cregs_.at( name ).first + read_value< int >( left_of( str ,
+                                                                     "]" ) ) ;
+      }
+
       /// Parses an angle.
       template <typename T>
       T parseAngle( std::string& str ) const {
@@ -151,6 +275,22 @@ namespace qclab::io {
         return 0 ;
       }
 
+      /// Parses a constant gate on a list of qubits.
+      int parseNconst( std::string name , std::string& command ,
+                       std::vector< int >& qubits ) const {
+        const auto n1 = name.length() ;
+        const auto n2 = qregName_.length() ;
+        if ( command.substr( 0 , n1 + n2 ) == name + qregName_ ) {
+          qubits.clear() ;
+          qubits.push_back( parseQubit( command.erase( 0 , n1 + n2 + 1 ) ) ) ;
+          while ( !command.empty() ) {
+            qubits.push_back( parseQubit( command.erase( 0 , n2 + 2 ) ) ) ;
+          }
+          return 1 ;
+        }
+        return 0 ;
+      }
+
     private:
       /// Parses the QASM file.
       void parse() ;
@@ -161,6 +301,10 @@ namespace qclab::io {
       int                         nbQubits_ ;
       /// Quantum register name of this QASM file.
       std::string                 qregName_ ;
+      /// Number of classical bits of this QASM file.
+      int                         nbBits_ = 0 ;
+      /// Offsets and sizes of the classical registers of this QASM file.
+      std::map< std::string , std::pair< int , int > >  cregs_ ;
       /// Gates of this QASM file.
       std::vector< std::string >  gateCommands_ ;
 
@@ -0,0 +1,229 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/sim/Options.hpp"
+#include "qclab/sim/Schedule.hpp"
+#include "qclab/qgates/DiagonalGate.hpp"
+#include <mpi.h>
+#include <complex>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * Namespace qclab::mpi.
+   *
+   * Distributed simulation of quantum circuits over the ranks of an MPI
+   * communicator. Only available if qclab++ is built with QCLAB_MPI. MPI
+   * must be initialized with at least MPI_THREAD_FUNNELED, as all MPI calls
+   * are made by the calling thread outside the OpenMP parallel regions.
+   */
+  namespace mpi {
+
+    /// Returns the MPI datatype of the value type `T`.
+    template <typename T>
+    inline MPI_Datatype datatype() {
+      if constexpr ( std::is_same_v< T , float > ) {
+        return MPI_FLOAT ;
+      } else if constexpr ( std::is_same_v< T , double > ) {
+        return MPI_DOUBLE ;
+      } else if constexpr ( std::is_same_v< T , std::complex< float > > ) {
+        return MPI_C_FLOAT_COMPLEX ;
+      } else {
+        static_assert( std::is_same_v< T , std::complex< double > > ) ;
+        return MPI_C_DOUBLE_COMPLEX ;
+      }
+    }
+
+    /**
+     * \class DistributedStateVector
+     * \brief State vector of a quantum register distributed over the P ranks
+     *        of an MPI communicator, with P a power of 2.
+     *
+     * The log2(P) most significant physical qubits are global, i.e., they
+     * select the rank, and the other physical qubits are local to the
+     * vector of 2^(n - log2(P)) amplitudes of every rank. Gates on local
+     * qubits are applied by the usual kernels on the local vectors without
+     * communication. Diagonal gates on global qubits are reduced to diagonal
+     * gates on the local qubits of every rank, and SWAP gates only relabel
+     * the qubits. For other gates on global qubits, every global qubit is
+     * first interchanged with the local qubit that is used last by the
+     * following gates, by a pairwise exchange of half of the local vectors.
+     *
+     * The logical qubit `q` is stored at the physical qubit `permutation()[q]`
+     * and the vector is only permuted back to the logical order when it is
+     * gathered.
+     */
+    template <typename T>
+    class DistributedStateVector
+    {
+
+      public:
+        /// Value type of this distributed state vector.
+        using value_type = T ;
+
+        /// Maximum number of amplitudes of a single message of an exchange.
+        static constexpr int64_t maxMessage = int64_t(1) << 20 ;
+
+        /// Maximum number of gates scanned to select a local qubit.
+        static constexpr int lookahead = 4096 ;
+
+        /**
+         * \struct Timings
+         * \brief Wall clock times and statistics of the simulations of a
+         *        distributed state vector.
+         */
+        struct Timings {
+          /// Time spent in the kernels on the local vector, in seconds.
+          double   compute = 0 ;
+          /// Time spent in the exchanges of amplitudes, in seconds.
+          double   communication = 0 ;
+          /// Number of exchanges of amplitudes.
+          int64_t  nbExchanges = 0 ;
+          /// Number of bytes sent by this rank.
+          int64_t  bytes = 0 ;
+        } ;
+
+        /**
+         * \brief Constructs a distributed state vector of `nbQubits` qubits in
+         *        the all zero state over the ranks of the communicator `comm`.
+         *        Every rank must hold at least 2 local qubits.
+         */
+        DistributedStateVector( const int nbQubits ,
+                                MPI_Comm comm = MPI_COMM_WORLD ) ;
+
+        /// Returns the number of qubits of this distributed state vector.
+        inline int nbQubits() const { return nbQubits_ ; }
+
+        /// Returns the number of global qubits of this state vector.
+        inline int nbGlobalQubits() const { return nbGlobal_ ; }
+
+        /// Returns the number of local qubits of this state vector.
+        inline int nbLocalQubits() const { return nbQubits_ - nbGlobal_ ; }
+
+        /// Returns the rank of this process in the communicator.
+        inline int rank() const { return rank_ ; }
+
+        /// Returns the communicator of this distributed state vector.
+        inline MPI_Comm comm() const { return comm_ ; }
+
+        /// Returns the local vector of this rank, in physical qubit order.
+        inline const std::vector< T >& local() const { return local_ ; }
+
+        /// Returns the physical qubits of the logical qubits.
+        inline const std::vector< int >& permutation() const { return perm_ ; }
+
+        /// Returns the timings of the simulations of this state vector.
+        inline const Timings& timings() const { return timings_ ; }
+
+        /// Resets the timings of the simulations of this state vector.
+        inline void resetTimings() { timings_ = Timings() ; }
+
+        /**
+         * \brief Distributes the vector `vector` of 2^nbQubits amplitudes,
+         *        given on the rank `root`, over all ranks.
+         */
+        void scatter( const std::vector< T >& vector , const int root = 0 ) ;
+
+        /**
+         * \brief Gathers the amplitudes of all ranks in the logical qubit
+         *        order into the vector `vector` on the rank `root`.
+         */
+        void gather( std::vector< T >& vector , const int root = 0 ) ;
+
+        /// Returns the squared 2-norm of this distributed state vector.
+        double norm2() const ;
+
+        /**
+         * \brief Simulates the quantum circuit `circuit` on this distributed
+         *        state vector with the fusion and cache blocking options of
+         *        `options`. The circuit must not be dynamic.
+         */
+        void simulate( const qclab::QCircuit< T >& circuit ,
+                       const sim::Options& options = sim::Options() ) ;
+
+        /**
+         * \brief Applies the schedule `schedule` to this distributed state
+         *        vector, with cache blocking of the local vector on
+         *        `blockQubits` qubits if nonzero.
+         */
+        void apply( const sim::Schedule< T >& schedule ,
+                    const int blockQubits = 0 ) ;
+
+        /// Permutes this distributed state vector to the logical qubit order.
+        void unpermute() ;
+
+      private:
+        /// Returns the bit of the global physical qubit `p` of this rank.
+        inline int rankBit( const int p ) const {
+          return ( rank_ >> ( nbGlobal_ - p - 1 ) ) & 1 ;
+        }
+
+        /**
+         * \brief Interchanges the global physical qubit `a` with the local
+         *        physical qubit `b` by exchanging half of the local vector
+         *        with the partner rank.
+         */
+        void exchange( const int a , const int b ) ;
+
+        /**
+         * \brief Interchanges the global physical qubits `a` and `b` by
+         *        exchanging the local vectors of the ranks for which their
+         *        bits differ.
+         */
+        void exchangeGlobal( const int a , const int b ) ;
+
+        /**
+         * \brief Sends `count` amplitudes of `send` to the rank `partner` and
+         *        receives its amplitudes in `recv`, in place if `send` equals
+         *        `recv`.
+         */
+        void sendrecv( const T* send , T* recv , const int64_t count ,
+                       const int partner ) ;
+
+        /**
+         * \brief Returns the local physical qubit that is not used by the
+         *        item at position `pos` of `schedule` and is used last by the
+         *        following items.
+         */
+        int victim( const sim::Schedule< T >& schedule ,
+                    const size_t pos ) const ;
+
+        /**
+         * \brief Returns the diagonal gate on the local qubits of this rank
+         *        that is equal to the diagonal item `item` with its global
+         *        qubits fixed by the rank, or an empty pointer if `item` is
+         *        not diagonal. Sets `trivial` if the result is the identity.
+         */
+        std::unique_ptr< qgates::DiagonalGate< T > > localDiagonal(
+                                const typename sim::Schedule< T >::Item& item ,
+                                bool& trivial ) const ;
+
+        /// Number of qubits.
+        int                 nbQubits_ ;
+        /// Number of global qubits.
+        int                 nbGlobal_ ;
+        /// Communicator.
+        MPI_Comm            comm_ ;
+        /// Rank of this process.
+        int                 rank_ ;
+        /// Physical qubits of the logical qubits.
+        std::vector< int >  perm_ ;
+        /// Logical qubits of the physical qubits.
+        std::vector< int >  logical_ ;
+        /// Local vector of this rank.
+        std::vector< T >    local_ ;
+        /// Buffers of the exchanges.
+        std::vector< T >    send_ , recv_ ;
+        /// Timings of the simulations.
+        Timings             timings_ ;
+
+    } ; // class DistributedStateVector
+
+  } // namespace mpi
+
+} // namespace qclab
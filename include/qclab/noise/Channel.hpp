@@ -0,0 +1,293 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/QGate1.hpp"
+#include "qclab/parallel.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace qclab {
+
+  /**
+   * Namespace qclab::noise.
+   *
+   * Noisy circuits are simulated with quantum trajectories: every noise
+   * channel applies one of its Kraus operators, drawn with the next random
+   * number of the classical register, such that the average over many
+   * trajectories equals the density matrix of the noisy circuit.
+   */
+  namespace noise {
+
+    /**
+     * \brief Applies one Kraus operator of `kraus` to the qubit `qubit` of the
+     *        vector `vector` of `nbQubits` qubits, drawn with the next random
+     *        number of the classical register `creg`, renormalizes the vector,
+     *        and returns the index of the drawn Kraus operator.
+     *
+     * If `probabilities` is empty, the probabilities of the Kraus operators
+     * follow from the reduced density matrix of the qubit, which is summed
+     * over a fixed number of chunks in one parallel pass. Otherwise, the
+     * channel is a mixture of the unitaries `kraus` with the given
+     * probabilities, and the vector is not touched if the drawn unitary is
+     * the identity. Can be called by all threads of a persistent team.
+     */
+    template <typename T>
+    int applyKraus( const int nbQubits , const int qubit ,
+                    std::vector< T >& vector , qclab::ClassicalRegister& creg ,
+                    const std::vector< qclab::dense::SmallMatrix< T , 2 > >&
+                      kraus ,
+                    const std::vector< double >& probabilities ) ;
+
+    /**
+     * \class Channel
+     * \brief 1-qubit noise channel defined by its Kraus operators
+     *        \f$K_k\f$, with \f$\sum_k K_k^\dagger K_k = I\f$.
+     *
+     * If every \f$K_k^\dagger K_k\f$ is a multiple \f$p_k I\f$ of the identity,
+     * the channel is a mixture of unitaries with probabilities \f$p_k\f$ that
+     * do not depend on the state, and a trajectory only touches the vector if
+     * it draws a unitary different from the identity.
+     */
+    template <typename T>
+    class Channel : public qgates::QGate1< T >
+    {
+
+      public:
+        /// Kraus operator type of this channel.
+        using kraus_type = qclab::dense::SmallMatrix< T , 2 > ;
+
+        /**
+         * \brief Constructs a noise channel on the qubit `qubit` with the
+         *        Kraus operators `kraus`.
+         */
+        Channel( const int qubit , const std::vector< kraus_type >& kraus )
+        : qgates::QGate1< T >( qubit )
+        , kraus_( kraus )
+        {
+          assert( !kraus.empty() ) ;
+          mixture() ;
+        } // Channel(qubit,kraus)
+
+        // nbQubits
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override {
+          throw std::logic_error( "a noise channel is not unitary" ) ;
+        }
+
+        // dynamic
+        inline bool dynamic() const override { return true ; }
+
+        // apply
+        using qgates::QGate1< T >::apply ;
+
+        // apply
+        void apply( Op , const int , std::vector< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a noise channel requires a classical "
+                                  "register" ) ;
+        }
+
+        // apply
+        void apply( const int nbQubits , std::vector< T >& vector ,
+                    qclab::ClassicalRegister& creg ,
+                    const int offset = 0 ) const override {
+          applyKraus( nbQubits , this->qubit_ + offset , vector , creg ,
+                      probabilities_.empty() ? kraus_ : unitaries_ ,
+                      probabilities_ ) ;
+        }
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op , const int , T* ,
+                           const int = 0 ) const override {
+          throw std::logic_error( "a noise channel requires a classical "
+                                  "register" ) ;
+        }
+      #endif
+
+        // apply
+        void apply( Side , Op , const int ,
+                    qclab::dense::SquareMatrix< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a noise channel is not unitary" ) ;
+        }
+
+        // print
+        void print() const override {
+          std::cout << "Noise channel on qubit " << this->qubit_ << " with "
+                    << kraus_.size() << " Kraus operators" << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // noise channels are not supported in QASM
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          using C = Channel< T > ;
+          if ( const C* p = dynamic_cast< const C* >( &other ) ) {
+            return ( p->qubit() == this->qubit_ ) && ( p->kraus() == kraus_ ) ;
+          }
+          return false ;
+        }
+
+        /// Returns the Kraus operators of this channel.
+        inline const std::vector< kraus_type >& kraus() const {
+          return kraus_ ;
+        }
+
+        /// Checks if this channel is a mixture of unitaries.
+        inline bool mixedUnitary() const { return !probabilities_.empty() ; }
+
+        /**
+         * \brief Returns the probabilities of the unitaries of this channel,
+         *        or an empty vector if it is not a mixture of unitaries.
+         */
+        inline const std::vector< double >& probabilities() const {
+          return probabilities_ ;
+        }
+
+      protected:
+        /**
+         * \brief Sets the probabilities and unitaries of this channel if it is
+         *        a mixture of unitaries.
+         */
+        void mixture() {
+          using R = qclab::real_t< T > ;
+          const double tol = 100 * std::numeric_limits< R >::epsilon() ;
+          std::vector< double > probabilities ;
+          std::vector< kraus_type > unitaries ;
+          for ( const auto& K : kraus_ ) {
+            // K^H K
+            const double e00 = std::norm( K(0,0) ) + std::norm( K(1,0) ) ;
+            const double e11 = std::norm( K(0,1) ) + std::norm( K(1,1) ) ;
+            const double e01 = std::abs( std::conj( K(0,0) ) * K(0,1) +
+                                         std::conj( K(1,0) ) * K(1,1) ) ;
+            if ( ( std::abs( e00 - e11 ) > tol ) || ( e01 > tol ) ) return ;
+            probabilities.push_back( e00 ) ;
+            const R scale = ( e00 > 0 ) ? 1 / std::sqrt( e00 ) : 0 ;
+            unitaries.push_back( kraus_type( scale * K(0,0) , scale * K(0,1) ,
+                                             scale * K(1,0) ,
+                                             scale * K(1,1) ) ) ;
+          }
+          probabilities_ = std::move( probabilities ) ;
+          unitaries_ = std::move( unitaries ) ;
+        }
+
+        /// Kraus operators of this channel.
+        std::vector< kraus_type >  kraus_ ;
+        /// Probabilities of the unitaries of a mixed unitary channel.
+        std::vector< double >      probabilities_ ;
+        /// Normalized Kraus operators of a mixed unitary channel.
+        std::vector< kraus_type >  unitaries_ ;
+
+    } ; // class Channel
+
+
+    /**
+     * \brief Returns the depolarizing channel on the qubit `qubit` with error
+     *        probability `p`, i.e., the qubit is left untouched with
+     *        probability 1 - `p` and hit by X, Y, or Z with probability
+     *        `p` / 3 each. For real value types, Y is replaced by iY, which
+     *        only differs by a global phase.
+     */
+    template <typename T>
+    Channel< T > depolarizing( const int qubit , const double p ) {
+      assert( p >= 0 && p <= 1 ) ;
+      using R = qclab::real_t< T > ;
+      const R a = std::sqrt( 1 - p ) ;
+      const R b = std::sqrt( p / 3 ) ;
+      T y = b ;
+      if constexpr ( qclab::is_complex_v< T > ) y = T( 0 , b ) ;
+      using K = typename Channel< T >::kraus_type ;
+      return Channel< T >( qubit , { K( a , 0 , 0 , a ) ,
+                                     K( 0 , b , b , 0 ) ,
+                                     K( 0 , -y , y , 0 ) ,
+                                     K( b , 0 , 0 , -b ) } ) ;
+    }
+
+    /**
+     * \brief Returns the bit-flip channel on the qubit `qubit`, i.e., X is
+     *        applied with probability `p`.
+     */
+    template <typename T>
+    Channel< T > bitFlip( const int qubit , const double p ) {
+      assert( p >= 0 && p <= 1 ) ;
+      using R = qclab::real_t< T > ;
+      const R a = std::sqrt( 1 - p ) ;
+      const R b = std::sqrt( p ) ;
+      using K = typename Channel< T >::kraus_type ;
+      return Channel< T >( qubit , { K( a , 0 , 0 , a ) ,
+                                     K( 0 , b , b , 0 ) } ) ;
+    }
+
+    /**
+     * \brief Returns the phase-flip channel on the qubit `qubit`, i.e., Z is
+     *        applied with probability `p`.
+     */
+    template <typename T>
+    Channel< T > phaseFlip( const int qubit , const double p ) {
+      assert( p >= 0 && p <= 1 ) ;
+      using R = qclab::real_t< T > ;
+      const R a = std::sqrt( 1 - p ) ;
+      const R b = std::sqrt( p ) ;
+      using K = typename Channel< T >::kraus_type ;
+      return Channel< T >( qubit , { K( a , 0 , 0 ,  a ) ,
+                                     K( b , 0 , 0 , -b ) } ) ;
+    }
+
+    /**
+     * \brief Returns the amplitude damping channel on the qubit `qubit` with
+     *        decay probability `gamma` from 1 to 0.
+     */
+    template <typename T>
+    Channel< T > amplitudeDamping( const int qubit , const double gamma ) {
+      assert( gamma >= 0 && gamma <= 1 ) ;
+      using R = qclab::real_t< T > ;
+      const R a = std::sqrt( 1 - gamma ) ;
+      const R b = std::sqrt( gamma ) ;
+      using K = typename Channel< T >::kraus_type ;
+      return Channel< T >( qubit , { K( 1 , 0 , 0 , a ) ,
+                                     K( 0 , b , 0 , 0 ) } ) ;
+    }
+
+    /**
+     * \brief Returns the phase damping channel on the qubit `qubit` with
+     *        damping probability `lambda`.
+     */
+    template <typename T>
+    Channel< T > phaseDamping( const int qubit , const double lambda ) {
+      assert( lambda >= 0 && lambda <= 1 ) ;
+      using R = qclab::real_t< T > ;
+      const R a = std::sqrt( 1 - lambda ) ;
+      const R b = std::sqrt( lambda ) ;
+      using K = typename Channel< T >::kraus_type ;
+      return Channel< T >( qubit , { K( 1 , 0 , 0 , a ) ,
+                                     K( 0 , 0 , 0 , b ) } ) ;
+    }
+
+  } // namespace noise
+
+} // namespace qclab
@@ -0,0 +1,156 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/noise/Channel.hpp"
+#include "qclab/noise/NoisyMeasurement.hpp"
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace qclab {
+
+  namespace noise {
+
+    /**
+     * \class NoiseModel
+     * \brief Noise model that attaches noise channels to the gates of a
+     *        quantum circuit, and readout errors to its measurements.
+     *
+     * A channel is attached either to all gates, to the gates of a given
+     * type, or to the gates acting on a given qubit, and is applied after
+     * every matching gate on each of its qubits, or on the given qubit only.
+     * The qubit of the channel itself is ignored. Channels are only attached
+     * to unitary gates, i.e., not to measurements, resets, or classically
+     * conditioned gates.
+     */
+    template <typename T>
+    class NoiseModel
+    {
+
+      public:
+        /// Quantum object type of this noise model.
+        using object_type  = qclab::QObject< T > ;
+        /// Noise channel type of this noise model.
+        using channel_type = Channel< T > ;
+
+        /// Attaches the noise channel `channel` to all gates.
+        void add( const channel_type& channel ) {
+          rules_.push_back( { nullptr , -1 , channel } ) ;
+        }
+
+        /// Attaches the noise channel `channel` to all gates of type `G`.
+        template <typename G>
+        void add( const channel_type& channel ) {
+          rules_.push_back( { &matches< G > , -1 , channel } ) ;
+        }
+
+        /**
+         * \brief Attaches the noise channel `channel` to the qubit `qubit` of
+         *        all gates acting on `qubit`.
+         */
+        void add( const int qubit , const channel_type& channel ) {
+          assert( qubit >= 0 ) ;
+          rules_.push_back( { nullptr , qubit , channel } ) ;
+        }
+
+        /**
+         * \brief Sets the readout error of all measurements to the
+         *        probabilities `p01` and `p10`, see NoisyMeasurement.
+         */
+        void setReadoutError( const double p01 , const double p10 ) {
+          readoutError_ = { p01 , p10 } ;
+        }
+
+        /**
+         * \brief Sets the readout error of the measurements of the qubit
+         *        `qubit` to the probabilities `p01` and `p10`.
+         */
+        void setReadoutError( const int qubit , const double p01 ,
+                              const double p10 ) {
+          assert( qubit >= 0 ) ;
+          readoutErrors_[ qubit ] = { p01 , p10 } ;
+        }
+
+        /// Returns the number of noise channels of this noise model.
+        inline int nbChannels() const { return rules_.size() ; }
+
+        /**
+         * \brief Flattens the quantum circuit `circuit` into the schedule
+         *        `schedule`, with the noise channels of this noise model
+         *        inserted after the gates and the measurements replaced by
+         *        noisy measurements. The circuit must outlive the schedule.
+         */
+        void schedule( const qclab::QCircuit< T >& circuit ,
+                       sim::Schedule< T >& schedule ) const {
+          sim::Schedule< T > flat ;
+          circuit.flatten( flat ) ;
+          for ( const auto& item : flat ) {
+            const object_type* object = item.object ;
+            using M = qgates::Measurement< T > ;
+            const M* measurement = dynamic_cast< const M* >( object ) ;
+            if ( measurement &&
+                 !dynamic_cast< const NoisyMeasurement< T >* >( object ) ) {
+              const int qubit = measurement->qubit() + item.offset ;
+              const auto error = readoutError( qubit ) ;
+              if ( ( error.first > 0 ) || ( error.second > 0 ) ) {
+                schedule.push_back( std::make_unique< NoisyMeasurement< T > >(
+                                      qubit , measurement->bit() ,
+                                      error.first , error.second ) ) ;
+                continue ;
+              }
+            }
+            schedule.push_back( object , item.offset ) ;
+            if ( object->dynamic() ) continue ;
+            const auto qubits = object->qubits() ;
+            for ( const auto& rule : rules_ ) {
+              if ( rule.match && !rule.match( object ) ) continue ;
+              for ( int qubit : qubits ) {
+                qubit += item.offset ;
+                if ( ( rule.qubit >= 0 ) && ( rule.qubit != qubit ) ) continue ;
+                auto channel =
+                  std::make_unique< channel_type >( rule.channel ) ;
+                channel->setQubit( qubit ) ;
+                schedule.push_back( std::move( channel ) ) ;
+              }
+            }
+          }
+        }
+
+      private:
+        /// Noise channel attached to the matching gates.
+        struct Rule {
+          /// Checks if a gate matches, or nullptr for all gates.
+          bool (*match)( const object_type* ) ;
+          /// Qubit of the channel, or -1 for all qubits of the gate.
+          int           qubit ;
+          /// Noise channel of the rule.
+          channel_type  channel ;
+        } ;
+
+        /// Checks if `object` is of type `G`.
+        template <typename G>
+        static bool matches( const object_type* object ) {
+          return dynamic_cast< const G* >( object ) != nullptr ;
+        }
+
+        /// Returns the readout error of the measurements of qubit `qubit`.
+        std::pair< double , double > readoutError( const int qubit ) const {
+          const auto it = readoutErrors_.find( qubit ) ;
+          return ( it != readoutErrors_.end() ) ? it->second : readoutError_ ;
+        }
+
+        /// Noise channels of this noise model.
+        std::vector< Rule >                              rules_ ;
+        /// Readout error of all measurements.
+        std::pair< double , double >                     readoutError_ = {} ;
+        /// Readout errors of the measurements of given qubits.
+        std::map< int , std::pair< double , double > >   readoutErrors_ ;
+
+    } ; // class NoiseModel
+
+  } // namespace noise
+
+} // namespace qclab
@@ -0,0 +1,99 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/Measurement.hpp"
+
+namespace qclab {
+
+  namespace noise {
+
+    /**
+     * \class NoisyMeasurement
+     * \brief Measurement of a qubit in the computational basis with a readout
+     *        error, i.e., the outcome stored in the classical register is
+     *        flipped from 0 to 1 with probability `p01` and from 1 to 0 with
+     *        probability `p10`.
+     *
+     * The state collapses to the true outcome, and the readout error draws
+     * its own random number of the classical register.
+     */
+    template <typename T>
+    class NoisyMeasurement : public qgates::Measurement< T >
+    {
+
+      public:
+        /**
+         * \brief Constructs a noisy measurement of the qubit `qubit` with
+         *        outcome stored in the classical bit `bit` and readout error
+         *        probabilities `p01` and `p10`.
+         */
+        NoisyMeasurement( const int qubit , const int bit , const double p01 ,
+                          const double p10 )
+        : qgates::Measurement< T >( qubit , bit )
+        , p01_( p01 )
+        , p10_( p10 )
+        {
+          assert( p01 >= 0 && p01 <= 1 ) ;
+          assert( p10 >= 0 && p10 <= 1 ) ;
+        } // NoisyMeasurement(qubit,bit,p01,p10)
+
+        // apply
+        using qgates::Measurement< T >::apply ;
+
+        // apply
+        void apply( const int nbQubits , std::vector< T >& vector ,
+                    qclab::ClassicalRegister& creg ,
+                    const int offset = 0 ) const override {
+          int outcome = qgates::measure( nbQubits , this->qubit_ + offset ,
+                                         vector , creg ) ;
+          const double u = creg.next() ;
+          parallel::barrier() ;
+          if ( u < ( outcome ? p10_ : p01_ ) ) outcome = 1 - outcome ;
+          parallel::forEach( 1 , [&] ( const int ) {
+            creg.set( this->bit_ , outcome ) ;
+            creg.advance() ;
+          } ) ;
+        }
+
+        // print
+        void print() const override {
+          std::cout << "Noisy measurement of qubit " << this->qubit_
+                    << " to bit " << this->bit_ << " with readout errors "
+                    << p01_ << " and " << p10_ << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // readout errors are not supported in QASM
+        }
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          using M = NoisyMeasurement< T > ;
+          if ( const M* p = dynamic_cast< const M* >( &other ) ) {
+            return ( p->qubit() == this->qubit_ ) &&
+                   ( p->bit() == this->bit_ ) && ( p->p01() == p01_ ) &&
+                   ( p->p10() == p10_ ) ;
+          }
+          return false ;
+        }
+
+        /// Returns the probability that outcome 0 is read as 1.
+        inline double p01() const { return p01_ ; }
+
+        /// Returns the probability that outcome 1 is read as 0.
+        inline double p10() const { return p10_ ; }
+
+      protected:
+        /// Probability that outcome 0 is read as 1.
+        double  p01_ ;
+        /// Probability that outcome 1 is read as 0.
+        double  p10_ ;
+
+    } ; // class NoisyMeasurement
+
+  } // namespace noise
+
+} // namespace qclab
@@ -0,0 +1,325 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/noise/NoiseModel.hpp"
+#include "qclab/sample.hpp"
+#include "qclab/random.hpp"
+#include "qclab/parallel.hpp"
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace qclab {
+
+  namespace noise {
+
+    /**
+     * \class Trajectories
+     * \brief Quantum-trajectory simulator of a quantum circuit with a noise
+     *        model.
+     *
+     * Every trajectory simulates the circuit with the noise channels of the
+     * noise model, each of which applies a single Kraus operator drawn with
+     * the classical register of the trajectory. The register of trajectory t
+     * is seeded from the seed of the run and t, such that the results only
+     * depend on the seed and not on the number of threads. As for Sweep,
+     * small states are simulated concurrently, one trajectory per thread,
+     * while states large enough to keep all threads busy are simulated one
+     * after the other with all threads. Every thread reuses a single work
+     * vector, and the results are aggregated on the fly, such that the memory
+     * use does not grow with the number of trajectories.
+     *
+     * The circuit must outlive the trajectory simulator.
+     */
+    template <typename T>
+    class Trajectories
+    {
+
+      public:
+        /// Real value type of this trajectory simulator.
+        using real_type = qclab::real_t< T > ;
+
+        /**
+         * \brief Constructs a trajectory simulator for the quantum circuit
+         *        `circuit` with the noise model `model`.
+         */
+        Trajectories( const qclab::QCircuit< T >& circuit ,
+                      const NoiseModel< T >& model )
+        : nbQubits_( circuit.nbQubits() )
+        {
+          model.schedule( circuit , schedule_ ) ;
+        } // Trajectories(circuit,model)
+
+        /// Returns the number of qubits of this trajectory simulator.
+        inline int nbQubits() const { return nbQubits_ ; }
+
+        /// Returns the noisy schedule of this trajectory simulator.
+        inline const sim::Schedule< T >& schedule() const { return schedule_ ; }
+
+        /**
+         * \brief Simulates a single trajectory for the given vector `vector`
+         *        with the classical register `creg`.
+         */
+        void simulate( std::vector< T >& vector ,
+                       qclab::ClassicalRegister& creg ) const {
+          assert( vector.size() == int64_t(1) << nbQubits_ ) ;
+          parallel::run( int64_t(1) << nbQubits_ , [&] () {
+            schedule_.apply( nbQubits_ , vector , creg ) ;
+          } ) ;
+        }
+
+        /**
+         * \brief Simulates `nbTrajectories` trajectories for the initial
+         *        vector `initial` with seed `seed`, and calls
+         *        `f( trajectory , vector , creg )` with the final vector
+         *        `vector` and classical register `creg` of every trajectory.
+         *        Calls of `f` for different trajectories may run concurrently.
+         */
+        template <typename F>
+        void run( const std::vector< T >& initial ,
+                  const int64_t nbTrajectories , const uint64_t seed ,
+                  F&& f ) const {
+          runBlocks( initial , nbTrajectories , seed , 1 , f ) ;
+        }
+
+        /**
+         * \brief Returns the average expectation value of the observable
+         *        `observable`, e.g., a PauliSum, over `nbTrajectories`
+         *        trajectories for the initial vector `initial` with seed
+         *        `seed`.
+         */
+        template <typename O>
+        real_type expectation( const std::vector< T >& initial ,
+                               const O& observable ,
+                               const int64_t nbTrajectories ,
+                               const uint64_t seed = 0 ) const {
+          real_type error ;
+          return expectation( initial , observable , nbTrajectories , seed ,
+                              error ) ;
+        }
+
+        /**
+         * \brief Returns the average expectation value of the observable
+         *        `observable` as above, and sets `error` to its standard
+         *        error, i.e., the standard deviation of the expectation values
+         *        of the trajectories divided by the square root of
+         *        `nbTrajectories`.
+         *
+         * The trajectories are split in at most 256 blocks of consecutive
+         * trajectories. Every block is simulated by a single thread, which
+         * accumulates the mean and the sum of squared deviations of its
+         * expectation values with Welford's update, and the blocks are merged
+         * in the order of the blocks. Hence, the result only depends on the
+         * seed and not on the number of threads.
+         */
+        template <typename O>
+        real_type expectation( const std::vector< T >& initial ,
+                               const O& observable ,
+                               const int64_t nbTrajectories ,
+                               const uint64_t seed , real_type& error ) const {
+          error = 0 ;
+          if ( nbTrajectories <= 0 ) return 0 ;
+          const int64_t maxBlocks = 256 ;
+          const int64_t blockSize = ( nbTrajectories + maxBlocks - 1 ) /
+                                    maxBlocks ;
+          std::vector< Moments > blocks( ( nbTrajectories + blockSize - 1 ) /
+                                         blockSize ) ;
+          runBlocks( initial , nbTrajectories , seed , blockSize ,
+                     [&] ( const int64_t traj , const std::vector< T >& v ,
+                           const qclab::ClassicalRegister& ) {
+            blocks[ traj / blockSize ].add( observable.expectation( v ) ) ;
+          } ) ;
+          Moments total ;
+          for ( const auto& block : blocks ) total.merge( block ) ;
+          if ( nbTrajectories > 1 ) {
+            const double var = total.m2 / ( nbTrajectories - 1 ) ;
+            error = std::sqrt( var / nbTrajectories ) ;
+          }
+          return total.mean ;
+        }
+
+        /**
+         * \brief Returns the counts of the values of the classical bits
+         *        `bits`, where `bits[0]` is the least significant bit, at the
+         *        end of `nbTrajectories` trajectories for the initial vector
+         *        `initial` with seed `seed`.
+         */
+        qclab::Counts counts( const std::vector< T >& initial ,
+                              const int64_t nbTrajectories ,
+                              const std::vector< int >& bits ,
+                              const uint64_t seed = 0 ) const {
+          return aggregate( initial , nbTrajectories , seed ,
+                            [&] ( const int64_t ,
+                                  const std::vector< T >& ,
+                                  const qclab::ClassicalRegister& creg ,
+                                  std::map< uint64_t , int64_t >& counts ) {
+            counts[ creg.value( bits ) ]++ ;
+          } ) ;
+        }
+
+        /**
+         * \brief Returns the counts of `nbShots` measurements of the qubits
+         *        `qubits` of the final vector of each of `nbTrajectories`
+         *        trajectories for the initial vector `initial` with seed
+         *        `seed`, see qclab::sample.
+         */
+        qclab::Counts sample( const std::vector< T >& initial ,
+                              const int64_t nbTrajectories ,
+                              const int64_t nbShots ,
+                              const std::vector< int >& qubits = {} ,
+                              const uint64_t seed = 0 ) const {
+          const qclab::Random random( seed ) ;
+          return aggregate( initial , nbTrajectories , seed ,
+                            [&] ( const int64_t traj ,
+                                  const std::vector< T >& v ,
+                                  const qclab::ClassicalRegister& ,
+                                  std::map< uint64_t , int64_t >& counts ) {
+            const auto shots = qclab::sample( v , nbShots , qubits ,
+                                              random( 2 * traj + 1 ) ) ;
+            for ( const auto& shot : shots ) {
+              counts[ shot.first ] += shot.second ;
+            }
+          } ) ;
+        }
+
+      private:
+        /**
+         * \class Moments
+         * \brief Mean and sum of squared deviations from the mean of a
+         *        sequence of values, padded to a cache line.
+         */
+        struct alignas( 64 ) Moments {
+          int64_t  count = 0 ;  ///< Number of values.
+          double   mean = 0 ;   ///< Mean of the values.
+          double   m2 = 0 ;     ///< Sum of squared deviations from the mean.
+
+          /// Adds the value `value` with Welford's update.
+          void add( const double value ) {
+            count++ ;
+            const double delta = value - mean ;
+            mean += delta / count ;
+            m2 += delta * ( value - mean ) ;
+          }
+
+          /// Appends the values of the moments `other`.
+          void merge( const Moments& other ) {
+            if ( other.count == 0 ) return ;
+            const int64_t n = count + other.count ;
+            const double delta = other.mean - mean ;
+            mean += delta * other.count / n ;
+            m2 += other.m2 + delta * delta * count * other.count / n ;
+            count = n ;
+          }
+        } ; // struct Moments
+
+        /**
+         * \brief Runs `nbTrajectories` trajectories as in run, where every
+         *        block of `blockSize` consecutive trajectories is simulated
+         *        by a single thread in ascending order.
+         */
+        template <typename F>
+        void runBlocks( const std::vector< T >& initial ,
+                        const int64_t nbTrajectories , const uint64_t seed ,
+                        const int64_t blockSize , F&& f ) const {
+          const int64_t size = int64_t(1) << nbQubits_ ;
+          assert( initial.size() == size ) ;
+          if ( nbTrajectories <= 0 ) return ;
+          const qclab::Random random( seed ) ;
+          // parallel within a trajectory
+        #ifdef _OPENMP
+          const int maxThreads = omp_in_parallel() ? 1 : omp_get_max_threads() ;
+        #else
+          const int maxThreads = 1 ;
+        #endif
+          const int t = std::min< int64_t >( maxThreads , nbTrajectories ) ;
+          if ( ( t == 1 ) || ( parallel::nbThreads( size ) == maxThreads ) ) {
+            std::vector< T > v( size ) ;
+            for ( int64_t traj = 0; traj < nbTrajectories; traj++ ) {
+              qclab::ClassicalRegister creg( 0 , random( 2 * traj ) ) ;
+              parallel::run( size , [&] () {
+                simulateTrajectory( initial , v , creg ) ;
+              } ) ;
+              f( traj , static_cast< const std::vector< T >& >( v ) ,
+                 static_cast< const qclab::ClassicalRegister& >( creg ) ) ;
+            }
+            return ;
+          }
+          // parallel over the trajectories
+        #ifdef _OPENMP
+          #pragma omp parallel num_threads( t )
+          {
+            std::vector< T > v( size ) ;
+            #pragma omp for schedule( dynamic , blockSize )
+            for ( int64_t traj = 0; traj < nbTrajectories; traj++ ) {
+              qclab::ClassicalRegister creg( 0 , random( 2 * traj ) ) ;
+              simulateTrajectory( initial , v , creg ) ;
+              f( traj , static_cast< const std::vector< T >& >( v ) ,
+                 static_cast< const qclab::ClassicalRegister& >( creg ) ) ;
+            }
+          }
+        #endif
+        }
+
+        /**
+         * \brief Simulates the noisy schedule starting from the vector
+         *        `initial` into `vector` with the classical register `creg`.
+         */
+        void simulateTrajectory( const std::vector< T >& initial ,
+                                 std::vector< T >& vector ,
+                                 qclab::ClassicalRegister& creg ) const {
+          parallel::forRange( initial.size() , [&] ( const int64_t begin ,
+                                                     const int64_t end ) {
+            std::copy( initial.begin() + begin , initial.begin() + end ,
+                       vector.begin() + begin ) ;
+          } ) ;
+          schedule_.apply( nbQubits_ , vector , creg ) ;
+        }
+
+        /**
+         * \brief Runs `nbTrajectories` trajectories, see run, and returns the
+         *        counts accumulated by `f( trajectory , vector , creg ,
+         *        counts )` in a histogram per thread.
+         */
+        template <typename F>
+        qclab::Counts aggregate( const std::vector< T >& initial ,
+                                 const int64_t nbTrajectories ,
+                                 const uint64_t seed , F&& f ) const {
+        #ifdef _OPENMP
+          const bool nested = omp_in_parallel() ;
+          const int nbHistograms = nested ? 1 : omp_get_max_threads() ;
+        #else
+          const int nbHistograms = 1 ;
+        #endif
+          std::vector< std::map< uint64_t , int64_t > >
+            histograms( nbHistograms ) ;
+          run( initial , nbTrajectories , seed , [&] ( const int64_t traj ,
+                 const std::vector< T >& v ,
+                 const qclab::ClassicalRegister& creg ) {
+          #ifdef _OPENMP
+            auto& histogram =
+              histograms[ nested ? 0 : omp_get_thread_num() ] ;
+          #else
+            auto& histogram = histograms[0] ;
+          #endif
+            f( traj , v , creg , histogram ) ;
+          } ) ;
+          for ( int h = 1; h < nbHistograms; h++ ) {
+            for ( const auto& count : histograms[h] ) {
+              histograms[0][ count.first ] += count.second ;
+            }
+          }
+          return qclab::Counts( histograms[0].begin() , histograms[0].end() ) ;
+        }
+
+        /// Number of qubits of this trajectory simulator.
+        int                 nbQubits_ ;
+        /// Flattened circuit with the noise channels.
+        sim::Schedule< T >  schedule_ ;
+
+    } ; // class Trajectories
+
+  } // namespace noise
+
+} // namespace qclab
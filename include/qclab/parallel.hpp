@@ -0,0 +1,188 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace qclab {
+
+  /**
+   * Namespace qclab::parallel.
+   *
+   * The loops of the vector kernels are distributed over the OpenMP threads
+   * with forRange and forEach. The number of threads of a loop is chosen from
+   * its number of iterations, such that small loops run serially instead of
+   * paying for a parallel region. A simulation runs all its gates inside a
+   * single parallel region, see run, in which every loop is shared among the
+   * threads of this persistent team.
+   */
+  namespace parallel {
+
+    /**
+     * \brief Returns the minimum number of loop iterations per thread, i.e.,
+     *        loops with less than 2 * `threshold()` iterations run serially.
+     *        Defaults to 4096, unless overridden with the environment
+     *        variable QCLAB_OMP_THRESHOLD.
+     */
+    int64_t threshold() ;
+
+    /// Sets the minimum number of loop iterations per thread to `threshold`.
+    void setThreshold( const int64_t threshold ) ;
+
+    /**
+     * \brief Returns the number of threads used for `work` loop iterations,
+     *        i.e., `work / threshold()` clamped to the range from 1 to the
+     *        maximum number of OpenMP threads.
+     */
+    int nbThreads( const int64_t work ) ;
+
+    /// Checks if the calling thread is a member of a persistent team.
+    bool inTeam() ;
+
+    /**
+     * \class Team
+     * \brief Marks the calling thread as a member of a persistent team, or
+     *        not if `member` is false, for the lifetime of this object.
+     */
+    class Team
+    {
+
+      public:
+        /// Marks the calling thread as a member of a persistent team or not.
+        explicit Team( const bool member = true ) ;
+
+        /// Restores the previous membership of the calling thread.
+        ~Team() ;
+
+        Team( const Team& ) = delete ;
+        Team& operator=( const Team& ) = delete ;
+
+      private:
+        /// Previous membership of the calling thread.
+        bool  previous_ ;
+
+    } ; // class Team
+
+    /**
+     * \brief Runs `f()` on a persistent team of `nbThreads( work )` threads,
+     *        where `work` is the number of iterations of the largest loop of
+     *        `f`.
+     *
+     * Every thread of the team calls `f()` and the loops of `f` share their
+     * iterations among the team, with a barrier at the end of every loop.
+     * Hence, all threads must run the same sequence of loops and must only
+     * write to shared data inside these loops. If a single thread suffices,
+     * or if the calling thread is already inside a parallel region, `f()` is
+     * called by the calling thread only.
+     */
+    template <typename F>
+    void run( const int64_t work , F&& f ) {
+    #ifdef _OPENMP
+      const int t = nbThreads( work ) ;
+      if ( ( t > 1 ) && !omp_in_parallel() ) {
+        #pragma omp parallel num_threads( t )
+        {
+          Team team ;
+          f() ;
+        }
+        return ;
+      }
+    #endif
+      f() ;
+    }
+
+    /**
+     * \brief Calls `f( begin , end )` for contiguous ranges [`begin`, `end`)
+     *        that partition [0, `n`), one range per thread.
+     *
+     * Every iteration counts as `weight` iterations for the number of
+     * threads. Inside a persistent team, the ranges are distributed over the
+     * first threads of the team, followed by a barrier. Otherwise, a parallel
+     * region is only opened if more than one thread is used.
+     */
+    template <typename F>
+    void forRange( const int64_t n , F&& f , const int64_t weight = 1 ) {
+    #ifdef _OPENMP
+      if ( inTeam() ) {
+        const int t = std::min( nbThreads( n * weight ) ,
+                                omp_get_num_threads() ) ;
+        const int id = omp_get_thread_num() ;
+        if ( id < t ) {
+          Team serial( false ) ;
+          f( n * id / t , n * ( id + 1 ) / t ) ;
+        }
+        #pragma omp barrier
+        return ;
+      }
+      const int t = omp_in_parallel() ? 1 : nbThreads( n * weight ) ;
+      if ( t > 1 ) {
+        #pragma omp parallel num_threads( t )
+        {
+          const int id = omp_get_thread_num() ;
+          const int nt = omp_get_num_threads() ;
+          f( n * id / nt , n * ( id + 1 ) / nt ) ;
+        }
+        return ;
+      }
+    #endif
+      f( int64_t(0) , n ) ;
+    }
+
+    /**
+     * \brief Waits for all threads of the persistent team of the calling
+     *        thread, e.g., before a shared value that all threads have read is
+     *        overwritten. Does nothing outside a persistent team.
+     */
+    inline void barrier() {
+    #ifdef _OPENMP
+      if ( inTeam() ) {
+        #pragma omp barrier
+      }
+    #endif
+    }
+
+    /**
+     * \brief Calls `f()` on behalf of the persistent team of the calling
+     *        thread.
+     *
+     * If `shared` is true, every thread of the team calls `f()`, whose loops
+     * must be shared with forRange or forEach. Otherwise, `f()` is called by
+     * a single thread that is not a team member, between barriers, such that
+     * code with plain loops or its own parallel regions runs exactly once.
+     * Outside a persistent team, `f()` is called by the calling thread.
+     */
+    template <typename F>
+    void call( const bool shared , F&& f ) {
+    #ifdef _OPENMP
+      if ( !shared && inTeam() ) {
+        #pragma omp barrier
+        #pragma omp single
+        {
+          Team serial( false ) ;
+          f() ;
+        }
+        return ;
+      }
+    #endif
+      f() ;
+    }
+
+    /**
+     * \brief Calls `f( k )` for k = 0, ..., `n` - 1, distributed over the
+     *        threads as in forRange.
+     */
+    template <typename I, typename F>
+    void forEach( const I n , F&& f , const int64_t weight = 1 ) {
+      forRange( int64_t( n ) , [&f] ( const int64_t begin ,
+                                      const int64_t end ) {
+        for ( I k = begin; k < I( end ); k++ ) f( k ) ;
+      } , weight ) ;
+    }
+
+  } // namespace parallel
+
+} // namespace qclab
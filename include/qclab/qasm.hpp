@@ -3,6 +3,8 @@
 #pragma once
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 namespace qclab {
 
@@ -34,6 +36,17 @@ namespace qclab {
     return stream.str() ;
   }
 
+  /// Returns a qasm string for a gate on the given qubits `qubits`.
+  inline auto qasmN( const char type[] , const std::vector< int >& qubits ) {
+    std::stringstream stream ;
+    stream << type ;
+    for ( int i = 0; i < qubits.size(); i++ ) {
+      stream << ( ( i == 0 ) ? " q[" : ", q[" ) << qubits[i] << "]" ;
+    }
+    stream << ";\n" ;
+    return stream.str() ;
+  }
+
   /// Returns a qasm string for a 1 qubit gate with angle `angle`.
   template <typename T>
   inline auto qasm1( const char type[] , const int qubit , const T angle ) {
@@ -216,5 +229,32 @@ namespace qclab {
     return qasm2( "iswap" , qubit0 , qubit1 ) ;
   }
 
+  /**
+   * \brief Returns a qasm string for a Toffoli gate with given control qubits
+   *        `control0` and `control1`, and target qubit `target`.
+   */
+  inline auto qasmCCX( const int control0 , const int control1 ,
+                       const int target ) {
+    return qasmN( "ccx" , { control0 , control1 , target } ) ;
+  }
+
+  /**
+   * \brief Returns a qasm string for a multi-controlled Pauli-X gate with
+   *        given control qubits `controls` and target qubit `target`.
+   */
+  inline auto qasmMCX( std::vector< int > controls , const int target ) {
+    controls.push_back( target ) ;
+    return qasmN( "mcx" , controls ) ;
+  }
+
+  /**
+   * \brief Returns a qasm string for a Fredkin gate with given control qubit
+   *        `control` and target qubits `target0` and `target1`.
+   */
+  inline auto qasmCSWAP( const int control , const int target0 ,
+                         const int target1 ) {
+    return qasmN( "cswap" , { control , target0 , target1 } ) ;
+  }
+
 } // namespace qclab
 
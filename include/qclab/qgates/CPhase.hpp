@@ -101,6 +101,9 @@ namespace qclab {
 
         // matrix
 
+        // apply
+        using QControlledGate2< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
@@ -103,6 +103,22 @@ namespace qclab {
         // matrix
 
         // apply
+        using QControlledGate2< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
 
         // print
 
@@ -0,0 +1,176 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QObject.hpp"
+#include <memory>
+#include <stdexcept>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class Conditional
+     * \brief Classically conditioned quantum object, i.e., a quantum object
+     *        that is only applied if the bits of the classical register equal
+     *        a given value.
+     */
+    template <typename T>
+    class Conditional : public qclab::QObject< T >
+    {
+
+      public:
+        /// Quantum object type of this conditional object.
+        using object_type = qclab::QObject< T > ;
+
+        /**
+         * \brief Constructs a conditional object that applies the quantum
+         *        object `object` if the classical bits `bits` equal `value`,
+         *        where `bits[0]` is the least significant bit.
+         */
+        Conditional( std::unique_ptr< object_type > object ,
+                     const std::vector< int >& bits , const uint64_t value )
+        : object_( std::move( object ) )
+        , bits_( bits )
+        , value_( value )
+        {
+          assert( object_ ) ;
+          assert( bits.size() <= 64 ) ;
+        } // Conditional(object,bits,value)
+
+        // nbQubits
+        inline int nbQubits() const override { return object_->nbQubits() ; }
+
+        // fixed
+        inline bool fixed() const override { return object_->fixed() ; }
+
+        // controlled
+        inline bool controlled() const override { return false ; }
+
+        // teamAware
+        inline bool teamAware() const override {
+          return object_->teamAware() ;
+        }
+
+        // qubit
+        inline int qubit() const override { return object_->qubit() ; }
+
+        // setQubit
+        inline void setQubit( const int qubit ) override {
+          object_->setQubit( qubit ) ;
+        }
+
+        // qubits
+        std::vector< int > qubits() const override {
+          return object_->qubits() ;
+        }
+
+        // setQubits
+        inline void setQubits( const int* qubits ) override {
+          object_->setQubits( qubits ) ;
+        }
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override {
+          throw std::logic_error( "a conditional object depends on the "
+                                  "classical register" ) ;
+        }
+
+        // dynamic
+        inline bool dynamic() const override { return true ; }
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
+        // apply
+        void apply( Op , const int , std::vector< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a conditional object requires a "
+                                  "classical register" ) ;
+        }
+
+        // apply
+        void apply( const int nbQubits , std::vector< T >& vector ,
+                    qclab::ClassicalRegister& creg ,
+                    const int offset = 0 ) const override {
+          if ( creg.value( bits_ ) == value_ ) {
+            object_->apply( nbQubits , vector , creg , offset ) ;
+          }
+        }
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op , const int , T* ,
+                           const int = 0 ) const override {
+          throw std::logic_error( "a conditional object requires a "
+                                  "classical register" ) ;
+        }
+      #endif
+
+        // apply
+        void apply( Side , Op , const int ,
+                    qclab::dense::SquareMatrix< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a conditional object depends on the "
+                                  "classical register" ) ;
+        }
+
+        // print
+        void print() const override {
+          std::cout << "Conditional on value " << value_ << " of bits" ;
+          for ( const int bit : bits_ ) std::cout << " " << bit ;
+          std::cout << std::endl ;
+          object_->print() ;
+        }
+
+        /**
+         * \brief Writes the QASM code of this conditional object to the given
+         *        `stream`. Only conditions on the bits 0, 1, ..., of the
+         *        classical register c are supported.
+         */
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          for ( size_t i = 0; i < bits_.size(); i++ ) {
+            if ( size_t( bits_[i] ) != i ) return -1 ;
+          }
+          stream << "if(c==" << value_ << ") " ;
+          return object_->toQASM( stream , offset ) ;
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          using C = Conditional< T > ;
+          if ( const C* p = dynamic_cast< const C* >( &other ) ) {
+            return ( p->bits() == bits_ ) && ( p->value() == value_ ) &&
+                   ( p->object() == *object_ ) ;
+          }
+          return false ;
+        }
+
+        /// Returns the conditioned quantum object of this conditional object.
+        inline const object_type& object() const { return *object_ ; }
+
+        /// Returns the classical bits of this conditional object.
+        inline const std::vector< int >& bits() const { return bits_ ; }
+
+        /// Returns the value of the classical bits of this conditional object.
+        inline uint64_t value() const { return value_ ; }
+
+      protected:
+        /// Conditioned quantum object.
+        std::unique_ptr< object_type >  object_ ;
+        /// Classical bits of the condition.
+        std::vector< int >              bits_ ;
+        /// Value of the classical bits of the condition.
+        uint64_t                        value_ ;
+
+    } ; // class Conditional
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -0,0 +1,167 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QObject.hpp"
+#include <array>
+#include <map>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class DiagonalGate
+     * \brief Diagonal gate defined by a product of 1-qubit and 2-qubit
+     *        diagonal factors.
+     *
+     * The diagonal of a diagonal gate is stored as a table of 2 entries per
+     * qubit and a table of 4 entries per pair of qubits, such that the
+     * amplitude of a basis state x is multiplied by
+     *
+     *    prod_q  d_q[ x_q ]  *  prod_{p < q}  d_pq[ 2 x_p + x_q ] .
+     *
+     * The product is evaluated with cached partial products, such that an
+     * arbitrary number of diagonal gates is applied in a single sweep over
+     * the vector with a few multiplications per amplitude.
+     */
+    template <typename T>
+    class DiagonalGate : public qclab::QObject< T >
+    {
+
+      public:
+        /// Diagonal of a 1-qubit factor.
+        using diag1_type = std::array< T , 2 > ;
+        /// Diagonal of a 2-qubit factor.
+        using diag2_type = std::array< T , 4 > ;
+
+        /// Default constructor. Constructs an empty diagonal gate.
+        DiagonalGate() = default ;
+
+        /**
+         * \brief Multiplies this diagonal gate with the 1-qubit diagonal
+         *        `diag` on qubit `qubit`.
+         */
+        void multiply( const int qubit , const diag1_type& diag ) ;
+
+        /**
+         * \brief Multiplies this diagonal gate with the 2-qubit diagonal
+         *        `diag` on the qubits `qubit0` < `qubit1`.
+         */
+        void multiply( const int qubit0 , const int qubit1 ,
+                       const diag2_type& diag ) ;
+
+        /**
+         * \brief Multiplies this diagonal gate with the diagonal matrix
+         *        `matrix` of a 1-qubit or 2-qubit gate on the ascending
+         *        qubits `qubits`.
+         */
+        void multiply( const std::vector< int >& qubits ,
+                       const qclab::dense::SquareMatrix< T >& matrix ) ;
+
+        /// Returns the 1-qubit factors of this diagonal gate.
+        const std::map< int , diag1_type >& factors1() const {
+          return factors1_ ;
+        }
+
+        /// Returns the 2-qubit factors of this diagonal gate.
+        const std::map< std::pair< int , int > , diag2_type >&
+        factors2() const {
+          return factors2_ ;
+        }
+
+        // nbQubits
+        inline int nbQubits() const override { return qubits_.size() ; }
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+        inline bool controlled() const override { return false ; }
+
+        // teamAware
+        inline bool teamAware() const override { return true ; }
+
+        // qubit
+        inline int qubit() const override {
+          assert( !qubits_.empty() ) ;
+          return qubits_[0] ;
+        }
+
+        // setQubit
+        void setQubit( const int qubit ) override {
+          assert( nbQubits() == 1 ) ;
+          setQubits( &qubit ) ;
+        }
+
+        // qubits
+        std::vector< int > qubits() const override { return qubits_ ; }
+
+        // setQubits
+        void setQubits( const int* qubits ) override ;
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override ;
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+        // apply
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+        void print() const override {
+          std::cout << "DiagonalGate on " << nbQubits() << " qubits with "
+                    << factors1_.size() << " 1-qubit and " << factors2_.size()
+                    << " 2-qubit factors" << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // general diagonal gates are not supported in QASM
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          if ( other.qubits() != qubits_ ) return false ;
+          return ( other.matrix() == matrix() ) ;
+        }
+
+      protected:
+        /// Updates the qubits of this diagonal gate from its factors.
+        void updateQubits() ;
+
+        /// Qubits of this diagonal gate in ascending order.
+        std::vector< int >  qubits_ ;
+        /// 1-qubit factors of this diagonal gate.
+        std::map< int , diag1_type >  factors1_ ;
+        /// 2-qubit factors of this diagonal gate.
+        std::map< std::pair< int , int > , diag2_type >  factors2_ ;
+
+    } ; // class DiagonalGate
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -44,12 +44,20 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
+          return qclab::dense::SquareMatrix< T >( matrix2x2() ) ;
+        }
+
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
           using R = qclab::real_t< T > ;
           const R sqrt2 = R(1) / std::sqrt( R(2) ) ;
-          return qclab::dense::SquareMatrix< T >( sqrt2 ,  sqrt2 ,
-                                                  sqrt2 , -sqrt2 ) ;
+          return qclab::dense::SmallMatrix< T , 2 >( sqrt2 ,  sqrt2 ,
+                                                     sqrt2 , -sqrt2 ) ;
         }
 
+        // apply
+        using QGate1< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
@@ -0,0 +1,137 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/QControlledGateN.hpp"
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class MCGate
+     * \brief Multi-controlled 1-qubit gate defined by a 2 x 2 matrix.
+     */
+    template <typename T>
+    class MCGate : public QControlledGateN< T >
+    {
+
+      public:
+        /// Matrix type of the controlled 1-qubit gate of this gate.
+        using matrix_type = qclab::dense::SquareMatrix< T > ;
+
+        /**
+         * \brief Constructs a multi-controlled 1-qubit gate with the given
+         *        ascending control qubits `controls`, target qubit `target`,
+         *        2 x 2 matrix `matrix`, and control states `controlStates`.
+         *        The default control states are 1.
+         */
+        MCGate( const std::vector< int >& controls , const int target ,
+                const matrix_type& matrix ,
+                const std::vector< int >& controlStates = {} )
+        : QControlledGateN< T >( controls , controlStates )
+        , target_( target )
+        , matrix_( matrix )
+        {
+          assert( target >= 0 ) ;
+          assert( matrix.size() == 2 ) ;
+          assert( std::find( controls.begin() , controls.end() , target ) ==
+                  controls.end() ) ;
+        } // MCGate(controls,target,matrix,controlStates)
+
+        // nbQubits
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+
+        // apply
+        using QControlledGateN< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+        // apply
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+        void print() const override {
+          std::cout << "MCGate with " << this->controls().size()
+                    << " controls on target " << target_ << std::endl ;
+          printMatrix( matrix_ ) ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // general multi-controlled gates are not supported
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+
+        // controls
+
+        // controlStates
+
+        // targets
+        std::vector< int > targets() const override { return { target_ } ; }
+
+        // targetMatrix
+        matrix_type targetMatrix() const override { return matrix_ ; }
+
+        /// Returns the target qubit of this gate.
+        inline int target() const { return target_ ; }
+
+        /// Sets the target of this gate to the given `target`.
+        void setTarget( const int target ) {
+          assert( target >= 0 ) ;
+          assert( !std::binary_search( this->controls_.begin() ,
+                                       this->controls_.end() , target ) ) ;
+          target_ = target ;
+        }
+
+      protected:
+        // setTargets
+        void setTargets( const int* targets ) override {
+          target_ = targets[0] ;
+        }
+
+        /// Target qubit of this gate.
+        int          target_ ;
+        /// Matrix of the controlled 1-qubit gate of this gate.
+        matrix_type  matrix_ ;
+
+    } ; // class MCGate
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -0,0 +1,139 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/QControlledGateN.hpp"
+#include <array>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class MCSWAP
+     * \brief Multi-controlled SWAP gate, e.g., the Fredkin gate for 1 control
+     *        qubit.
+     */
+    template <typename T>
+    class MCSWAP : public QControlledGateN< T >
+    {
+
+      public:
+        /**
+         * \brief Constructs a multi-controlled SWAP gate with the given
+         *        ascending control qubits `controls`, target qubits `target0`
+         *        and `target1`, and control states `controlStates`. The
+         *        default control states are 1.
+         */
+        MCSWAP( const std::vector< int >& controls , const int target0 ,
+                const int target1 ,
+                const std::vector< int >& controlStates = {} )
+        : QControlledGateN< T >( controls , controlStates )
+        , targets_( { std::min( target0 , target1 ) ,
+                      std::max( target0 , target1 ) } )
+        {
+          assert( target0 >= 0 ) ; assert( target1 >= 0 ) ;
+          assert( target0 != target1 ) ;
+          for ( const int target : targets_ ) {
+            assert( std::find( controls.begin() , controls.end() , target ) ==
+                    controls.end() ) ;
+          }
+        } // MCSWAP(controls,target0,target1,controlStates)
+
+        // nbQubits
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+
+        // apply
+        using QControlledGateN< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+        // apply
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+        void print() const override {
+          std::cout << "MCSWAP with " << this->controls().size()
+                    << " controls on targets " << targets_[0] << " and "
+                    << targets_[1] << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          if ( this->controls().size() > 1 ) return -1 ;
+          const int control = this->controls()[0] + offset ;
+          const bool flip = ( this->controlStates()[0] == 0 ) ;
+          if ( flip ) stream << qasmX( control ) ;
+          stream << qasmCSWAP( control , targets_[0] + offset ,
+                                         targets_[1] + offset ) ;
+          if ( flip ) stream << qasmX( control ) ;
+          return 0 ;
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+
+        // controls
+
+        // controlStates
+
+        // targets
+        std::vector< int > targets() const override {
+          return { targets_[0] , targets_[1] } ;
+        }
+
+        // targetMatrix
+        qclab::dense::SquareMatrix< T > targetMatrix() const override {
+          qclab::dense::SquareMatrix< T > mat( 4 , T(0) ) ;
+          mat(0,0) = 1 ; mat(2,1) = 1 ; mat(1,2) = 1 ; mat(3,3) = 1 ;
+          return mat ;
+        }
+
+      protected:
+        // setTargets
+        void setTargets( const int* targets ) override {
+          assert( targets[0] < targets[1] ) ;
+          targets_ = { targets[0] , targets[1] } ;
+        }
+
+        /// Target qubits of this gate in ascending order.
+        std::array< int , 2 >  targets_ ;
+
+    } ; // class MCSWAP
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -0,0 +1,109 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/MCGate.hpp"
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class MCX
+     * \brief Multi-controlled Pauli-X gate, e.g., the Toffoli gate for 2
+     *        control qubits.
+     */
+    template <typename T>
+    class MCX : public MCGate< T >
+    {
+
+      public:
+        /**
+         * \brief Constructs a multi-controlled Pauli-X gate with the given
+         *        ascending control qubits `controls`, target qubit `target`,
+         *        and control states `controlStates`. The default control
+         *        states are 1.
+         */
+        MCX( const std::vector< int >& controls , const int target ,
+             const std::vector< int >& controlStates = {} )
+        : MCGate< T >( controls , target ,
+                       qclab::dense::SquareMatrix< T >( 0 , 1 ,
+                                                        1 , 0 ) ,
+                       controlStates )
+        { } // MCX(controls,target,controlStates)
+
+        // nbQubits
+
+        // fixed
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+
+        // apply
+        using MCGate< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+        // apply
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          auto controls = this->controls() ;
+          for ( auto& control : controls ) { control += offset ; }
+          const int target = this->target() + offset ;
+          const auto& states = this->controlStates() ;
+          for ( int i = 0; i < controls.size(); i++ ) {
+            if ( states[i] == 0 ) stream << qasmX( controls[i] ) ;
+          }
+          if ( controls.size() == 1 ) {
+            stream << qasmCX( controls[0] , target ) ;
+          } else if ( controls.size() == 2 ) {
+            stream << qasmCCX( controls[0] , controls[1] , target ) ;
+          } else {
+            stream << qasmMCX( controls , target ) ;
+          }
+          for ( int i = 0; i < controls.size(); i++ ) {
+            if ( states[i] == 0 ) stream << qasmX( controls[i] ) ;
+          }
+          return 0 ;
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+
+    } ; // class MCX
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -0,0 +1,117 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/QGate1.hpp"
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class MatrixGate1
+     * \brief 1-qubit gate defined by a general 2x2 matrix.
+     */
+    template <typename T>
+    class MatrixGate1 : public QGate1< T >
+    {
+
+      public:
+        /// Matrix type of this 1-qubit matrix gate.
+        using matrix_type = qclab::dense::SquareMatrix< T > ;
+
+        /**
+         * \brief Default constructor. Constructs a 1-qubit matrix gate on
+         *        qubit 0 equal to the identity.
+         */
+        MatrixGate1()
+        : QGate1< T >( 0 )
+        , matrix_( 1 , 0 ,
+                   0 , 1 )
+        { } // MatrixGate1()
+
+        /**
+         * \brief Constructs a 1-qubit matrix gate on the given qubit `qubit`
+         *        with the given 2x2 matrix `matrix`.
+         */
+        MatrixGate1( const int qubit , const matrix_type& matrix )
+        : QGate1< T >( qubit )
+        , matrix_( matrix )
+        {
+          assert( matrix.size() == 2 ) ;
+        } // MatrixGate1(qubit,matrix)
+
+        /**
+         * \brief Constructs a 1-qubit matrix gate on the given qubit `qubit`
+         *        with the given matrix elements.
+         */
+        MatrixGate1( const int qubit , const T m00 , const T m01 ,
+                                       const T m10 , const T m11 )
+        : QGate1< T >( qubit )
+        , matrix_( m00 , m01 ,
+                   m10 , m11 )
+        { } // MatrixGate1(qubit,m00,m01,m10,m11)
+
+        // nbQubits
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override {
+          return matrix_ ;
+        }
+
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
+          return qclab::dense::SmallMatrix< T , 2 >( matrix_ ) ;
+        }
+
+        // apply
+
+        // print
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // general 1-qubit matrices are not supported in QASM
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          if ( other.nbQubits() != 1 ) return false ;
+          return ( other.matrix() == matrix_ ) ;
+        }
+
+        /**
+         * \brief Multiplies the 2x2 matrix `lhs` to the left of the matrix of
+         *        this 1-qubit matrix gate.
+         */
+        inline void leftMultiply( const matrix_type& lhs ) {
+          assert( lhs.size() == 2 ) ;
+          matrix_ = lhs * matrix_ ;
+        }
+
+      protected:
+        /// Matrix of this 1-qubit matrix gate.
+        matrix_type  matrix_ ;
+
+    } ; // class MatrixGate1
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -0,0 +1,138 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QObject.hpp"
+#include "qclab/dense/transpose.hpp"
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class MatrixGateN
+     * \brief N-qubit gate defined by a general dense matrix.
+     *
+     * The matrix of an N-qubit matrix gate acts on its qubits in ascending
+     * order, i.e., the first qubit corresponds to the most significant bit.
+     * The qubits do not need to be adjacent. Vector kernels are available up
+     * to `maxQubits` qubits.
+     */
+    template <typename T>
+    class MatrixGateN : public qclab::QObject< T >
+    {
+
+      public:
+        /// Matrix type of this N-qubit matrix gate.
+        using matrix_type = qclab::dense::SquareMatrix< T > ;
+
+        /// Maximum number of qubits of an N-qubit matrix gate.
+        static constexpr int maxQubits = 6 ;
+
+        /**
+         * \brief Constructs an N-qubit matrix gate on the given qubits
+         *        `qubits`, in ascending order, with the given matrix `matrix`.
+         */
+        MatrixGateN( const std::vector< int >& qubits ,
+                     const matrix_type& matrix )
+        : qubits_( qubits )
+        , matrix_( matrix )
+        {
+          assert( qubits.size() >= 1 ) ;
+          assert( qubits.size() <= maxQubits ) ;
+          assert( matrix.size() == 1 << qubits.size() ) ;
+          assert( qubits[0] >= 0 ) ;
+          for ( int i = 1; i < qubits.size(); i++ ) {
+            assert( qubits[i] > qubits[i-1] ) ;
+          }
+        } // MatrixGateN(qubits,matrix)
+
+        // nbQubits
+        inline int nbQubits() const override { return qubits_.size() ; }
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+        inline bool controlled() const override { return false ; }
+
+        // teamAware
+        inline bool teamAware() const override { return true ; }
+
+        // qubit
+        inline int qubit() const override { return qubits_[0] ; }
+
+        // setQubit
+        inline void setQubit( const int qubit ) override {
+          assert( nbQubits() == 1 ) ;
+          assert( qubit >= 0 ) ;
+          qubits_[0] = qubit ;
+        }
+
+        // qubits
+        std::vector< int > qubits() const override { return qubits_ ; }
+
+        // setQubits
+        inline void setQubits( const int* qubits ) override {
+          assert( qubits[0] >= 0 ) ;
+          for ( int i = 1; i < nbQubits(); i++ ) {
+            assert( qubits[i] > qubits[i-1] ) ;
+          }
+          std::copy( qubits , qubits + nbQubits() , qubits_.begin() ) ;
+        }
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override {
+          return matrix_ ;
+        }
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+        void print() const override {
+          printMatrix( matrix_ ) ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // general N-qubit matrices are not supported in QASM
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          if ( other.nbQubits() != nbQubits() ) return false ;
+          return ( other.matrix() == matrix_ ) ;
+        }
+
+      protected:
+        /// Qubits of this N-qubit matrix gate in ascending order.
+        std::vector< int >  qubits_ ;
+        /// Matrix of this N-qubit matrix gate.
+        matrix_type         matrix_ ;
+
+    } ; // class MatrixGateN
+
+  } // namespace qgates
+
+} // namespace qclab
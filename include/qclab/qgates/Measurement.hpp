@@ -0,0 +1,153 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/QGate1.hpp"
+#include "qclab/parallel.hpp"
+#include <stdexcept>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \brief Measures the qubit `qubit` of the vector `vector` of `nbQubits`
+     *        qubits in the computational basis with the next random number
+     *        of the classical register `creg`, and returns the outcome.
+     *
+     * The probability of outcome 1 is summed over a fixed number of chunks
+     * in one parallel pass, and the state is collapsed and renormalized in a
+     * second parallel pass. If `reset` is true, the qubit is flipped to 0
+     * in the same pass. Can be called by all threads of a persistent team.
+     */
+    template <typename T>
+    int measure( const int nbQubits , const int qubit ,
+                 std::vector< T >& vector , qclab::ClassicalRegister& creg ,
+                 const bool reset = false ) ;
+
+    /**
+     * \class Measurement
+     * \brief Measurement of a qubit in the computational basis, with the
+     *        outcome stored in a bit of the classical register.
+     */
+    template <typename T>
+    class Measurement : public QGate1< T >
+    {
+
+      public:
+        /**
+         * \brief Constructs a measurement of the qubit `qubit` with outcome
+         *        stored in the classical bit `bit`.
+         */
+        Measurement( const int qubit , const int bit )
+        : QGate1< T >( qubit )
+        , bit_( bit )
+        {
+          assert( bit >= 0 ) ;
+        } // Measurement(qubit,bit)
+
+        // nbQubits
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override {
+          throw std::logic_error( "a measurement is not unitary" ) ;
+        }
+
+        // dynamic
+        inline bool dynamic() const override { return true ; }
+
+        // apply
+        using QGate1< T >::apply ;
+
+        // apply
+        void apply( Op , const int , std::vector< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a measurement requires a "
+                                  "classical register" ) ;
+        }
+
+        // apply
+        void apply( const int nbQubits , std::vector< T >& vector ,
+                    qclab::ClassicalRegister& creg ,
+                    const int offset = 0 ) const override {
+          const int outcome = measure( nbQubits , this->qubit_ + offset ,
+                                       vector , creg ) ;
+          parallel::forEach( 1 , [&] ( const int ) {
+            creg.set( bit_ , outcome ) ;
+          } ) ;
+        }
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op , const int , T* ,
+                           const int = 0 ) const override {
+          throw std::logic_error( "a measurement requires a "
+                                  "classical register" ) ;
+        }
+      #endif
+
+        // apply
+        void apply( Side , Op , const int ,
+                    qclab::dense::SquareMatrix< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a measurement is not unitary" ) ;
+        }
+
+        // print
+        void print() const override {
+          std::cout << "Measurement of qubit " << this->qubit_
+                    << " to bit " << bit_ << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          stream << "measure q[" << this->qubit_ + offset << "] -> c["
+                 << bit_ << "];\n" ;
+          return 0 ;
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          using M = Measurement< T > ;
+          if ( const M* p = dynamic_cast< const M* >( &other ) ) {
+            return ( p->qubit() == this->qubit_ ) && ( p->bit() == bit_ ) ;
+          }
+          return false ;
+        }
+
+        /// Returns the classical bit of this measurement.
+        inline int bit() const { return bit_ ; }
+
+        /// Sets the classical bit of this measurement to `bit`.
+        inline void setBit( const int bit ) {
+          assert( bit >= 0 ) ;
+          bit_ = bit ;
+        }
+
+      protected:
+        /// Classical bit of this measurement.
+        int  bit_ ;
+
+    } ; // class Measurement
+
+  } // namespace qgates
+
+} // namespace qclab
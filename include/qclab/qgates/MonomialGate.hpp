@@ -0,0 +1,171 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QObject.hpp"
+#include <algorithm>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class MonomialGate
+     * \brief Gate that maps every basis state to a basis state with a phase,
+     *        i.e., a gate with a monomial matrix.
+     *
+     * A monomial gate on m qubits is stored as a permutation `perm` and a
+     * phase `phase` of its 2^m local basis states, such that the basis state
+     * x is mapped to
+     *
+     *    phase[x] * |perm[x]> .
+     *
+     * Products of Pauli, controlled Pauli, SWAP, iSWAP and phase gates are
+     * monomial. The gate is applied in place in a single sweep over the
+     * vector, which is split in chunks of at most 2^`chunkQubits` amplitudes
+     * whose permutation is applied cycle by cycle.
+     */
+    template <typename T>
+    class MonomialGate : public qclab::QObject< T >
+    {
+
+      public:
+        /// Maximum number of qubits of a monomial gate.
+        static constexpr int maxQubits = 12 ;
+        /// Maximum number of qubits of a chunk, see apply.
+        static constexpr int chunkQubits = 14 ;
+
+        /// Default constructor. Constructs an identity gate on no qubits.
+        MonomialGate()
+        : perm_( 1 , 0 )
+        , phase_( 1 , T(1) )
+        { } // MonomialGate()
+
+        /**
+         * \brief Constructs a monomial gate on the ascending qubits `qubits`
+         *        that maps the local basis state x to phase[x] * |perm[x]>.
+         */
+        MonomialGate( const std::vector< int >& qubits ,
+                      const std::vector< int64_t >& perm ,
+                      const std::vector< T >& phase )
+        : qubits_( qubits )
+        , perm_( perm )
+        , phase_( phase )
+        {
+          assert( int( qubits.size() ) <= maxQubits ) ;
+          assert( perm.size() == size_t(1) << qubits.size() ) ;
+          assert( phase.size() == perm.size() ) ;
+          assert( std::is_sorted( qubits.begin() , qubits.end() ) ) ;
+        } // MonomialGate(qubits,perm,phase)
+
+        /**
+         * \brief Multiplies this monomial gate from the left with the monomial
+         *        matrix `matrix` of a gate on the ascending qubits `qubits`,
+         *        i.e., the gate `matrix` is applied after this gate.
+         */
+        void multiply( const std::vector< int >& qubits ,
+                       const qclab::dense::SquareMatrix< T >& matrix ) ;
+
+        /// Returns the permutation of the local basis states of this gate.
+        const std::vector< int64_t >& perm() const { return perm_ ; }
+
+        /// Returns the phases of the local basis states of this gate.
+        const std::vector< T >& phase() const { return phase_ ; }
+
+        // nbQubits
+        inline int nbQubits() const override { return qubits_.size() ; }
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+        inline bool controlled() const override { return false ; }
+
+        // teamAware
+        inline bool teamAware() const override { return true ; }
+
+        // qubit
+        inline int qubit() const override {
+          assert( !qubits_.empty() ) ;
+          return qubits_[0] ;
+        }
+
+        // setQubit
+        void setQubit( const int qubit ) override {
+          assert( nbQubits() == 1 ) ;
+          setQubits( &qubit ) ;
+        }
+
+        // qubits
+        std::vector< int > qubits() const override { return qubits_ ; }
+
+        // setQubits
+        void setQubits( const int* qubits ) override {
+          assert( nbQubits() == 0 || qubits[0] >= 0 ) ;
+          for ( int i = 0; i < nbQubits(); i++ ) {
+            assert( i == 0 || qubits[i] > qubits[i-1] ) ;
+            qubits_[i] = qubits[i] ;
+          }
+        }
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override ;
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+        // apply
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+        void print() const override {
+          std::cout << "MonomialGate on " << nbQubits() << " qubits"
+                    << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          return -1 ;  // general monomial gates are not supported in QASM
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          if ( other.qubits() != qubits_ ) return false ;
+          return ( other.matrix() == matrix() ) ;
+        }
+
+      protected:
+        /// Qubits of this monomial gate in ascending order.
+        std::vector< int >      qubits_ ;
+        /// Permutation of the local basis states of this monomial gate.
+        std::vector< int64_t >  perm_ ;
+        /// Phases of the local basis states of this monomial gate.
+        std::vector< T >        phase_ ;
+
+    } ; // class MonomialGate
+
+  } // namespace qgates
+
+} // namespace qclab
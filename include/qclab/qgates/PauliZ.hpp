@@ -44,10 +44,18 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
-          return qclab::dense::SquareMatrix< T >( 1 ,  0 ,
-                                                  0 , -1 ) ;
+          return qclab::dense::SquareMatrix< T >( matrix2x2() ) ;
         }
 
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
+          return qclab::dense::SmallMatrix< T , 2 >( 1 ,  0 ,
+                                                     0 , -1 ) ;
+        }
+
+        // apply
+        using QGate1< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
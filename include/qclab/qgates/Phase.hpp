@@ -117,10 +117,19 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
-          return qclab::dense::SquareMatrix< T >( T(1) , T(0) ,
-                                                  T(0) , T( cos() , sin() ) ) ;
+          return qclab::dense::SquareMatrix< T >( matrix2x2() ) ;
         }
 
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
+          using SmMat = qclab::dense::SmallMatrix< T , 2 > ;
+          return SmMat( T(1) , T(0) ,
+                        T(0) , T( cos() , sin() ) ) ;
+        }
+
+        // apply
+        using QGate1< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
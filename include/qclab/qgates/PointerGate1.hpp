@@ -53,6 +53,11 @@ namespace qclab {
           return gate_->matrix() ;
         }
 
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
+          return gate_->matrix2x2() ;
+        }
+
         // apply
 
         // print
@@ -50,6 +50,12 @@ namespace qclab {
           return v ;
         }
 
+        // qubitPair
+        std::array< int , 2 > qubitPair() const override {
+          auto qubits = gate_->qubitPair() ;
+          return { qubits[0] + offset_ , qubits[1] + offset_ } ;
+        }
+
         // setQubits
         inline void setQubits( const int* qubits ) override { assert( false ) ;}
 
@@ -58,6 +64,14 @@ namespace qclab {
           return gate_->matrix() ;
         }
 
+        // matrix4x4
+        qclab::dense::SmallMatrix< T , 4 > matrix4x4() const override {
+          return gate_->matrix4x4() ;
+        }
+
+        // apply
+        using QGate2< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override {
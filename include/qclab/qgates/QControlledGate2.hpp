@@ -52,6 +52,12 @@ namespace qclab {
                                        std::max( control() , this->target() )});
         }
 
+        // qubitPair
+        std::array< int , 2 > qubitPair() const override {
+          return { std::min( control() , this->target() ) ,
+                   std::max( control() , this->target() ) } ;
+        }
+
         // setQubits
         inline void setQubits( const int* qubits ) override {
           assert( qubits[0] >= 0 ) ; assert( qubits[1] >= 0 ) ;
@@ -88,6 +94,29 @@ namespace qclab {
           }
         }
 
+        // matrix4x4
+        qclab::dense::SmallMatrix< T , 4 > matrix4x4() const override {
+          const auto CG = this->gate()->matrix2x2() ;
+          // bits of the control and target qubits in the row/column index
+          const int c = ( control() < target() ) ? 2 : 1 ;
+          const int t = 3 - c ;
+          qclab::dense::SmallMatrix< T , 4 >  mat ;
+          for ( int j = 0; j < 4; j++ ) {
+            for ( int i = 0; i < 4; i++ ) {
+              if ( ( i & c ) != ( j & c ) ) continue ;
+              if ( ( ( i & c ) != 0 ) == ( controlState_ == 1 ) ) {
+                mat(i,j) = CG( ( i & t ) != 0 , ( j & t ) != 0 ) ;
+              } else if ( i == j ) {
+                mat(i,j) = 1 ;
+              }
+            }
+          }
+          return mat ;
+        }
+
+        // apply
+        using QGate2< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
@@ -0,0 +1,177 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QObject.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class QControlledGateN
+     * \brief Base class for multi-controlled gates, i.e., gates that apply a
+     *        target gate to their target qubits if all their control qubits
+     *        are in their control states.
+     *
+     * The vector kernels of multi-controlled gates only iterate over the
+     * subspace in which the control qubits match their control states.
+     */
+    template <typename T>
+    class QControlledGateN : public qclab::QObject< T >
+    {
+
+      public:
+        /**
+         * \brief Constructs a multi-controlled gate with the given control
+         *        qubits `controls` on the control states `controlStates`.
+         *        The default control states are 1.
+         */
+        QControlledGateN( const std::vector< int >& controls ,
+                          const std::vector< int >& controlStates = {} )
+        : controls_( controls )
+        , controlStates_( controlStates )
+        {
+          assert( !controls.empty() ) ;
+          if ( controlStates_.empty() ) {
+            controlStates_.assign( controls_.size() , 1 ) ;
+          }
+          assert( controlStates_.size() == controls_.size() ) ;
+          for ( int i = 0; i < controls_.size(); i++ ) {
+            assert( controls_[i] >= 0 ) ;
+            assert( ( i == 0 ) || ( controls_[i] > controls_[i-1] ) ) ;
+            assert( ( controlStates_[i] == 0 ) || ( controlStates_[i] == 1 ) ) ;
+          }
+        } // QControlledGateN(controls,controlStates)
+
+        // nbQubits
+        inline int nbQubits() const override {
+          return controls_.size() + targets().size() ;
+        }
+
+        // fixed
+
+        // controlled
+        inline bool controlled() const override { return true ; }
+
+        // teamAware
+        inline bool teamAware() const override { return true ; }
+
+        // qubit
+        inline int qubit() const override {
+          return std::min( controls_[0] , targets()[0] ) ;
+        }
+
+        // setQubit
+        inline void setQubit( const int qubit ) override {
+          assert( false ) ;  // multi-controlled gates have 2 or more qubits
+        }
+
+        // qubits
+        std::vector< int > qubits() const override {
+          std::vector< int > qubits( controls_ ) ;
+          const auto targets = this->targets() ;
+          qubits.insert( qubits.end() , targets.begin() , targets.end() ) ;
+          std::sort( qubits.begin() , qubits.end() ) ;
+          return qubits ;
+        }
+
+        // setQubits
+        void setQubits( const int* qubits ) override ;
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override ;
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
+
+        // print
+
+        // toQASM
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        bool equals( const QObject< T >& other ) const override {
+          using CG = QControlledGateN< T > ;
+          if ( const CG* p = dynamic_cast< const CG* >( &other ) ) {
+            return ( p->controls() == controls_ ) &&
+                   ( p->controlStates() == controlStates_ ) &&
+                   ( p->targets() == targets() ) &&
+                   ( p->targetMatrix() == targetMatrix() ) ;
+          }
+          if ( other.qubits() != qubits() ) return false ;
+          return ( other.matrix() == matrix() ) ;
+        }
+
+        /// Returns the control qubits of this gate in ascending order.
+        inline const std::vector< int >& controls() const { return controls_ ; }
+
+        /// Returns the control states of the control qubits of this gate.
+        inline const std::vector< int >& controlStates() const {
+          return controlStates_ ;
+        }
+
+        /// Returns the target qubits of this gate in ascending order.
+        virtual std::vector< int > targets() const = 0 ;
+
+        /// Returns the matrix of the target gate of this gate.
+        virtual qclab::dense::SquareMatrix< T > targetMatrix() const = 0 ;
+
+        /// Sets the control states of this gate to `controlStates`.
+        void setControlStates( const std::vector< int >& controlStates ) {
+          assert( controlStates.size() == controls_.size() ) ;
+          controlStates_ = controlStates ;
+        }
+
+      protected:
+        /// Sets the target qubits of this gate to `targets`, ascending.
+        virtual void setTargets( const int* targets ) = 0 ;
+
+        /**
+         * \brief Returns the ascending qubits of this gate, shifted by
+         *        `offset`, in a register of `nbQubits` qubits and the bits
+         *        `a1` and `b1` of the pairs of amplitudes on which the vector
+         *        kernels act. The control qubits are in their control states
+         *        and the targets in the states 0 and 1 for a single target,
+         *        or in the states 10 and 01 for two targets.
+         */
+        std::tuple< std::vector< int > , uint64_t , uint64_t >
+        subspace( const int nbQubits , const int offset ) const {
+          auto qubits = this->qubits() ;
+          for ( auto& qubit : qubits ) { qubit += offset ; }
+          assert( qubits.back() < nbQubits ) ;
+          uint64_t a1 = 0 ;
+          for ( int i = 0; i < controls_.size(); i++ ) {
+            if ( controlStates_[i] == 1 ) {
+              a1 |= 1ULL << ( nbQubits - controls_[i] - offset - 1 ) ;
+            }
+          }
+          const auto targets = this->targets() ;
+          uint64_t b1 = a1 ;
+          b1 |= 1ULL << ( nbQubits - targets.back() - offset - 1 ) ;
+          if ( targets.size() == 2 ) {
+            a1 |= 1ULL << ( nbQubits - targets[0] - offset - 1 ) ;
+          }
+          return { qubits , a1 , b1 } ;
+        }
+
+        /// Control qubits of this gate in ascending order.
+        std::vector< int >  controls_ ;
+        /// Control states of the control qubits of this gate.
+        std::vector< int >  controlStates_ ;
+
+    } ; // class QControlledGateN
+
+  } // namespace qgates
+
+} // namespace qclab
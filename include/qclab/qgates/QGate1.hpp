@@ -4,6 +4,7 @@
 
 #include "qclab/QObject.hpp"
 #include "qclab/dense/transpose.hpp"
+#include "qclab/dense/SmallMatrix.hpp"
 
 namespace qclab {
 
@@ -41,6 +42,9 @@ namespace qclab {
         // controlled
         inline bool controlled() const override { return false ; }
 
+        // teamAware
+        inline bool teamAware() const override { return true ; }
+
         // qubit
         inline int qubit() const override { return qubit_ ; }
 
@@ -63,10 +67,32 @@ namespace qclab {
 
         // matrix
 
+        /**
+         * \brief Returns the 2x2 matrix of this 1-qubit gate without heap
+         *        allocations. The default implementation copies matrix().
+         */
+        virtual qclab::dense::SmallMatrix< T , 2 > matrix2x2() const {
+          return qclab::dense::SmallMatrix< T , 2 >( this->matrix() ) ;
+        }
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
 
+        /**
+         * \brief Applies this 1-qubit gate to the given state vector with the
+         *        2x2 matrix of matrix2x2(), without heap allocations.
+         */
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override {
+          assert( nbQubits == state.nbQubits() ) ;
+          state.applyMatrix( op , qubit_ + offset , this->matrix2x2() ) ;
+        }
+
       #ifdef QCLAB_OMP_OFFLOADING
         // apply_device
         void apply_device( Op op , const int nbQubits , T* vector ,
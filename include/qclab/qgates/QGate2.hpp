@@ -4,6 +4,8 @@
 
 #include "qclab/QObject.hpp"
 #include "qclab/dense/transpose.hpp"
+#include "qclab/dense/SmallMatrix.hpp"
+#include <array>
 
 namespace qclab {
 
@@ -25,6 +27,9 @@ namespace qclab {
 
         // controlled
 
+        // teamAware
+        inline bool teamAware() const override { return true ; }
+
         // qubit
 
         // setQubit
@@ -32,14 +37,48 @@ namespace qclab {
 
         // qubits
 
+        /**
+         * \brief Returns the qubits of this 2-qubit gate in ascending order
+         *        without heap allocations. The default implementation copies
+         *        qubits().
+         */
+        virtual std::array< int , 2 > qubitPair() const {
+          const auto qubits = this->qubits() ;
+          return { qubits[0] , qubits[1] } ;
+        }
+
         // setQubits
 
         // matrix
 
+        /**
+         * \brief Returns the 4x4 matrix of this 2-qubit gate without heap
+         *        allocations. The default implementation copies matrix().
+         */
+        virtual qclab::dense::SmallMatrix< T , 4 > matrix4x4() const {
+          return qclab::dense::SmallMatrix< T , 4 >( this->matrix() ) ;
+        }
+
+        // apply
+        using qclab::QObject< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
 
+        /**
+         * \brief Applies this 2-qubit gate to the given state vector with the
+         *        4x4 matrix of matrix4x4(), without heap allocations.
+         */
+        void apply( Op op , const int nbQubits ,
+                    qclab::StateVector< T >& state ,
+                    const int offset = 0 ) const override {
+          assert( nbQubits == state.nbQubits() ) ;
+          const auto qubits = this->qubitPair() ;
+          state.applyMatrix( op , qubits[0] + offset , qubits[1] + offset ,
+                             this->matrix4x4() ) ;
+        }
+
       #ifdef QCLAB_OMP_OFFLOADING
         // apply_device
         void apply_device( Op op , const int nbQubits , T* vector ,
@@ -138,6 +138,9 @@ namespace qclab {
           return std::vector< int >( { qubits_[0] , qubits_[1] } ) ;
         }
 
+        // qubitPair
+        std::array< int , 2 > qubitPair() const override { return qubits_ ; }
+
         // setQubits
         inline void setQubits( const int* qubits ) override {
           assert( qubits[0] >= 0 ) ; assert( qubits[1] >= 0 ) ;
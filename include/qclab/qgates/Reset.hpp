@@ -0,0 +1,110 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/qgates/Measurement.hpp"
+#include <stdexcept>
+
+namespace qclab {
+
+  namespace qgates {
+
+    /**
+     * \class Reset
+     * \brief Reset of a qubit to 0, i.e., a measurement of the qubit in the
+     *        computational basis followed by a flip if the outcome is 1.
+     */
+    template <typename T>
+    class Reset : public QGate1< T >
+    {
+
+      public:
+        /// Constructs a reset of the qubit `qubit`.
+        Reset( const int qubit )
+        : QGate1< T >( qubit )
+        { } // Reset(qubit)
+
+        // nbQubits
+
+        // fixed
+        inline bool fixed() const override { return true ; }
+
+        // controlled
+
+        // qubit
+
+        // setQubit
+
+        // qubits
+
+        // setQubits
+
+        // matrix
+        qclab::dense::SquareMatrix< T > matrix() const override {
+          throw std::logic_error( "a reset is not unitary" ) ;
+        }
+
+        // dynamic
+        inline bool dynamic() const override { return true ; }
+
+        // apply
+        using QGate1< T >::apply ;
+
+        // apply
+        void apply( Op , const int , std::vector< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a reset requires a classical register" ) ;
+        }
+
+        // apply
+        void apply( const int nbQubits , std::vector< T >& vector ,
+                    qclab::ClassicalRegister& creg ,
+                    const int offset = 0 ) const override {
+          measure( nbQubits , this->qubit_ + offset , vector , creg , true ) ;
+        }
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op , const int , T* ,
+                           const int = 0 ) const override {
+          throw std::logic_error( "a reset requires a classical register" ) ;
+        }
+      #endif
+
+        // apply
+        void apply( Side , Op , const int ,
+                    qclab::dense::SquareMatrix< T >& ,
+                    const int = 0 ) const override {
+          throw std::logic_error( "a reset is not unitary" ) ;
+        }
+
+        // print
+        void print() const override {
+          std::cout << "Reset of qubit " << this->qubit_ << std::endl ;
+        }
+
+        // toQASM
+        int toQASM( std::ostream& stream ,
+                    const int offset = 0 ) const override {
+          stream << qasm1( "reset" , this->qubit_ + offset ) ;
+          return 0 ;
+        }
+
+        // operator==
+
+        // operator!=
+
+        // equals
+        inline bool equals( const QObject< T >& other ) const override {
+          using R = Reset< T > ;
+          if ( const R* p = dynamic_cast< const R* >( &other ) ) {
+            return ( p->qubit() == this->qubit_ ) ;
+          }
+          return false ;
+        }
+
+    } ; // class Reset
+
+  } // namespace qgates
+
+} // namespace qclab
@@ -134,15 +134,36 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
+          return qclab::dense::SquareMatrix< T >( matrix4x4() ) ;
+        }
+
+        // matrix4x4
+        qclab::dense::SmallMatrix< T , 4 > matrix4x4() const override {
           const T d = this->cos() ;
           const T o = T(0,-this->sin()) ;
-          return qclab::dense::SquareMatrix< T >( d , 0 , 0 , o ,
-                                                  0 , d , o , 0 ,
-                                                  0 , o , d , 0 ,
-                                                  o , 0 , 0 , d ) ;
+          return qclab::dense::SmallMatrix< T , 4 >( d , 0 , 0 , o ,
+                                                     0 , d , o , 0 ,
+                                                     0 , o , d , 0 ,
+                                                     o , 0 , 0 , d ) ;
         }
 
         // apply
+        using QRotationGate2< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
 
         // print
 
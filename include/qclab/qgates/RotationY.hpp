@@ -102,10 +102,19 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
-          return qclab::dense::SquareMatrix< T >( this->cos() , -this->sin() ,
-                                                  this->sin() ,  this->cos() ) ;
+          return qclab::dense::SquareMatrix< T >( matrix2x2() ) ;
         }
 
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
+          using SmMat = qclab::dense::SmallMatrix< T , 2 > ;
+          return SmMat( this->cos() , -this->sin() ,
+                        this->sin() ,  this->cos() ) ;
+        }
+
+        // apply
+        using QRotationGate1< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
@@ -102,11 +102,19 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
-          using SqMat = qclab::dense::SquareMatrix< T > ;
-          return SqMat( T(this->cos(),-this->sin()) , T(0) ,
+          return qclab::dense::SquareMatrix< T >( matrix2x2() ) ;
+        }
+
+        // matrix2x2
+        qclab::dense::SmallMatrix< T , 2 > matrix2x2() const override {
+          using SmMat = qclab::dense::SmallMatrix< T , 2 > ;
+          return SmMat( T(this->cos(),-this->sin()) , T(0) ,
                         T(0) , T(this->cos(), this->sin()) ) ;
         }
 
+        // apply
+        using QRotationGate1< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
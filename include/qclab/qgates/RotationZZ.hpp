@@ -134,15 +134,36 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
+          return qclab::dense::SquareMatrix< T >( matrix4x4() ) ;
+        }
+
+        // matrix4x4
+        qclab::dense::SmallMatrix< T , 4 > matrix4x4() const override {
           const T a = T(this->cos(),-this->sin()) ;
           const T b = T(this->cos(), this->sin()) ;
-          return qclab::dense::SquareMatrix< T >( a , 0 , 0 , 0 ,
-                                                  0 , b , 0 , 0 ,
-                                                  0 , 0 , b , 0 ,
-                                                  0 , 0 , 0 , a ) ;
+          return qclab::dense::SmallMatrix< T , 4 >( a , 0 , 0 , 0 ,
+                                                     0 , b , 0 , 0 ,
+                                                     0 , 0 , b , 0 ,
+                                                     0 , 0 , 0 , a ) ;
         }
 
         // apply
+        using QRotationGate2< T >::apply ;
+
+        // apply
+        void apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                    const int offset = 0 ) const override ;
+
+      #ifdef QCLAB_OMP_OFFLOADING
+        // apply_device
+        void apply_device( Op op , const int nbQubits , T* vector ,
+                           const int offset = 0 ) const override ;
+      #endif
+
+        // apply
+        void apply( Side side , Op op , const int nbQubits ,
+                    qclab::dense::SquareMatrix< T >& matrix ,
+                    const int offset = 0 ) const override ;
 
         // print
 
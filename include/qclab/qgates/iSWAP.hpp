@@ -56,6 +56,9 @@ namespace qclab {
           return std::vector< int >( { qubits_[0] , qubits_[1] } ) ;
         }
 
+        // qubitPair
+        std::array< int , 2 > qubitPair() const override { return qubits_ ; }
+
         // setQubits
         inline void setQubits( const int* qubits ) override {
           assert( qubits[0] >= 0 ) ; assert( qubits[1] >= 0 ) ;
@@ -66,13 +69,21 @@ namespace qclab {
 
         // matrix
         qclab::dense::SquareMatrix< T > matrix() const override {
+          return qclab::dense::SquareMatrix< T >( matrix4x4() ) ;
+        }
+
+        // matrix4x4
+        qclab::dense::SmallMatrix< T , 4 > matrix4x4() const override {
           const T i(0,1) ;
-          return qclab::dense::SquareMatrix< T >( 1 , 0 , 0 , 0 ,
-                                                  0 , 0 , i , 0 ,
-                                                  0 , i , 0 , 0 ,
-                                                  0 , 0 , 0 , 1 ) ;
+          return qclab::dense::SmallMatrix< T , 4 >( 1 , 0 , 0 , 0 ,
+                                                     0 , 0 , i , 0 ,
+                                                     0 , i , 0 , 0 ,
+                                                     0 , 0 , 0 , 1 ) ;
         }
 
+        // apply
+        using QGate2< T >::apply ;
+
         // apply
         void apply( Op op , const int nbQubits , std::vector< T >& vector ,
                     const int offset = 0 ) const override ;
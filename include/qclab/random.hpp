@@ -0,0 +1,53 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include <cstdint>
+
+namespace qclab {
+
+  /**
+   * \class Random
+   * \brief Counter-based random number generator.
+   *
+   * The k-th random number of a stream only depends on the seed and on the
+   * counter k, such that a parallel loop draws the same numbers for any
+   * number of threads. The numbers are the SplitMix64 hash of the counter,
+   * which passes the BigCrush battery of TestU01.
+   */
+  class Random
+  {
+
+    public:
+      /// Constructs a random number generator with seed `seed`.
+      Random( const uint64_t seed = 0 )
+      : key_( mix( seed ^ 0x6a09e667f3bcc909ULL ) )
+      { } // Random(seed)
+
+      /// Returns the random 64-bit integer number `counter` of this stream.
+      inline uint64_t operator()( const uint64_t counter ) const {
+        return mix( key_ + ( counter + 1 ) * 0x9e3779b97f4a7c15ULL ) ;
+      }
+
+      /**
+       * \brief Returns the random number `counter` of this stream, uniformly
+       *        distributed in (0, 1).
+       */
+      inline double uniform( const uint64_t counter ) const {
+        return ( ( (*this)( counter ) >> 11 ) + 0.5 ) * 0x1.0p-53 ;
+      }
+
+    private:
+      /// SplitMix64 finalizer.
+      static inline uint64_t mix( uint64_t z ) {
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL ;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL ;
+        return z ^ ( z >> 31 ) ;
+      }
+
+      /// Key of this stream.
+      uint64_t  key_ ;
+
+  } ; // class Random
+
+} // namespace qclab
@@ -0,0 +1,53 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/util.hpp"
+#include "qclab/StateVector.hpp"
+#include "qclab/random.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * \brief Measurement counts, i.e., the pairs of an outcome and its number
+   *        of shots, sorted by outcome. Only outcomes with at least one shot
+   *        are stored.
+   */
+  using Counts = std::vector< std::pair< uint64_t , int64_t > > ;
+
+  /**
+   * \brief Samples `nbShots` measurements of the qubits `qubits` of the
+   *        state `vector` in the computational basis, with the random number
+   *        stream of seed `seed`.
+   *
+   * The outcome of a shot is the bitstring of the measured qubits, with
+   * `qubits[0]` as most significant bit. If `qubits` is empty, all qubits
+   * are measured in order. The state does not need to be normalized.
+   *
+   * The shots are drawn with sorted uniform numbers from the probability
+   * prefix of the state, which is never stored: a first sweep sums the
+   * probabilities of fixed-size blocks and chunks, and a second sweep walks
+   * every chunk in parallel with its own range of the sorted numbers, and
+   * only visits the blocks that contain a shot. The uniform numbers
+   * are generated by their normalized cumulative exponential spacings, which
+   * avoids a sort. As the chunks and the counter-based random numbers do not
+   * depend on the number of threads, neither do the counts.
+   */
+  template <typename T>
+  Counts sample( const std::vector< T >& vector , const int64_t nbShots ,
+                 const std::vector< int >& qubits = {} ,
+                 const uint64_t seed = 0 ) ;
+
+  /**
+   * \brief Samples `nbShots` measurements of the qubits `qubits` of the
+   *        state `state` with the random number stream of seed `seed`.
+   */
+  template <typename T>
+  Counts sample( const qclab::StateVector< T >& state , const int64_t nbShots ,
+                 const std::vector< int >& qubits = {} ,
+                 const uint64_t seed = 0 ) ;
+
+} // namespace qclab
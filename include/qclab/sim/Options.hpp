@@ -0,0 +1,40 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+namespace qclab {
+
+  namespace sim {
+
+    /**
+     * \class Options
+     * \brief Options for simulating a quantum circuit.
+     *
+     * All optimizations are disabled by default, such that a simulation with
+     * the default options applies the gates of the circuit one by one.
+     */
+    struct Options
+    {
+      /// Accumulates runs of diagonal gates into diagonal gates that are
+      /// applied in a single sweep (see sim::fuseDiagonal).
+      bool  fuseDiagonal = false ;
+      /// Accumulates runs of permutation and phase gates into monomial gates
+      /// that are applied in a single sweep (see sim::fuseMonomial).
+      bool  fuseMonomial = false ;
+      /// Fuses runs of 1-qubit gates acting on the same qubit.
+      bool  fuse1 = false ;
+      /// Fuses gates into dense blocks acting on at most `fuseK` qubits,
+      /// disabled if smaller than 2 (see sim::fuseK).
+      int   fuseK = 0 ;
+      /// Applies runs of gates on the `blockQubits` least significant qubits
+      /// block by block, disabled if 0 (see sim::applyBlocked).
+      int   blockQubits = 0 ;
+      /// With cache blocking, moves the most used qubits of every window of
+      /// `remapWindow` gates into the blocked qubits by permuting the vector,
+      /// disabled if 0 (see sim::applyRemapped).
+      int   remapWindow = 0 ;
+    } ; // struct Options
+
+  } // namespace sim
+
+} // namespace qclab
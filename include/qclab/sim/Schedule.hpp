@@ -0,0 +1,136 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QObject.hpp"
+#include "qclab/parallel.hpp"
+#include <memory>
+#include <vector>
+
+namespace qclab {
+
+  /**
+   * Namespace qclab::sim.
+   */
+  namespace sim {
+
+    /**
+     * \class Schedule
+     * \brief Flat list of quantum objects applied in order by the simulator.
+     *
+     * The objects of a schedule are either borrowed from a quantum circuit,
+     * together with their qubit offset, or owned by the schedule itself,
+     * e.g., the gates created by a fusion pass.
+     */
+    template <typename T>
+    class Schedule
+    {
+
+      public:
+        /// Quantum object type of this schedule.
+        using object_type = qclab::QObject< T > ;
+
+        /// Item of a schedule: a quantum object and its qubit offset.
+        struct Item {
+          const object_type*  object ;  ///< Pointer to the quantum object.
+          int                 offset ;  ///< Qubit offset of the object.
+        } ;
+
+        /// Item vector type of this schedule.
+        using vector_type    = std::vector< Item > ;
+        /// Size type of this schedule.
+        using size_type      = typename vector_type::size_type ;
+        /// Const iterator type of this schedule.
+        using const_iterator = typename vector_type::const_iterator ;
+
+        /// Adds the borrowed quantum object `object` with offset `offset`.
+        void push_back( const object_type* object , const int offset = 0 ) {
+          assert( object != nullptr ) ;
+          items_.push_back( { object , offset } ) ;
+        }
+
+        /// Adds the quantum object `object` and takes ownership of it.
+        void push_back( std::unique_ptr< object_type > object ) {
+          items_.push_back( { adopt( std::move( object ) ) , 0 } ) ;
+        }
+
+        /**
+         * \brief Takes ownership of the quantum object `object` without adding
+         *        it to this schedule and returns a pointer to it.
+         */
+        const object_type* adopt( std::unique_ptr< object_type > object ) {
+          assert( object ) ;
+          owned_.push_back( std::move( object ) ) ;
+          return owned_.back().get() ;
+        }
+
+        /// Returns the item at position `pos` of this schedule.
+        const Item& operator[]( const size_type pos ) const {
+          assert( pos < items_.size() ) ;
+          return items_[ pos ] ;
+        }
+
+        /// Returns a const iterator to the beginning of this schedule.
+        const_iterator begin() const { return items_.begin() ; }
+
+        /// Returns a const iterator to the end of this schedule.
+        const_iterator end() const { return items_.end() ; }
+
+        /// Returns the number of items of this schedule.
+        size_type size() const { return items_.size() ; }
+
+        /// Checks if this schedule is empty.
+        bool empty() const { return items_.empty() ; }
+
+        /**
+         * \brief Replaces the items of this schedule by `items`. Owned
+         *        quantum objects are kept alive, such that `items` can still
+         *        refer to them.
+         */
+        void assign( vector_type&& items ) { items_ = std::move( items ) ; }
+
+        /// Applies this schedule to the given vector `vector`.
+        void apply( const int nbQubits , std::vector< T >& vector ) const {
+          for ( const auto& item : items_ ) {
+            parallel::call( item.object->teamAware() , [&] () {
+              item.object->apply( Op::NoTrans , nbQubits , vector ,
+                                  item.offset ) ;
+            } ) ;
+          }
+        }
+
+        /**
+         * \brief Applies this schedule to the given vector `vector` with the
+         *        classical register `creg` of its dynamic objects.
+         */
+        void apply( const int nbQubits , std::vector< T >& vector ,
+                    qclab::ClassicalRegister& creg ) const {
+          for ( const auto& item : items_ ) {
+            parallel::call( item.object->teamAware() , [&] () {
+              item.object->apply( nbQubits , vector , creg , item.offset ) ;
+            } ) ;
+          }
+        }
+
+        /// Applies this schedule to the given state vector `state`.
+        void apply( const int nbQubits ,
+                    qclab::StateVector< T >& state ) const {
+          for ( const auto& item : items_ ) {
+            parallel::call( item.object->teamAware() , [&] () {
+              item.object->apply( Op::NoTrans , nbQubits , state ,
+                                  item.offset ) ;
+            } ) ;
+          }
+        }
+
+      private:
+        /// Items of this schedule.
+        vector_type  items_ ;
+        /// Quantum objects owned by this schedule.
+        std::vector< std::unique_ptr< object_type > >  owned_ ;
+
+    } ; // class Schedule
+
+  } // namespace sim
+
+} // namespace qclab
@@ -0,0 +1,348 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/RotationYY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/Phase.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/CRotationX.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/CRotationZ.hpp"
+#include "qclab/parallel.hpp"
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace qclab {
+
+  namespace sim {
+
+    /**
+     * \class Sweep
+     * \brief Parameter-sweep engine that simulates a parametrized quantum
+     *        circuit for many sets of parameters.
+     *
+     * The parameters of the sweep are the angles \f$\theta\f$ of the
+     * variable gates of the circuit, in the order of the flattened circuit.
+     * Supported variable gates are the rotation gates RotationX, RotationY,
+     * RotationZ, RotationXX, RotationYY, RotationZZ, CRotationX, CRotationY,
+     * CRotationZ, and the phase gates Phase and CPhase.
+     *
+     * The gates of the circuit are never modified: every thread updates its
+     * own copies of the variable gates. The prefix of fixed gates before the
+     * first variable gate is simulated once per sweep and shared by all
+     * parameter sets. Small states are simulated concurrently, one parameter
+     * set per thread, while states large enough to keep all threads busy
+     * are simulated one after the other with all threads.
+     *
+     * The circuit must outlive the sweep. The constructor throws an
+     * std::invalid_argument if the circuit holds any other variable gate.
+     */
+    template <typename T>
+    class Sweep
+    {
+
+      public:
+        /// Real value type of this sweep.
+        using real_type   = qclab::real_t< T > ;
+        /// Quantum object type of this sweep.
+        using object_type = qclab::QObject< T > ;
+
+        /// Constructs a parameter sweep for the quantum circuit `circuit`.
+        Sweep( const qclab::QCircuit< T >& circuit )
+        : nbQubits_( circuit.nbQubits() )
+        {
+          circuit.flatten( schedule_ ) ;
+          prefix_ = schedule_.size() ;
+          for ( size_t i = 0; i < schedule_.size(); i++ ) {
+            const auto& item = schedule_[i] ;
+            if ( item.object->fixed() ) continue ;
+            prefix_ = std::min( prefix_ , i ) ;
+            Parameter parameter = { i , nullptr , nullptr , nullptr } ;
+            const bool found =
+              bind< qgates::RotationX< T > >( item.object , parameter ) ||
+              bind< qgates::RotationY< T > >( item.object , parameter ) ||
+              bind< qgates::RotationZ< T > >( item.object , parameter ) ||
+              bind< qgates::RotationXX< T > >( item.object , parameter ) ||
+              bind< qgates::RotationYY< T > >( item.object , parameter ) ||
+              bind< qgates::RotationZZ< T > >( item.object , parameter ) ||
+              bind< qgates::Phase< T > >( item.object , parameter ) ||
+              bindControlled< qgates::CRotationX< T > >( item.object ,
+                                                         parameter ) ||
+              bindControlled< qgates::CRotationY< T > >( item.object ,
+                                                         parameter ) ||
+              bindControlled< qgates::CRotationZ< T > >( item.object ,
+                                                         parameter ) ||
+              bindControlled< qgates::CPhase< T > >( item.object ,
+                                                     parameter ) ;
+            if ( !found ) {
+              throw std::invalid_argument( "unsupported variable gate" ) ;
+            }
+            parameters_.push_back( parameter ) ;
+          }
+        } // Sweep(circuit)
+
+        /// Returns the number of qubits of this sweep.
+        inline int nbQubits() const { return nbQubits_ ; }
+
+        /// Returns the number of parameters of this sweep.
+        inline int nbParameters() const { return parameters_.size() ; }
+
+        /// Returns the current parameters of the circuit of this sweep.
+        std::vector< real_type > parameters() const {
+          std::vector< real_type > thetas ;
+          thetas.reserve( parameters_.size() ) ;
+          for ( const auto& parameter : parameters_ ) {
+            thetas.push_back( parameter.theta(
+                                    schedule_[ parameter.item ].object ) ) ;
+          }
+          return thetas ;
+        }
+
+        /**
+         * \brief Simulates the circuit of this sweep for the initial vector
+         *        `initial` and every parameter set of `parameters`, and
+         *        stores the final vectors in `vectors`. Vectors of `vectors`
+         *        that already have the right size are reused.
+         */
+        void simulate( const std::vector< T >& initial ,
+                       const std::vector< std::vector< real_type > >&
+                         parameters ,
+                       std::vector< std::vector< T > >& vectors ) const {
+          vectors.resize( parameters.size() ) ;
+          runSets( initial , parameters , [&] ( const size_t set ,
+                                                const int ) ->
+                                              std::vector< T >& {
+            return vectors[ set ] ;
+          } , [] ( const size_t , const std::vector< T >& ) {} ) ;
+        }
+
+        /**
+         * \brief Simulates the circuit of this sweep for the initial vector
+         *        `initial` and every parameter set of `parameters`, and calls
+         *        `f( set , vector )` with the final vector `vector` of every
+         *        parameter set `set`.
+         *
+         * Every thread reuses a single work vector for all its parameter
+         * sets, such that the memory use does not grow with the number of
+         * parameter sets. Calls of `f` for different parameter sets may run
+         * concurrently.
+         */
+        template <typename F>
+        void run( const std::vector< T >& initial ,
+                  const std::vector< std::vector< real_type > >& parameters ,
+                  F&& f ) const {
+          std::vector< std::vector< T > > buffers(
+                                          nbTeamThreads( parameters.size() ) ) ;
+          runSets( initial , parameters , [&] ( const size_t ,
+                                                const int thread ) ->
+                                              std::vector< T >& {
+            return buffers[ thread ] ;
+          } , f ) ;
+        }
+
+      private:
+        /// Variable gate of the schedule bound to a parameter.
+        struct Parameter {
+          /// Position of the variable gate in the schedule.
+          size_t  item ;
+          /// Returns a variable copy of the gate.
+          std::unique_ptr< object_type > (*copy)( const object_type* ) ;
+          /// Updates the copy of the gate with the given angle.
+          void (*update)( object_type* , const real_type ) ;
+          /// Returns the angle of the gate.
+          real_type (*theta)( const object_type* ) ;
+        } ;
+
+        /// Binds the parameter `parameter` to `object` if it is of type `G`.
+        template <typename G>
+        static bool bind( const object_type* object , Parameter& parameter ) {
+          if ( dynamic_cast< const G* >( object ) == nullptr ) return false ;
+          parameter.copy = [] ( const object_type* gate ) ->
+                             std::unique_ptr< object_type > {
+            return std::make_unique< G >( *static_cast< const G* >( gate ) ) ;
+          } ;
+          parameter.update = [] ( object_type* gate , const real_type theta ) {
+            static_cast< G* >( gate )->update( theta ) ;
+          } ;
+          parameter.theta = [] ( const object_type* gate ) {
+            return static_cast< const G* >( gate )->theta() ;
+          } ;
+          return true ;
+        }
+
+        /**
+         * \brief Binds the parameter `parameter` to `object` if it is of the
+         *        controlled gate type `G`.
+         */
+        template <typename G>
+        static bool bindControlled( const object_type* object ,
+                                    Parameter& parameter ) {
+          if ( dynamic_cast< const G* >( object ) == nullptr ) return false ;
+          parameter.copy = [] ( const object_type* gate ) ->
+                             std::unique_ptr< object_type > {
+            const G* g = static_cast< const G* >( gate ) ;
+            return std::make_unique< G >( g->control() , g->target() ,
+                                          g->theta() , g->controlState() ) ;
+          } ;
+          parameter.update = [] ( object_type* gate , const real_type theta ) {
+            static_cast< G* >( gate )->update( theta ) ;
+          } ;
+          parameter.theta = [] ( const object_type* gate ) {
+            return static_cast< const G* >( gate )->theta() ;
+          } ;
+          return true ;
+        }
+
+        /**
+         * \brief Updates the variable gates `gates` with the parameter set
+         *        `parameters` and resizes `vector` to the size of `prefix`.
+         */
+        void prepareSet( const std::vector< T >& prefix ,
+                         const std::vector< real_type >& parameters ,
+                         std::vector< std::unique_ptr< object_type > >& gates ,
+                         std::vector< T >& vector ) const {
+          assert( parameters.size() == parameters_.size() ) ;
+          for ( size_t p = 0; p < parameters_.size(); p++ ) {
+            parameters_[p].update( gates[p].get() , parameters[p] ) ;
+          }
+          if ( vector.size() != prefix.size() ) {
+            vector.resize( prefix.size() ) ;
+          }
+        }
+
+        /**
+         * \brief Simulates the gates after the prefix starting from the
+         *        vector `prefix` into `vector`, with the variable gates
+         *        `gates`, see prepareSet.
+         */
+        void simulateSet( const std::vector< T >& prefix ,
+                          const std::vector< std::unique_ptr< object_type > >&
+                            gates ,
+                          std::vector< T >& vector ) const {
+          parallel::forRange( prefix.size() , [&] ( const int64_t begin ,
+                                                    const int64_t end ) {
+            std::copy( prefix.begin() + begin , prefix.begin() + end ,
+                       vector.begin() + begin ) ;
+          } ) ;
+          size_t p = 0 ;
+          for ( size_t i = prefix_; i < schedule_.size(); i++ ) {
+            const auto& item = schedule_[i] ;
+            const object_type* object = item.object ;
+            if ( ( p < parameters_.size() ) && ( parameters_[p].item == i ) ) {
+              object = gates[p++].get() ;
+            }
+            parallel::call( object->teamAware() , [&] () {
+              object->apply( Op::NoTrans , nbQubits_ , vector , item.offset ) ;
+            } ) ;
+          }
+        }
+
+        /// Returns variable copies of the gates bound to the parameters.
+        std::vector< std::unique_ptr< object_type > > copyGates() const {
+          std::vector< std::unique_ptr< object_type > > gates ;
+          gates.reserve( parameters_.size() ) ;
+          for ( const auto& parameter : parameters_ ) {
+            gates.push_back( parameter.copy(
+                                  schedule_[ parameter.item ].object ) ) ;
+          }
+          return gates ;
+        }
+
+        /**
+         * \brief Returns the number of threads of the team that simulates
+         *        `nbSets` parameter sets concurrently, or 1 if the parameter
+         *        sets are simulated one after the other, see runSets.
+         */
+        int nbTeamThreads( const int64_t nbSets ) const {
+        #ifdef _OPENMP
+          const int maxThreads = omp_in_parallel() ? 1 : omp_get_max_threads() ;
+        #else
+          const int maxThreads = 1 ;
+        #endif
+          const int64_t size = int64_t(1) << nbQubits_ ;
+          const int t = std::min< int64_t >( maxThreads , nbSets ) ;
+          if ( ( t <= 1 ) || ( parallel::nbThreads( size ) == maxThreads ) ) {
+            return 1 ;
+          }
+          return t ;
+        }
+
+        /**
+         * \brief Simulates all parameter sets of `parameters` for the initial
+         *        vector `initial`. The final vector of parameter set `set`,
+         *        simulated by the thread `thread` of a team of
+         *        `nbTeamThreads( parameters.size() )` threads, is stored in
+         *        `vector( set , thread )` and passed to `f( set , vector )`.
+         */
+        template <typename V, typename F>
+        void runSets( const std::vector< T >& initial ,
+                      const std::vector< std::vector< real_type > >&
+                        parameters ,
+                      V&& vector , F&& f ) const {
+          const int64_t size = int64_t(1) << nbQubits_ ;
+          assert( initial.size() == size ) ;
+          const int64_t nbSets = parameters.size() ;
+          if ( nbSets == 0 ) return ;
+          // shared prefix of fixed gates
+          std::vector< T > prefix( initial ) ;
+          parallel::run( size , [&] () {
+            for ( size_t i = 0; i < prefix_; i++ ) {
+              const auto& item = schedule_[i] ;
+              parallel::call( item.object->teamAware() , [&] () {
+                item.object->apply( Op::NoTrans , nbQubits_ , prefix ,
+                                    item.offset ) ;
+              } ) ;
+            }
+          } ) ;
+          // parallel within a state
+          const int t = nbTeamThreads( nbSets ) ;
+          if ( t == 1 ) {
+            auto gates = copyGates() ;
+            for ( int64_t set = 0; set < nbSets; set++ ) {
+              auto& v = vector( set , 0 ) ;
+              prepareSet( prefix , parameters[ set ] , gates , v ) ;
+              parallel::run( size , [&] () {
+                simulateSet( prefix , gates , v ) ;
+              } ) ;
+              f( set , static_cast< const std::vector< T >& >( v ) ) ;
+            }
+            return ;
+          }
+          // parallel over the parameter sets
+        #ifdef _OPENMP
+          #pragma omp parallel num_threads( t )
+          {
+            const int thread = omp_get_thread_num() ;
+            auto gates = copyGates() ;
+            #pragma omp for schedule( dynamic )
+            for ( int64_t set = 0; set < nbSets; set++ ) {
+              auto& v = vector( set , thread ) ;
+              prepareSet( prefix , parameters[ set ] , gates , v ) ;
+              simulateSet( prefix , gates , v ) ;
+              f( set , static_cast< const std::vector< T >& >( v ) ) ;
+            }
+          }
+        #endif
+        }
+
+        /// Number of qubits of this sweep.
+        int                       nbQubits_ ;
+        /// Flattened circuit of this sweep.
+        Schedule< T >             schedule_ ;
+        /// Number of fixed gates before the first variable gate.
+        size_t                    prefix_ ;
+        /// Variable gates of the schedule, in order.
+        std::vector< Parameter >  parameters_ ;
+
+    } ; // class Sweep
+
+  } // namespace sim
+
+} // namespace qclab
@@ -0,0 +1,251 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/sim/Schedule.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/RotationYY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/Phase.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/CRotationX.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/CRotationZ.hpp"
+#include "qclab/parallel.hpp"
+#include <bitset>
+#include <vector>
+
+namespace qclab {
+
+  namespace sim {
+
+    /**
+     * \struct Generator
+     * \brief Generator of a variable gate G(\f$\theta\f$), i.e., the operator
+     *        H with \f$\partial G / \partial \theta = H G\f$.
+     *
+     * The generator is `factor` times the Pauli string \f$X^x Z^z\f$, with
+     * bit masks `xMask` and `zMask`, restricted to the amplitudes whose
+     * `controlMask` bits equal `controlValue`.
+     */
+    template <typename T>
+    struct Generator
+    {
+      /// Bits of the control qubits and projectors.
+      uint64_t  controlMask = 0 ;
+      /// Values of the bits of the control qubits and projectors.
+      uint64_t  controlValue = 0 ;
+      /// Bits flipped by the Pauli string.
+      uint64_t  xMask = 0 ;
+      /// Bits with a phase -1 in the Pauli string.
+      uint64_t  zMask = 0 ;
+      /// Scalar factor of the generator.
+      T         factor = 0 ;
+    } ; // struct Generator
+
+    /**
+     * \brief Computes the generator `generator` of the variable gate `object`
+     *        with qubit offset `offset` on `nbQubits` qubits. Returns false if
+     *        `object` is not a supported variable gate.
+     *
+     * Supported are the rotation gates RotationX, RotationY, RotationZ,
+     * RotationXX, RotationYY, RotationZZ, CRotationX, CRotationY, CRotationZ,
+     * and the phase gates Phase and CPhase.
+     */
+    template <typename T>
+    bool generator( const qclab::QObject< T >* object , const int nbQubits ,
+                    const int offset , Generator< T >& generator ) {
+      using namespace qgates ;
+      auto bit = [&] ( const int qubit ) {
+        return uint64_t(1) << ( nbQubits - qubit - offset - 1 ) ;
+      } ;
+      auto control = [&] ( const int qubit , const int state ) {
+        generator.controlMask |= bit( qubit ) ;
+        if ( state ) generator.controlValue |= bit( qubit ) ;
+      } ;
+      // exp( -i theta/2 P ) with P = i^nY X^x Z^z
+      int nbY = 0 ;
+      auto pauli = [&] ( const int qubit , const char p ) {
+        if ( p != 'Z' ) generator.xMask |= bit( qubit ) ;
+        if ( p != 'X' ) generator.zMask |= bit( qubit ) ;
+        if ( p == 'Y' ) nbY++ ;
+      } ;
+      generator = Generator< T >() ;
+      if ( auto g = dynamic_cast< const RotationX< T >* >( object ) ) {
+        pauli( g->qubit() , 'X' ) ;
+      } else if ( auto g = dynamic_cast< const RotationY< T >* >( object ) ) {
+        pauli( g->qubit() , 'Y' ) ;
+      } else if ( auto g = dynamic_cast< const RotationZ< T >* >( object ) ) {
+        pauli( g->qubit() , 'Z' ) ;
+      } else if ( auto g = dynamic_cast< const RotationXX< T >* >( object ) ) {
+        for ( const int q : g->qubits() ) pauli( q , 'X' ) ;
+      } else if ( auto g = dynamic_cast< const RotationYY< T >* >( object ) ) {
+        for ( const int q : g->qubits() ) pauli( q , 'Y' ) ;
+      } else if ( auto g = dynamic_cast< const RotationZZ< T >* >( object ) ) {
+        for ( const int q : g->qubits() ) pauli( q , 'Z' ) ;
+      } else if ( auto g = dynamic_cast< const CRotationX< T >* >( object ) ) {
+        control( g->control() , g->controlState() ) ;
+        pauli( g->target() , 'X' ) ;
+      } else if ( auto g = dynamic_cast< const CRotationY< T >* >( object ) ) {
+        control( g->control() , g->controlState() ) ;
+        pauli( g->target() , 'Y' ) ;
+      } else if ( auto g = dynamic_cast< const CRotationZ< T >* >( object ) ) {
+        control( g->control() , g->controlState() ) ;
+        pauli( g->target() , 'Z' ) ;
+      } else if ( auto g = dynamic_cast< const Phase< T >* >( object ) ) {
+        // diag( 1 , exp( i theta ) )
+        control( g->qubit() , 1 ) ;
+        generator.factor = T(0,1) ;
+        return true ;
+      } else if ( auto g = dynamic_cast< const CPhase< T >* >( object ) ) {
+        control( g->control() , g->controlState() ) ;
+        control( g->target() , 1 ) ;
+        generator.factor = T(0,1) ;
+        return true ;
+      } else {
+        return false ;
+      }
+      const T powY[4] = { T(1) , T(0,1) , T(-1) , T(0,-1) } ;
+      generator.factor = T(0,-0.5) * powY[ nbY % 4 ] ;
+      return true ;
+    }
+
+    /**
+     * \brief Computes \f$\langle \lambda | H | \psi \rangle\f$ for the
+     *        generator H = `generator` and the vectors `lambda` and `psi`.
+     *        The partial sum of every thread is stored in `partials`.
+     */
+    template <typename T>
+    void dotGenerator( const Generator< T >& generator ,
+                       const std::vector< T >& lambda ,
+                       const std::vector< T >& psi , T* partials ) {
+      const uint64_t cm = generator.controlMask ;
+      const uint64_t cv = generator.controlValue ;
+      const uint64_t x  = generator.xMask ;
+      const uint64_t z  = generator.zMask ;
+      parallel::forRange( psi.size() , [&] ( const int64_t begin ,
+                                             const int64_t end ) {
+        T sum = 0 ;
+        for ( int64_t i = begin; i < end; i++ ) {
+          if ( ( i & cm ) != cv ) continue ;
+          const uint64_t j = i ^ x ;
+          const T term = std::conj( lambda[i] ) * psi[j] ;
+          if ( std::bitset< 64 >( j & z ).count() & 1 ) {
+            sum -= term ;
+          } else {
+            sum += term ;
+          }
+        }
+      #ifdef _OPENMP
+        partials[ omp_get_thread_num() ] = sum ;
+      #else
+        partials[0] = sum ;
+      #endif
+      } ) ;
+    }
+
+    /**
+     * \brief Computes the expectation value of the observable `observable`
+     *        for the vector `vector` after the schedule `schedule`, and its
+     *        gradient `gradient` with respect to the angles of the variable
+     *        gates of `schedule`, in order, by adjoint differentiation.
+     *
+     * The observable is a Hermitian quantum object, e.g., a circuit of Pauli
+     * gates, or a PauliSum. It is applied outside the persistent team of the
+     * forward and backward passes.
+     *
+     * On entry, `vector` holds the initial vector of `nbQubits` qubits. On
+     * exit, it holds the initial vector again, up to rounding errors. The
+     * schedule is applied once forward and twice backward, with
+     * Op::ConjTrans, for the vector and the adjoint vector, and the gradient
+     * of every variable gate costs a single sweep over both vectors.
+     */
+    template <typename T, typename O>
+    qclab::real_t< T > adjoint( const Schedule< T >& schedule ,
+                                const int nbQubits , const O& observable ,
+                                std::vector< T >& vector ,
+                                std::vector< qclab::real_t< T > >& gradient ) {
+      using R = qclab::real_t< T > ;
+      const int64_t size = int64_t(1) << nbQubits ;
+      assert( vector.size() == size ) ;
+    #ifdef _OPENMP
+      const int nbThreads = omp_get_max_threads() ;
+    #else
+      const int nbThreads = 1 ;
+    #endif
+      // generators of the variable gates
+      std::vector< Generator< T > > generators ;
+      std::vector< bool > variable( schedule.size() , false ) ;
+      for ( size_t i = 0; i < schedule.size(); i++ ) {
+        const auto& item = schedule[i] ;
+        if ( item.object->fixed() ) continue ;
+        Generator< T > g ;
+        variable[i] = generator( item.object , nbQubits , item.offset , g ) ;
+        assert( variable[i] ) ;
+        if ( variable[i] ) generators.push_back( g ) ;
+      }
+      const size_t nbParameters = generators.size() ;
+      std::vector< T > partials( ( nbParameters + 1 ) * nbThreads , T(0) ) ;
+      std::vector< T > lambda( size ) ;
+      parallel::run( size , [&] () {
+        // forward
+        schedule.apply( nbQubits , vector ) ;
+        parallel::forRange( size , [&] ( const int64_t begin ,
+                                         const int64_t end ) {
+          std::copy( vector.begin() + begin , vector.begin() + end ,
+                     lambda.begin() + begin ) ;
+        } ) ;
+      } ) ;
+      observable.apply( Op::NoTrans , nbQubits , lambda ) ;
+      parallel::run( size , [&] () {
+        // expectation value
+        parallel::forRange( size , [&] ( const int64_t begin ,
+                                         const int64_t end ) {
+          T sum = 0 ;
+          for ( int64_t i = begin; i < end; i++ ) {
+            sum += std::conj( vector[i] ) * lambda[i] ;
+          }
+        #ifdef _OPENMP
+          partials[ nbParameters * nbThreads + omp_get_thread_num() ] = sum ;
+        #else
+          partials[ nbParameters * nbThreads ] = sum ;
+        #endif
+        } ) ;
+        // backward
+        size_t p = nbParameters ;
+        for ( size_t i = schedule.size(); i-- > 0; ) {
+          const auto& item = schedule[i] ;
+          if ( variable[i] ) {
+            --p ;
+            dotGenerator( generators[p] , lambda , vector ,
+                          partials.data() + p * nbThreads ) ;
+          }
+          parallel::call( item.object->teamAware() , [&] () {
+            item.object->apply( Op::ConjTrans , nbQubits , vector ,
+                                item.offset ) ;
+            item.object->apply( Op::ConjTrans , nbQubits , lambda ,
+                                item.offset ) ;
+          } ) ;
+        }
+      } ) ;
+      gradient.assign( nbParameters , R(0) ) ;
+      for ( size_t p = 0; p < nbParameters; p++ ) {
+        T dot = 0 ;
+        for ( int t = 0; t < nbThreads; t++ ) {
+          dot += partials[ p * nbThreads + t ] ;
+        }
+        gradient[p] = 2 * std::real( generators[p].factor * dot ) ;
+      }
+      T expectation = 0 ;
+      for ( int t = 0; t < nbThreads; t++ ) {
+        expectation += partials[ nbParameters * nbThreads + t ] ;
+      }
+      return std::real( expectation ) ;
+    }
+
+  } // namespace sim
+
+} // namespace qclab
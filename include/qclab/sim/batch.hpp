@@ -0,0 +1,88 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/parallel.hpp"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace qclab {
+
+  namespace sim {
+
+    /**
+     * \brief Returns the number of batch qubits needed to store a batch of
+     *        `batchSize` vectors, i.e., the smallest k with 2^k >= `batchSize`.
+     */
+    inline int batchQubits( const int64_t batchSize ) {
+      assert( batchSize > 0 ) ;
+      int k = 0 ;
+      while ( ( int64_t(1) << k ) < batchSize ) k++ ;
+      return k ;
+    }
+
+    /**
+     * \brief Maximum number of qubits of a packed batch, including the batch
+     *        qubits, that is simulated at once by QCircuit::simulate. Larger
+     *        batches are split, such that every packed batch stays in cache.
+     */
+    constexpr int maxBatchQubits = 16 ;
+
+    /**
+     * \brief Packs the `nbVectors` vectors `vectors` of `nbQubits` qubits into
+     *        the vector `batch` in a batch-innermost layout.
+     *
+     * Amplitude i of vector b is stored at position i * 2^k + b of `batch`,
+     * with k = batchQubits( `nbVectors` ). Hence, the batch behaves as a
+     * single vector of `nbQubits` + k qubits in which the k least significant
+     * qubits index the vectors, such that every gate acting on the first
+     * `nbQubits` qubits is applied to all vectors at once, with contiguous
+     * inner loops over the batch. The 2^k - `nbVectors` padding vectors are
+     * zero.
+     */
+    template <typename T>
+    void pack( const int nbQubits , const int64_t nbVectors ,
+               const std::vector< T >* vectors , std::vector< T >& batch ) {
+      const int64_t size = int64_t(1) << nbQubits ;
+      const int64_t nb = nbVectors ;
+      const int64_t stride = int64_t(1) << batchQubits( nb ) ;
+      batch.resize( size * stride ) ;
+      for ( int64_t b = 0; b < nb; b++ ) {
+        assert( vectors[b].size() == size ) ;
+      }
+      parallel::forRange( size , [&] ( const int64_t begin ,
+                                       const int64_t end ) {
+        for ( int64_t i = begin; i < end; i++ ) {
+          T* row = batch.data() + i * stride ;
+          for ( int64_t b = 0; b < nb; b++ ) row[b] = vectors[b][i] ;
+          for ( int64_t b = nb; b < stride; b++ ) row[b] = 0 ;
+        }
+      } , stride ) ;
+    }
+
+    /**
+     * \brief Unpacks the vector `batch` of `nbQubits` qubits in a
+     *        batch-innermost layout into the `nbVectors` vectors `vectors`,
+     *        see pack.
+     */
+    template <typename T>
+    void unpack( const int nbQubits , const std::vector< T >& batch ,
+                 const int64_t nbVectors , std::vector< T >* vectors ) {
+      const int64_t size = int64_t(1) << nbQubits ;
+      const int64_t nb = nbVectors ;
+      const int64_t stride = int64_t(1) << batchQubits( nb ) ;
+      assert( batch.size() == size * stride ) ;
+      for ( int64_t b = 0; b < nb; b++ ) vectors[b].resize( size ) ;
+      parallel::forRange( size , [&] ( const int64_t begin ,
+                                       const int64_t end ) {
+        for ( int64_t i = begin; i < end; i++ ) {
+          const T* row = batch.data() + i * stride ;
+          for ( int64_t b = 0; b < nb; b++ ) vectors[b][i] = row[b] ;
+        }
+      } , stride ) ;
+    }
+
+  } // namespace sim
+
+} // namespace qclab
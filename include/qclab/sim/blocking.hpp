@@ -0,0 +1,100 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/sim/Schedule.hpp"
+#include "qclab/parallel.hpp"
+#include <algorithm>
+
+namespace qclab {
+
+  namespace sim {
+
+    /**
+     * \brief Checks if the item `item` only acts on the local qubits of a
+     *        simulation of `nbQubits` qubits with blocks of `blockQubits`
+     *        qubits, i.e., the `blockQubits` least significant qubits.
+     */
+    template <typename T>
+    bool isLocal( const typename Schedule< T >::Item& item ,
+                  const int nbQubits , const int blockQubits ) {
+      const auto qubits = item.object->qubits() ;
+      const int first = *std::min_element( qubits.begin() , qubits.end() ) ;
+      return ( first + item.offset >= nbQubits - blockQubits ) ;
+    }
+
+    /**
+     * \brief Applies the items [`first`, `last`) of a schedule to the given
+     *        vector `vector` block by block.
+     *
+     * The vector is split into blocks of 2^`blockQubits` consecutive
+     * amplitudes and all items must act on local qubits only. Every block is
+     * copied into a thread private buffer, all items are applied to the
+     * buffer and the result is copied back, such that the vector is only
+     * streamed once through the memory hierarchy for all items. The blocks
+     * are distributed over the OpenMP threads, or over the threads of the
+     * persistent team of a simulation (see qclab::parallel::run), and the
+     * items are applied serially to every block.
+     */
+    template <typename T, typename Iterator>
+    void applyBlocked( Iterator first , Iterator last , const int nbQubits ,
+                       std::vector< T >& vector , const int blockQubits ) {
+      assert( blockQubits < nbQubits ) ;
+      const int64_t nbBlocks  = int64_t(1) << ( nbQubits - blockQubits ) ;
+      const int64_t blockSize = int64_t(1) << blockQubits ;
+      const int shift = nbQubits - blockQubits ;
+      qclab::parallel::forRange( nbBlocks , [&] ( const int64_t begin ,
+                                                  const int64_t end ) {
+        std::vector< T > buffer( blockSize ) ;
+        for ( int64_t b = begin; b < end; b++ ) {
+          auto data = vector.begin() + b * blockSize ;
+          std::copy( data , data + blockSize , buffer.begin() ) ;
+          for ( auto it = first; it != last; ++it ) {
+            it->object->apply( Op::NoTrans , blockQubits , buffer ,
+                               it->offset - shift ) ;
+          }
+          std::copy( buffer.begin() , buffer.end() , data ) ;
+        }
+      } , blockSize ) ;
+    }
+
+    /**
+     * \brief Applies the schedule `schedule` to the given vector `vector`
+     *        with cache blocking on the `blockQubits` least significant
+     *        qubits.
+     *
+     * Runs of consecutive items acting on local qubits only are applied
+     * block by block with applyBlocked, all other items are applied to the
+     * full vector.
+     */
+    template <typename T>
+    void applyBlocked( const Schedule< T >& schedule , const int nbQubits ,
+                       std::vector< T >& vector , const int blockQubits ) {
+      assert( blockQubits < nbQubits ) ;
+      auto it = schedule.begin() ;
+      while ( it != schedule.end() ) {
+        // run of local items
+        auto last = it ;
+        while ( ( last != schedule.end() ) &&
+                isLocal< T >( *last , nbQubits , blockQubits ) ) {
+          ++last ;
+        }
+        if ( last - it > 1 ) {
+          applyBlocked( it , last , nbQubits , vector , blockQubits ) ;
+          it = last ;
+        } else {
+          // single local item or non-local item
+          if ( last == it ) ++last ;
+          for ( ; it != last; ++it ) {
+            parallel::call( it->object->teamAware() , [&] () {
+              it->object->apply( Op::NoTrans , nbQubits , vector ,
+                                 it->offset ) ;
+            } ) ;
+          }
+        }
+      }
+    }
+
+  } // namespace sim
+
+} // namespace qclab
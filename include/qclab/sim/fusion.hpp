@@ -0,0 +1,423 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/sim/Schedule.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/DiagonalGate.hpp"
+#include "qclab/qgates/MonomialGate.hpp"
+#include <algorithm>
+
+namespace qclab {
+
+  namespace sim {
+
+    /**
+     * \brief Fuses the runs of 1-qubit gates acting on the same qubit in the
+     *        schedule `schedule` into 1-qubit matrix gates.
+     *
+     * A run is ended by the first multi-qubit object acting on its qubit.
+     * 1-qubit gates on different qubits commute, hence interleaved runs on
+     * different qubits are fused independently. Runs of a single gate keep
+     * the original gate and its specialized kernel.
+     */
+    template <typename T>
+    void fuse1( Schedule< T >& schedule ) {
+
+      using item_type = typename Schedule< T >::Item ;
+      using gate_type = qclab::qgates::MatrixGate1< T > ;
+
+      // pending run of 1-qubit gates on a qubit
+      struct Run {
+        int                           count = 0 ;
+        item_type                     first ;
+        std::unique_ptr< gate_type >  gate ;
+      } ;
+      std::vector< Run >  runs ;
+      typename Schedule< T >::vector_type  items ;
+      items.reserve( schedule.size() ) ;
+
+      // flushes the pending run on qubit `qubit`
+      auto flush = [&] ( const int qubit ) {
+        if ( qubit >= runs.size() ) return ;
+        Run& run = runs[qubit] ;
+        if ( run.count == 1 ) {
+          items.push_back( run.first ) ;
+        } else if ( run.count > 1 ) {
+          items.push_back( { schedule.adopt( std::move( run.gate ) ) , 0 } ) ;
+        }
+        run = Run() ;
+      } ;
+
+      // loop over items
+      for ( const auto& item : schedule ) {
+        if ( item.object->nbQubits() == 1 ) {
+          // 1-qubit gate: extend run
+          const int qubit = item.object->qubit() + item.offset ;
+          if ( qubit >= runs.size() ) runs.resize( qubit + 1 ) ;
+          Run& run = runs[qubit] ;
+          if ( run.count == 0 ) {
+            run.first = item ;
+          } else if ( run.count == 1 ) {
+            run.gate = std::make_unique< gate_type >( qubit ,
+                                                  run.first.object->matrix() ) ;
+            run.gate->leftMultiply( item.object->matrix() ) ;
+          } else {
+            run.gate->leftMultiply( item.object->matrix() ) ;
+          }
+          ++run.count ;
+        } else {
+          // multi-qubit object: flush runs on its qubits
+          for ( const int qubit : item.object->qubits() ) {
+            flush( qubit + item.offset ) ;
+          }
+          items.push_back( item ) ;
+        }
+      }
+
+      // flush remaining runs
+      for ( int qubit = 0; qubit < runs.size(); qubit++ ) {
+        flush( qubit ) ;
+      }
+      schedule.assign( std::move( items ) ) ;
+
+    } // fuse1
+
+    /**
+     * \brief Fuses the gates of the schedule `schedule` into dense blocks
+     *        acting on at most `maxQubits` qubits.
+     *
+     * The gates are grouped greedily: a gate joins the open blocks on its
+     * qubits if the merged block still acts on at most `maxQubits` qubits,
+     * otherwise these blocks are closed and the gate starts a new block.
+     * Open blocks always act on disjoint qubits, hence they commute and can be
+     * merged or emitted in any order. Every block of 2 or more gates is
+     * replaced by a single N-qubit matrix gate, such that one sweep over the
+     * vector performs the work of all gates in the block.
+     */
+    template <typename T>
+    void fuseK( Schedule< T >& schedule , const int maxQubits ) {
+
+      using item_type = typename Schedule< T >::Item ;
+      using gate_type = qclab::qgates::MatrixGateN< T > ;
+      assert( maxQubits >= 1 ) ;
+      assert( maxQubits <= gate_type::maxQubits ) ;
+
+      // block of gates
+      struct Block {
+        std::vector< int >        qubits ;  // ascending
+        std::vector< item_type >  items ;
+        bool                      open = true ;
+      } ;
+      std::vector< Block >  blocks ;
+      std::vector< int >    current ;  // open block on each qubit, -1 if none
+      typename Schedule< T >::vector_type  items ;
+      items.reserve( schedule.size() ) ;
+
+      // returns the absolute qubits of `item`
+      auto qubitsOf = [] ( const item_type& item ) {
+        auto qubits = item.object->qubits() ;
+        for ( auto& qubit : qubits ) { qubit += item.offset ; }
+        return qubits ;
+      } ;
+
+      // emits block `b`
+      auto emit = [&] ( const int b ) {
+        Block& block = blocks[b] ;
+        assert( block.open ) ;
+        for ( const int qubit : block.qubits ) { current[qubit] = -1 ; }
+        block.open = false ;
+        if ( block.items.size() == 1 ) {
+          items.push_back( block.items[0] ) ;
+          return ;
+        }
+        // dense matrix of the block
+        const int m = block.qubits.size() ;
+        auto mat = qclab::dense::eye< T >( 1 << m ) ;
+        for ( const auto& item : block.items ) {
+          auto local = qubitsOf( item ) ;
+          for ( auto& qubit : local ) {
+            qubit = std::lower_bound( block.qubits.begin() ,
+                                      block.qubits.end() , qubit ) -
+                    block.qubits.begin() ;
+          }
+          gate_type gate( local , item.object->matrix() ) ;
+          gate.apply( Side::Right , Op::NoTrans , m , mat ) ;
+        }
+        auto gate = std::make_unique< gate_type >( block.qubits , mat ) ;
+        items.push_back( { schedule.adopt( std::move( gate ) ) , 0 } ) ;
+      } ;
+
+      // loop over items
+      for ( const auto& item : schedule ) {
+        const auto qubits = qubitsOf( item ) ;
+        if ( qubits.back() >= current.size() ) {
+          current.resize( qubits.back() + 1 , -1 ) ;
+        }
+        // open blocks on the qubits of this item
+        std::vector< int > open ;
+        for ( const int qubit : qubits ) {
+          const int b = current[qubit] ;
+          if ( ( b >= 0 ) &&
+               ( std::find( open.begin() , open.end() , b ) == open.end() ) ) {
+            open.push_back( b ) ;
+          }
+        }
+        std::sort( open.begin() , open.end() ) ;
+        // qubits of the merged block
+        std::vector< int > merged = qubits ;
+        for ( const int b : open ) {
+          merged.insert( merged.end() , blocks[b].qubits.begin() ,
+                                        blocks[b].qubits.end() ) ;
+        }
+        std::sort( merged.begin() , merged.end() ) ;
+        merged.erase( std::unique( merged.begin() , merged.end() ) ,
+                      merged.end() ) ;
+        if ( merged.size() <= maxQubits ) {
+          // merge open blocks and this item into a single block
+          int target ;
+          if ( open.empty() ) {
+            target = blocks.size() ;
+            blocks.emplace_back() ;
+          } else {
+            target = open[0] ;
+            for ( int i = 1; i < open.size(); i++ ) {
+              auto& other = blocks[ open[i] ].items ;
+              blocks[target].items.insert( blocks[target].items.end() ,
+                                           other.begin() , other.end() ) ;
+              blocks[ open[i] ].items.clear() ;
+              blocks[ open[i] ].open = false ;
+            }
+          }
+          blocks[target].qubits = merged ;
+          blocks[target].items.push_back( item ) ;
+          for ( const int qubit : merged ) { current[qubit] = target ; }
+        } else {
+          // close open blocks
+          for ( const int b : open ) { emit( b ) ; }
+          if ( qubits.size() <= maxQubits ) {
+            // start a new block
+            const int b = blocks.size() ;
+            for ( const int qubit : qubits ) { current[qubit] = b ; }
+            blocks.emplace_back() ;
+            blocks.back().qubits = qubits ;
+            blocks.back().items.push_back( item ) ;
+          } else {
+            // object too large to be fused
+            items.push_back( item ) ;
+          }
+        }
+      }
+
+      // emit remaining open blocks
+      for ( int b = 0; b < blocks.size(); b++ ) {
+        if ( blocks[b].open ) emit( b ) ;
+      }
+      schedule.assign( std::move( items ) ) ;
+
+    } // fuseK
+
+    /// Checks if `object` is a diagonal 1-qubit or 2-qubit gate.
+    template <typename T>
+    bool isDiagonal( const qclab::QObject< T >& object ) {
+      if ( object.nbQubits() > 2 ) return false ;
+      const auto mat = object.matrix() ;
+      for ( int64_t j = 0; j < mat.size(); j++ ) {
+        for ( int64_t i = 0; i < mat.size(); i++ ) {
+          if ( ( i != j ) && ( mat(i,j) != T(0) ) ) return false ;
+        }
+      }
+      return true ;
+    }
+
+    /**
+     * \brief Accumulates the runs of diagonal 1-qubit and 2-qubit gates in
+     *        the schedule `schedule` into diagonal gates.
+     *
+     * Diagonal gates commute with each other, hence a run collects diagonal
+     * gates on any qubits. A run is only ended by a non-diagonal object that
+     * acts on one of its qubits, non-diagonal objects on other qubits are
+     * moved in front of the run. Every run of 2 or more gates is replaced by
+     * a single diagonal gate, which is applied in one sweep over the vector.
+     * Runs of a single gate keep the original gate.
+     */
+    template <typename T>
+    void fuseDiagonal( Schedule< T >& schedule ) {
+
+      using item_type = typename Schedule< T >::Item ;
+      using gate_type = qclab::qgates::DiagonalGate< T > ;
+
+      // pending run of diagonal gates
+      std::vector< item_type >  run ;
+      std::vector< bool >       inRun ;  // qubits of the pending run
+      typename Schedule< T >::vector_type  items ;
+      items.reserve( schedule.size() ) ;
+
+      // returns the absolute qubits of `item`
+      auto qubitsOf = [] ( const item_type& item ) {
+        auto qubits = item.object->qubits() ;
+        for ( auto& qubit : qubits ) { qubit += item.offset ; }
+        return qubits ;
+      } ;
+
+      // flushes the pending run
+      auto flush = [&] () {
+        if ( run.size() == 1 ) {
+          items.push_back( run[0] ) ;
+        } else if ( run.size() > 1 ) {
+          auto gate = std::make_unique< gate_type >() ;
+          for ( const auto& item : run ) {
+            gate->multiply( qubitsOf( item ) , item.object->matrix() ) ;
+          }
+          items.push_back( { schedule.adopt( std::move( gate ) ) , 0 } ) ;
+        }
+        run.clear() ;
+        std::fill( inRun.begin() , inRun.end() , false ) ;
+      } ;
+
+      // loop over items
+      for ( const auto& item : schedule ) {
+        const auto qubits = qubitsOf( item ) ;
+        if ( qubits.back() >= inRun.size() ) {
+          inRun.resize( qubits.back() + 1 , false ) ;
+        }
+        if ( isDiagonal( *item.object ) ) {
+          // diagonal gate: extend run
+          run.push_back( item ) ;
+          for ( const int qubit : qubits ) { inRun[qubit] = true ; }
+        } else {
+          // other object: end run if it acts on one of its qubits
+          for ( const int qubit : qubits ) {
+            if ( inRun[qubit] ) {
+              flush() ;
+              break ;
+            }
+          }
+          items.push_back( item ) ;
+        }
+      }
+
+      // flush remaining run
+      flush() ;
+      schedule.assign( std::move( items ) ) ;
+
+    } // fuseDiagonal
+
+    /**
+     * \brief Checks if `object` is a monomial 1-qubit or 2-qubit gate, i.e.,
+     *        a gate that maps every basis state to a basis state with a
+     *        phase.
+     */
+    template <typename T>
+    bool isMonomial( const qclab::QObject< T >& object ) {
+      if ( object.nbQubits() > 2 ) return false ;
+      const auto mat = object.matrix() ;
+      std::vector< bool > used( mat.size() , false ) ;
+      for ( int64_t j = 0; j < mat.size(); j++ ) {
+        int nnz = 0 ;
+        for ( int64_t i = 0; i < mat.size(); i++ ) {
+          if ( mat(i,j) == T(0) ) continue ;
+          if ( used[i] ) return false ;
+          used[i] = true ;
+          nnz++ ;
+        }
+        if ( nnz != 1 ) return false ;
+      }
+      return true ;
+    }
+
+    /**
+     * \brief Accumulates the runs of monomial 1-qubit and 2-qubit gates in
+     *        the schedule `schedule` into monomial gates acting on at most
+     *        `maxQubits` qubits.
+     *
+     * Monomial gates, e.g., Pauli, CX, CZ, SWAP, iSWAP and phase gates, map
+     * basis states to basis states with a phase and a run of them is again
+     * monomial. A run is ended by a non-monomial object that acts on one of
+     * its qubits, non-monomial objects on other qubits are moved in front of
+     * the run, or by a gate that would extend the run beyond `maxQubits`
+     * qubits, which defaults to MonomialGate::maxQubits. Every run with 2 or
+     * more non-diagonal gates is replaced by a single monomial gate, which is
+     * applied in one sweep over the vector. Other runs keep their original
+     * gates, as the dedicated kernels of a single permutation are faster.
+     */
+    template <typename T>
+    void fuseMonomial( Schedule< T >& schedule , const int maxQubits =
+                         qclab::qgates::MonomialGate< T >::maxQubits ) {
+
+      using item_type = typename Schedule< T >::Item ;
+      using gate_type = qclab::qgates::MonomialGate< T > ;
+      assert( maxQubits >= 1 ) ;
+      assert( maxQubits <= gate_type::maxQubits ) ;
+
+      // pending run of monomial gates
+      std::vector< item_type >  run ;
+      std::vector< bool >       inRun ;  // qubits of the pending run
+      int                       nbRun = 0 ;
+      int                       nbMoving = 0 ;  // non-diagonal gates in run
+      typename Schedule< T >::vector_type  items ;
+      items.reserve( schedule.size() ) ;
+
+      // returns the absolute qubits of `item`
+      auto qubitsOf = [] ( const item_type& item ) {
+        auto qubits = item.object->qubits() ;
+        for ( auto& qubit : qubits ) { qubit += item.offset ; }
+        return qubits ;
+      } ;
+
+      // flushes the pending run
+      auto flush = [&] () {
+        if ( nbMoving < 2 ) {
+          items.insert( items.end() , run.begin() , run.end() ) ;
+        } else {
+          auto gate = std::make_unique< gate_type >() ;
+          for ( const auto& item : run ) {
+            gate->multiply( qubitsOf( item ) , item.object->matrix() ) ;
+          }
+          items.push_back( { schedule.adopt( std::move( gate ) ) , 0 } ) ;
+        }
+        run.clear() ;
+        std::fill( inRun.begin() , inRun.end() , false ) ;
+        nbRun = 0 ;
+        nbMoving = 0 ;
+      } ;
+
+      // loop over items
+      for ( const auto& item : schedule ) {
+        const auto qubits = qubitsOf( item ) ;
+        if ( qubits.back() >= inRun.size() ) {
+          inRun.resize( qubits.back() + 1 , false ) ;
+        }
+        if ( isMonomial( *item.object ) ) {
+          // monomial gate: extend run if it stays small enough
+          int added = 0 ;
+          for ( const int qubit : qubits ) { added += !inRun[qubit] ; }
+          if ( nbRun + added > maxQubits ) flush() ;
+          run.push_back( item ) ;
+          nbMoving += !isDiagonal( *item.object ) ;
+          for ( const int qubit : qubits ) {
+            nbRun += !inRun[qubit] ;
+            inRun[qubit] = true ;
+          }
+        } else {
+          // other object: end run if it acts on one of its qubits
+          for ( const int qubit : qubits ) {
+            if ( inRun[qubit] ) {
+              flush() ;
+              break ;
+            }
+          }
+          items.push_back( item ) ;
+        }
+      }
+
+      // flush remaining run
+      flush() ;
+      schedule.assign( std::move( items ) ) ;
+
+    } // fuseMonomial
+
+  } // namespace sim
+
+} // namespace qclab
@@ -0,0 +1,464 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/sim/Schedule.hpp"
+#include "qclab/sim/blocking.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/DiagonalGate.hpp"
+#include "qclab/qgates/MonomialGate.hpp"
+#include "qclab/qgates/MCX.hpp"
+#include "qclab/qgates/MCSWAP.hpp"
+#include "qclab/qgates/CX.hpp"
+#include "qclab/qgates/CY.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/CRotationX.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/CRotationZ.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/RotationYY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+#include "qclab/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+namespace qclab {
+
+  namespace sim {
+
+    /// Maximum number of qubit pairs interchanged by a single swapQubits.
+    constexpr int maxSwapPairs = 6 ;
+
+    /**
+     * \brief Interchanges the physical qubits `pairs[i].first` and
+     *        `pairs[i].second` of the vector `vector` for all pairs at once.
+     *
+     * The pairs must be disjoint. For k pairs, the contiguous runs of
+     * amplitudes that only differ in the 2k swapped bits form a 2^k x 2^k
+     * tile that is transposed in place, such that the vector is permuted in
+     * a single sweep.
+     */
+    template <typename T>
+    void swapQubits( const int nbQubits ,
+                     const std::vector< std::pair< int , int > >& pairs ,
+                     std::vector< T >& vector ) {
+      const int k = pairs.size() ;
+      assert( k <= maxSwapPairs ) ;
+      if ( k == 0 ) return ;
+      // offsets of the tile rows and columns
+      std::array< int , 2 * maxSwapPairs > pos ;
+      std::array< uint64_t , 1 << maxSwapPairs > oA , oB ;
+      for ( int i = 0; i < k; i++ ) {
+        assert( pairs[i].first != pairs[i].second ) ;
+        pos[2*i]     = nbQubits - pairs[i].first - 1 ;
+        pos[2*i + 1] = nbQubits - pairs[i].second - 1 ;
+      }
+      const int d = 1 << k ;
+      for ( int r = 0; r < d; r++ ) {
+        oA[r] = 0 ;
+        oB[r] = 0 ;
+        for ( int i = 0; i < k; i++ ) {
+          if ( ( r >> i ) & 1 ) {
+            oA[r] |= 1ULL << pos[2*i] ;
+            oB[r] |= 1ULL << pos[2*i + 1] ;
+          }
+        }
+      }
+      std::sort( pos.begin() , pos.begin() + 2*k ) ;
+      // transpose tiles of contiguous runs of the `len` amplitudes below the
+      // swapped bits
+      const int seg = std::min( pos[0] , 10 ) ;
+      const int64_t len = int64_t(1) << seg ;
+      const uint64_t n = 1ULL << ( nbQubits - 2*k - seg ) ;
+      T* v = vector.data() ;
+      qclab::parallel::forEach( n , [&] ( const uint64_t j ) {
+        uint64_t base = j << seg ;
+        for ( int i = 0; i < 2*k; i++ ) {
+          const uint64_t mR = ( 1ULL << pos[i] ) - 1 ;
+          base = ( ( base & ~mR ) << 1 ) | ( base & mR ) ;
+        }
+        for ( int r = 0; r < d; r++ ) {
+          for ( int c = r + 1; c < d; c++ ) {
+            T* x = v + ( base | oA[r] | oB[c] ) ;
+            T* y = v + ( base | oA[c] | oB[r] ) ;
+            std::swap_ranges( x , x + len , y ) ;
+          }
+        }
+      } , len * d * d ) ;
+    }
+
+    /**
+     * \brief Permutes the vector `vector` back to the identity permutation,
+     *        where `perm[q]` is the physical qubit of the logical qubit `q`.
+     *        On return, `perm` is the identity permutation.
+     */
+    template <typename T>
+    void unpermute( const int nbQubits , std::vector< T >& vector ,
+                    std::vector< int >& perm ) {
+      assert( perm.size() == nbQubits ) ;
+      while ( true ) {
+        // disjoint pairs that move logical qubits to their own position
+        std::vector< std::pair< int , int > > pairs ;
+        std::vector< bool > busy( nbQubits , false ) ;
+        for ( int q = 0; q < nbQubits; q++ ) {
+          const int p = perm[q] ;
+          if ( ( p != q ) && !busy[p] && !busy[q] &&
+               ( pairs.size() < maxSwapPairs ) ) {
+            pairs.push_back( { p , q } ) ;
+            busy[p] = true ;
+            busy[q] = true ;
+          }
+        }
+        if ( pairs.empty() ) return ;
+        swapQubits( nbQubits , pairs , vector ) ;
+        for ( const auto& [ a , b ] : pairs ) {
+          for ( auto& p : perm ) {
+            if ( p == a ) { p = b ; } else if ( p == b ) { p = a ; }
+          }
+        }
+      }
+    }
+
+    /**
+     * \brief Returns a copy of the 2-qubit gate `object` acting on the
+     *        physical qubits `perm[q + offset]` instead of its qubits `q`, or
+     *        an empty pointer if `object` is not a controlled gate, a 2-qubit
+     *        rotation or a swap gate.
+     */
+    template <typename T>
+    std::unique_ptr< qclab::QObject< T > > relabel2(
+                                          const qclab::QObject< T >& object ,
+                                          const std::vector< int >& perm ,
+                                          const int offset ) {
+      using namespace qclab::qgates ;
+      using controlled_type = QControlledGate2< T > ;
+      if ( auto gate = dynamic_cast< const controlled_type* >( &object ) ) {
+        const int c = perm[ gate->control() + offset ] ;
+        const int t = perm[ gate->target() + offset ] ;
+        const int s = gate->controlState() ;
+        if ( dynamic_cast< const CX< T >* >( gate ) ) {
+          return std::make_unique< CX< T > >( c , t , s ) ;
+        } else if ( dynamic_cast< const CY< T >* >( gate ) ) {
+          return std::make_unique< CY< T > >( c , t , s ) ;
+        } else if ( dynamic_cast< const CZ< T >* >( gate ) ) {
+          return std::make_unique< CZ< T > >( c , t , s ) ;
+        } else if ( auto g = dynamic_cast< const CPhase< T >* >( gate ) ) {
+          return std::make_unique< CPhase< T > >( c , t , g->gate()->angle() ,
+                                                  s ) ;
+        } else if ( auto g = dynamic_cast< const CRotationX< T >* >( gate ) ) {
+          return std::make_unique< CRotationX< T > >( c , t ,
+                                                      g->gate()->rotation() ,
+                                                      s ) ;
+        } else if ( auto g = dynamic_cast< const CRotationY< T >* >( gate ) ) {
+          return std::make_unique< CRotationY< T > >( c , t ,
+                                                      g->gate()->rotation() ,
+                                                      s ) ;
+        } else if ( auto g = dynamic_cast< const CRotationZ< T >* >( gate ) ) {
+          return std::make_unique< CRotationZ< T > >( c , t ,
+                                                      g->gate()->rotation() ,
+                                                      s ) ;
+        }
+        return nullptr ;
+      }
+      // symmetric gates on the sorted physical qubits
+      const auto qubits = object.qubits() ;
+      const int p = std::min( perm[ qubits[0] + offset ] ,
+                              perm[ qubits[1] + offset ] ) ;
+      const int q = std::max( perm[ qubits[0] + offset ] ,
+                              perm[ qubits[1] + offset ] ) ;
+      if ( auto g = dynamic_cast< const RotationXX< T >* >( &object ) ) {
+        return std::make_unique< RotationXX< T > >( p , q , g->rotation() ) ;
+      } else if ( auto g = dynamic_cast< const RotationYY< T >* >( &object ) ) {
+        return std::make_unique< RotationYY< T > >( p , q , g->rotation() ) ;
+      } else if ( auto g = dynamic_cast< const RotationZZ< T >* >( &object ) ) {
+        return std::make_unique< RotationZZ< T > >( p , q , g->rotation() ) ;
+      } else if ( dynamic_cast< const SWAP< T >* >( &object ) ) {
+        return std::make_unique< SWAP< T > >( p , q ) ;
+      } else if ( dynamic_cast< const iSWAP< T >* >( &object ) ) {
+        return std::make_unique< iSWAP< T > >( p , q ) ;
+      }
+      return nullptr ;
+    }
+
+    /**
+     * \brief Returns a copy of the multi-controlled gate `object` acting on
+     *        the physical qubits `perm[q + offset]` instead of its qubits `q`,
+     *        or an empty pointer if `object` is not a multi-controlled gate.
+     */
+    template <typename T>
+    std::unique_ptr< qclab::QObject< T > > relabelMC(
+                                          const qclab::QObject< T >& object ,
+                                          const std::vector< int >& perm ,
+                                          const int offset ) {
+      using namespace qclab::qgates ;
+      using controlled_type = QControlledGateN< T > ;
+      auto gate = dynamic_cast< const controlled_type* >( &object ) ;
+      if ( gate == nullptr ) return nullptr ;
+      // physical control qubits in ascending order with their states
+      const int k = gate->controls().size() ;
+      std::vector< std::pair< int , int > > pairs( k ) ;
+      for ( int i = 0; i < k; i++ ) {
+        pairs[i] = { perm[ gate->controls()[i] + offset ] ,
+                     gate->controlStates()[i] } ;
+      }
+      std::sort( pairs.begin() , pairs.end() ) ;
+      std::vector< int > controls( k ) ;
+      std::vector< int > states( k ) ;
+      for ( int i = 0; i < k; i++ ) {
+        controls[i] = pairs[i].first ;
+        states[i] = pairs[i].second ;
+      }
+      const auto targets = gate->targets() ;
+      if ( dynamic_cast< const MCX< T >* >( gate ) ) {
+        return std::make_unique< MCX< T > >( controls ,
+                                             perm[ targets[0] + offset ] ,
+                                             states ) ;
+      } else if ( auto g = dynamic_cast< const MCGate< T >* >( gate ) ) {
+        return std::make_unique< MCGate< T > >( controls ,
+                                                perm[ targets[0] + offset ] ,
+                                                g->targetMatrix() , states ) ;
+      } else if ( dynamic_cast< const MCSWAP< T >* >( gate ) ) {
+        return std::make_unique< MCSWAP< T > >( controls ,
+                                                perm[ targets[0] + offset ] ,
+                                                perm[ targets[1] + offset ] ,
+                                                states ) ;
+      }
+      return nullptr ;
+    }
+
+    /**
+     * \brief Returns the item `item` of the schedule `schedule` acting on the
+     *        physical qubits `perm[q]` instead of the logical qubits `q`.
+     *
+     * Items whose qubits are all shifted by the same amount keep their
+     * object, and hence its specialized kernel, with a new offset. Other
+     * items are rebuilt on their physical qubits and owned by `schedule`:
+     * diagonal gates factor by factor, 2-qubit gates with a specialized
+     * kernel by relabel2, multi-controlled gates of any size by relabelMC,
+     * monomial gates by permuting their local basis states, and other
+     * objects on at most MatrixGateN::maxQubits qubits as matrix gates.
+     * Returns an item without object if `item` can not be remapped.
+     */
+    template <typename T>
+    typename Schedule< T >::Item remap(
+                                    const typename Schedule< T >::Item& item ,
+                                    const std::vector< int >& perm ,
+                                    Schedule< T >& schedule ) {
+      using diag_type = qclab::qgates::DiagonalGate< T > ;
+      using gate_type = qclab::qgates::MatrixGateN< T > ;
+      using mono_type = qclab::qgates::MonomialGate< T > ;
+      const auto qubits = item.object->qubits() ;
+      const int m = qubits.size() ;
+      std::vector< int > phys( m ) ;
+      const int shift = perm[ qubits[0] + item.offset ] - qubits[0] ;
+      bool uniform = true ;
+      for ( int i = 0; i < m; i++ ) {
+        phys[i] = perm[ qubits[i] + item.offset ] ;
+        uniform = uniform && ( phys[i] == qubits[i] + shift ) ;
+      }
+      // uniform shift: keep the object and its kernel, only change the offset
+      if ( uniform ) return { item.object , shift } ;
+      // diagonal gate
+      if ( auto diag = dynamic_cast< const diag_type* >( item.object ) ) {
+        auto gate = std::make_unique< diag_type >() ;
+        for ( const auto& [ q , d ] : diag->factors1() ) {
+          gate->multiply( perm[ q + item.offset ] , d ) ;
+        }
+        for ( const auto& [ pq , d ] : diag->factors2() ) {
+          const int p = perm[ pq.first + item.offset ] ;
+          const int q = perm[ pq.second + item.offset ] ;
+          if ( p < q ) {
+            gate->multiply( p , q , d ) ;
+          } else {
+            gate->multiply( q , p , { d[0] , d[2] , d[1] , d[3] } ) ;
+          }
+        }
+        return { schedule.adopt( std::move( gate ) ) , 0 } ;
+      }
+      // 2-qubit gate with a specialized kernel
+      if ( m == 2 ) {
+        if ( auto gate = relabel2( *item.object , perm , item.offset ) ) {
+          return { schedule.adopt( std::move( gate ) ) , 0 } ;
+        }
+      }
+      // multi-controlled gate
+      if ( auto gate = relabelMC( *item.object , perm , item.offset ) ) {
+        return { schedule.adopt( std::move( gate ) ) , 0 } ;
+      }
+      auto mono = dynamic_cast< const mono_type* >( item.object ) ;
+      if ( m > ( mono ? mono_type::maxQubits : gate_type::maxQubits ) ) {
+        return { nullptr , 0 } ;
+      }
+      // new position j holds the old qubit order[j], the new local basis
+      // state x is the old local basis state old[x]
+      std::vector< int > order( m ) ;
+      std::iota( order.begin() , order.end() , 0 ) ;
+      std::sort( order.begin() , order.end() ,
+                 [&phys] ( const int i , const int j ) {
+                   return phys[i] < phys[j] ; } ) ;
+      std::vector< int > sorted( m ) ;
+      for ( int j = 0; j < m; j++ ) sorted[j] = phys[ order[j] ] ;
+      const int64_t D = int64_t(1) << m ;
+      std::vector< int64_t > old( D , 0 ) ;
+      for ( int64_t x = 0; x < D; x++ ) {
+        for ( int j = 0; j < m; j++ ) {
+          old[x] |= ( ( x >> ( m - j - 1 ) ) & 1 ) << ( m - order[j] - 1 ) ;
+        }
+      }
+      // monomial gate
+      if ( mono ) {
+        std::vector< int64_t > inv( D ) ;
+        for ( int64_t x = 0; x < D; x++ ) inv[ old[x] ] = x ;
+        std::vector< int64_t > permP( D ) ;
+        std::vector< T > phaseP( D ) ;
+        for ( int64_t x = 0; x < D; x++ ) {
+          permP[x] = inv[ mono->perm()[ old[x] ] ] ;
+          phaseP[x] = mono->phase()[ old[x] ] ;
+        }
+        return { schedule.adopt( std::make_unique< mono_type >( sorted ,
+                                                                permP ,
+                                                                phaseP ) ) ,
+                 0 } ;
+      }
+      // matrix gate
+      auto mat = item.object->matrix() ;
+      if ( !std::is_sorted( phys.begin() , phys.end() ) ) {
+        qclab::dense::SquareMatrix< T > matP( D ) ;
+        for ( int64_t y = 0; y < D; y++ ) {
+          for ( int64_t x = 0; x < D; x++ ) {
+            matP(x,y) = mat( old[x] , old[y] ) ;
+          }
+        }
+        mat = std::move( matP ) ;
+      }
+      return { schedule.adopt( std::make_unique< gate_type >( sorted , mat ) ) ,
+               0 } ;
+    }
+
+    /**
+     * \brief Applies the schedule `schedule` to the given vector `vector`
+     *        with cache blocking on the `blockQubits` least significant
+     *        qubits and dynamic qubit remapping.
+     *
+     * The logical qubit `q` is stored at the physical qubit `perm[q]`. For
+     * every window of `window` items, the most used qubits of the window are
+     * moved into the `blockQubits` least significant physical qubits by a
+     * single swapQubits sweep, provided that this makes more items local than
+     * the number of sweeps. The items of the window are relabeled to their
+     * physical qubits and applied with applyBlocked. Objects that can not be
+     * relabeled are applied after restoring the identity permutation.
+     *
+     * On return, `perm` holds the final permutation, which can be undone with
+     * unpermute.
+     */
+    template <typename T>
+    void applyRemapped( const Schedule< T >& schedule , const int nbQubits ,
+                        std::vector< T >& vector , const int blockQubits ,
+                        const int window , std::vector< int >& perm ) {
+      assert( blockQubits > 0 && blockQubits < nbQubits ) ;
+      assert( window > 0 ) ;
+      assert( perm.size() == nbQubits ) ;
+      const int lo = nbQubits - blockQubits ;  // first local physical qubit
+
+      // checks if the logical qubits of `item` are local in `map`
+      auto local = [&] ( const typename Schedule< T >::Item& item ,
+                         const std::vector< int >& map ) {
+        for ( const int q : item.object->qubits() ) {
+          if ( map[ q + item.offset ] < lo ) return false ;
+        }
+        return true ;
+      } ;
+
+      auto it = schedule.begin() ;
+      while ( it != schedule.end() ) {
+        const auto last = ( schedule.end() - it > window ) ? it + window
+                                                            : schedule.end() ;
+
+        // usage of the logical qubits by the items that fit in a block
+        std::vector< int > count( nbQubits , 0 ) ;
+        for ( auto jt = it; jt != last; ++jt ) {
+          if ( jt->object->nbQubits() > blockQubits ) continue ;
+          for ( const int q : jt->object->qubits() ) count[ q + jt->offset ]++ ;
+        }
+        std::vector< int > hot ;
+        for ( int q = 0; q < nbQubits; q++ ) {
+          if ( count[q] > 0 ) hot.push_back( q ) ;
+        }
+        std::stable_sort( hot.begin() , hot.end() ,
+                          [&count] ( const int p , const int q ) {
+                            return count[p] > count[q] ; } ) ;
+        if ( hot.size() > blockQubits ) hot.resize( blockQubits ) ;
+
+        // pair non-local hot qubits with the least used local qubits
+        std::vector< bool > isHot( nbQubits , false ) ;
+        for ( const int q : hot ) isHot[q] = true ;
+        std::vector< int > logical( nbQubits ) ;  // inverse permutation
+        for ( int q = 0; q < nbQubits; q++ ) logical[ perm[q] ] = q ;
+        std::vector< int > free ;
+        for ( int p = lo; p < nbQubits; p++ ) {
+          if ( !isHot[ logical[p] ] ) free.push_back( p ) ;
+        }
+        std::stable_sort( free.begin() , free.end() ,
+                          [&] ( const int p , const int q ) {
+                            return count[ logical[p] ] < count[ logical[q] ] ;
+                          } ) ;
+        std::vector< std::pair< int , int > > pairs ;
+        for ( const int q : hot ) {
+          if ( perm[q] < lo ) {
+            assert( pairs.size() < free.size() ) ;
+            pairs.push_back( { perm[q] , free[ pairs.size() ] } ) ;
+          }
+        }
+
+        // swap if more items become local than the number of sweeps
+        if ( !pairs.empty() ) {
+          std::vector< int > next( perm ) ;
+          for ( const auto& [ a , b ] : pairs ) {
+            std::swap( next[ logical[a] ] , next[ logical[b] ] ) ;
+          }
+          int gain = 0 ;
+          for ( auto jt = it; jt != last; ++jt ) {
+            gain += local( *jt , next ) - local( *jt , perm ) ;
+          }
+          const int sweeps = ( pairs.size() + maxSwapPairs - 1 ) /
+                             maxSwapPairs ;
+          if ( gain > sweeps ) {
+            for ( size_t i = 0; i < pairs.size(); i += maxSwapPairs ) {
+              const size_t j = std::min( pairs.size() , i + maxSwapPairs ) ;
+              const std::vector< std::pair< int , int > > sweep(
+                                      pairs.begin() + i , pairs.begin() + j ) ;
+              swapQubits( nbQubits , sweep , vector ) ;
+            }
+            perm = std::move( next ) ;
+          }
+        }
+
+        // relabel and apply the window
+        Schedule< T > relabeled ;
+        typename Schedule< T >::vector_type items ;
+        auto flush = [&] () {
+          relabeled.assign( std::move( items ) ) ;
+          applyBlocked( relabeled , nbQubits , vector , blockQubits ) ;
+          items.clear() ;
+        } ;
+        for ( ; it != last; ++it ) {
+          auto item = remap( *it , perm , relabeled ) ;
+          if ( item.object == nullptr ) {
+            flush() ;
+            unpermute( nbQubits , vector , perm ) ;
+            item = *it ;
+          }
+          items.push_back( item ) ;
+        }
+        flush() ;
+      }
+    }
+
+  } // namespace sim
+
+} // namespace qclab
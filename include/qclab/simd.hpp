@@ -0,0 +1,51 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+namespace qclab {
+
+  /**
+   * Namespace qclab::simd.
+   */
+  namespace simd {
+
+    /**
+     * Instruction set used by the vector kernels of the gates.
+     * \ingroup Enumerations
+     */
+    enum class Isa : char
+    {
+      Scalar = 'S' ,  ///< Scalar kernels
+      AVX2   = '2' ,  ///< AVX2 + FMA kernels
+      AVX512 = '5'    ///< AVX-512F kernels
+    } ; // enum class Isa
+
+    /// Returns the best instruction set supported by the CPU and the build.
+    Isa detect() ;
+
+    /**
+     * \brief Returns the instruction set currently used by the vector
+     *        kernels. Defaults to `detect()`, unless overridden with the
+     *        environment variable QCLAB_SIMD (`scalar`, `avx2` or `avx512`).
+     */
+    Isa isa() ;
+
+    /**
+     * \brief Sets the instruction set used by the vector kernels to `isa`.
+     *        Instruction sets that are not supported fall back to the best
+     *        supported one below `isa`.
+     */
+    void setIsa( const Isa isa ) ;
+
+    /// Returns the name of the instruction set `isa`.
+    inline const char* name( const Isa isa ) {
+      switch ( isa ) {
+        case Isa::AVX2   : return "avx2" ;
+        case Isa::AVX512 : return "avx512" ;
+        default          : return "scalar" ;
+      }
+    }
+
+  } // namespace simd
+
+} // namespace qclab
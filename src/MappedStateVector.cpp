@@ -0,0 +1,233 @@
+#include "qclab/MappedStateVector.hpp"
+#include "qclab/sim/fusion.hpp"
+#include "qclab/sim/blocking.hpp"
+#include "qclab/sim/remap.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace qclab {
+
+  // MappedStateVector
+  template <typename T>
+  MappedStateVector< T >::MappedStateVector( const std::string& filename ,
+                                             const int nbQubits ,
+                                             const int chunkQubits )
+  : nbQubits_( nbQubits )
+  , chunkQubits_( std::min( chunkQubits , nbQubits ) )
+  , filename_( filename )
+  , fd_( -1 )
+  , data_( nullptr )
+  , nbSweeps_( 0 )
+  {
+    assert( nbQubits >= 1 ) ;
+    assert( chunkQubits >= 1 ) ;
+    const size_t bytes = size() * sizeof( T ) ;
+    // closes the file and throws the error `error` of the call `call`
+    auto fail = [&] ( const int error , const char* call ) {
+      if ( fd_ >= 0 ) close( fd_ ) ;
+      throw std::system_error( error , std::generic_category() ,
+                               std::string( call ) + " " + filename_ ) ;
+    } ;
+    // the truncated file reads as zeros
+    fd_ = open( filename_.c_str() , O_RDWR | O_CREAT | O_TRUNC , 0644 ) ;
+    if ( fd_ < 0 ) fail( errno , "open" ) ;
+    if ( ftruncate( fd_ , bytes ) != 0 ) fail( errno , "ftruncate" ) ;
+    void* data = mmap( nullptr , bytes , PROT_READ | PROT_WRITE , MAP_SHARED ,
+                       fd_ , 0 ) ;
+    if ( data == MAP_FAILED ) fail( errno , "mmap" ) ;
+    // posix_madvise returns the error number instead of setting errno
+    const int error = posix_madvise( data , bytes , POSIX_MADV_SEQUENTIAL ) ;
+    if ( error != 0 ) {
+      munmap( data , bytes ) ;
+      fail( error , "posix_madvise" ) ;
+    }
+    data_ = static_cast< T* >( data ) ;
+    data_[0] = 1 ;
+  }
+
+  // ~MappedStateVector
+  template <typename T>
+  MappedStateVector< T >::~MappedStateVector() {
+    if ( data_ ) munmap( data_ , size() * sizeof( T ) ) ;
+    if ( fd_ >= 0 ) close( fd_ ) ;
+  }
+
+  // sync
+  template <typename T>
+  void MappedStateVector< T >::sync() {
+    if ( msync( data_ , size() * sizeof( T ) , MS_SYNC ) != 0 ) {
+      throw std::system_error( errno , std::generic_category() ,
+                               "msync " + filename_ ) ;
+    }
+  }
+
+  // simulate
+  template <typename T>
+  void MappedStateVector< T >::simulate( const qclab::QCircuit< T >& circuit ,
+                                         const sim::Options& options ) {
+    assert( circuit.nbQubits() == nbQubits_ ) ;
+    assert( !circuit.dynamic() ) ;
+    sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    if ( options.fuseDiagonal ) sim::fuseDiagonal( schedule ) ;
+    // fused gates must fit in a sweep
+    const bool chunked = ( chunkQubits_ < nbQubits_ ) ;
+    if ( options.fuseMonomial ) {
+      const int m = qgates::MonomialGate< T >::maxQubits ;
+      sim::fuseMonomial( schedule , chunked ? std::min( m , maxGroupQubits )
+                                            : m ) ;
+    }
+    if ( options.fuse1 ) sim::fuse1( schedule ) ;
+    const int k = chunked ? std::min( options.fuseK , maxGroupQubits )
+                          : options.fuseK ;
+    if ( k >= 2 ) sim::fuseK( schedule , k ) ;
+    apply( schedule , options.blockQubits ) ;
+  }
+
+  // apply
+  template <typename T>
+  void MappedStateVector< T >::apply( const sim::Schedule< T >& schedule ,
+                                      const int blockQubits ) {
+    const int nH = nbQubits_ - chunkQubits_ ;
+    nbSweeps_ = 0 ;
+    auto it = schedule.begin() ;
+    while ( it != schedule.end() ) {
+      // longest run of items on at most maxGroupQubits high qubits
+      std::vector< int > high ;
+      auto last = it ;
+      for ( ; last != schedule.end(); ++last ) {
+        assert( !last->object->dynamic() ) ;
+        auto next = high ;
+        for ( int q : last->object->qubits() ) {
+          q += last->offset ;
+          if ( ( q < nH ) &&
+               ( std::find( next.begin() , next.end() , q ) == next.end() ) ) {
+            next.push_back( q ) ;
+          }
+        }
+        // an item on more high qubits forms a sweep on its own
+        if ( ( next.size() > maxGroupQubits ) && ( last != it ) ) break ;
+        high = std::move( next ) ;
+        if ( high.size() > maxGroupQubits ) {
+          ++last ;
+          break ;
+        }
+      }
+      std::sort( high.begin() , high.end() ) ;
+      applySweep( it , last , high , blockQubits ) ;
+      nbSweeps_++ ;
+      it = last ;
+    }
+  }
+
+  // applySweep
+  template <typename T>
+  void MappedStateVector< T >::applySweep(
+                          typename sim::Schedule< T >::const_iterator first ,
+                          typename sim::Schedule< T >::const_iterator last ,
+                          const std::vector< int >& high ,
+                          const int blockQubits ) {
+    const int nH = nbQubits_ - chunkQubits_ ;
+    const int k = high.size() ;
+    const int m = chunkQubits_ + k ;  // qubits of a buffer
+
+    // items on the qubits of a buffer: high qubits first, then low qubits
+    std::vector< int > perm( nbQubits_ , -1 ) ;
+    for ( int i = 0; i < k; i++ ) perm[ high[i] ] = i ;
+    for ( int q = nH; q < nbQubits_; q++ ) perm[ q ] = q - nH + k ;
+    sim::Schedule< T > segment ;
+    for ( auto it = first; it != last; ++it ) {
+      const auto item = sim::remap( *it , perm , segment ) ;
+      if ( item.object == nullptr ) {
+        throw std::invalid_argument( "object can not be relabeled" ) ;
+      }
+      segment.push_back( item.object , item.offset ) ;
+    }
+
+    // chunk index bits of the high qubits
+    std::vector< int64_t > bits( k ) ;
+    for ( int i = 0; i < k; i++ ) bits[i] = int64_t(1) << ( nH - high[i] - 1 ) ;
+    std::vector< int64_t > ascending( bits.rbegin() , bits.rend() ) ;
+    const int64_t nbGroups = int64_t(1) << ( nH - k ) ;
+    const int64_t nbChunks = int64_t(1) << k ;
+    const int64_t chunkSize = int64_t(1) << chunkQubits_ ;
+
+    // first chunk of group g: zero bits inserted at the high qubits
+    auto base = [&] ( int64_t g ) {
+      for ( const int64_t bit : ascending ) {
+        g = ( ( g & ~( bit - 1 ) ) << 1 ) | ( g & ( bit - 1 ) ) ;
+      }
+      return g ;
+    } ;
+    // chunk c of the group with first chunk b
+    auto chunk = [&] ( const int64_t b , const int64_t c ) {
+      int64_t index = b ;
+      for ( int i = 0; i < k; i++ ) {
+        if ( ( c >> ( k - i - 1 ) ) & 1 ) index |= bits[i] ;
+      }
+      return data_ + index * chunkSize ;
+    } ;
+    auto applySegment = [&] ( std::vector< T >& buffer ) {
+      if ( ( blockQubits > 0 ) && ( blockQubits < m ) ) {
+        sim::applyBlocked( segment , m , buffer , blockQubits ) ;
+      } else {
+        segment.apply( m , buffer ) ;
+      }
+    } ;
+
+    const bool distributed = ( nbGroups >= parallel::nbThreads( size() ) ) ;
+    std::vector< T > shared( distributed ? 0 : nbChunks * chunkSize ) ;
+    parallel::run( size() , [&] () {
+      if ( distributed ) {
+        // groups distributed over the threads
+        parallel::forRange( nbGroups , [&] ( const int64_t begin ,
+                                             const int64_t end ) {
+          std::vector< T > buffer( nbChunks * chunkSize ) ;
+          for ( int64_t g = begin; g < end; g++ ) {
+            const int64_t b = base( g ) ;
+            for ( int64_t c = 0; c < nbChunks; c++ ) {
+              const T* data = chunk( b , c ) ;
+              std::copy( data , data + chunkSize ,
+                         buffer.begin() + c * chunkSize ) ;
+            }
+            applySegment( buffer ) ;
+            for ( int64_t c = 0; c < nbChunks; c++ ) {
+              auto data = buffer.begin() + c * chunkSize ;
+              std::copy( data , data + chunkSize , chunk( b , c ) ) ;
+            }
+          }
+        } , nbChunks * chunkSize ) ;
+      } else {
+        // groups one by one, every group shared by all threads
+        for ( int64_t g = 0; g < nbGroups; g++ ) {
+          const int64_t b = base( g ) ;
+          for ( int64_t c = 0; c < nbChunks; c++ ) {
+            const T* data = chunk( b , c ) ;
+            T* buffer = shared.data() + c * chunkSize ;
+            parallel::forRange( chunkSize , [&] ( const int64_t begin ,
+                                                  const int64_t end ) {
+              std::copy( data + begin , data + end , buffer + begin ) ;
+            } ) ;
+          }
+          applySegment( shared ) ;
+          for ( int64_t c = 0; c < nbChunks; c++ ) {
+            T* data = chunk( b , c ) ;
+            const T* buffer = shared.data() + c * chunkSize ;
+            parallel::forRange( chunkSize , [&] ( const int64_t begin ,
+                                                  const int64_t end ) {
+              std::copy( buffer + begin , buffer + end , data + begin ) ;
+            } ) ;
+          }
+        }
+      }
+    } ) ;
+  }
+
+  template class MappedStateVector< std::complex< float > > ;
+  template class MappedStateVector< std::complex< double > > ;
+
+} // namespace qclab
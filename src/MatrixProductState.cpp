@@ -0,0 +1,357 @@
+#include "qclab/MatrixProductState.hpp"
+#include "qclab/dense/svd.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace qclab {
+
+  namespace {
+
+    // product of the m x k matrix A and the k x n matrix B, stored row by row
+    template <typename T>
+    std::vector< T > multiply( const int64_t m , const int64_t k ,
+                               const int64_t n , const T* A , const T* B ) {
+      std::vector< T > C( m * n , T(0) ) ;
+      parallel::forRange( m , [&] ( const int64_t begin ,
+                                    const int64_t end ) {
+        for ( int64_t i = begin; i < end; i++ ) {
+          T* c = C.data() + i * n ;
+          for ( int64_t l = 0; l < k; l++ ) {
+            const T a = A[ i * k + l ] ;
+            if ( a == T(0) ) continue ;
+            const T* b = B + l * n ;
+            for ( int64_t j = 0; j < n; j++ ) c[j] += a * b[j] ;
+          }
+        }
+      } , k * n ) ;
+      return C ;
+    }
+
+  } // namespace
+
+  // MatrixProductState
+  template <typename T>
+  MatrixProductState< T >::MatrixProductState( const int nbQubits )
+  : nbQubits_( nbQubits )
+  , maxBond_( 256 )
+  , truncation_( std::numeric_limits< real_type >::epsilon() *
+                 std::numeric_limits< real_type >::epsilon() )
+  , truncationError_( 0 )
+  , center_( 0 )
+  , bonds_( nbQubits + 1 , 1 )
+  , tensors_( nbQubits , std::vector< T >( { 1 , 0 } ) )
+  {
+    assert( nbQubits >= 1 ) ;
+  }
+
+  // maxBondDimension
+  template <typename T>
+  int64_t MatrixProductState< T >::maxBondDimension() const {
+    return *std::max_element( bonds_.begin() , bonds_.end() ) ;
+  }
+
+  // amplitude
+  template <typename T>
+  T MatrixProductState< T >::amplitude( const std::vector< int >& bitstring )
+  const {
+    assert( bitstring.size() == nbQubits_ ) ;
+    std::vector< T > v( 1 , T(1) ) ;
+    for ( int q = 0; q < nbQubits_; q++ ) {
+      const int64_t l = bonds_[q] ;
+      const int64_t r = bonds_[q+1] ;
+      const T* A = tensors_[q].data() + bitstring[q] * r ;
+      std::vector< T > w( r , T(0) ) ;
+      for ( int64_t a = 0; a < l; a++ ) {
+        for ( int64_t c = 0; c < r; c++ ) w[c] += v[a] * A[ a * 2 * r + c ] ;
+      }
+      v = std::move( w ) ;
+    }
+    return v[0] ;
+  }
+
+  // operator()
+  template <typename T>
+  T MatrixProductState< T >::operator()( const uint64_t index ) const {
+    assert( nbQubits_ <= 64 ) ;
+    std::vector< int > bitstring( nbQubits_ ) ;
+    for ( int q = 0; q < nbQubits_; q++ ) {
+      bitstring[q] = ( index >> ( nbQubits_ - q - 1 ) ) & 1 ;
+    }
+    return amplitude( bitstring ) ;
+  }
+
+  // vector
+  template <typename T>
+  std::vector< T > MatrixProductState< T >::vector() const {
+    assert( nbQubits_ <= maxDenseQubits ) ;
+    // amplitudes of the first q qubits times the tensors of the bond q
+    std::vector< T > vector( 1 , T(1) ) ;
+    int64_t rows = 1 ;
+    for ( int q = 0; q < nbQubits_; q++ ) {
+      vector = multiply( rows , bonds_[q] , 2 * bonds_[q+1] , vector.data() ,
+                         tensors_[q].data() ) ;
+      rows *= 2 ;
+    }
+    return vector ;
+  }
+
+  // apply
+  template <typename T>
+  void MatrixProductState< T >::apply( const qclab::QObject< T >& object ,
+                                       const int offset ) {
+    assert( !object.dynamic() ) ;
+    using C = QCircuit< T > ;
+    if ( const C* circuit = dynamic_cast< const C* >( &object ) ) {
+      sim::Schedule< T > schedule ;
+      circuit->flatten( schedule , offset ) ;
+      for ( const auto& item : schedule ) apply( *item.object , item.offset ) ;
+      return ;
+    }
+    const auto qubits = object.qubits() ;
+    if ( qubits.size() == 1 ) {
+      apply1( qubits[0] + offset , object.matrix() ) ;
+      return ;
+    }
+    assert( qubits.size() == 2 ) ;
+    const int a = qubits[0] + offset ;
+    const int b = qubits[1] + offset ;
+    assert( a >= 0 && a < b && b < nbQubits_ ) ;
+    // move the qubit b next to the qubit a and back
+    const qclab::dense::SquareMatrix< T >  swap( 1 , 0 , 0 , 0 ,
+                                                 0 , 0 , 1 , 0 ,
+                                                 0 , 1 , 0 , 0 ,
+                                                 0 , 0 , 0 , 1 ) ;
+    for ( int q = b - 1; q > a; q-- ) apply2( q , swap ) ;
+    apply2( a , object.matrix() ) ;
+    for ( int q = a + 1; q < b; q++ ) apply2( q , swap ) ;
+  }
+
+  // simulate
+  template <typename T>
+  void MatrixProductState< T >::simulate(
+                                   const qclab::QCircuit< T >& circuit ) {
+    assert( circuit.nbQubits() == nbQubits_ ) ;
+    apply( circuit ) ;
+  }
+
+  // sample
+  template <typename T>
+  Counts MatrixProductState< T >::sample( const int64_t nbShots ,
+                                          const std::vector< int >& qubits ,
+                                          const uint64_t seed ) {
+    std::vector< int > measured = qubits ;
+    if ( measured.empty() ) {
+      measured.resize( nbQubits_ ) ;
+      std::iota( measured.begin() , measured.end() , 0 ) ;
+    }
+    assert( measured.size() <= 64 ) ;
+    if ( nbShots <= 0 ) return Counts() ;
+    moveCenter( 0 ) ;
+    const int last = *std::max_element( measured.begin() , measured.end() ) ;
+    int64_t work = 0 ;
+    for ( int q = 0; q <= last; q++ ) work += 2 * bonds_[q] * bonds_[q+1] ;
+
+    const qclab::Random random( seed ) ;
+    std::vector< uint64_t > outcomes( nbShots ) ;
+    parallel::forRange( nbShots , [&] ( const int64_t begin ,
+                                        const int64_t end ) {
+      std::vector< T > v , w0 , w1 ;
+      std::vector< int > bits( last + 1 ) ;
+      for ( int64_t shot = begin; shot < end; shot++ ) {
+        // conditional probabilities of the qubits from left to right
+        v.assign( 1 , T(1) ) ;
+        for ( int q = 0; q <= last; q++ ) {
+          const int64_t l = bonds_[q] ;
+          const int64_t r = bonds_[q+1] ;
+          const T* A = tensors_[q].data() ;
+          w0.assign( r , T(0) ) ;
+          w1.assign( r , T(0) ) ;
+          for ( int64_t a = 0; a < l; a++ ) {
+            for ( int64_t c = 0; c < r; c++ ) {
+              w0[c] += v[a] * A[ a * 2 * r + c ] ;
+              w1[c] += v[a] * A[ a * 2 * r + r + c ] ;
+            }
+          }
+          double p0 = 0 ;
+          double p1 = 0 ;
+          for ( int64_t c = 0; c < r; c++ ) {
+            p0 += std::norm( w0[c] ) ;
+            p1 += std::norm( w1[c] ) ;
+          }
+          const double u = random.uniform( shot * ( last + 1 ) + q ) ;
+          bits[q] = ( u * ( p0 + p1 ) < p1 ) ? 1 : 0 ;
+          const real_type scale = 1 / std::sqrt( bits[q] ? p1 : p0 ) ;
+          std::swap( v , bits[q] ? w1 : w0 ) ;
+          for ( auto& x : v ) x *= scale ;
+        }
+        uint64_t outcome = 0 ;
+        for ( const int q : measured ) outcome = ( outcome << 1 ) | bits[q] ;
+        outcomes[ shot ] = outcome ;
+      }
+    } , work ) ;
+
+    // counts of the sorted outcomes
+    std::sort( outcomes.begin() , outcomes.end() ) ;
+    Counts counts ;
+    for ( const uint64_t outcome : outcomes ) {
+      if ( counts.empty() || ( counts.back().first != outcome ) ) {
+        counts.push_back( { outcome , 0 } ) ;
+      }
+      counts.back().second++ ;
+    }
+    return counts ;
+  }
+
+  // apply1
+  template <typename T>
+  void MatrixProductState< T >::apply1( const int q ,
+                              const qclab::dense::SquareMatrix< T >& mat ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    assert( mat.rows() == 2 ) ;
+    const int64_t l = bonds_[q] ;
+    const int64_t r = bonds_[q+1] ;
+    T* A = tensors_[q].data() ;
+    parallel::forRange( l , [&] ( const int64_t begin , const int64_t end ) {
+      for ( int64_t a = begin; a < end; a++ ) {
+        T* x0 = A + a * 2 * r ;
+        T* x1 = x0 + r ;
+        for ( int64_t c = 0; c < r; c++ ) {
+          const T y0 = x0[c] ;
+          const T y1 = x1[c] ;
+          x0[c] = mat(0,0) * y0 + mat(0,1) * y1 ;
+          x1[c] = mat(1,0) * y0 + mat(1,1) * y1 ;
+        }
+      }
+    } , 2 * r ) ;
+  }
+
+  // apply2
+  template <typename T>
+  void MatrixProductState< T >::apply2( const int q ,
+                              const qclab::dense::SquareMatrix< T >& mat ) {
+    assert( q >= 0 && q < nbQubits_ - 1 ) ;
+    assert( mat.rows() == 4 ) ;
+    moveCenter( q ) ;
+    const int64_t l = bonds_[q] ;
+    const int64_t m = bonds_[q+1] ;
+    const int64_t r = bonds_[q+2] ;
+
+    // contraction of both tensors, of shape l x 2 x 2 x r, and the gate
+    std::vector< T > theta = multiply( 2 * l , m , 2 * r ,
+                                       tensors_[q].data() ,
+                                       tensors_[q+1].data() ) ;
+    parallel::forRange( l , [&] ( const int64_t begin , const int64_t end ) {
+      for ( int64_t a = begin; a < end; a++ ) {
+        T* x = theta.data() + a * 4 * r ;
+        for ( int64_t c = 0; c < r; c++ ) {
+          const T y[4] = { x[c] , x[r+c] , x[2*r+c] , x[3*r+c] } ;
+          for ( int s = 0; s < 4; s++ ) {
+            x[ s * r + c ] = mat(s,0) * y[0] + mat(s,1) * y[1] +
+                             mat(s,2) * y[2] + mat(s,3) * y[3] ;
+          }
+        }
+      }
+    } , 16 * r ) ;
+
+    // split with the center on the qubit q + 1
+    std::vector< T > U , Vh ;
+    std::vector< real_type > S ;
+    qclab::dense::svd( 2 * l , 2 * r , theta , U , S , Vh ) ;
+    const int64_t k = S.size() ;
+    const int64_t chi = truncate( S ) ;
+    std::vector< T >& A = tensors_[q] ;
+    A.resize( 2 * l * chi ) ;
+    for ( int64_t i = 0; i < 2 * l; i++ ) {
+      std::copy( U.begin() + i * k , U.begin() + i * k + chi ,
+                 A.begin() + i * chi ) ;
+    }
+    std::vector< T >& B = tensors_[q+1] ;
+    B.resize( chi * 2 * r ) ;
+    for ( int64_t j = 0; j < chi; j++ ) {
+      for ( int64_t c = 0; c < 2 * r; c++ ) {
+        B[ j * 2 * r + c ] = S[j] * Vh[ j * 2 * r + c ] ;
+      }
+    }
+    bonds_[q+1] = chi ;
+    center_ = q + 1 ;
+  }
+
+  // moveCenter
+  template <typename T>
+  void MatrixProductState< T >::moveCenter( const int q ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    std::vector< T > U , Vh ;
+    std::vector< real_type > S ;
+    while ( center_ < q ) {
+      // A = U ( S Vh ), where S Vh moves into the next tensor
+      const int c = center_ ;
+      const int64_t l = bonds_[c] ;
+      const int64_t m = bonds_[c+1] ;
+      const int64_t r = bonds_[c+2] ;
+      qclab::dense::svd( 2 * l , m , tensors_[c] , U , S , Vh ) ;
+      const int64_t k = S.size() ;
+      const int64_t chi = truncate( S ) ;
+      std::vector< T >& A = tensors_[c] ;
+      A.resize( 2 * l * chi ) ;
+      for ( int64_t i = 0; i < 2 * l; i++ ) {
+        std::copy( U.begin() + i * k , U.begin() + i * k + chi ,
+                   A.begin() + i * chi ) ;
+      }
+      for ( int64_t j = 0; j < chi; j++ ) {
+        for ( int64_t b = 0; b < m; b++ ) Vh[ j * m + b ] *= S[j] ;
+      }
+      tensors_[c+1] = multiply( chi , m , 2 * r , Vh.data() ,
+                                tensors_[c+1].data() ) ;
+      bonds_[c+1] = chi ;
+      center_++ ;
+    }
+    while ( center_ > q ) {
+      // A = ( U S ) Vh, where U S moves into the previous tensor
+      const int c = center_ ;
+      const int64_t l = bonds_[c-1] ;
+      const int64_t m = bonds_[c] ;
+      const int64_t r = bonds_[c+1] ;
+      qclab::dense::svd( m , 2 * r , tensors_[c] , U , S , Vh ) ;
+      const int64_t k = S.size() ;
+      const int64_t chi = truncate( S ) ;
+      tensors_[c].assign( Vh.begin() , Vh.begin() + chi * 2 * r ) ;
+      std::vector< T > US( m * chi ) ;
+      for ( int64_t b = 0; b < m; b++ ) {
+        for ( int64_t j = 0; j < chi; j++ ) {
+          US[ b * chi + j ] = U[ b * k + j ] * S[j] ;
+        }
+      }
+      tensors_[c-1] = multiply( 2 * l , m , chi , tensors_[c-1].data() ,
+                                US.data() ) ;
+      bonds_[c] = chi ;
+      center_-- ;
+    }
+  }
+
+  // truncate
+  template <typename T>
+  int64_t MatrixProductState< T >::truncate( std::vector< real_type >& S ) {
+    double total = 0 ;
+    for ( const real_type s : S ) total += double( s ) * s ;
+    int64_t keep = S.size() ;
+    double dropped = 0 ;
+    while ( keep > 1 ) {
+      const double weight = double( S[ keep - 1 ] ) * S[ keep - 1 ] ;
+      if ( ( keep <= maxBond_ ) &&
+           ( dropped + weight > truncation_ * total ) ) break ;
+      dropped += weight ;
+      keep-- ;
+    }
+    S.resize( keep ) ;
+    if ( ( dropped == 0 ) || ( total == 0 ) ) return keep ;
+    // renormalize the kept singular values
+    truncationError_ += dropped / total ;
+    const real_type scale = std::sqrt( total / ( total - dropped ) ) ;
+    for ( real_type& s : S ) s *= scale ;
+    return keep ;
+  }
+
+  template class MatrixProductState< std::complex< float > > ;
+  template class MatrixProductState< std::complex< double > > ;
+
+} // namespace qclab
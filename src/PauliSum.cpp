@@ -0,0 +1,272 @@
+#include "qclab/PauliSum.hpp"
+#include "qclab/parallel.hpp"
+#include <bitset>
+#include <iostream>
+#include <map>
+
+namespace qclab {
+
+  namespace {
+
+  /// Returns the parity of the bits of `bits`.
+  inline bool parity( const uint64_t bits ) {
+    return std::bitset< 64 >( bits ).count() & 1 ;
+  }
+
+  /// Returns the complex conjugate of `x`, or `x` itself for real types.
+  template <typename T>
+  inline T conj( const T x ) {
+    if constexpr ( qclab::is_complex_v< T > ) {
+      return std::conj( x ) ;
+    } else {
+      return x ;
+    }
+  }
+
+  /**
+   * \brief Returns the sum of `f( begin , end )` over the ranges of forRange
+   *        for the loop [0, `n`).
+   *
+   * Every thread of a persistent team stores the sum of its range in a slot
+   * shared by the team, and all threads return the sum of the slots in the
+   * order of the threads. Outside a team, a team is opened if the loop is
+   * large enough.
+   */
+  template <typename R, typename F>
+  R sumRange( const int64_t n , F&& f ) {
+  #ifdef _OPENMP
+    if ( !parallel::inTeam() ) {
+      if ( omp_in_parallel() || ( parallel::nbThreads( n ) == 1 ) ) {
+        return f( int64_t(0) , n ) ;
+      }
+      R total = 0 ;
+      parallel::run( n , [&] () {
+        const R sum = sumRange< R >( n , f ) ;
+        #pragma omp master
+        total = sum ;
+      } ) ;
+      return total ;
+    }
+    // slots of the team, owned by the thread that allocates them
+    std::vector< R > owned ;
+    std::vector< R >* slots = nullptr ;
+    #pragma omp single copyprivate( slots )
+    {
+      owned.assign( omp_get_num_threads() , R(0) ) ;
+      slots = &owned ;
+    }
+    parallel::forRange( n , [&] ( const int64_t begin , const int64_t end ) {
+      (*slots)[ omp_get_thread_num() ] = f( begin , end ) ;
+    } ) ;
+    R total = 0 ;
+    for ( const R sum : *slots ) total += sum ;
+    // the owner keeps the slots until all threads have read them
+    #pragma omp barrier
+    return total ;
+  #else
+    return f( int64_t(0) , n ) ;
+  #endif
+  }
+
+  /**
+   * \brief Returns the expectation value of the term groups `groups` for
+   *        the vector of `nbQubits` qubits with amplitudes `amp( i )`.
+   *
+   * A Pauli string \f$i^y X^x Z^z\f$ maps amplitude j = i ^ x to i with the
+   * sign of the parity of j & z. For x = 0, the terms are a parity-weighted
+   * sum of the probabilities. Otherwise, the amplitudes i and i ^ x form a
+   * pair with the highest bit of x cleared in i, and both halves of the pair
+   * contribute twice the real or imaginary part of conj( amp( i ) ) *
+   * amp( i ^ x ), depending on the parity of y.
+   */
+  template <typename G, typename A>
+  auto expectationGroups( const int nbQubits , const std::vector< G >& groups ,
+                          A&& amp ) {
+    using R = decltype( std::abs( amp( 0 ) ) ) ;
+    const int64_t size = int64_t(1) << nbQubits ;
+    R total = 0 ;
+    for ( const auto& group : groups ) {
+      const int nbTerms = group.zMasks.size() ;
+      const uint64_t* z = group.zMasks.data() ;
+      const uint64_t x = group.xMask ;
+      if ( x == 0 ) {
+        const R* c = group.coefficients.data() ;
+        total += sumRange< R >( size , [&] ( const int64_t begin ,
+                                             const int64_t end ) {
+          R sum = 0 ;
+          for ( int64_t i = begin; i < end; i++ ) {
+            R w = 0 ;
+            for ( int t = 0; t < nbTerms; t++ ) {
+              w += parity( i & z[t] ) ? -c[t] : c[t] ;
+            }
+            sum += w * std::norm( amp( i ) ) ;
+          }
+          return sum ;
+        } ) ;
+        continue ;
+      }
+      // weights of the real and imaginary parts of the pair products
+      std::vector< R > wRe( nbTerms ) , wIm( nbTerms ) ;
+      for ( int t = 0; t < nbTerms; t++ ) {
+        const R c = 2 * group.coefficients[t] ;
+        switch ( group.nbY[t] % 4 ) {
+          case 0 : wRe[t] =  c ; wIm[t] = 0 ; break ;
+          case 1 : wRe[t] =  0 ; wIm[t] = -c ; break ;
+          case 2 : wRe[t] = -c ; wIm[t] = 0 ; break ;
+          case 3 : wRe[t] =  0 ; wIm[t] =  c ; break ;
+        }
+      }
+      int b = 63 ;
+      while ( !( ( x >> b ) & 1 ) ) b-- ;
+      const uint64_t low = ( uint64_t(1) << b ) - 1 ;
+      total += sumRange< R >( size / 2 , [&] ( const int64_t begin ,
+                                               const int64_t end ) {
+        R sum = 0 ;
+        for ( int64_t k = begin; k < end; k++ ) {
+          const uint64_t i = ( ( k & ~low ) << 1 ) | ( k & low ) ;
+          const uint64_t j = i ^ x ;
+          const auto p = conj( amp( i ) ) * amp( j ) ;
+          const R re = std::real( p ) ;
+          const R im = std::imag( p ) ;
+          for ( int t = 0; t < nbTerms; t++ ) {
+            const R w = wRe[t] * re + wIm[t] * im ;
+            sum += parity( j & z[t] ) ? -w : w ;
+          }
+        }
+        return sum ;
+      } ) ;
+    }
+    return total ;
+  }
+
+  } // namespace
+
+  // groups
+  template <typename T>
+  std::vector< typename PauliSum< T >::Group >
+  PauliSum< T >::groups( const int nbQubits , const int offset ) const {
+    assert( nbQubits_ + offset <= nbQubits ) ;
+    auto physical = [&] ( const uint64_t mask ) {
+      uint64_t bits = 0 ;
+      for ( int q = 0; q < nbQubits_; q++ ) {
+        if ( ( mask >> q ) & 1 ) {
+          bits |= uint64_t(1) << ( nbQubits - q - offset - 1 ) ;
+        }
+      }
+      return bits ;
+    } ;
+    std::map< uint64_t , Group > map ;
+    for ( const auto& term : terms_ ) {
+      const uint64_t x = physical( term.xMask ) ;
+      auto& group = map[x] ;
+      group.xMask = x ;
+      group.zMasks.push_back( physical( term.zMask ) ) ;
+      group.nbY.push_back( std::bitset< 64 >( term.xMask &
+                                              term.zMask ).count() ) ;
+      group.coefficients.push_back( term.coefficient ) ;
+    }
+    std::vector< Group > groups ;
+    groups.reserve( map.size() ) ;
+    for ( auto& [ x , group ] : map ) groups.push_back( std::move( group ) ) ;
+    return groups ;
+  }
+
+  // expectation
+  template <typename T>
+  typename PauliSum< T >::real_type
+  PauliSum< T >::expectation( const std::vector< T >& vector ) const {
+    const int n = nbQubits_ ;
+    assert( vector.size() == int64_t(1) << n ) ;
+    const T* data = vector.data() ;
+    return expectationGroups( n , groups( n , 0 ) ,
+                              [data] ( const uint64_t i ) {
+                                return data[i] ;
+                              } ) ;
+  }
+
+  // expectation
+  template <typename T>
+  typename PauliSum< T >::real_type
+  PauliSum< T >::expectation( const qclab::StateVector< T >& state ) const {
+    const int n = nbQubits_ ;
+    assert( state.nbQubits() == n ) ;
+    if ( state.layout() == Layout::Interleaved ) {
+      const T* data = state.data() ;
+      return expectationGroups( n , groups( n , 0 ) ,
+                                [data] ( const uint64_t i ) {
+                                  return data[i] ;
+                                } ) ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      const real_type* re = state.real() ;
+      const real_type* im = state.imag() ;
+      return expectationGroups( n , groups( n , 0 ) ,
+                                [re,im] ( const uint64_t i ) {
+                                  return T( re[i] , im[i] ) ;
+                                } ) ;
+    }
+    return 0 ;
+  }
+
+  // apply
+  template <typename T>
+  void PauliSum< T >::apply( Op op , const int nbQubits ,
+                             std::vector< T >& vector ,
+                             const int offset ) const {
+    const int64_t size = int64_t(1) << nbQubits ;
+    assert( vector.size() == size ) ;
+    std::vector< T > result( size ) ;
+    const auto groups = this->groups( nbQubits , offset ) ;
+    for ( const auto& group : groups ) {
+      // coefficients including i^nbY, the transpose of Y is -Y
+      const int nbTerms = group.zMasks.size() ;
+      std::vector< T > c( nbTerms ) ;
+      for ( int t = 0; t < nbTerms; t++ ) {
+        const int y = group.nbY[t] ;
+        const real_type s = ( op == Op::Trans ) && ( y & 1 ) ? -1 : 1 ;
+        const real_type r = s * group.coefficients[t] ;
+        if constexpr ( qclab::is_complex_v< T > ) {
+          const T powY[4] = { T(1) , T(0,1) , T(-1) , T(0,-1) } ;
+          c[t] = r * powY[ y % 4 ] ;
+        } else {
+          assert( ( y & 1 ) == 0 ) ;
+          c[t] = ( y % 4 == 0 ) ? r : -r ;
+        }
+      }
+      const uint64_t* z = group.zMasks.data() ;
+      const uint64_t x = group.xMask ;
+      parallel::forRange( size , [&] ( const int64_t begin ,
+                                       const int64_t end ) {
+        for ( int64_t i = begin; i < end; i++ ) {
+          const uint64_t j = i ^ x ;
+          T w = 0 ;
+          for ( int t = 0; t < nbTerms; t++ ) {
+            w += parity( j & z[t] ) ? -c[t] : c[t] ;
+          }
+          result[i] += w * vector[j] ;
+        }
+      } ) ;
+    }
+    vector = std::move( result ) ;
+  }
+
+  // print
+  template <typename T>
+  void PauliSum< T >::print() const {
+    for ( const auto& term : terms_ ) {
+      std::cout << term.coefficient << " * " ;
+      for ( int q = 0; q < nbQubits_; q++ ) {
+        const bool x = ( term.xMask >> q ) & 1 ;
+        const bool z = ( term.zMask >> q ) & 1 ;
+        std::cout << ( x ? ( z ? 'Y' : 'X' ) : ( z ? 'Z' : 'I' ) ) ;
+      }
+      std::cout << std::endl ;
+    }
+  }
+
+  template class PauliSum< float > ;
+  template class PauliSum< double > ;
+  template class PauliSum< std::complex< float > > ;
+  template class PauliSum< std::complex< double > > ;
+
+} // namespace qclab
@@ -0,0 +1,235 @@
+#include "qclab/SparseStateVector.hpp"
+#include "qclab/qgates/QControlledGate2.hpp"
+#include "qclab/qgates/QControlledGateN.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace qclab {
+
+  // SparseStateVector
+  template <typename T>
+  SparseStateVector< T >::SparseStateVector( const int nbQubits ,
+                                             const uint64_t basis )
+  : nbQubits_( nbQubits )
+  , tolerance_( 10 * std::numeric_limits< real_type >::epsilon() )
+  , density_( 1.0 / 16 )
+  , isDense_( false )
+  , entries_( { { basis , T(1) } } )
+  {
+    assert( nbQubits >= 1 && nbQubits <= maxQubits ) ;
+    assert( ( nbQubits == 64 ) || ( basis >> nbQubits ) == 0 ) ;
+  }
+
+  // operator()
+  template <typename T>
+  T SparseStateVector< T >::operator()( const uint64_t index ) const {
+    if ( isDense_ ) return dense_[ index ] ;
+    for ( const auto& entry : entries_ ) {
+      if ( entry.first == index ) return entry.second ;
+    }
+    return T(0) ;
+  }
+
+  // entries
+  template <typename T>
+  std::vector< typename SparseStateVector< T >::entry_type >
+  SparseStateVector< T >::entries() const {
+    std::vector< entry_type > entries ;
+    if ( isDense_ ) {
+      for ( uint64_t i = 0; i < dense_.size(); i++ ) {
+        if ( dense_[i] != T(0) ) entries.push_back( { i , dense_[i] } ) ;
+      }
+      return entries ;
+    }
+    entries = entries_ ;
+    std::sort( entries.begin() , entries.end() ,
+               [] ( const entry_type& a , const entry_type& b ) {
+                 return a.first < b.first ; } ) ;
+    return entries ;
+  }
+
+  // vector
+  template <typename T>
+  std::vector< T > SparseStateVector< T >::vector() const {
+    if ( isDense_ ) return dense_ ;
+    assert( nbQubits_ <= maxDenseQubits ) ;
+    std::vector< T > vector( int64_t(1) << nbQubits_ , T(0) ) ;
+    for ( const auto& entry : entries_ ) vector[ entry.first ] = entry.second ;
+    return vector ;
+  }
+
+  // apply
+  template <typename T>
+  void SparseStateVector< T >::apply( const qclab::QObject< T >& object ,
+                                      const int offset ) {
+    assert( !object.dynamic() ) ;
+    if ( isDense_ ) {
+      parallel::run( dense_.size() , [&] () {
+        parallel::call( object.teamAware() , [&] () {
+          object.apply( Op::NoTrans , nbQubits_ , dense_ , offset ) ;
+        } ) ;
+      } ) ;
+      return ;
+    }
+    applySparse( object , offset ) ;
+    updateDensity() ;
+  }
+
+  // simulate
+  template <typename T>
+  void SparseStateVector< T >::simulate( const qclab::QCircuit< T >& circuit ) {
+    assert( circuit.nbQubits() == nbQubits_ ) ;
+    assert( !circuit.dynamic() ) ;
+    sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    auto it = schedule.begin() ;
+    for ( ; ( it != schedule.end() ) && !isDense_; ++it ) {
+      applySparse( *it->object , it->offset ) ;
+      updateDensity() ;
+    }
+    // remaining items on the dense vector by a single team
+    if ( it == schedule.end() ) return ;
+    parallel::run( dense_.size() , [&] () {
+      for ( auto jt = it; jt != schedule.end(); ++jt ) {
+        parallel::call( jt->object->teamAware() , [&] () {
+          jt->object->apply( Op::NoTrans , nbQubits_ , dense_ , jt->offset ) ;
+        } ) ;
+      }
+    } ) ;
+  }
+
+  // applySparse
+  template <typename T>
+  void SparseStateVector< T >::applySparse( const qclab::QObject< T >& object ,
+                                            const int offset ) {
+    const int n = nbQubits_ ;
+    auto bit = [n] ( const int q ) { return uint64_t(1) << ( n - q - 1 ) ; } ;
+
+    // controls and target matrix
+    uint64_t controlMask = 0 ;
+    uint64_t controlValue = 0 ;
+    std::vector< int > targets ;
+    qclab::dense::SquareMatrix< T > mat ;
+    using CG2 = qgates::QControlledGate2< T > ;
+    using CGN = qgates::QControlledGateN< T > ;
+    if ( const auto* gate = dynamic_cast< const CG2* >( &object ) ) {
+      controlMask = bit( gate->control() + offset ) ;
+      controlValue = gate->controlState() ? controlMask : 0 ;
+      targets = { gate->target() } ;
+      mat = gate->gate()->matrix() ;
+    } else if ( const auto* gate = dynamic_cast< const CGN* >( &object ) ) {
+      for ( int i = 0; i < gate->controls().size(); i++ ) {
+        const uint64_t b = bit( gate->controls()[i] + offset ) ;
+        controlMask |= b ;
+        if ( gate->controlStates()[i] ) controlValue |= b ;
+      }
+      targets = gate->targets() ;
+      mat = gate->targetMatrix() ;
+    } else {
+      targets = object.qubits() ;
+      mat = object.matrix() ;
+    }
+    const int t = targets.size() ;
+    const int64_t D = int64_t(1) << t ;
+    assert( mat.rows() == D ) ;
+    std::vector< uint64_t > masks( t ) ;
+    uint64_t targetMask = 0 ;
+    for ( int j = 0; j < t; j++ ) {
+      masks[j] = bit( targets[j] + offset ) ;
+      targetMask |= masks[j] ;
+    }
+    // column of the target matrix of index i
+    auto column = [&] ( const uint64_t i ) {
+      int64_t c = 0 ;
+      for ( int j = 0; j < t; j++ ) c = ( c << 1 ) | ( ( i & masks[j] ) != 0 ) ;
+      return c ;
+    } ;
+    // bits of the target qubits of row r
+    auto deposit = [&] ( const int64_t r ) {
+      uint64_t i = 0 ;
+      for ( int j = 0; j < t; j++ ) {
+        if ( ( r >> ( t - j - 1 ) ) & 1 ) i |= masks[j] ;
+      }
+      return i ;
+    } ;
+    auto active = [&] ( const uint64_t i ) {
+      return ( i & controlMask ) == controlValue ;
+    } ;
+
+    // monomial gate: a single nonzero per column
+    std::vector< int64_t > rows( D , -1 ) ;
+    bool monomial = true ;
+    for ( int64_t c = 0; ( c < D ) && monomial; c++ ) {
+      for ( int64_t r = 0; r < D; r++ ) {
+        if ( mat(r,c) == T(0) ) continue ;
+        if ( rows[c] >= 0 ) { monomial = false ; break ; }
+        rows[c] = r ;
+      }
+      monomial = monomial && ( rows[c] >= 0 ) ;
+    }
+    if ( monomial ) {
+      const int64_t size = entries_.size() ;
+      parallel::forRange( size , [&] ( const int64_t begin ,
+                                       const int64_t end ) {
+        for ( int64_t k = begin; k < end; k++ ) {
+          auto& [ i , a ] = entries_[k] ;
+          if ( !active( i ) ) continue ;
+          const int64_t c = column( i ) ;
+          a *= mat( rows[c] , c ) ;
+          i = ( i & ~targetMask ) | deposit( rows[c] ) ;
+        }
+      } ) ;
+      return ;
+    }
+
+    // general gate: gather the amplitudes of every subspace of the targets
+    std::vector< entry_type > entries ;
+    std::unordered_map< uint64_t , int64_t > slots ;
+    std::vector< uint64_t > bases ;
+    std::vector< T > blocks ;
+    for ( const auto& [ i , a ] : entries_ ) {
+      if ( !active( i ) ) {
+        entries.push_back( { i , a } ) ;
+        continue ;
+      }
+      const uint64_t base = i & ~targetMask ;
+      const auto [ it , inserted ] = slots.try_emplace( base , bases.size() ) ;
+      if ( inserted ) {
+        bases.push_back( base ) ;
+        blocks.resize( blocks.size() + D , T(0) ) ;
+      }
+      blocks[ it->second * D + column( i ) ] = a ;
+    }
+    std::vector< T > y( D ) ;
+    for ( int64_t s = 0; s < bases.size(); s++ ) {
+      const T* x = blocks.data() + s * D ;
+      std::fill( y.begin() , y.end() , T(0) ) ;
+      for ( int64_t c = 0; c < D; c++ ) {
+        if ( x[c] == T(0) ) continue ;
+        for ( int64_t r = 0; r < D; r++ ) y[r] += mat(r,c) * x[c] ;
+      }
+      for ( int64_t r = 0; r < D; r++ ) {
+        if ( std::abs( y[r] ) > tolerance_ ) {
+          entries.push_back( { bases[s] | deposit( r ) , y[r] } ) ;
+        }
+      }
+    }
+    entries_ = std::move( entries ) ;
+  }
+
+  // updateDensity
+  template <typename T>
+  void SparseStateVector< T >::updateDensity() {
+    if ( nbQubits_ > maxDenseQubits ) return ;
+    const int64_t size = int64_t(1) << nbQubits_ ;
+    if ( entries_.size() <= density_ * size ) return ;
+    dense_.assign( size , T(0) ) ;
+    for ( const auto& [ i , a ] : entries_ ) dense_[i] = a ;
+    entries_ = std::vector< entry_type >() ;
+    isDense_ = true ;
+  }
+
+  template class SparseStateVector< std::complex< float > > ;
+  template class SparseStateVector< std::complex< double > > ;
+
+} // namespace qclab
@@ -0,0 +1,499 @@
+#include "qclab/StabilizerTableau.hpp"
+#include "qclab/qgates/Identity.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/Phase90.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/PauliY.hpp"
+#include "qclab/qgates/PauliZ.hpp"
+#include "qclab/qgates/CX.hpp"
+#include "qclab/qgates/CY.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+#include "qclab/qgates/Measurement.hpp"
+#include "qclab/qgates/Reset.hpp"
+#include "qclab/qgates/Conditional.hpp"
+#include <algorithm>
+#include <numeric>
+#include <typeinfo>
+
+namespace qclab {
+
+  namespace {
+
+    // dynamic cast of a quantum object
+    template <typename G , typename T>
+    inline const G* as( const qclab::QObject< T >& object ) {
+      return dynamic_cast< const G* >( &object ) ;
+    }
+
+    // counts of the sorted outcomes
+    Counts countOutcomes( std::vector< uint64_t >& outcomes ) {
+      std::sort( outcomes.begin() , outcomes.end() ) ;
+      Counts counts ;
+      for ( const uint64_t outcome : outcomes ) {
+        if ( counts.empty() || ( counts.back().first != outcome ) ) {
+          counts.push_back( { outcome , 0 } ) ;
+        }
+        counts.back().second++ ;
+      }
+      return counts ;
+    }
+
+  } // namespace
+
+  // StabilizerTableau
+  StabilizerTableau::StabilizerTableau( const int nbQubits )
+  : nbQubits_( nbQubits )
+  , words_( ( nbQubits + 63 ) / 64 )
+  , x_( ( 2 * nbQubits + 1 ) * words_ , 0 )
+  , z_( ( 2 * nbQubits + 1 ) * words_ , 0 )
+  , r_( 2 * nbQubits + 1 , 0 )
+  {
+    assert( nbQubits >= 1 ) ;
+    // destabilizers X_q and stabilizers Z_q
+    for ( int q = 0; q < nbQubits; q++ ) {
+      xs( q )[ q / 64 ] = uint64_t(1) << ( q % 64 ) ;
+      zs( nbQubits + q )[ q / 64 ] = uint64_t(1) << ( q % 64 ) ;
+    }
+  }
+
+  // h
+  void StabilizerTableau::h( const int q ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    const int w = q / 64 ;
+    const int b = q % 64 ;
+    parallel::forRange( 2 * nbQubits_ , [&] ( const int64_t begin ,
+                                              const int64_t end ) {
+      for ( int64_t i = begin; i < end; i++ ) {
+        uint64_t& x = x_[ i * words_ + w ] ;
+        uint64_t& z = z_[ i * words_ + w ] ;
+        r_[i] ^= ( x & z ) >> b & 1 ;
+        const uint64_t d = ( x ^ z ) & ( uint64_t(1) << b ) ;
+        x ^= d ;
+        z ^= d ;
+      }
+    } ) ;
+  }
+
+  // s
+  void StabilizerTableau::s( const int q ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    const int w = q / 64 ;
+    const int b = q % 64 ;
+    parallel::forRange( 2 * nbQubits_ , [&] ( const int64_t begin ,
+                                              const int64_t end ) {
+      for ( int64_t i = begin; i < end; i++ ) {
+        const uint64_t x = x_[ i * words_ + w ] & ( uint64_t(1) << b ) ;
+        uint64_t& z = z_[ i * words_ + w ] ;
+        r_[i] ^= ( x & z ) >> b ;
+        z ^= x ;
+      }
+    } ) ;
+  }
+
+  // x
+  void StabilizerTableau::x( const int q ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    for ( int i = 0; i < 2 * nbQubits_; i++ ) r_[i] ^= zbit( i , q ) ;
+  }
+
+  // y
+  void StabilizerTableau::y( const int q ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    for ( int i = 0; i < 2 * nbQubits_; i++ ) {
+      r_[i] ^= xbit( i , q ) ^ zbit( i , q ) ;
+    }
+  }
+
+  // z
+  void StabilizerTableau::z( const int q ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    for ( int i = 0; i < 2 * nbQubits_; i++ ) r_[i] ^= xbit( i , q ) ;
+  }
+
+  // cx
+  void StabilizerTableau::cx( const int c , const int t ) {
+    assert( c >= 0 && c < nbQubits_ ) ;
+    assert( t >= 0 && t < nbQubits_ ) ;
+    assert( c != t ) ;
+    const int wc = c / 64 , bc = c % 64 ;
+    const int wt = t / 64 , bt = t % 64 ;
+    parallel::forRange( 2 * nbQubits_ , [&] ( const int64_t begin ,
+                                              const int64_t end ) {
+      for ( int64_t i = begin; i < end; i++ ) {
+        uint64_t* x = x_.data() + i * words_ ;
+        uint64_t* z = z_.data() + i * words_ ;
+        const uint64_t xc = x[ wc ] >> bc & 1 , zc = z[ wc ] >> bc & 1 ;
+        const uint64_t xt = x[ wt ] >> bt & 1 , zt = z[ wt ] >> bt & 1 ;
+        r_[i] ^= xc & zt & ( xt ^ zc ^ 1 ) ;
+        x[ wt ] ^= xc << bt ;
+        z[ wc ] ^= zt << bc ;
+      }
+    } ) ;
+  }
+
+  // cy
+  void StabilizerTableau::cy( const int c , const int t ) {
+    // CY = S(t) CX S(t)^H and S^H = S Z
+    z( t ) ;
+    s( t ) ;
+    cx( c , t ) ;
+    s( t ) ;
+  }
+
+  // cz
+  void StabilizerTableau::cz( const int a , const int b ) {
+    assert( a >= 0 && a < nbQubits_ ) ;
+    assert( b >= 0 && b < nbQubits_ ) ;
+    assert( a != b ) ;
+    const int wa = a / 64 , ba = a % 64 ;
+    const int wb = b / 64 , bb = b % 64 ;
+    parallel::forRange( 2 * nbQubits_ , [&] ( const int64_t begin ,
+                                              const int64_t end ) {
+      for ( int64_t i = begin; i < end; i++ ) {
+        const uint64_t* x = x_.data() + i * words_ ;
+        uint64_t* z = z_.data() + i * words_ ;
+        const uint64_t xa = x[ wa ] >> ba & 1 , za = z[ wa ] >> ba & 1 ;
+        const uint64_t xb = x[ wb ] >> bb & 1 , zb = z[ wb ] >> bb & 1 ;
+        r_[i] ^= xa & xb & ( za ^ zb ) ;
+        z[ wa ] ^= xb << ba ;
+        z[ wb ] ^= xa << bb ;
+      }
+    } ) ;
+  }
+
+  // swap
+  void StabilizerTableau::swap( const int a , const int b ) {
+    assert( a >= 0 && a < nbQubits_ ) ;
+    assert( b >= 0 && b < nbQubits_ ) ;
+    if ( a == b ) return ;
+    const int wa = a / 64 , ba = a % 64 ;
+    const int wb = b / 64 , bb = b % 64 ;
+    auto swapBits = [&] ( uint64_t* v ) {
+      const uint64_t d = ( v[ wa ] >> ba ^ v[ wb ] >> bb ) & 1 ;
+      v[ wa ] ^= d << ba ;
+      v[ wb ] ^= d << bb ;
+    } ;
+    parallel::forRange( 2 * nbQubits_ , [&] ( const int64_t begin ,
+                                              const int64_t end ) {
+      for ( int64_t i = begin; i < end; i++ ) {
+        swapBits( x_.data() + i * words_ ) ;
+        swapBits( z_.data() + i * words_ ) ;
+      }
+    } ) ;
+  }
+
+  // iswap
+  void StabilizerTableau::iswap( const int a , const int b ) {
+    // iSWAP = ( S x S ) SWAP CZ
+    cz( a , b ) ;
+    swap( a , b ) ;
+    s( a ) ;
+    s( b ) ;
+  }
+
+  // rowsum
+  void StabilizerTableau::rowsum( const int h , const int i ) {
+    // 2-bit counters of the powers of i of all qubits, 64 qubits at a time
+    uint64_t* xh = xs( h ) ;
+    uint64_t* zh = zs( h ) ;
+    const uint64_t* xi = xs( i ) ;
+    const uint64_t* zi = zs( i ) ;
+    uint64_t cnt1 = 0 ;
+    uint64_t cnt2 = 0 ;
+    for ( int w = 0; w < words_; w++ ) {
+      const uint64_t x = xh[w] ^ xi[w] ;
+      const uint64_t z = zh[w] ^ zi[w] ;
+      const uint64_t xz = xi[w] & zh[w] ;
+      const uint64_t anti = ( xh[w] & zi[w] ) ^ xz ;
+      cnt2 ^= ( cnt1 ^ x ^ z ^ xz ) & anti ;
+      cnt1 ^= anti ;
+      xh[w] = x ;
+      zh[w] = z ;
+    }
+    const int s = __builtin_popcountll( cnt1 ) +
+                  2 * ( __builtin_popcountll( cnt2 ) + r_[h] + r_[i] ) ;
+    r_[h] = ( s & 3 ) >> 1 ;
+  }
+
+  // isRandom
+  bool StabilizerTableau::isRandom( const int q ) const {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    for ( int p = nbQubits_; p < 2 * nbQubits_; p++ ) {
+      if ( xbit( p , q ) ) return true ;
+    }
+    return false ;
+  }
+
+  // measure
+  int StabilizerTableau::measure( const int q , const double u ) {
+    assert( q >= 0 && q < nbQubits_ ) ;
+    const int n = nbQubits_ ;
+    int p = n ;
+    while ( ( p < 2 * n ) && !xbit( p , q ) ) p++ ;
+
+    // deterministic outcome: product of the stabilizers in the scratch row
+    if ( p == 2 * n ) {
+      std::fill( xs( 2 * n ) , xs( 2 * n ) + words_ , 0 ) ;
+      std::fill( zs( 2 * n ) , zs( 2 * n ) + words_ , 0 ) ;
+      r_[ 2 * n ] = 0 ;
+      for ( int i = 0; i < n; i++ ) {
+        if ( xbit( i , q ) ) rowsum( 2 * n , i + n ) ;
+      }
+      return r_[ 2 * n ] ;
+    }
+
+    // random outcome: the stabilizer p is replaced by +/- Z_q
+    parallel::forRange( 2 * n , [&] ( const int64_t begin ,
+                                      const int64_t end ) {
+      for ( int64_t i = begin; i < end; i++ ) {
+        if ( ( i != p ) && xbit( i , q ) ) rowsum( i , p ) ;
+      }
+    } , words_ ) ;
+    std::copy( xs( p ) , xs( p ) + words_ , xs( p - n ) ) ;
+    std::copy( zs( p ) , zs( p ) + words_ , zs( p - n ) ) ;
+    r_[ p - n ] = r_[ p ] ;
+    std::fill( xs( p ) , xs( p ) + words_ , 0 ) ;
+    std::fill( zs( p ) , zs( p ) + words_ , 0 ) ;
+    zs( p )[ q / 64 ] = uint64_t(1) << ( q % 64 ) ;
+    r_[ p ] = ( u < 0.5 ) ? 1 : 0 ;
+    return r_[ p ] ;
+  }
+
+  // stabilizers
+  std::vector< std::string > StabilizerTableau::stabilizers() const {
+    std::vector< std::string > stabilizers ;
+    for ( int i = nbQubits_; i < 2 * nbQubits_; i++ ) {
+      std::string pauli( 1 , r_[i] ? '-' : '+' ) ;
+      for ( int q = 0; q < nbQubits_; q++ ) {
+        const bool x = xbit( i , q ) ;
+        const bool z = zbit( i , q ) ;
+        pauli += x ? ( z ? 'Y' : 'X' ) : ( z ? 'Z' : 'I' ) ;
+      }
+      stabilizers.push_back( pauli ) ;
+    }
+    return stabilizers ;
+  }
+
+  // isClifford
+  template <typename T>
+  bool StabilizerTableau::isClifford( const qclab::QObject< T >& object ) {
+    using namespace qgates ;
+    if ( const auto* circuit = as< QCircuit< T > >( object ) ) {
+      for ( auto it = circuit->begin(); it != circuit->end(); ++it ) {
+        if ( !isClifford( **it ) ) return false ;
+      }
+      return true ;
+    }
+    if ( const auto* conditional = as< Conditional< T > >( object ) ) {
+      return isClifford( conditional->object() ) ;
+    }
+    // measurements with readout errors are not supported
+    if ( typeid( object ) == typeid( Measurement< T > ) ) return true ;
+    return as< Reset< T > >( object ) || as< Identity< T > >( object ) ||
+           as< Hadamard< T > >( object ) || as< Phase90< T > >( object ) ||
+           as< PauliX< T > >( object ) || as< PauliY< T > >( object ) ||
+           as< PauliZ< T > >( object ) || as< CX< T > >( object ) ||
+           as< CY< T > >( object ) || as< CZ< T > >( object ) ||
+           as< SWAP< T > >( object ) || as< iSWAP< T > >( object ) ;
+  }
+
+  // apply
+  template <typename T>
+  void StabilizerTableau::apply( const qclab::QObject< T >& object ,
+                                 qclab::ClassicalRegister& creg ,
+                                 const int offset ) {
+    using namespace qgates ;
+    if ( const auto* circuit = as< QCircuit< T > >( object ) ) {
+      for ( auto it = circuit->begin(); it != circuit->end(); ++it ) {
+        apply( **it , creg , offset + circuit->offset() ) ;
+      }
+      return ;
+    }
+    if ( const auto* conditional = as< Conditional< T > >( object ) ) {
+      if ( creg.value( conditional->bits() ) == conditional->value() ) {
+        apply( conditional->object() , creg , offset ) ;
+      }
+      return ;
+    }
+    if ( const auto* measurement = as< Measurement< T > >( object ) ) {
+      assert( typeid( object ) == typeid( Measurement< T > ) ) ;
+      const int outcome = measure( measurement->qubit() + offset ,
+                                   creg.next() ) ;
+      creg.advance() ;
+      creg.set( measurement->bit() , outcome ) ;
+      return ;
+    }
+    if ( as< Reset< T > >( object ) ) {
+      const int q = object.qubit() + offset ;
+      if ( measure( q , creg.next() ) ) x( q ) ;
+      creg.advance() ;
+      return ;
+    }
+    if ( as< Identity< T > >( object ) ) return ;
+    if ( object.nbQubits() == 1 ) {
+      const int q = object.qubit() + offset ;
+      if ( as< Hadamard< T > >( object ) ) {
+        h( q ) ;
+      } else if ( as< Phase90< T > >( object ) ) {
+        s( q ) ;
+      } else if ( as< PauliX< T > >( object ) ) {
+        x( q ) ;
+      } else if ( as< PauliY< T > >( object ) ) {
+        y( q ) ;
+      } else if ( as< PauliZ< T > >( object ) ) {
+        z( q ) ;
+      } else {
+        assert( false ) ;  // not a Clifford object
+      }
+      return ;
+    }
+    if ( as< CX< T > >( object ) || as< CY< T > >( object ) ||
+         as< CZ< T > >( object ) ) {
+      const auto* gate = as< QControlledGate2< T > >( object ) ;
+      const int c = gate->control() + offset ;
+      const int t = gate->target() + offset ;
+      if ( gate->controlState() == 0 ) x( c ) ;
+      if ( as< CX< T > >( object ) ) cx( c , t ) ;
+      if ( as< CY< T > >( object ) ) cy( c , t ) ;
+      if ( as< CZ< T > >( object ) ) cz( c , t ) ;
+      if ( gate->controlState() == 0 ) x( c ) ;
+      return ;
+    }
+    if ( as< SWAP< T > >( object ) || as< iSWAP< T > >( object ) ) {
+      const auto qubits = object.qubits() ;
+      if ( as< SWAP< T > >( object ) ) {
+        swap( qubits[0] + offset , qubits[1] + offset ) ;
+      } else {
+        iswap( qubits[0] + offset , qubits[1] + offset ) ;
+      }
+      return ;
+    }
+    assert( false ) ;  // not a Clifford object
+  }
+
+  // simulate
+  template <typename T>
+  void StabilizerTableau::simulate( const qclab::QCircuit< T >& circuit ,
+                                    qclab::ClassicalRegister& creg ) {
+    assert( circuit.nbQubits() == nbQubits_ ) ;
+    apply( circuit , creg ) ;
+  }
+
+  // sample
+  Counts StabilizerTableau::sample( const int64_t nbShots ,
+                                   const std::vector< int >& qubits ,
+                                   const uint64_t seed ) const {
+    std::vector< int > measured = qubits ;
+    if ( measured.empty() ) {
+      measured.resize( nbQubits_ ) ;
+      std::iota( measured.begin() , measured.end() , 0 ) ;
+    }
+    assert( measured.size() <= 64 ) ;
+    if ( nbShots <= 0 ) return Counts() ;
+    const qclab::Random random( seed ) ;
+    const int64_t m = measured.size() ;
+    std::vector< uint64_t > outcomes( nbShots ) ;
+    parallel::forRange( nbShots , [&] ( const int64_t begin ,
+                                        const int64_t end ) {
+      StabilizerTableau tableau( *this ) ;
+      for ( int64_t shot = begin; shot < end; shot++ ) {
+        if ( shot > begin ) tableau = *this ;
+        uint64_t outcome = 0 ;
+        for ( int64_t k = 0; k < m; k++ ) {
+          const double u = random.uniform( shot * m + k ) ;
+          outcome = ( outcome << 1 ) | tableau.measure( measured[k] , u ) ;
+        }
+        outcomes[ shot ] = outcome ;
+      }
+    } , int64_t( 2 ) * nbQubits_ * words_ ) ;
+    return countOutcomes( outcomes ) ;
+  }
+
+  // isClifford
+  template <typename T>
+  bool isClifford( const qclab::QCircuit< T >& circuit ) {
+    return StabilizerTableau::isClifford( circuit ) ;
+  }
+
+  // sample
+  template <typename T>
+  Counts sample( const qclab::QCircuit< T >& circuit , const int64_t nbShots ,
+                 const std::vector< int >& qubits , const uint64_t seed ) {
+    const int n = circuit.nbQubits() ;
+    if ( nbShots <= 0 ) return Counts() ;
+    const bool clifford = isClifford( circuit ) ;
+
+    // static circuits: a single simulation
+    if ( !circuit.dynamic() ) {
+      if ( clifford ) {
+        StabilizerTableau tableau( n ) ;
+        qclab::ClassicalRegister creg ;
+        tableau.simulate( circuit , creg ) ;
+        return tableau.sample( nbShots , qubits , seed ) ;
+      }
+      std::vector< T > vector( int64_t(1) << n , T(0) ) ;
+      vector[0] = 1 ;
+      circuit.simulate( vector ) ;
+      return qclab::sample( vector , nbShots , qubits , seed ) ;
+    }
+
+    // dynamic circuits: a simulation per shot
+    const qclab::Random random( seed ) ;
+    std::vector< uint64_t > outcomes( nbShots ) ;
+    if ( clifford ) {
+      parallel::forRange( nbShots , [&] ( const int64_t begin ,
+                                          const int64_t end ) {
+        for ( int64_t shot = begin; shot < end; shot++ ) {
+          StabilizerTableau tableau( n ) ;
+          qclab::ClassicalRegister creg( 0 , random( 2 * shot ) ) ;
+          tableau.simulate( circuit , creg ) ;
+          outcomes[ shot ] = tableau.sample( 1 , qubits ,
+                                             random( 2 * shot + 1 ) )[0].first ;
+        }
+      } , int64_t( n ) * n ) ;
+      return countOutcomes( outcomes ) ;
+    }
+    std::vector< T > vector( int64_t(1) << n ) ;
+    for ( int64_t shot = 0; shot < nbShots; shot++ ) {
+      std::fill( vector.begin() , vector.end() , T(0) ) ;
+      vector[0] = 1 ;
+      qclab::ClassicalRegister creg( 0 , random( 2 * shot ) ) ;
+      circuit.simulate( vector , creg ) ;
+      outcomes[ shot ] = qclab::sample( vector , 1 , qubits ,
+                                        random( 2 * shot + 1 ) )[0].first ;
+    }
+    return countOutcomes( outcomes ) ;
+  }
+
+  template bool StabilizerTableau::isClifford(
+    const qclab::QObject< std::complex< float > >& ) ;
+  template bool StabilizerTableau::isClifford(
+    const qclab::QObject< std::complex< double > >& ) ;
+
+  template void StabilizerTableau::apply(
+    const qclab::QObject< std::complex< float > >& ,
+    qclab::ClassicalRegister& , const int ) ;
+  template void StabilizerTableau::apply(
+    const qclab::QObject< std::complex< double > >& ,
+    qclab::ClassicalRegister& , const int ) ;
+
+  template void StabilizerTableau::simulate(
+    const qclab::QCircuit< std::complex< float > >& ,
+    qclab::ClassicalRegister& ) ;
+  template void StabilizerTableau::simulate(
+    const qclab::QCircuit< std::complex< double > >& ,
+    qclab::ClassicalRegister& ) ;
+
+  template bool isClifford( const qclab::QCircuit< std::complex< float > >& ) ;
+  template bool isClifford( const qclab::QCircuit< std::complex< double > >& ) ;
+
+  template Counts sample( const qclab::QCircuit< std::complex< float > >& ,
+                          const int64_t , const std::vector< int >& ,
+                          const uint64_t ) ;
+  template Counts sample( const qclab::QCircuit< std::complex< double > >& ,
+                          const int64_t , const std::vector< int >& ,
+                          const uint64_t ) ;
+
+} // namespace qclab
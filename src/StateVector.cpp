@@ -0,0 +1,343 @@
+#include "qclab/StateVector.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/dense/transpose.hpp"
+#include "qgates/applyN.hpp"
+
+namespace qclab {
+
+  namespace {
+
+  using qgates::simdChunk ;
+
+  // isDiagonal
+  template <typename M>
+  bool isDiagonal( const M& mat ) {
+    for ( int64_t j = 0; j < mat.size(); j++ ) {
+      for ( int64_t i = 0; i < mat.size(); i++ ) {
+        if ( ( i != j ) && ( mat(i,j) != typename M::value_type(0) ) ) {
+          return false ;
+        }
+      }
+    }
+    return true ;
+  }
+
+  // applyDiag2: diagonal 1-qubit gate diag(d0, d1) on an interleaved vector
+  template <typename T>
+  void applyDiag2( const int nbQubits , const int qubit , const T d0 ,
+                   const T d1 , T* vector ) {
+    if ( qgates::simd_applyDiag2( nbQubits , qubit , d0 , d1 , vector ) ) {
+      return ;
+    }
+    auto f = [=] ( const uint64_t a , const uint64_t b ) {
+      vector[a] *= d0 ;
+      vector[b] *= d1 ;
+    } ;
+    qgates::apply2( nbQubits , qubit , f ) ;
+  }
+
+  /*
+   * Kernels for split state vectors. The loops over contiguous runs of real
+   * and imaginary parts vectorize without shuffles. Every kernel is compiled
+   * for the default target and, if available, for AVX2 and AVX-512, and the
+   * instruction set is selected at runtime by qclab::simd::isa().
+   */
+
+  #define QCLAB_SOA_INLINE __attribute__(( always_inline )) inline
+
+  // soa_kernel2: 1-qubit gate with matrix `mr + i * mi`, row-major
+  template <typename R>
+  QCLAB_SOA_INLINE void soa_kernel2( R* r0 , R* i0 , R* r1 , R* i1 ,
+                                     const int64_t len ,
+                                     const R* mr , const R* mi ) {
+    #pragma omp simd
+    for ( int64_t l = 0; l < len; l++ ) {
+      const R x0r = r0[l] , x0i = i0[l] ;
+      const R x1r = r1[l] , x1i = i1[l] ;
+      r0[l] = mr[0] * x0r - mi[0] * x0i + mr[1] * x1r - mi[1] * x1i ;
+      i0[l] = mr[0] * x0i + mi[0] * x0r + mr[1] * x1i + mi[1] * x1r ;
+      r1[l] = mr[2] * x0r - mi[2] * x0i + mr[3] * x1r - mi[3] * x1i ;
+      i1[l] = mr[2] * x0i + mi[2] * x0r + mr[3] * x1i + mi[3] * x1r ;
+    }
+  }
+
+  // soa_kernelDiag: multiplication with `dr + i * di`
+  template <typename R>
+  QCLAB_SOA_INLINE void soa_kernelDiag( R* r , R* i , const int64_t len ,
+                                        const R dr , const R di ) {
+    #pragma omp simd
+    for ( int64_t l = 0; l < len; l++ ) {
+      const R xr = r[l] , xi = i[l] ;
+      r[l] = dr * xr - di * xi ;
+      i[l] = dr * xi + di * xr ;
+    }
+  }
+
+  // soa_kernel4: 2-qubit gate with matrix `mr + i * mi`, row-major
+  template <typename R>
+  QCLAB_SOA_INLINE void soa_kernel4( R* const* r , R* const* i ,
+                                     const int64_t len ,
+                                     const R* mr , const R* mi ) {
+    R* r0 = r[0] ; R* r1 = r[1] ; R* r2 = r[2] ; R* r3 = r[3] ;
+    R* i0 = i[0] ; R* i1 = i[1] ; R* i2 = i[2] ; R* i3 = i[3] ;
+    #pragma omp simd
+    for ( int64_t l = 0; l < len; l++ ) {
+      const R xr[4] = { r0[l] , r1[l] , r2[l] , r3[l] } ;
+      const R xi[4] = { i0[l] , i1[l] , i2[l] , i3[l] } ;
+      R yr[4] , yi[4] ;
+      for ( int p = 0; p < 4; p++ ) {
+        yr[p] = 0 ; yi[p] = 0 ;
+        for ( int c = 0; c < 4; c++ ) {
+          yr[p] += mr[4*p + c] * xr[c] - mi[4*p + c] * xi[c] ;
+          yi[p] += mr[4*p + c] * xi[c] + mi[4*p + c] * xr[c] ;
+        }
+      }
+      r0[l] = yr[0] ; r1[l] = yr[1] ; r2[l] = yr[2] ; r3[l] = yr[3] ;
+      i0[l] = yi[0] ; i1[l] = yi[1] ; i2[l] = yi[2] ; i3[l] = yi[3] ;
+    }
+  }
+
+#ifdef QCLAB_SIMD_KERNELS
+  #define QCLAB_SOA_TARGETS( kernel , params , args ) \
+    template <typename R> \
+    QCLAB_TARGET_AVX2 void kernel##_avx2 params { kernel args ; } \
+    template <typename R> \
+    QCLAB_TARGET_AVX512 void kernel##_avx512 params { kernel args ; }
+#else
+  #define QCLAB_SOA_TARGETS( kernel , params , args ) \
+    template <typename R> void kernel##_avx2 params { kernel args ; } \
+    template <typename R> void kernel##_avx512 params { kernel args ; }
+#endif
+
+  QCLAB_SOA_TARGETS( soa_kernel2 ,
+    ( R* r0 , R* i0 , R* r1 , R* i1 , const int64_t len , const R* mr ,
+      const R* mi ) ,
+    ( r0 , i0 , r1 , i1 , len , mr , mi ) )
+  QCLAB_SOA_TARGETS( soa_kernelDiag ,
+    ( R* r , R* i , const int64_t len , const R dr , const R di ) ,
+    ( r , i , len , dr , di ) )
+  QCLAB_SOA_TARGETS( soa_kernel4 ,
+    ( R* const* r , R* const* i , const int64_t len , const R* mr ,
+      const R* mi ) ,
+    ( r , i , len , mr , mi ) )
+
+  #undef QCLAB_SOA_TARGETS
+
+  // dispatches `kernel` to the current instruction set
+  #define QCLAB_SOA_DISPATCH( isa , kernel , ... ) \
+    switch ( isa ) { \
+      case qclab::simd::Isa::AVX512 : kernel##_avx512( __VA_ARGS__ ) ; break ;\
+      case qclab::simd::Isa::AVX2   : kernel##_avx2( __VA_ARGS__ ) ; break ; \
+      default                       : kernel( __VA_ARGS__ ) ; \
+    }
+
+  // soa_apply2: 1-qubit gate with matrix `m`, row-major
+  template <typename R>
+  void soa_apply2( const int nbQubits , const int qubit ,
+                   const std::complex< R >* m , R* re , R* im ) {
+    const int64_t s = int64_t(1) << ( nbQubits - qubit - 1 ) ;
+    const int64_t len = std::min( s , simdChunk ) ;
+    const int64_t n = ( int64_t(1) << ( nbQubits - 1 ) ) / len ;
+    const auto isa = qclab::simd::isa() ;
+    R mr[4] , mi[4] ;
+    for ( int k = 0; k < 4; k++ ) {
+      mr[k] = std::real( m[k] ) ;
+      mi[k] = std::imag( m[k] ) ;
+    }
+    qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+      const int64_t j = k * len ;
+      const int64_t a = ( ( j & ~(s - 1) ) << 1 ) | ( j & (s - 1) ) ;
+      QCLAB_SOA_DISPATCH( isa , soa_kernel2 , re + a , im + a ,
+                          re + a + s , im + a + s , len , mr , mi )
+    } , len ) ;
+  }
+
+  // soa_diag2: diagonal 1-qubit gate diag(d0, d1), d0 = 1 is skipped
+  template <typename R>
+  void soa_diag2( const int nbQubits , const int qubit ,
+                  const std::complex< R > d0 , const std::complex< R > d1 ,
+                  R* re , R* im ) {
+    const int64_t s = int64_t(1) << ( nbQubits - qubit - 1 ) ;
+    const int64_t len = std::min( s , simdChunk ) ;
+    const int64_t n = ( int64_t(1) << ( nbQubits - 1 ) ) / len ;
+    const auto isa = qclab::simd::isa() ;
+    const bool skip0 = ( d0 == std::complex< R >(1) ) ;
+    const R d0r = std::real( d0 ) , d0i = std::imag( d0 ) ;
+    const R d1r = std::real( d1 ) , d1i = std::imag( d1 ) ;
+    qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+      const int64_t j = k * len ;
+      const int64_t a = ( ( j & ~(s - 1) ) << 1 ) | ( j & (s - 1) ) ;
+      if ( !skip0 ) {
+        QCLAB_SOA_DISPATCH( isa , soa_kernelDiag , re + a , im + a , len ,
+                            d0r , d0i )
+      }
+      QCLAB_SOA_DISPATCH( isa , soa_kernelDiag , re + a + s , im + a + s ,
+                          len , d1r , d1i )
+    } , len ) ;
+  }
+
+  // soa_apply4: 2-qubit gate with matrix `m`, row-major, on the ascending
+  // qubits `qubit0` and `qubit1`
+  template <typename R>
+  void soa_apply4( const int nbQubits , const int qubit0 , const int qubit1 ,
+                   const std::complex< R >* m , R* re , R* im ) {
+    assert( qubit0 < qubit1 ) ;
+    uint64_t mL , mC , mR ;
+    std::tie( mL , mC , mR ) = qgates::masks( nbQubits , qubit0 , qubit1 ) ;
+    const int64_t b0 = int64_t(1) << ( nbQubits - qubit0 - 1 ) ;
+    const int64_t s  = int64_t(1) << ( nbQubits - qubit1 - 1 ) ;
+    const int64_t len = std::min( s , simdChunk ) ;
+    const int64_t n = ( int64_t(1) << ( nbQubits - 2 ) ) / len ;
+    const auto isa = qclab::simd::isa() ;
+    R mr[16] , mi[16] ;
+    for ( int k = 0; k < 16; k++ ) {
+      mr[k] = std::real( m[k] ) ;
+      mi[k] = std::imag( m[k] ) ;
+    }
+    qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+      const uint64_t j = k * len ;
+      const uint64_t a = (j & mR) + ( (j & mC) << 1 ) + ( (j & mL) << 2 ) ;
+      R* const r[4] = { re + a , re + a + s , re + a + b0 , re + a + b0 + s } ;
+      R* const i[4] = { im + a , im + a + s , im + a + b0 , im + a + b0 + s } ;
+      QCLAB_SOA_DISPATCH( isa , soa_kernel4 , r , i , len , mr , mi )
+    } , len ) ;
+  }
+
+  #undef QCLAB_SOA_DISPATCH
+
+  // soa_applyK: K-qubit gate with matrix `mat` on the ascending qubits
+  // `qubits`
+  template <typename R>
+  void soa_applyK( const int nbQubits , const int K , const int* qubits ,
+                   const qclab::dense::SquareMatrix< std::complex< R > >& mat ,
+                   R* re , R* im ) {
+    constexpr int maxD = 1 << qgates::MatrixGateN< std::complex< R > >::
+                                                                   maxQubits ;
+    const int D = 1 << K ;
+    assert( D <= maxD ) ;
+    std::vector< R > mr( D * D ) , mi( D * D ) ;
+    for ( int r = 0; r < D; r++ ) {
+      for ( int c = 0; c < D; c++ ) {
+        mr[ r*D + c ] = std::real( mat(r,c) ) ;
+        mi[ r*D + c ] = std::imag( mat(r,c) ) ;
+      }
+    }
+    std::vector< uint64_t > o( D , 0 ) ;
+    for ( int r = 0; r < D; r++ ) {
+      for ( int i = 0; i < K; i++ ) {
+        if ( r & ( 1 << ( K - i - 1 ) ) ) {
+          o[r] |= 1ULL << ( nbQubits - qubits[i] - 1 ) ;
+        }
+      }
+    }
+    const R* pr = mr.data() ; const R* pi = mi.data() ;
+    const uint64_t* po = o.data() ;
+    auto f = [=] ( const uint64_t a ) {
+      R xr[maxD] , xi[maxD] ;
+      for ( int c = 0; c < D; c++ ) {
+        xr[c] = re[ a | po[c] ] ;
+        xi[c] = im[ a | po[c] ] ;
+      }
+      for ( int r = 0; r < D; r++ ) {
+        R yr = 0 , yi = 0 ;
+        for ( int c = 0; c < D; c++ ) {
+          yr += pr[ r*D + c ] * xr[c] - pi[ r*D + c ] * xi[c] ;
+          yi += pr[ r*D + c ] * xi[c] + pi[ r*D + c ] * xr[c] ;
+        }
+        re[ a | po[r] ] = yr ;
+        im[ a | po[r] ] = yi ;
+      }
+    } ;
+    qgates::applyK( nbQubits , K , qubits , f ) ;
+  }
+
+  } // namespace
+
+  // applyMatrix
+  template <typename T>
+  void StateVector< T >::applyMatrix( Op op , const std::vector< int >& qubits ,
+                              const qclab::dense::SquareMatrix< T >& matrix ) {
+    const int K = qubits.size() ;
+    assert( K >= 1 ) ;
+    assert( K <= qgates::MatrixGateN< T >::maxQubits ) ;
+    assert( matrix.size() == 1 << K ) ;
+    assert( qubits.back() < nbQubits_ ) ;
+    if ( K == 1 ) {
+      applyMatrix( op , qubits[0] ,
+                   qclab::dense::SmallMatrix< T , 2 >( matrix ) ) ;
+      return ;
+    }
+    if ( K == 2 ) {
+      applyMatrix( op , qubits[0] , qubits[1] ,
+                   qclab::dense::SmallMatrix< T , 4 >( matrix ) ) ;
+      return ;
+    }
+    const auto mat = qclab::dense::operate( op , matrix ) ;
+    if ( layout_ == Layout::Interleaved ) {
+      qgates::applyMatrixN( Op::NoTrans , nbQubits_ , qubits.data() , K , mat ,
+                            data() ) ;
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      soa_applyK( nbQubits_ , K , qubits.data() , mat , real() , imag() ) ;
+    }
+  }
+
+  // applyMatrix
+  template <typename T>
+  void StateVector< T >::applyMatrix( Op op , const int qubit ,
+                          const qclab::dense::SmallMatrix< T , 2 >& matrix ) {
+    assert( qubit >= 0 && qubit < nbQubits_ ) ;
+    const auto mat = qclab::dense::operate( op , matrix ) ;
+    const bool diagonal = isDiagonal( mat ) ;
+    if ( layout_ == Layout::Interleaved ) {
+      if ( diagonal ) {
+        applyDiag2( nbQubits_ , qubit , mat(0,0) , mat(1,1) , data() ) ;
+      } else if ( !qgates::simd_apply2( nbQubits_ , qubit , mat , data() ) ) {
+        auto f = qgates::lambda_QGate1( Op::NoTrans , mat , data() ) ;
+        qgates::apply2( nbQubits_ , qubit , f ) ;
+      }
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      if ( diagonal ) {
+        soa_diag2( nbQubits_ , qubit , mat(0,0) , mat(1,1) , real() , imag() ) ;
+      } else {
+        const T m[4] = { mat(0,0) , mat(0,1) , mat(1,0) , mat(1,1) } ;
+        soa_apply2( nbQubits_ , qubit , m , real() , imag() ) ;
+      }
+    }
+  }
+
+  // applyMatrix
+  template <typename T>
+  void StateVector< T >::applyMatrix( Op op , const int qubit0 ,
+                                      const int qubit1 ,
+                          const qclab::dense::SmallMatrix< T , 4 >& matrix ) {
+    assert( qubit0 >= 0 && qubit0 < qubit1 && qubit1 < nbQubits_ ) ;
+    const auto mat = qclab::dense::operate( op , matrix ) ;
+    if ( layout_ == Layout::Interleaved ) {
+      const auto matS = qgates::swapped( mat ) ;
+      if ( qgates::simd_apply4( nbQubits_ , qubit0 , qubit1 , matS ,
+                                data() ) ) return ;
+      auto f = qgates::lambda_QGate2( Op::NoTrans , matS , data() ) ;
+      qgates::apply4( nbQubits_ , qubit0 , qubit1 , f ) ;
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      T m[16] ;
+      for ( int r = 0; r < 4; r++ ) {
+        for ( int c = 0; c < 4; c++ ) {
+          m[4*r + c] = mat(r,c) ;
+        }
+      }
+      soa_apply4( nbQubits_ , qubit0 , qubit1 , m , real() , imag() ) ;
+    }
+  }
+
+  template class StateVector< float > ;
+  template class StateVector< double > ;
+  template class StateVector< std::complex< float > > ;
+  template class StateVector< std::complex< double > > ;
+
+} // namespace qclab
@@ -34,7 +34,14 @@ namespace qclab::io {
 
       // parse commands
       for ( auto& command : commands ) {
-        if ( !hasQreg ) {
+        if ( command.substr( 0 , 4 ) == "creg" ) {
+          // add classical register
+          command = command.substr( 4 ) ;
+          const auto name = left_of( command , "[" ) ;
+          const auto size = read_value< int >( left_of( command , "]" ) ) ;
+          cregs_[ name ] = { nbBits_ , size } ;
+          nbBits_ += size ;
+        } else if ( !hasQreg ) {
           if ( command.substr( 0 , 4 ) == "qreg" ) {
             // set quantum register
             command = command.substr( 4 ) ;
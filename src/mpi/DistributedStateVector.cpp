@@ -0,0 +1,392 @@
+#include "qclab/mpi/DistributedStateVector.hpp"
+#include "qclab/sim/fusion.hpp"
+#include "qclab/sim/blocking.hpp"
+#include "qclab/sim/remap.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include <climits>
+#include <numeric>
+#include <stdexcept>
+
+namespace qclab::mpi {
+
+  // DistributedStateVector
+  template <typename T>
+  DistributedStateVector< T >::DistributedStateVector( const int nbQubits ,
+                                                       MPI_Comm comm )
+  : nbQubits_( nbQubits )
+  , nbGlobal_( 0 )
+  , comm_( comm )
+  , perm_( nbQubits )
+  , logical_( nbQubits )
+  {
+    int nbRanks ;
+    MPI_Comm_size( comm_ , &nbRanks ) ;
+    MPI_Comm_rank( comm_ , &rank_ ) ;
+    assert( ( nbRanks & ( nbRanks - 1 ) ) == 0 ) ;
+    while ( ( 1 << nbGlobal_ ) < nbRanks ) nbGlobal_++ ;
+    assert( nbQubits_ - nbGlobal_ >= 2 ) ;
+    std::iota( perm_.begin() , perm_.end() , 0 ) ;
+    std::iota( logical_.begin() , logical_.end() , 0 ) ;
+    local_.assign( int64_t(1) << nbLocalQubits() , T(0) ) ;
+    if ( rank_ == 0 ) local_[0] = 1 ;
+  }
+
+  // scatter
+  template <typename T>
+  void DistributedStateVector< T >::scatter( const std::vector< T >& vector ,
+                                             const int root ) {
+    assert( nbLocalQubits() < 31 ) ;
+    assert( ( rank_ != root ) || ( vector.size() == int64_t(1) << nbQubits_ ) );
+    const int count = local_.size() ;
+    MPI_Scatter( vector.data() , count , datatype< T >() , local_.data() ,
+                 count , datatype< T >() , root , comm_ ) ;
+    std::iota( perm_.begin() , perm_.end() , 0 ) ;
+    std::iota( logical_.begin() , logical_.end() , 0 ) ;
+  }
+
+  // gather
+  template <typename T>
+  void DistributedStateVector< T >::gather( std::vector< T >& vector ,
+                                            const int root ) {
+    assert( nbLocalQubits() < 31 ) ;
+    unpermute() ;
+    if ( rank_ == root ) vector.resize( int64_t(1) << nbQubits_ ) ;
+    const int count = local_.size() ;
+    MPI_Gather( local_.data() , count , datatype< T >() , vector.data() ,
+                count , datatype< T >() , root , comm_ ) ;
+  }
+
+  // norm2
+  template <typename T>
+  double DistributedStateVector< T >::norm2() const {
+    double sum = 0 ;
+    const int64_t size = local_.size() ;
+    #pragma omp parallel for reduction(+:sum) \
+                             if( parallel::nbThreads( size ) > 1 )
+    for ( int64_t i = 0; i < size; i++ ) {
+      sum += std::norm( local_[i] ) ;
+    }
+    double total = 0 ;
+    MPI_Allreduce( &sum , &total , 1 , MPI_DOUBLE , MPI_SUM , comm_ ) ;
+    return total ;
+  }
+
+  // simulate
+  template <typename T>
+  void DistributedStateVector< T >::simulate(
+                                      const qclab::QCircuit< T >& circuit ,
+                                      const sim::Options& options ) {
+    assert( circuit.nbQubits() == nbQubits_ ) ;
+    assert( !circuit.dynamic() ) ;
+    sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    if ( options.fuseDiagonal ) sim::fuseDiagonal( schedule ) ;
+    // fused gates must fit on the local qubits
+    if ( options.fuseMonomial ) {
+      sim::fuseMonomial( schedule ,
+                         std::min( qgates::MonomialGate< T >::maxQubits ,
+                                   nbLocalQubits() ) ) ;
+    }
+    if ( options.fuse1 ) sim::fuse1( schedule ) ;
+    const int k = std::min( options.fuseK , nbLocalQubits() ) ;
+    if ( k >= 2 ) sim::fuseK( schedule , k ) ;
+    apply( schedule , options.blockQubits ) ;
+  }
+
+  // apply
+  template <typename T>
+  void DistributedStateVector< T >::apply( const sim::Schedule< T >& schedule ,
+                                           const int blockQubits ) {
+    const int g = nbGlobal_ ;
+    const int nL = nbLocalQubits() ;
+    sim::Schedule< T > owner ;    // owns the relabeled objects
+    sim::Schedule< T > segment ;  // items on the local qubits
+    typename sim::Schedule< T >::vector_type items ;
+
+    // applies the pending items to the local vector
+    auto flush = [&] () {
+      if ( items.empty() ) return ;
+      segment.assign( std::move( items ) ) ;
+      items.clear() ;
+      const double start = MPI_Wtime() ;
+      parallel::run( local_.size() , [&] () {
+        if ( ( blockQubits > 0 ) && ( blockQubits < nL ) ) {
+          sim::applyBlocked( segment , nL , local_ , blockQubits ) ;
+        } else {
+          segment.apply( nL , local_ ) ;
+        }
+      } ) ;
+      timings_.compute += MPI_Wtime() - start ;
+    } ;
+
+    for ( size_t pos = 0; pos < schedule.size(); pos++ ) {
+      const auto& item = schedule[ pos ] ;
+      assert( !item.object->dynamic() ) ;
+      const auto qubits = item.object->qubits() ;
+      assert( qubits.size() <= nL ) ;
+      // SWAP gates relabel the qubits
+      if ( dynamic_cast< const qgates::SWAP< T >* >( item.object ) ) {
+        const int a = qubits[0] + item.offset ;
+        const int b = qubits[1] + item.offset ;
+        std::swap( perm_[a] , perm_[b] ) ;
+        logical_[ perm_[a] ] = a ;
+        logical_[ perm_[b] ] = b ;
+        continue ;
+      }
+      bool global = false ;
+      for ( const int q : qubits ) global |= ( perm_[ q + item.offset ] < g ) ;
+      if ( global ) {
+        // diagonal gates with the global qubits fixed by the rank
+        bool trivial = false ;
+        auto diag = localDiagonal( item , trivial ) ;
+        if ( trivial ) continue ;
+        if ( diag ) {
+          items.push_back( { owner.adopt( std::move( diag ) ) , 0 } ) ;
+          continue ;
+        }
+        // interchange the global qubits with local qubits
+        flush() ;
+        for ( const int q : qubits ) {
+          const int p = perm_[ q + item.offset ] ;
+          if ( p < g ) exchange( p , victim( schedule , pos ) ) ;
+        }
+      }
+      const auto local = sim::remap( item , perm_ , owner ) ;
+      if ( local.object == nullptr ) {
+        throw std::invalid_argument( "object can not be relabeled" ) ;
+      }
+      items.push_back( { local.object , local.offset - g } ) ;
+    }
+    flush() ;
+  }
+
+  // unpermute
+  template <typename T>
+  void DistributedStateVector< T >::unpermute() {
+    const int g = nbGlobal_ ;
+    const int nL = nbLocalQubits() ;
+    // global qubits
+    for ( int a = 0; a < g; a++ ) {
+      if ( logical_[a] == a ) continue ;
+      const int p = perm_[a] ;
+      if ( p < g ) {
+        exchangeGlobal( a , p ) ;
+      } else {
+        exchange( a , p ) ;
+      }
+    }
+    // local qubits
+    std::vector< int > perm( nL ) ;
+    for ( int q = g; q < nbQubits_; q++ ) perm[ q - g ] = perm_[q] - g ;
+    const double start = MPI_Wtime() ;
+    sim::unpermute( nL , local_ , perm ) ;
+    timings_.compute += MPI_Wtime() - start ;
+    std::iota( perm_.begin() , perm_.end() , 0 ) ;
+    std::iota( logical_.begin() , logical_.end() , 0 ) ;
+  }
+
+  // exchange
+  template <typename T>
+  void DistributedStateVector< T >::exchange( const int a , const int b ) {
+    assert( a < nbGlobal_ && b >= nbGlobal_ ) ;
+    const double start = MPI_Wtime() ;
+    const int partner = rank_ ^ ( 1 << ( nbGlobal_ - a - 1 ) ) ;
+    const uint64_t bit = uint64_t(1) << ( nbQubits_ - b - 1 ) ;
+    const uint64_t low = bit - 1 ;
+    // the amplitudes whose bit b differs from the bit a of this rank move to
+    // the same positions on the partner rank
+    const uint64_t sel = rankBit( a ) ? 0 : bit ;
+    const int64_t half = local_.size() / 2 ;
+    const int64_t chunk = std::min( half , maxMessage ) ;
+    T* v = local_.data() ;
+    if ( bit >= uint64_t( chunk ) ) {
+      // contiguous runs of at least one message
+      for ( int64_t begin = 0; begin < half; begin += chunk ) {
+        T* x = v + ( ( ( begin & ~low ) << 1 ) | sel | ( begin & low ) ) ;
+        sendrecv( x , x , chunk , partner ) ;
+      }
+    } else {
+      send_.resize( chunk ) ;
+      recv_.resize( chunk ) ;
+      for ( int64_t begin = 0; begin < half; begin += chunk ) {
+        parallel::forRange( chunk , [&] ( const int64_t first ,
+                                          const int64_t last ) {
+          for ( int64_t k = first; k < last; k++ ) {
+            const uint64_t j = begin + k ;
+            send_[k] = v[ ( ( j & ~low ) << 1 ) | sel | ( j & low ) ] ;
+          }
+        } ) ;
+        sendrecv( send_.data() , recv_.data() , chunk , partner ) ;
+        parallel::forRange( chunk , [&] ( const int64_t first ,
+                                          const int64_t last ) {
+          for ( int64_t k = first; k < last; k++ ) {
+            const uint64_t j = begin + k ;
+            v[ ( ( j & ~low ) << 1 ) | sel | ( j & low ) ] = recv_[k] ;
+          }
+        } ) ;
+      }
+    }
+    timings_.communication += MPI_Wtime() - start ;
+    timings_.nbExchanges++ ;
+    // relabel
+    const int qa = logical_[a] ;
+    const int qb = logical_[b] ;
+    perm_[ qa ] = b ;
+    perm_[ qb ] = a ;
+    logical_[a] = qb ;
+    logical_[b] = qa ;
+  }
+
+  // exchangeGlobal
+  template <typename T>
+  void DistributedStateVector< T >::exchangeGlobal( const int a ,
+                                                    const int b ) {
+    assert( a < nbGlobal_ && b < nbGlobal_ && a != b ) ;
+    if ( rankBit( a ) != rankBit( b ) ) {
+      const double start = MPI_Wtime() ;
+      const int partner = rank_ ^ ( 1 << ( nbGlobal_ - a - 1 ) )
+                                ^ ( 1 << ( nbGlobal_ - b - 1 ) ) ;
+      const int64_t size = local_.size() ;
+      const int64_t chunk = std::min( size , maxMessage ) ;
+      for ( int64_t begin = 0; begin < size; begin += chunk ) {
+        sendrecv( local_.data() + begin , local_.data() + begin , chunk ,
+                  partner ) ;
+      }
+      timings_.communication += MPI_Wtime() - start ;
+      timings_.nbExchanges++ ;
+    }
+    // relabel
+    const int qa = logical_[a] ;
+    const int qb = logical_[b] ;
+    perm_[ qa ] = b ;
+    perm_[ qb ] = a ;
+    logical_[a] = qb ;
+    logical_[b] = qa ;
+  }
+
+  // sendrecv
+  template <typename T>
+  void DistributedStateVector< T >::sendrecv( const T* send , T* recv ,
+                                              const int64_t count ,
+                                              const int partner ) {
+    assert( count <= INT_MAX ) ;
+    if ( send == recv ) {
+      MPI_Sendrecv_replace( recv , count , datatype< T >() , partner , 0 ,
+                            partner , 0 , comm_ , MPI_STATUS_IGNORE ) ;
+    } else {
+      MPI_Sendrecv( send , count , datatype< T >() , partner , 0 ,
+                    recv , count , datatype< T >() , partner , 0 , comm_ ,
+                    MPI_STATUS_IGNORE ) ;
+    }
+    timings_.bytes += count * sizeof( T ) ;
+  }
+
+  // victim
+  template <typename T>
+  int DistributedStateVector< T >::victim( const sim::Schedule< T >& schedule ,
+                                           const size_t pos ) const {
+    const int g = nbGlobal_ ;
+    // local qubits that are not used by the item
+    std::vector< bool > used( nbQubits_ , false ) ;
+    for ( const int q : schedule[ pos ].object->qubits() ) {
+      used[ perm_[ q + schedule[ pos ].offset ] ] = true ;
+    }
+    int nbCandidates = 0 ;
+    for ( int p = g; p < nbQubits_; p++ ) nbCandidates += !used[p] ;
+    assert( nbCandidates > 0 ) ;
+    // next use of the candidates by items that need them local
+    std::vector< size_t > next( nbQubits_ , SIZE_MAX ) ;
+    int found = 0 ;
+    const size_t end = std::min( schedule.size() , pos + 1 + lookahead ) ;
+    for ( size_t i = pos + 1; ( i < end ) && ( found < nbCandidates - 1 );
+          i++ ) {
+      const auto& item = schedule[i] ;
+      if ( dynamic_cast< const qgates::SWAP< T >* >( item.object ) ||
+           dynamic_cast< const qgates::DiagonalGate< T >* >( item.object ) ||
+           sim::isDiagonal( *item.object ) ) continue ;
+      for ( const int q : item.object->qubits() ) {
+        const int p = perm_[ q + item.offset ] ;
+        if ( ( p >= g ) && !used[p] && ( next[p] == SIZE_MAX ) ) {
+          next[p] = i ;
+          found++ ;
+        }
+      }
+    }
+    int best = -1 ;
+    for ( int p = g; p < nbQubits_; p++ ) {
+      if ( used[p] ) continue ;
+      if ( ( best < 0 ) || ( next[p] > next[ best ] ) ) best = p ;
+    }
+    return best ;
+  }
+
+  // localDiagonal
+  template <typename T>
+  std::unique_ptr< qgates::DiagonalGate< T > >
+  DistributedStateVector< T >::localDiagonal(
+                                const typename sim::Schedule< T >::Item& item ,
+                                bool& trivial ) const {
+    using diag_type = qgates::DiagonalGate< T > ;
+    const int g = nbGlobal_ ;
+    const auto* diagonal = dynamic_cast< const diag_type* >( item.object ) ;
+    trivial = false ;
+    if ( !diagonal && !sim::isDiagonal( *item.object ) ) return nullptr ;
+    auto gate = std::make_unique< diag_type >() ;
+    T scale = 1 ;
+    // 1-qubit diagonal d on the logical qubit q
+    auto add1 = [&] ( const int q , const typename diag_type::diag1_type& d ) {
+      const int p = perm_[q] ;
+      if ( p < g ) {
+        scale *= d[ rankBit( p ) ] ;
+      } else {
+        gate->multiply( p - g , d ) ;
+      }
+    } ;
+    // 2-qubit diagonal d on the logical qubits q0 and q1
+    auto add2 = [&] ( const int q0 , const int q1 ,
+                      const typename diag_type::diag2_type& d ) {
+      const int p0 = perm_[ q0 ] ;
+      const int p1 = perm_[ q1 ] ;
+      if ( ( p0 < g ) && ( p1 < g ) ) {
+        scale *= d[ 2 * rankBit( p0 ) + rankBit( p1 ) ] ;
+      } else if ( p0 < g ) {
+        const int x = rankBit( p0 ) ;
+        gate->multiply( p1 - g , { d[ 2*x ] , d[ 2*x + 1 ] } ) ;
+      } else if ( p1 < g ) {
+        const int x = rankBit( p1 ) ;
+        gate->multiply( p0 - g , { d[x] , d[ 2 + x ] } ) ;
+      } else if ( p0 < p1 ) {
+        gate->multiply( p0 - g , p1 - g , d ) ;
+      } else {
+        gate->multiply( p1 - g , p0 - g , { d[0] , d[2] , d[1] , d[3] } ) ;
+      }
+    } ;
+    if ( diagonal ) {
+      for ( const auto& [ q , d ] : diagonal->factors1() ) {
+        add1( q + item.offset , d ) ;
+      }
+      for ( const auto& [ pq , d ] : diagonal->factors2() ) {
+        add2( pq.first + item.offset , pq.second + item.offset , d ) ;
+      }
+    } else {
+      const auto qubits = item.object->qubits() ;
+      const auto mat = item.object->matrix() ;
+      if ( qubits.size() == 1 ) {
+        add1( qubits[0] + item.offset , { mat(0,0) , mat(1,1) } ) ;
+      } else {
+        add2( qubits[0] + item.offset , qubits[1] + item.offset ,
+              { mat(0,0) , mat(1,1) , mat(2,2) , mat(3,3) } ) ;
+      }
+    }
+    if ( scale != T(1) ) gate->multiply( 0 , { scale , scale } ) ;
+    if ( gate->factors1().empty() && gate->factors2().empty() ) {
+      trivial = true ;
+      return nullptr ;
+    }
+    return gate ;
+  }
+
+  template class DistributedStateVector< std::complex< float > > ;
+  template class DistributedStateVector< std::complex< double > > ;
+
+} // namespace qclab::mpi
@@ -0,0 +1,137 @@
+#include "qclab/noise/Channel.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include <cmath>
+
+namespace qclab::noise {
+
+  // applyKraus
+  template <typename T>
+  int applyKraus( const int nbQubits , const int qubit ,
+                  std::vector< T >& vector , qclab::ClassicalRegister& creg ,
+                  const std::vector< qclab::dense::SmallMatrix< T , 2 > >&
+                    kraus ,
+                  const std::vector< double >& probabilities ) {
+    using R = qclab::real_t< T > ;
+    assert( qubit >= 0 && qubit < nbQubits ) ;
+    assert( vector.size() == int64_t(1) << nbQubits ) ;
+    assert( probabilities.empty() ||
+            ( probabilities.size() == kraus.size() ) ) ;
+    const int nbKraus = kraus.size() ;
+    const bool mixed = !probabilities.empty() ;
+
+    // probabilities of the Kraus operators
+    std::vector< double > p( probabilities ) ;
+    if ( !mixed ) {
+      // reduced density matrix of the qubit, summed over a fixed number of
+      // chunks such that the trajectory does not depend on the number of
+      // threads
+      const int64_t half = int64_t(1) << ( nbQubits - 1 ) ;
+      const uint64_t bit = uint64_t(1) << ( nbQubits - qubit - 1 ) ;
+      const uint64_t low = bit - 1 ;
+      const T* data = vector.data() ;
+      const int64_t nbChunks = std::min< int64_t >( half ,
+                                   qclab::ClassicalRegister::maxPartials / 4 ) ;
+      double* partials = creg.partials() ;
+      parallel::forEach( nbChunks , [&] ( const int64_t c ) {
+        double rho00 = 0 , rho11 = 0 , re10 = 0 , im10 = 0 ;
+        for ( int64_t k = half * c / nbChunks; k < half * ( c + 1 ) / nbChunks;
+              k++ ) {
+          const uint64_t i0 = ( ( k & ~low ) << 1 ) | ( k & low ) ;
+          const T a0 = data[ i0 ] ;
+          const T a1 = data[ i0 | bit ] ;
+          rho00 += std::norm( a0 ) ;
+          rho11 += std::norm( a1 ) ;
+          if constexpr ( qclab::is_complex_v< T > ) {
+            const T x = a1 * std::conj( a0 ) ;
+            re10 += x.real() ;
+            im10 += x.imag() ;
+          } else {
+            re10 += a1 * a0 ;
+          }
+        }
+        partials[ 4*c     ] = rho00 ;
+        partials[ 4*c + 1 ] = rho11 ;
+        partials[ 4*c + 2 ] = re10 ;
+        partials[ 4*c + 3 ] = im10 ;
+      } , half / nbChunks ) ;
+      double rho00 = 0 , rho11 = 0 , re10 = 0 , im10 = 0 ;
+      for ( int64_t c = 0; c < nbChunks; c++ ) {
+        rho00 += partials[ 4*c     ] ;
+        rho11 += partials[ 4*c + 1 ] ;
+        re10  += partials[ 4*c + 2 ] ;
+        im10  += partials[ 4*c + 3 ] ;
+      }
+      // p_k = trace( K_k^H K_k rho )
+      p.resize( nbKraus ) ;
+      for ( int k = 0; k < nbKraus; k++ ) {
+        const auto& K = kraus[k] ;
+        const double e00 = std::norm( K(0,0) ) + std::norm( K(1,0) ) ;
+        const double e11 = std::norm( K(0,1) ) + std::norm( K(1,1) ) ;
+        const auto e01 = std::conj( K(0,0) ) * K(0,1) +
+                         std::conj( K(1,0) ) * K(1,1) ;
+        const double re01 = std::real( e01 ) ;
+        const double im01 = std::imag( e01 ) ;
+        p[k] = std::max( e00 * rho00 + e11 * rho11 +
+                         2 * ( re01 * re10 - im01 * im10 ) , 0.0 ) ;
+      }
+    }
+
+    // draw a Kraus operator
+    double total = 0 ;
+    for ( int k = 0; k < nbKraus; k++ ) total += p[k] ;
+    const double u = creg.next() * total ;
+    int selected = -1 ;
+    double cumulative = 0 ;
+    for ( int k = 0; k < nbKraus; k++ ) {
+      if ( p[k] <= 0 ) continue ;
+      selected = k ;
+      cumulative += p[k] ;
+      if ( u < cumulative ) break ;
+    }
+    assert( selected >= 0 ) ;
+
+    // apply and renormalize
+    const auto& K = kraus[ selected ] ;
+    const R tol = 10 * std::numeric_limits< R >::epsilon() ;
+    const bool identity = mixed &&
+                          ( std::abs( K(0,0) - T(1) ) < tol ) &&
+                          ( std::abs( K(1,1) - T(1) ) < tol ) &&
+                          ( std::abs( K(0,1) ) < tol ) &&
+                          ( std::abs( K(1,0) ) < tol ) ;
+    if ( identity ) {
+      // all threads must have drawn the random number before it advances
+      parallel::barrier() ;
+    } else {
+      const R scale = mixed ? 1 : 1 / std::sqrt( p[ selected ] / total ) ;
+      qgates::MatrixGate1< T >( qubit , scale * K(0,0) , scale * K(0,1) ,
+                                        scale * K(1,0) , scale * K(1,1) )
+        .apply( Op::NoTrans , nbQubits , vector ) ;
+    }
+    parallel::forEach( 1 , [&] ( const int ) { creg.advance() ; } ) ;
+    return selected ;
+  }
+
+  template int applyKraus( const int , const int , std::vector< float >& ,
+                           qclab::ClassicalRegister& ,
+                           const std::vector<
+                             qclab::dense::SmallMatrix< float , 2 > >& ,
+                           const std::vector< double >& ) ;
+  template int applyKraus( const int , const int , std::vector< double >& ,
+                           qclab::ClassicalRegister& ,
+                           const std::vector<
+                             qclab::dense::SmallMatrix< double , 2 > >& ,
+                           const std::vector< double >& ) ;
+  template int applyKraus( const int , const int ,
+                           std::vector< std::complex< float > >& ,
+                           qclab::ClassicalRegister& ,
+                           const std::vector< qclab::dense::SmallMatrix<
+                             std::complex< float > , 2 > >& ,
+                           const std::vector< double >& ) ;
+  template int applyKraus( const int , const int ,
+                           std::vector< std::complex< double > >& ,
+                           qclab::ClassicalRegister& ,
+                           const std::vector< qclab::dense::SmallMatrix<
+                             std::complex< double > , 2 > >& ,
+                           const std::vector< double >& ) ;
+
+} // namespace qclab::noise
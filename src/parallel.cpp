@@ -0,0 +1,69 @@
+#include "qclab/parallel.hpp"
+#include <atomic>
+#include <cstdlib>
+
+namespace qclab::parallel {
+
+  namespace {
+
+  // initial
+  int64_t initial() {
+    const char* env = std::getenv( "QCLAB_OMP_THRESHOLD" ) ;
+    if ( env != nullptr ) {
+      char* end = nullptr ;
+      const long long value = std::strtoll( env , &end , 10 ) ;
+      if ( ( end != env ) && ( value > 0 ) ) return value ;
+    }
+    return 4096 ;
+  }
+
+  // current
+  std::atomic< int64_t >& current() {
+    static std::atomic< int64_t > threshold( initial() ) ;
+    return threshold ;
+  }
+
+  // member of a persistent team
+  thread_local bool member = false ;
+
+  } // namespace
+
+  // threshold
+  int64_t threshold() {
+    return current().load( std::memory_order_relaxed ) ;
+  }
+
+  // setThreshold
+  void setThreshold( const int64_t threshold ) {
+    current().store( std::max< int64_t >( threshold , 1 ) ,
+                     std::memory_order_relaxed ) ;
+  }
+
+  // nbThreads
+  int nbThreads( const int64_t work ) {
+  #ifdef _OPENMP
+    const int64_t t = work / threshold() ;
+    return int( std::clamp< int64_t >( t , 1 , omp_get_max_threads() ) ) ;
+  #else
+    return 1 ;
+  #endif
+  }
+
+  // inTeam
+  bool inTeam() {
+    return member ;
+  }
+
+  // Team
+  Team::Team( const bool isMember )
+  : previous_( member )
+  {
+    member = isMember ;
+  }
+
+  // ~Team
+  Team::~Team() {
+    member = previous_ ;
+  }
+
+} // namespace qclab::parallel
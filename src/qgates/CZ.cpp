@@ -7,7 +7,7 @@ namespace qclab::qgates {
   template <typename T>
   void CZ< T >::apply( Op op , const int nbQubits , std::vector< T >& vector ,
                        const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     const int control = this->control() + offset ;
@@ -22,7 +22,7 @@ namespace qclab::qgates {
   template <typename T>
   void CZ< T >::apply_device( Op op , const int nbQubits , T* vector ,
                               const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     const int control = this->control() + offset ;
@@ -0,0 +1,394 @@
+#include "qclab/qgates/DiagonalGate.hpp"
+#include "qclab/parallel.hpp"
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace qclab::qgates {
+
+  namespace {
+
+    // number of least significant qubits covered by a table of partial
+    // products, the table fits in the L1 cache
+    constexpr int tableQubits = 10 ;
+
+    // mul: complex multiplication without the checks for infinities
+    template <typename T>
+    inline T mul( const T a , const T b ) {
+      if constexpr ( qclab::is_complex_v< T > ) {
+        return T( a.real() * b.real() - a.imag() * b.imag() ,
+                  a.real() * b.imag() + a.imag() * b.real() ) ;
+      } else {
+        return a * b ;
+      }
+    }
+
+    // factors of a diagonal gate on absolute qubits
+    template <typename T>
+    struct Factors {
+      std::vector< std::pair< int , std::array< T , 2 > > >  f1 ;
+      std::vector< std::tuple< int , int , std::array< T , 4 > > >  f2 ;
+    } ;
+
+    // returns the factors of `gate` shifted by `offset` with operation `op`
+    template <typename T>
+    Factors< T > factors( const DiagonalGate< T >& gate , Op op ,
+                          const int offset ) {
+      auto operate = [op] ( T d ) {
+        if constexpr ( qclab::is_complex_v< T > ) {
+          if ( op == Op::ConjTrans ) return std::conj( d ) ;
+        }
+        return d ;
+      } ;
+      Factors< T > f ;
+      for ( const auto& [ q , d ] : gate.factors1() ) {
+        f.f1.push_back( { q + offset ,
+                          { operate( d[0] ) , operate( d[1] ) } } ) ;
+      }
+      for ( const auto& [ q , d ] : gate.factors2() ) {
+        f.f2.push_back( { q.first + offset , q.second + offset ,
+                          { operate( d[0] ) , operate( d[1] ) ,
+                            operate( d[2] ) , operate( d[3] ) } } ) ;
+      }
+      return f ;
+    }
+
+    /*
+     * sweep: calls `scale( base , c , tab , len )` for all blocks of `len`
+     * consecutive amplitudes of a vector of `nbQubits` qubits. The diagonal
+     * of the block starting at `base` equals c * tab[0:len].
+     *
+     * The table covers the L least significant qubits. For every block, the
+     * factors on the other qubits reduce to the scalar c, and the factors
+     * between both groups of qubits reduce to 1-qubit factors on the L
+     * qubits. The table is built from these 1-qubit factors by doubling and
+     * is reused for all blocks if there are no such mixed factors.
+     */
+    template <typename T, typename F>
+    void sweep( const int nbQubits , const Factors< T >& f , F& scale ) {
+      using diag1 = std::array< T , 2 > ;
+      const int L = std::min( nbQubits , tableQubits ) ;
+      const int lo = nbQubits - L ;  // first qubit of the table
+      const int64_t len = int64_t(1) << L ;
+      const int64_t nb  = int64_t(1) << lo ;
+      auto bit = [nbQubits] ( const uint64_t i , const int q ) {
+        return ( i >> ( nbQubits - q - 1 ) ) & 1 ;
+      } ;
+
+      // classify factors
+      std::vector< diag1 > g0( L , { T(1) , T(1) } ) ;
+      std::vector< std::pair< int , diag1 > > high1 ;
+      std::vector< std::tuple< int , int , std::array< T , 4 > > > high2 ,
+                                                                  mixed , low2 ;
+      for ( const auto& [ q , d ] : f.f1 ) {
+        assert( q >= 0 && q < nbQubits ) ;
+        if ( q >= lo ) {
+          g0[ q - lo ] = { mul( g0[ q - lo ][0] , d[0] ) ,
+                           mul( g0[ q - lo ][1] , d[1] ) } ;
+        } else {
+          high1.push_back( { q , d } ) ;
+        }
+      }
+      for ( const auto& term : f.f2 ) {
+        const int p = std::get< 0 >( term ) ;
+        const int q = std::get< 1 >( term ) ;
+        assert( p >= 0 && p < q && q < nbQubits ) ;
+        if ( p >= lo ) {
+          low2.push_back( term ) ;
+        } else if ( q >= lo ) {
+          mixed.push_back( term ) ;
+        } else {
+          high2.push_back( term ) ;
+        }
+      }
+
+      // table of the 2-qubit factors on the table qubits
+      std::vector< T > tab2 ;
+      if ( !low2.empty() ) {
+        tab2.assign( len , T(1) ) ;
+        for ( int64_t l = 0; l < len; l++ ) {
+          for ( const auto& [ p , q , d ] : low2 ) {
+            tab2[l] = mul( tab2[l] , d[ 2 * bit( l , p ) + bit( l , q ) ] ) ;
+          }
+        }
+      }
+
+      // builds the table of the 1-qubit factors `g`
+      auto build = [&] ( const diag1* g , T* tab ) {
+        tab[0] = T(1) ;
+        for ( int k = 0 , size = 1; k < L; k++ , size *= 2 ) {
+          for ( int64_t j = size - 1; j >= 0; j-- ) {
+            tab[ 2*j + 1 ] = mul( tab[j] , g[k][1] ) ;
+            tab[ 2*j ]     = mul( tab[j] , g[k][0] ) ;
+          }
+        }
+        if ( !tab2.empty() ) {
+          for ( int64_t l = 0; l < len; l++ ) tab[l] = mul( tab[l] , tab2[l] ) ;
+        }
+      } ;
+
+      // shared table if there are no mixed factors
+      std::vector< T > tab0 ;
+      if ( mixed.empty() ) {
+        tab0.resize( len ) ;
+        build( g0.data() , tab0.data() ) ;
+      }
+
+      qclab::parallel::forRange( nb , [&] ( const int64_t begin ,
+                                            const int64_t end ) {
+        std::vector< T > tab ;
+        std::vector< diag1 > g ;
+        if ( !mixed.empty() ) {
+          tab.resize( len ) ;
+          g.resize( L ) ;
+        }
+        for ( int64_t k = begin; k < end; k++ ) {
+          const uint64_t base = k << L ;
+          // scalar factor
+          T c(1) ;
+          for ( const auto& [ q , d ] : high1 ) {
+            c = mul( c , d[ bit( base , q ) ] ) ;
+          }
+          for ( const auto& [ p , q , d ] : high2 ) {
+            c = mul( c , d[ 2 * bit( base , p ) + bit( base , q ) ] ) ;
+          }
+          if ( mixed.empty() ) {
+            scale( base , c , tab0.data() , len ) ;
+            continue ;
+          }
+          // mixed factors
+          std::copy( g0.begin() , g0.end() , g.begin() ) ;
+          for ( const auto& [ p , q , d ] : mixed ) {
+            const int x = 2 * bit( base , p ) ;
+            g[ q - lo ] = { mul( g[ q - lo ][0] , d[x] ) ,
+                            mul( g[ q - lo ][1] , d[x + 1] ) } ;
+          }
+          build( g.data() , tab.data() ) ;
+          scale( base , c , tab.data() , len ) ;
+        }
+      } , len ) ;
+    }
+
+  } // namespace
+
+  // multiply
+  template <typename T>
+  void DiagonalGate< T >::multiply( const int qubit , const diag1_type& diag ) {
+    assert( qubit >= 0 ) ;
+    auto [ it , inserted ] = factors1_.insert( { qubit , diag } ) ;
+    if ( !inserted ) {
+      it->second = { it->second[0] * diag[0] , it->second[1] * diag[1] } ;
+    }
+    updateQubits() ;
+  }
+
+  // multiply
+  template <typename T>
+  void DiagonalGate< T >::multiply( const int qubit0 , const int qubit1 ,
+                                    const diag2_type& diag ) {
+    assert( qubit0 >= 0 ) ;
+    assert( qubit0 < qubit1 ) ;
+    auto [ it , inserted ] = factors2_.insert( { { qubit0 , qubit1 } , diag } );
+    if ( !inserted ) {
+      for ( int i = 0; i < 4; i++ ) it->second[i] *= diag[i] ;
+    }
+    updateQubits() ;
+  }
+
+  // multiply
+  template <typename T>
+  void DiagonalGate< T >::multiply( const std::vector< int >& qubits ,
+                              const qclab::dense::SquareMatrix< T >& matrix ) {
+    assert( matrix.size() == 1 << qubits.size() ) ;
+    if ( qubits.size() == 1 ) {
+      multiply( qubits[0] , { matrix(0,0) , matrix(1,1) } ) ;
+    } else {
+      assert( qubits.size() == 2 ) ;
+      multiply( qubits[0] , qubits[1] ,
+                { matrix(0,0) , matrix(1,1) , matrix(2,2) , matrix(3,3) } ) ;
+    }
+  }
+
+  // updateQubits
+  template <typename T>
+  void DiagonalGate< T >::updateQubits() {
+    qubits_.clear() ;
+    for ( const auto& factor : factors1_ ) {
+      qubits_.push_back( factor.first ) ;
+    }
+    for ( const auto& factor : factors2_ ) {
+      qubits_.push_back( factor.first.first ) ;
+      qubits_.push_back( factor.first.second ) ;
+    }
+    std::sort( qubits_.begin() , qubits_.end() ) ;
+    qubits_.erase( std::unique( qubits_.begin() , qubits_.end() ) ,
+                   qubits_.end() ) ;
+  }
+
+  // setQubits
+  template <typename T>
+  void DiagonalGate< T >::setQubits( const int* qubits ) {
+    assert( qubits[0] >= 0 ) ;
+    for ( int i = 1; i < nbQubits(); i++ ) {
+      assert( qubits[i] > qubits[i-1] ) ;
+    }
+    auto map = [&] ( const int qubit ) {
+      return qubits[ std::lower_bound( qubits_.begin() , qubits_.end() ,
+                                       qubit ) - qubits_.begin() ] ;
+    } ;
+    std::map< int , diag1_type > factors1 ;
+    for ( const auto& [ q , d ] : factors1_ ) {
+      factors1[ map( q ) ] = d ;
+    }
+    std::map< std::pair< int , int > , diag2_type > factors2 ;
+    for ( const auto& [ q , d ] : factors2_ ) {
+      factors2[ { map( q.first ) , map( q.second ) } ] = d ;
+    }
+    factors1_ = std::move( factors1 ) ;
+    factors2_ = std::move( factors2 ) ;
+    updateQubits() ;
+  }
+
+  // matrix
+  template <typename T>
+  qclab::dense::SquareMatrix< T > DiagonalGate< T >::matrix() const {
+    // diagonal on the qubits of this gate
+    DiagonalGate< T > local( *this ) ;
+    std::vector< int > qubits( nbQubits() ) ;
+    std::iota( qubits.begin() , qubits.end() , 0 ) ;
+    local.setQubits( qubits.data() ) ;
+    std::vector< T > diag( int64_t(1) << nbQubits() , T(1) ) ;
+    local.apply( Op::NoTrans , nbQubits() , diag ) ;
+    // matrix
+    qclab::dense::SquareMatrix< T > mat( diag.size() , T(0) ) ;
+    for ( int64_t i = 0; i < diag.size(); i++ ) {
+      mat(i,i) = diag[i] ;
+    }
+    return mat ;
+  }
+
+  // apply
+  template <typename T>
+  void DiagonalGate< T >::apply( Op op , const int nbQubits ,
+                                 std::vector< T >& vector ,
+                                 const int offset ) const {
+    assert( vector.size() == int64_t(1) << nbQubits ) ;
+    T* v = vector.data() ;
+    auto scale = [v] ( const uint64_t base , const T c , const T* tab ,
+                       const int64_t len ) {
+      T* p = v + base ;
+      for ( int64_t l = 0; l < len; l++ ) {
+        p[l] = mul( p[l] , mul( c , tab[l] ) ) ;
+      }
+    } ;
+    sweep( nbQubits , factors( *this , op , offset ) , scale ) ;
+  }
+
+  // apply
+  template <typename T>
+  void DiagonalGate< T >::apply( Op op , const int nbQubits ,
+                                 qclab::StateVector< T >& state ,
+                                 const int offset ) const {
+    assert( state.nbQubits() == nbQubits ) ;
+    if ( state.layout() == Layout::Interleaved ) {
+      T* v = state.data() ;
+      auto scale = [v] ( const uint64_t base , const T c , const T* tab ,
+                         const int64_t len ) {
+        T* p = v + base ;
+        for ( int64_t l = 0; l < len; l++ ) {
+          p[l] = mul( p[l] , mul( c , tab[l] ) ) ;
+        }
+      } ;
+      sweep( nbQubits , factors( *this , op , offset ) , scale ) ;
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      using R = qclab::real_t< T > ;
+      R* re = state.real() ;
+      R* im = state.imag() ;
+      auto scale = [re,im] ( const uint64_t base , const T c , const T* tab ,
+                             const int64_t len ) {
+        R* pr = re + base ;
+        R* pi = im + base ;
+        for ( int64_t l = 0; l < len; l++ ) {
+          const T z = mul( c , tab[l] ) ;
+          const R xr = pr[l] , xi = pi[l] ;
+          pr[l] = z.real() * xr - z.imag() * xi ;
+          pi[l] = z.real() * xi + z.imag() * xr ;
+        }
+      } ;
+      sweep( nbQubits , factors( *this , op , offset ) , scale ) ;
+    }
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void DiagonalGate< T >::apply_device( Op op , const int nbQubits ,
+                                        T* vector , const int offset ) const {
+    const auto f = factors( *this , op , offset ) ;
+    const int m1 = f.f1.size() ;
+    const int m2 = f.f2.size() ;
+    std::vector< int > q1( m1 ) , q2( 2 * m2 ) ;
+    std::vector< T > d1( 2 * m1 ) , d2( 4 * m2 ) ;
+    for ( int i = 0; i < m1; i++ ) {
+      q1[i] = nbQubits - f.f1[i].first - 1 ;
+      std::copy( f.f1[i].second.begin() , f.f1[i].second.end() , &d1[2*i] ) ;
+    }
+    for ( int i = 0; i < m2; i++ ) {
+      q2[2*i]   = nbQubits - std::get< 0 >( f.f2[i] ) - 1 ;
+      q2[2*i+1] = nbQubits - std::get< 1 >( f.f2[i] ) - 1 ;
+      const auto& d = std::get< 2 >( f.f2[i] ) ;
+      std::copy( d.begin() , d.end() , &d2[4*i] ) ;
+    }
+    const int* pq1 = q1.data() ; const T* pd1 = d1.data() ;
+    const int* pq2 = q2.data() ; const T* pd2 = d2.data() ;
+    const uint64_t n = 1ULL << nbQubits ;
+    #pragma omp target teams distribute parallel for \
+            map(to: pq1[0:m1], pd1[0:2*m1], pq2[0:2*m2], pd2[0:4*m2])
+    for ( uint64_t i = 0; i < n; i++ ) {
+      T z(1) ;
+      for ( int k = 0; k < m1; k++ ) {
+        z *= pd1[ 2*k + ( ( i >> pq1[k] ) & 1 ) ] ;
+      }
+      for ( int k = 0; k < m2; k++ ) {
+        z *= pd2[ 4*k + 2 * ( ( i >> pq2[2*k] ) & 1 )
+                      + ( ( i >> pq2[2*k+1] ) & 1 ) ] ;
+      }
+      vector[i] *= z ;
+    }
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void DiagonalGate< T >::apply( Side side , Op op , const int nbQubits ,
+                                 qclab::dense::SquareMatrix< T >& matrix ,
+                                 const int offset ) const {
+    assert( matrix.size() == 1 << nbQubits ) ;
+    std::vector< T > diag( matrix.size() , T(1) ) ;
+    apply( op , nbQubits , diag , offset ) ;
+    const int64_t size = matrix.size() ;
+    if ( side == Side::Left ) {
+      // matrix *= diag
+      for ( int64_t j = 0; j < size; j++ ) {
+        for ( int64_t i = 0; i < size; i++ ) {
+          matrix(i,j) *= diag[j] ;
+        }
+      }
+    } else {
+      // matrix = diag * matrix
+      for ( int64_t j = 0; j < size; j++ ) {
+        for ( int64_t i = 0; i < size; i++ ) {
+          matrix(i,j) *= diag[i] ;
+        }
+      }
+    }
+  }
+
+  template class DiagonalGate< float > ;
+  template class DiagonalGate< double > ;
+  template class DiagonalGate< std::complex< float > > ;
+  template class DiagonalGate< std::complex< double > > ;
+
+} // namespace qclab::qgates
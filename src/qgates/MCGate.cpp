@@ -0,0 +1,78 @@
+#include "qclab/qgates/MCGate.hpp"
+#include "apply.hpp"
+
+namespace qclab::qgates {
+
+  // apply
+  template <typename T>
+  void MCGate< T >::apply( Op op , const int nbQubits ,
+                           std::vector< T >& vector , const int offset ) const {
+    assert( vector.size() == int64_t(1) << nbQubits ) ;
+    const auto [ qubits , a1 , b1 ] = this->subspace( nbQubits , offset ) ;
+    const qclab::dense::SmallMatrix< T , 2 > mat1( matrix_ ) ;
+    auto f = lambda_QGate1( op , mat1 , vector.data() ) ;
+    applyMC( nbQubits , qubits , a1 , b1 , f ) ;
+  }
+
+  // apply
+  template <typename T>
+  void MCGate< T >::apply( Op op , const int nbQubits ,
+                           qclab::StateVector< T >& state ,
+                           const int offset ) const {
+    assert( state.nbQubits() == nbQubits ) ;
+    const auto [ qubits , a1 , b1 ] = this->subspace( nbQubits , offset ) ;
+    qclab::dense::SmallMatrix< T , 2 > mat1( matrix_ ) ;
+    if ( state.layout() == Layout::Interleaved ) {
+      auto f = lambda_QGate1( op , mat1 , state.data() ) ;
+      applyMC( nbQubits , qubits , a1 , b1 , f ) ;
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      using R = qclab::real_t< T > ;
+      qclab::dense::operateInPlace( op , mat1 ) ;
+      const T m11 = mat1( 0 , 0 ) ; const T m12 = mat1( 0 , 1 ) ;
+      const T m21 = mat1( 1 , 0 ) ; const T m22 = mat1( 1 , 1 ) ;
+      R* re = state.real() ;
+      R* im = state.imag() ;
+      auto f = [=] ( const uint64_t a , const uint64_t b ) {
+        const R xar = re[a] , xai = im[a] ;
+        const R xbr = re[b] , xbi = im[b] ;
+        re[a] = m11.real() * xar - m11.imag() * xai +
+                m12.real() * xbr - m12.imag() * xbi ;
+        im[a] = m11.real() * xai + m11.imag() * xar +
+                m12.real() * xbi + m12.imag() * xbr ;
+        re[b] = m21.real() * xar - m21.imag() * xai +
+                m22.real() * xbr - m22.imag() * xbi ;
+        im[b] = m21.real() * xai + m21.imag() * xar +
+                m22.real() * xbi + m22.imag() * xbr ;
+      } ;
+      applyMC( nbQubits , qubits , a1 , b1 , f ) ;
+    }
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void MCGate< T >::apply_device( Op op , const int nbQubits , T* vector ,
+                                  const int offset ) const {
+    const auto [ qubits , a1 , b1 ] = this->subspace( nbQubits , offset ) ;
+    const qclab::dense::SmallMatrix< T , 2 > mat1( matrix_ ) ;
+    auto f = lambda_QGate1( op , mat1 , vector ) ;
+    apply_deviceMC( nbQubits , qubits , a1 , b1 , f ) ;
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void MCGate< T >::apply( Side side , Op op , const int nbQubits ,
+                           qclab::dense::SquareMatrix< T >& matrix ,
+                           const int offset ) const {
+    QControlledGateN< T >::apply( side , op , nbQubits , matrix , offset ) ;
+  }
+
+  template class MCGate< float > ;
+  template class MCGate< double > ;
+  template class MCGate< std::complex< float > > ;
+  template class MCGate< std::complex< double > > ;
+
+} // namespace qclab::qgates
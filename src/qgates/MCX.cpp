@@ -0,0 +1,64 @@
+#include "qclab/qgates/MCX.hpp"
+#include "apply.hpp"
+
+namespace qclab::qgates {
+
+  // apply
+  template <typename T>
+  void MCX< T >::apply( Op op , const int nbQubits , std::vector< T >& vector ,
+                        const int offset ) const {
+    assert( vector.size() == int64_t(1) << nbQubits ) ;
+    const auto [ qubits , a1 , b1 ] = this->subspace( nbQubits , offset ) ;
+    auto f = lambda_PauliX( op , vector.data() ) ;
+    applyMC( nbQubits , qubits , a1 , b1 , f ) ;
+  }
+
+  // apply
+  template <typename T>
+  void MCX< T >::apply( Op op , const int nbQubits ,
+                        qclab::StateVector< T >& state ,
+                        const int offset ) const {
+    assert( state.nbQubits() == nbQubits ) ;
+    const auto [ qubits , a1 , b1 ] = this->subspace( nbQubits , offset ) ;
+    if ( state.layout() == Layout::Interleaved ) {
+      auto f = lambda_PauliX( op , state.data() ) ;
+      applyMC( nbQubits , qubits , a1 , b1 , f ) ;
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      using R = qclab::real_t< T > ;
+      R* re = state.real() ;
+      R* im = state.imag() ;
+      auto f = [=] ( const uint64_t a , const uint64_t b ) {
+        std::swap( re[a] , re[b] ) ;
+        std::swap( im[a] , im[b] ) ;
+      } ;
+      applyMC( nbQubits , qubits , a1 , b1 , f ) ;
+    }
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void MCX< T >::apply_device( Op op , const int nbQubits , T* vector ,
+                               const int offset ) const {
+    const auto [ qubits , a1 , b1 ] = this->subspace( nbQubits , offset ) ;
+    auto f = lambda_PauliX( op , vector ) ;
+    apply_deviceMC( nbQubits , qubits , a1 , b1 , f ) ;
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void MCX< T >::apply( Side side , Op op , const int nbQubits ,
+                        qclab::dense::SquareMatrix< T >& matrix ,
+                        const int offset ) const {
+    MCGate< T >::apply( side , op , nbQubits , matrix , offset ) ;
+  }
+
+  template class MCX< float > ;
+  template class MCX< double > ;
+  template class MCX< std::complex< float > > ;
+  template class MCX< std::complex< double > > ;
+
+} // namespace qclab::qgates
@@ -0,0 +1,106 @@
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "applyN.hpp"
+
+namespace qclab::qgates {
+
+  // apply
+  template <typename T>
+  void MatrixGateN< T >::apply( Op op , const int nbQubits ,
+                                std::vector< T >& vector ,
+                                const int offset ) const {
+    assert( this->nbQubits() <= maxQubits ) ;
+    int qubits[ maxQubits ] ;
+    for ( int i = 0; i < this->nbQubits(); i++ ) {
+      qubits[i] = qubits_[i] + offset ;
+    }
+    applyMatrixN( op , nbQubits , qubits , this->nbQubits() ,
+                  matrix_ , vector.data() ) ;
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void MatrixGateN< T >::apply_device( Op op , const int nbQubits ,
+                                       T* vector , const int offset ) const {
+    assert( this->nbQubits() <= maxQubits ) ;
+    int q[ maxQubits ] ;
+    for ( int i = 0; i < this->nbQubits(); i++ ) {
+      q[i] = qubits_[i] + offset ;
+    }
+    switch ( this->nbQubits() ) {
+      case 1 : {
+        const qclab::dense::SmallMatrix< T , 2 > mat1( matrix_ ) ;
+        auto f = lambda_QGate1( op , mat1 , vector ) ;
+        apply_device2( nbQubits , q[0] , f ) ;
+        break ;
+      }
+      case 2 : {
+        auto f = lambda_QGate2( op , swapped( matrix_ ) , vector ) ;
+        apply_device4( nbQubits , q[0] , q[1] , f ) ;
+        break ;
+      }
+      case 3 : {
+        auto f = lambda_QGateK< 3 >( op , matrix_ , nbQubits , q , vector ) ;
+        apply_deviceK( nbQubits , 3 , q , f ) ;
+        break ;
+      }
+      case 4 : {
+        auto f = lambda_QGateK< 4 >( op , matrix_ , nbQubits , q , vector ) ;
+        apply_deviceK( nbQubits , 4 , q , f ) ;
+        break ;
+      }
+      case 5 : {
+        auto f = lambda_QGateK< 5 >( op , matrix_ , nbQubits , q , vector ) ;
+        apply_deviceK( nbQubits , 5 , q , f ) ;
+        break ;
+      }
+      case 6 : {
+        auto f = lambda_QGateK< 6 >( op , matrix_ , nbQubits , q , vector ) ;
+        apply_deviceK( nbQubits , 6 , q , f ) ;
+        break ;
+      }
+      default :
+        assert( false ) ;
+    }
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void MatrixGateN< T >::apply( Side side , Op op , const int nbQubits ,
+                                qclab::dense::SquareMatrix< T >& matrix ,
+                                const int offset ) const {
+    assert( nbQubits >= this->nbQubits() ) ;
+    assert( matrix.size() == 1 << nbQubits ) ;
+    auto qubits = this->qubits() ;
+    for ( auto& qubit : qubits ) { qubit += offset ; }
+    assert( qubits.back() < nbQubits ) ;
+    // operation
+    qclab::dense::SquareMatrix< T >  matN = matrix_ ;
+    qclab::dense::operateInPlace( op , matN ) ;
+    // side
+    const int64_t size = matrix.size() ;
+    if ( side == Side::Left ) {
+      // matrix *= matN  <=>  matrix^T = matN^T * matrix^T
+      qclab::dense::transInPlace( matN ) ;
+      qclab::dense::transInPlace( matrix ) ;
+      for ( int64_t j = 0; j < size; j++ ) {
+        applyMatrixN( Op::NoTrans , nbQubits , qubits.data() , this->nbQubits(),
+                      matN , matrix.ptr() + j * size ) ;
+      }
+      qclab::dense::transInPlace( matrix ) ;
+    } else {
+      // matrix = matN * matrix
+      for ( int64_t j = 0; j < size; j++ ) {
+        applyMatrixN( Op::NoTrans , nbQubits , qubits.data() , this->nbQubits(),
+                      matN , matrix.ptr() + j * size ) ;
+      }
+    }
+  }
+
+  template class MatrixGateN< float > ;
+  template class MatrixGateN< double > ;
+  template class MatrixGateN< std::complex< float > > ;
+  template class MatrixGateN< std::complex< double > > ;
+
+} // namespace qclab::qgates
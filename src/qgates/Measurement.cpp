@@ -0,0 +1,72 @@
+#include "qclab/qgates/Measurement.hpp"
+#include <cmath>
+
+namespace qclab::qgates {
+
+  // measure
+  template <typename T>
+  int measure( const int nbQubits , const int qubit ,
+               std::vector< T >& vector , qclab::ClassicalRegister& creg ,
+               const bool reset ) {
+    using R = qclab::real_t< T > ;
+    assert( qubit >= 0 && qubit < nbQubits ) ;
+    assert( vector.size() == int64_t(1) << nbQubits ) ;
+    const int64_t half = int64_t(1) << ( nbQubits - 1 ) ;
+    const uint64_t bit = uint64_t(1) << ( nbQubits - qubit - 1 ) ;
+    const uint64_t low = bit - 1 ;
+    T* data = vector.data() ;
+
+    // probability of outcome 1, summed over a fixed number of chunks such
+    // that the outcome does not depend on the number of threads
+    const int64_t nbChunks = std::min< int64_t >( half ,
+                                 qclab::ClassicalRegister::maxPartials ) ;
+    double* partials = creg.partials() ;
+    parallel::forEach( nbChunks , [&] ( const int64_t c ) {
+      double sum = 0 ;
+      for ( int64_t k = half * c / nbChunks; k < half * ( c + 1 ) / nbChunks;
+            k++ ) {
+        const uint64_t i = ( ( k & ~low ) << 1 ) | bit | ( k & low ) ;
+        sum += std::norm( data[i] ) ;
+      }
+      partials[c] = sum ;
+    } , half / nbChunks ) ;
+    double p1 = 0 ;
+    for ( int64_t c = 0; c < nbChunks; c++ ) p1 += partials[c] ;
+    p1 = std::min( p1 , 1.0 ) ;
+
+    // collapse and renormalize
+    const int outcome = ( creg.next() < p1 ) ? 1 : 0 ;
+    const R scale = 1 / std::sqrt( outcome ? p1 : 1 - p1 ) ;
+    parallel::forRange( half , [&] ( const int64_t begin ,
+                                     const int64_t end ) {
+      for ( int64_t k = begin; k < end; k++ ) {
+        const uint64_t i0 = ( ( k & ~low ) << 1 ) | ( k & low ) ;
+        const uint64_t i1 = i0 | bit ;
+        if ( outcome == 0 ) {
+          data[ i0 ] *= scale ;
+          data[ i1 ] = 0 ;
+        } else if ( reset ) {
+          data[ i0 ] = scale * data[ i1 ] ;
+          data[ i1 ] = 0 ;
+        } else {
+          data[ i0 ] = 0 ;
+          data[ i1 ] *= scale ;
+        }
+      }
+    } ) ;
+    parallel::forEach( 1 , [&] ( const int ) { creg.advance() ; } ) ;
+    return outcome ;
+  }
+
+  template int measure( const int , const int , std::vector< float >& ,
+                        qclab::ClassicalRegister& , const bool ) ;
+  template int measure( const int , const int , std::vector< double >& ,
+                        qclab::ClassicalRegister& , const bool ) ;
+  template int measure( const int , const int ,
+                        std::vector< std::complex< float > >& ,
+                        qclab::ClassicalRegister& , const bool ) ;
+  template int measure( const int , const int ,
+                        std::vector< std::complex< double > >& ,
+                        qclab::ClassicalRegister& , const bool ) ;
+
+} // namespace qclab::qgates
@@ -0,0 +1,396 @@
+#include "qclab/qgates/MonomialGate.hpp"
+#include "qclab/parallel.hpp"
+#include "qclab/dense/transpose.hpp"
+#include <algorithm>
+
+namespace qclab::qgates {
+
+  namespace {
+
+    // mul: complex multiplication without the checks for infinities
+    template <typename T>
+    inline T mul( const T a , const T b ) {
+      if constexpr ( qclab::is_complex_v< T > ) {
+        return T( a.real() * b.real() - a.imag() * b.imag() ,
+                  a.real() * b.imag() + a.imag() * b.real() ) ;
+      } else {
+        return a * b ;
+      }
+    }
+
+    // conjugate
+    template <typename T>
+    inline T conjugate( const T a ) {
+      if constexpr ( qclab::is_complex_v< T > ) {
+        return std::conj( a ) ;
+      } else {
+        return a ;
+      }
+    }
+
+    // offsets in a vector of `nbQubits` qubits of the local basis states on
+    // the absolute qubits `qubits`
+    inline std::vector< uint64_t > offsets( const int nbQubits ,
+                                            const std::vector< int >& qubits ) {
+      const int m = qubits.size() ;
+      std::vector< uint64_t > off( int64_t(1) << m , 0 ) ;
+      for ( int j = 0; j < m; j++ ) {
+        assert( qubits[j] >= 0 && qubits[j] < nbQubits ) ;
+        const uint64_t bit = 1ULL << ( nbQubits - qubits[j] - 1 ) ;
+        const int64_t  loc = int64_t(1) << ( m - j - 1 ) ;
+        for ( int64_t a = loc; a < off.size(); a = ( a + 1 ) | loc ) {
+          off[a] |= bit ;
+        }
+      }
+      return off ;
+    }
+
+    /*
+     * permute: applies the monomial gate `perm`, `phase` on the absolute
+     * qubits `qubits`, or its transpose if `forward` is false, to the vector
+     * of `nbQubits` qubits accessed by `load( i )` and `store( i , z )`. The
+     * phases are conjugated if `conj` is true.
+     *
+     * The permutation is applied in place cycle by cycle, which only requires
+     * a buffer for the last amplitudes of every cycle. The vector is split in
+     * chunks of the 2^m local basis states times the 2^r basis states of the
+     * r least significant other qubits, such that the vector is swept once
+     * and the innermost loops run over contiguous amplitudes.
+     */
+    template <typename T, typename Load, typename Store>
+    void permute( const std::vector< int64_t >& perm ,
+                  const std::vector< T >& phase ,
+                  const std::vector< int >& qubits , const bool forward ,
+                  const bool conj , const int nbQubits , Load& load ,
+                  Store& store ) {
+      const int m = qubits.size() ;
+      const int64_t D = perm.size() ;
+      const auto offL = offsets( nbQubits , qubits ) ;
+
+      // steps of the cycles: save v[src] in the buffer, v[dst] = ph * v[src]
+      // or v[dst] = ph * buffer
+      enum Kind { Save , Move , Restore } ;
+      struct Step { Kind kind ; uint64_t dst ; uint64_t src ; T ph ; } ;
+      std::vector< Step > steps ;
+      std::vector< bool > done( D , false ) ;
+      auto ph = [&] ( const int64_t x ) {
+        return conj ? conjugate( phase[x] ) : phase[x] ;
+      } ;
+      for ( int64_t x = 0; x < D; x++ ) {
+        if ( done[x] ) continue ;
+        std::vector< int64_t > c ;  // c[j+1] = perm[c[j]]
+        for ( int64_t y = x; !done[y]; y = perm[y] ) {
+          done[y] = true ;
+          c.push_back( y ) ;
+        }
+        const int64_t L = c.size() ;
+        if ( L == 1 ) {
+          if ( phase[x] != T(1) ) {
+            steps.push_back( { Move , offL[x] , offL[x] , ph( x ) } ) ;
+          }
+        } else if ( forward ) {
+          // v[c[j+1]] = ph[c[j]] * v[c[j]]
+          steps.push_back( { Save , 0 , offL[ c[L-1] ] , T(1) } ) ;
+          for ( int64_t j = L - 1; j > 0; j-- ) {
+            steps.push_back( { Move , offL[ c[j] ] , offL[ c[j-1] ] ,
+                               ph( c[j-1] ) } ) ;
+          }
+          steps.push_back( { Restore , offL[ c[0] ] , 0 , ph( c[L-1] ) } ) ;
+        } else {
+          // v[c[j]] = ph[c[j]] * v[c[j+1]]
+          steps.push_back( { Save , 0 , offL[ c[0] ] , T(1) } ) ;
+          for ( int64_t j = 0; j < L - 1; j++ ) {
+            steps.push_back( { Move , offL[ c[j] ] , offL[ c[j+1] ] ,
+                               ph( c[j] ) } ) ;
+          }
+          steps.push_back( { Restore , offL[ c[L-1] ] , 0 , ph( c[L-1] ) } ) ;
+        }
+      }
+      if ( steps.empty() ) return ;
+
+      // r least significant other qubits
+      const int r = std::max( 0 , std::min( MonomialGate< T >::chunkQubits - m ,
+                                            nbQubits - m ) ) ;
+      std::vector< int > pos ;     // positions of the chunk bits
+      for ( const int q : qubits ) pos.push_back( nbQubits - q - 1 ) ;
+      std::vector< int > inner ;   // absolute qubits of the other bits
+      for ( int p = 0; ( p < nbQubits ) && ( inner.size() < r ); p++ ) {
+        if ( std::find( pos.begin() , pos.end() , p ) == pos.end() ) {
+          inner.insert( inner.begin() , nbQubits - p - 1 ) ;
+          pos.push_back( p ) ;
+        }
+      }
+      std::sort( pos.begin() , pos.end() ) ;
+      const auto offR = offsets( nbQubits , inner ) ;
+      const int64_t R = offR.size() ;
+      const uint64_t n = 1ULL << ( nbQubits - m - r ) ;
+      // inner amplitudes are contiguous
+      const bool contiguous = ( inner.empty() ||
+                                ( inner[0] == nbQubits - r ) ) ;
+
+      qclab::parallel::forRange( n , [&] ( const int64_t begin ,
+                                           const int64_t end ) {
+        std::vector< T > buffer( R ) ;
+        T* b = buffer.data() ;
+        for ( int64_t k = begin; k < end; k++ ) {
+          uint64_t base = k ;
+          for ( const int p : pos ) {
+            const uint64_t mR = ( 1ULL << p ) - 1 ;
+            base = ( ( base & ~mR ) << 1 ) | ( base & mR ) ;
+          }
+          for ( const auto& s : steps ) {
+            const uint64_t i = base + s.dst ;
+            const uint64_t j = base + s.src ;
+            const T z = s.ph ;
+            const bool unit = ( z == T(1) ) ;
+            if ( contiguous ) {
+              if ( s.kind == Save ) {
+                for ( int64_t l = 0; l < R; l++ ) b[l] = load( j + l ) ;
+              } else if ( s.kind == Restore ) {
+                if ( unit ) {
+                  for ( int64_t l = 0; l < R; l++ ) store( i + l , b[l] ) ;
+                } else {
+                  for ( int64_t l = 0; l < R; l++ ) {
+                    store( i + l , mul( z , b[l] ) ) ;
+                  }
+                }
+              } else if ( unit ) {
+                for ( int64_t l = 0; l < R; l++ ) {
+                  store( i + l , load( j + l ) ) ;
+                }
+              } else {
+                for ( int64_t l = 0; l < R; l++ ) {
+                  store( i + l , mul( z , load( j + l ) ) ) ;
+                }
+              }
+            } else {
+              for ( int64_t l = 0; l < R; l++ ) {
+                if ( s.kind == Save ) {
+                  b[l] = load( j + offR[l] ) ;
+                } else {
+                  const T w = ( s.kind == Move ) ? load( j + offR[l] ) : b[l] ;
+                  store( i + offR[l] , unit ? w : mul( z , w ) ) ;
+                }
+              }
+            }
+          }
+        }
+      } , int64_t( steps.size() ) * R ) ;
+    }
+
+  } // namespace
+
+  // multiply
+  template <typename T>
+  void MonomialGate< T >::multiply( const std::vector< int >& qubits ,
+                              const qclab::dense::SquareMatrix< T >& matrix ) {
+    const int k = qubits.size() ;
+    assert( k > 0 ) ;
+    assert( matrix.size() == 1 << k ) ;
+    assert( std::is_sorted( qubits.begin() , qubits.end() ) ) ;
+
+    // extend the local basis states with the new qubits
+    std::vector< int > merged( qubits_ ) ;
+    merged.insert( merged.end() , qubits.begin() , qubits.end() ) ;
+    std::sort( merged.begin() , merged.end() ) ;
+    merged.erase( std::unique( merged.begin() , merged.end() ) ,
+                  merged.end() ) ;
+    assert( merged.size() <= maxQubits ) ;
+    const int m = merged.size() ;
+    auto bitOf = [&merged,m] ( const int qubit ) {
+      return m - ( std::lower_bound( merged.begin() , merged.end() , qubit ) -
+                   merged.begin() ) - 1 ;
+    } ;
+    if ( m > nbQubits() ) {
+      const int m0 = nbQubits() ;
+      std::vector< int > bits( m0 ) ;
+      uint64_t mask = 0 ;
+      for ( int j = 0; j < m0; j++ ) {
+        bits[j] = bitOf( qubits_[j] ) ;
+        mask |= 1ULL << bits[j] ;
+      }
+      std::vector< int64_t > perm( int64_t(1) << m ) ;
+      std::vector< T > phase( perm.size() ) ;
+      for ( int64_t x = 0; x < perm.size(); x++ ) {
+        int64_t x0 = 0 ;
+        for ( int j = 0; j < m0; j++ ) {
+          x0 |= ( ( x >> bits[j] ) & 1 ) << ( m0 - j - 1 ) ;
+        }
+        int64_t y = x & ~mask ;
+        for ( int j = 0; j < m0; j++ ) {
+          y |= ( ( perm_[x0] >> ( m0 - j - 1 ) ) & 1 ) << bits[j] ;
+        }
+        perm[x]  = y ;
+        phase[x] = phase_[x0] ;
+      }
+      qubits_ = merged ;
+      perm_   = std::move( perm ) ;
+      phase_  = std::move( phase ) ;
+    }
+
+    // columns of the monomial matrix
+    const int64_t K = matrix.size() ;
+    std::vector< int64_t > row( K , -1 ) ;
+    for ( int64_t c = 0; c < K; c++ ) {
+      for ( int64_t i = 0; i < K; i++ ) {
+        if ( matrix(i,c) != T(0) ) {
+          assert( row[c] < 0 ) ;  // monomial
+          row[c] = i ;
+        }
+      }
+      assert( row[c] >= 0 ) ;
+    }
+
+    // apply the matrix to the images of the local basis states
+    std::vector< int > bits( k ) ;
+    int64_t mask = 0 ;
+    for ( int i = 0; i < k; i++ ) {
+      bits[i] = bitOf( qubits[i] ) ;
+      mask |= int64_t(1) << bits[i] ;
+    }
+    for ( int64_t x = 0; x < perm_.size(); x++ ) {
+      const int64_t y = perm_[x] ;
+      int64_t c = 0 ;
+      for ( int i = 0; i < k; i++ ) {
+        c |= ( ( y >> bits[i] ) & 1 ) << ( k - i - 1 ) ;
+      }
+      int64_t z = y & ~mask ;
+      for ( int i = 0; i < k; i++ ) {
+        z |= ( ( row[c] >> ( k - i - 1 ) ) & 1 ) << bits[i] ;
+      }
+      perm_[x]  = z ;
+      phase_[x] = matrix( row[c] , c ) * phase_[x] ;
+    }
+  }
+
+  // matrix
+  template <typename T>
+  qclab::dense::SquareMatrix< T > MonomialGate< T >::matrix() const {
+    qclab::dense::SquareMatrix< T > mat( perm_.size() , T(0) ) ;
+    for ( int64_t x = 0; x < perm_.size(); x++ ) {
+      mat( perm_[x] , x ) = phase_[x] ;
+    }
+    return mat ;
+  }
+
+  // apply
+  template <typename T>
+  void MonomialGate< T >::apply( Op op , const int nbQubits ,
+                                 std::vector< T >& vector ,
+                                 const int offset ) const {
+    assert( vector.size() == int64_t(1) << nbQubits ) ;
+    auto qubits = qubits_ ;
+    for ( auto& qubit : qubits ) { qubit += offset ; }
+    T* v = vector.data() ;
+    auto load  = [v] ( const uint64_t i ) { return v[i] ; } ;
+    auto store = [v] ( const uint64_t i , const T z ) { v[i] = z ; } ;
+    permute( perm_ , phase_ , qubits , op == Op::NoTrans ,
+             op == Op::ConjTrans , nbQubits , load , store ) ;
+  }
+
+  // apply
+  template <typename T>
+  void MonomialGate< T >::apply( Op op , const int nbQubits ,
+                                 qclab::StateVector< T >& state ,
+                                 const int offset ) const {
+    assert( state.nbQubits() == nbQubits ) ;
+    auto qubits = qubits_ ;
+    for ( auto& qubit : qubits ) { qubit += offset ; }
+    if ( state.layout() == Layout::Interleaved ) {
+      T* v = state.data() ;
+      auto load  = [v] ( const uint64_t i ) { return v[i] ; } ;
+      auto store = [v] ( const uint64_t i , const T z ) { v[i] = z ; } ;
+      permute( perm_ , phase_ , qubits , op == Op::NoTrans ,
+               op == Op::ConjTrans , nbQubits , load , store ) ;
+      return ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      using R = qclab::real_t< T > ;
+      R* re = state.real() ;
+      R* im = state.imag() ;
+      auto load  = [re,im] ( const uint64_t i ) {
+        return T( re[i] , im[i] ) ;
+      } ;
+      auto store = [re,im] ( const uint64_t i , const T z ) {
+        re[i] = z.real() ;
+        im[i] = z.imag() ;
+      } ;
+      permute( perm_ , phase_ , qubits , op == Op::NoTrans ,
+               op == Op::ConjTrans , nbQubits , load , store ) ;
+    }
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void MonomialGate< T >::apply_device( Op op , const int nbQubits ,
+                                        T* vector , const int offset ) const {
+    const int m = this->nbQubits() ;
+    const int64_t D = perm_.size() ;
+    auto qubits = qubits_ ;
+    for ( auto& qubit : qubits ) { qubit += offset ; }
+    const auto off = offsets( nbQubits , qubits ) ;
+    // local sources and phases of the local destinations
+    std::vector< int64_t > src( D ) ;
+    std::vector< T > ph( D ) ;
+    std::vector< int > pos( m ) ;
+    for ( int64_t x = 0; x < D; x++ ) {
+      const int64_t a = ( op == Op::NoTrans ) ? perm_[x] : x ;
+      src[a] = ( op == Op::NoTrans ) ? x : perm_[x] ;
+      ph[a]  = ( op == Op::ConjTrans ) ? conjugate( phase_[x] ) : phase_[x] ;
+    }
+    for ( int j = 0; j < m; j++ ) pos[j] = nbQubits - qubits[j] - 1 ;
+    const uint64_t mask = off[ D - 1 ] ;
+    const int64_t* psrc = src.data() ; const T* pph = ph.data() ;
+    const uint64_t* poff = off.data() ; const int* ppos = pos.data() ;
+    const uint64_t n = 1ULL << nbQubits ;
+    const int device = omp_get_default_device() ;
+    T* tmp = static_cast< T* >( omp_target_alloc( n * sizeof( T ) , device ) ) ;
+    #pragma omp target teams distribute parallel for is_device_ptr( tmp )
+    for ( uint64_t i = 0; i < n; i++ ) {
+      tmp[i] = vector[i] ;
+    }
+    #pragma omp target teams distribute parallel for is_device_ptr( tmp ) \
+            map(to: psrc[0:D], pph[0:D], poff[0:D], ppos[0:m])
+    for ( uint64_t i = 0; i < n; i++ ) {
+      int64_t a = 0 ;
+      for ( int j = 0; j < m; j++ ) {
+        a |= int64_t( ( i >> ppos[j] ) & 1 ) << ( m - j - 1 ) ;
+      }
+      vector[i] = pph[a] * tmp[ ( i & ~mask ) | poff[ psrc[a] ] ] ;
+    }
+    omp_target_free( tmp , device ) ;
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void MonomialGate< T >::apply( Side side , Op op , const int nbQubits ,
+                                 qclab::dense::SquareMatrix< T >& matrix ,
+                                 const int offset ) const {
+    assert( matrix.size() == 1 << nbQubits ) ;
+    auto qubits = qubits_ ;
+    for ( auto& qubit : qubits ) { qubit += offset ; }
+    // op(G) = G, G^T or conj(G^T), and op(G)^T = G^T, G or conj(G)
+    const bool forward = ( side == Side::Left ) ? ( op != Op::NoTrans )
+                                                : ( op == Op::NoTrans ) ;
+    const bool conj = ( op == Op::ConjTrans ) ;
+    const int64_t size = matrix.size() ;
+    // matrix *= op(G)  <=>  matrix^T = op(G)^T * matrix^T
+    if ( side == Side::Left ) qclab::dense::transInPlace( matrix ) ;
+    for ( int64_t j = 0; j < size; j++ ) {
+      T* v = matrix.ptr() + j * size ;
+      auto load  = [v] ( const uint64_t i ) { return v[i] ; } ;
+      auto store = [v] ( const uint64_t i , const T z ) { v[i] = z ; } ;
+      permute( perm_ , phase_ , qubits , forward , conj , nbQubits , load ,
+               store ) ;
+    }
+    if ( side == Side::Left ) qclab::dense::transInPlace( matrix ) ;
+  }
+
+  template class MonomialGate< float > ;
+  template class MonomialGate< double > ;
+  template class MonomialGate< std::complex< float > > ;
+  template class MonomialGate< std::complex< double > > ;
+
+} // namespace qclab::qgates
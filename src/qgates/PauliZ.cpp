@@ -1,5 +1,6 @@
 #include "qclab/qgates/PauliZ.hpp"
 #include "apply.hpp"
+#include "simd.hpp"
 
 namespace qclab::qgates {
 
@@ -8,6 +9,9 @@ namespace qclab::qgates {
   void PauliZ< T >::apply( Op op , const int nbQubits ,
                            std::vector< T >& vector , const int offset ) const {
     const int qubit = this->qubit() + offset ;
+    const auto mat1 = qclab::dense::operate( op , this->matrix2x2() ) ;
+    if ( simd_applyDiag2( nbQubits , qubit , mat1(0,0) , mat1(1,1) ,
+                          vector.data() ) ) return ;
     auto f = lambda_PauliZ( op , vector.data() ) ;
     apply2b( nbQubits , qubit , f ) ;
   }
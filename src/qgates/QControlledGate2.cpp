@@ -9,12 +9,12 @@ namespace qclab::qgates {
                                      const int nbQubits ,
                                      std::vector< T >& vector ,
                                      const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     const int control = this->control() + offset ;
     const int target  = this->target()  + offset ;
-    auto f = lambda_QGate1( op , this->gate()->matrix() , vector.data() ) ;
+    auto f = lambda_QGate1( op , this->gate()->matrix2x2() , vector.data() ) ;
     apply4( nbQubits , qubits[0] , qubits[1] , control , target ,
             this->controlState() , f ) ;
   }
@@ -26,12 +26,12 @@ namespace qclab::qgates {
                                             const int nbQubits ,
                                             T* vector ,
                                             const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     const int control = this->control() + offset ;
     const int target  = this->target()  + offset ;
-    auto f = lambda_QGate1( op , this->gate()->matrix() , vector ) ;
+    auto f = lambda_QGate1( op , this->gate()->matrix2x2() , vector ) ;
     apply_device4( nbQubits , qubits[0] , qubits[1] , control , target ,
                    this->controlState() , f ) ;
   }
@@ -42,16 +42,14 @@ namespace qclab::qgates {
   void QControlledGate2< T >::apply( Side side , Op op , const int nbQubits ,
                                      qclab::dense::SquareMatrix< T >& matrix ,
                                      const int offset ) const {
-    using matrix_type = qclab::dense::SquareMatrix< T > ;
     assert( nbQubits >= 2 ) ;
     assert( matrix.size() == 1 << nbQubits ) ;
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     assert( qubits[0] < nbQubits ) ; assert( qubits[1] < nbQubits ) ;
     // operation
-    matrix_type  mat1 = this->gate()->matrix() ;
-    qclab::dense::operateInPlace( op , mat1 ) ;
+    const auto mat1 = qclab::dense::operate( op , this->gate()->matrix2x2() ) ;
     // control / target
     if ( control() < target() ) {
       // control() < target()
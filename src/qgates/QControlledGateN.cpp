@@ -0,0 +1,122 @@
+#include "qclab/qgates/QControlledGateN.hpp"
+#include "qclab/dense/transpose.hpp"
+
+namespace qclab::qgates {
+
+  // setQubits
+  template <typename T>
+  void QControlledGateN< T >::setQubits( const int* qubits ) {
+    const auto old = this->qubits() ;
+    std::vector< int > controls ;
+    std::vector< int > targets ;
+    for ( int i = 0; i < old.size(); i++ ) {
+      assert( qubits[i] >= 0 ) ;
+      assert( ( i == 0 ) || ( qubits[i] > qubits[i-1] ) ) ;
+      if ( std::binary_search( controls_.begin() , controls_.end() ,
+                               old[i] ) ) {
+        controls.push_back( qubits[i] ) ;
+      } else {
+        targets.push_back( qubits[i] ) ;
+      }
+    }
+    controls_ = std::move( controls ) ;
+    setTargets( targets.data() ) ;
+  }
+
+  // matrix
+  template <typename T>
+  qclab::dense::SquareMatrix< T > QControlledGateN< T >::matrix() const {
+    const auto qubits  = this->qubits() ;
+    const auto targets = this->targets() ;
+    const auto tmat    = targetMatrix() ;
+    const int nbQubits = qubits.size() ;
+    const int t = targets.size() ;
+    // local bits of the controls and targets
+    auto bitOf = [&qubits,nbQubits] ( const int qubit ) {
+      const int i = std::lower_bound( qubits.begin() , qubits.end() , qubit ) -
+                    qubits.begin() ;
+      return int64_t(1) << ( nbQubits - i - 1 ) ;
+    } ;
+    int64_t cmask = 0 , cval = 0 ;
+    for ( int i = 0; i < controls_.size(); i++ ) {
+      cmask |= bitOf( controls_[i] ) ;
+      if ( controlStates_[i] == 1 ) cval |= bitOf( controls_[i] ) ;
+    }
+    std::vector< int64_t > toff( int64_t(1) << t , 0 ) ;
+    for ( int64_t k = 0; k < toff.size(); k++ ) {
+      for ( int j = 0; j < t; j++ ) {
+        if ( ( k >> ( t - j - 1 ) ) & 1 ) toff[k] |= bitOf( targets[j] ) ;
+      }
+    }
+    const int64_t tmask = toff.back() ;
+    // identity, except for the target block in the control states
+    auto mat = qclab::dense::eye< T >( int64_t(1) << nbQubits ) ;
+    for ( int64_t x = 0; x < mat.size(); x++ ) {
+      if ( ( x & ( cmask | tmask ) ) != cval ) continue ;
+      for ( int64_t j = 0; j < toff.size(); j++ ) {
+        for ( int64_t i = 0; i < toff.size(); i++ ) {
+          mat( x | toff[i] , x | toff[j] ) = tmat(i,j) ;
+        }
+      }
+    }
+    return mat ;
+  }
+
+  // apply
+  template <typename T>
+  void QControlledGateN< T >::apply( Side side , Op op , const int nbQubits ,
+                                     qclab::dense::SquareMatrix< T >& matrix ,
+                                     const int offset ) const {
+    assert( nbQubits >= this->nbQubits() ) ;
+    assert( matrix.size() == 1 << nbQubits ) ;
+    const auto targets = this->targets() ;
+    const int t = targets.size() ;
+    // operation
+    auto tmat = targetMatrix() ;
+    qclab::dense::operateInPlace( op , tmat ) ;
+    // bits of the controls and targets
+    auto bitOf = [nbQubits,offset] ( const int qubit ) {
+      assert( qubit + offset < nbQubits ) ;
+      return int64_t(1) << ( nbQubits - qubit - offset - 1 ) ;
+    } ;
+    int64_t cmask = 0 , cval = 0 ;
+    for ( int i = 0; i < controls_.size(); i++ ) {
+      cmask |= bitOf( controls_[i] ) ;
+      if ( controlStates_[i] == 1 ) cval |= bitOf( controls_[i] ) ;
+    }
+    std::vector< int64_t > toff( int64_t(1) << t , 0 ) ;
+    for ( int64_t k = 0; k < toff.size(); k++ ) {
+      for ( int j = 0; j < t; j++ ) {
+        if ( ( k >> ( t - j - 1 ) ) & 1 ) toff[k] |= bitOf( targets[j] ) ;
+      }
+    }
+    const int64_t tmask = toff.back() ;
+    // side
+    const int64_t size = matrix.size() ;
+    if ( side == Side::Left ) {
+      // matrix *= op(G)  <=>  matrix^T = op(G)^T * matrix^T
+      qclab::dense::transInPlace( tmat ) ;
+      qclab::dense::transInPlace( matrix ) ;
+    }
+    std::vector< T > x( toff.size() ) ;
+    for ( int64_t j = 0; j < size; j++ ) {
+      T* v = matrix.ptr() + j * size ;
+      for ( int64_t a = 0; a < size; a++ ) {
+        if ( ( a & ( cmask | tmask ) ) != cval ) continue ;
+        for ( int64_t k = 0; k < toff.size(); k++ ) x[k] = v[ a | toff[k] ] ;
+        for ( int64_t i = 0; i < toff.size(); i++ ) {
+          T y = 0 ;
+          for ( int64_t k = 0; k < toff.size(); k++ ) y += tmat(i,k) * x[k] ;
+          v[ a | toff[i] ] = y ;
+        }
+      }
+    }
+    if ( side == Side::Left ) qclab::dense::transInPlace( matrix ) ;
+  }
+
+  template class QControlledGateN< float > ;
+  template class QControlledGateN< double > ;
+  template class QControlledGateN< std::complex< float > > ;
+  template class QControlledGateN< std::complex< double > > ;
+
+} // namespace qclab::qgates
@@ -1,5 +1,6 @@
 #include "qclab/qgates/QGate1.hpp"
 #include "apply.hpp"
+#include "simd.hpp"
 
 namespace qclab::qgates {
 
@@ -8,7 +9,10 @@ namespace qclab::qgates {
   void QGate1< T >::apply( Op op , const int nbQubits ,
                            std::vector< T >& vector , const int offset ) const {
     const int qubit = this->qubit() + offset ;
-    auto f = lambda_QGate1( op , this->matrix() , vector.data() ) ;
+    const auto mat1 = this->matrix2x2() ;
+    if ( simd_apply2( nbQubits , qubit , qclab::dense::operate( op , mat1 ) ,
+                      vector.data() ) ) return ;
+    auto f = lambda_QGate1( op , mat1 , vector.data() ) ;
     apply2( nbQubits , qubit , f ) ;
   }
 
@@ -18,7 +22,7 @@ namespace qclab::qgates {
   void QGate1< T >::apply_device( Op op , const int nbQubits , T* vector ,
                                   const int offset ) const {
     const int qubit = this->qubit() + offset ;
-    auto f = lambda_QGate1( op , this->matrix() , vector ) ;
+    auto f = lambda_QGate1( op , this->matrix2x2() , vector ) ;
     apply_device2( nbQubits , qubit , f ) ;
   }
 #endif
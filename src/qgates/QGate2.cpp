@@ -1,5 +1,6 @@
 #include "qclab/qgates/QGate2.hpp"
 #include "apply.hpp"
+#include "simd.hpp"
 
 namespace qclab::qgates {
 
@@ -7,10 +8,14 @@ namespace qclab::qgates {
   template <typename T>
   void QGate2< T >::apply( Op op , const int nbQubits ,
                            std::vector< T >& vector , const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
-    auto f = lambda_QGate2( op , this->matrix() , vector.data() ) ;
+    const auto mat2 = this->matrix4x4() ;
+    if ( simd_apply4( nbQubits , qubits[0] , qubits[1] ,
+                      qclab::dense::operate( op , mat2 ) ,
+                      vector.data() ) ) return ;
+    auto f = lambda_QGate2( op , mat2 , vector.data() ) ;
     apply4( nbQubits , qubits[0] , qubits[1] , f ) ;
   }
 
@@ -19,10 +24,10 @@ namespace qclab::qgates {
   template <typename T>
   void QGate2< T >::apply_device( Op op , const int nbQubits , T* vector ,
                                   const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
-    auto f = lambda_QGate2( op , this->matrix() , vector ) ;
+    auto f = lambda_QGate2( op , this->matrix4x4() , vector ) ;
     apply_device4( nbQubits , qubits[0] , qubits[1] , f ) ;
   }
 #endif
@@ -34,7 +39,7 @@ namespace qclab::qgates {
                            const int offset ) const {
     assert( nbQubits >= 2 ) ;
     assert( matrix.size() == 1 << nbQubits ) ;
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     assert( qubits[0] < nbQubits ) ; assert( qubits[1] < nbQubits ) ;
@@ -0,0 +1,49 @@
+#include "qclab/qgates/RotationXX.hpp"
+#include "apply.hpp"
+#include "simd.hpp"
+
+namespace qclab::qgates {
+
+  // apply
+  template <typename T>
+  void RotationXX< T >::apply( Op op , const int nbQubits ,
+                               std::vector< T >& vector ,
+                               const int offset ) const {
+    auto qubits = this->qubitPair() ;
+    qubits[0] += offset ;
+    qubits[1] += offset ;
+    const T s = T( 0 , op == Op::ConjTrans ? this->sin() : -this->sin() ) ;
+    const T c = this->cos() ;
+    const T m[4] = { c , s , s , c } ;
+    if ( simd_applyPairs4( nbQubits , qubits[0] , qubits[1] , m , m ,
+                           vector.data() ) ) return ;
+    auto f = lambda_RotationXX( op , this->cos() , this->sin() ,
+                                 vector.data() ) ;
+    apply4( nbQubits , qubits[0] , qubits[1] , f ) ;
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void RotationXX< T >::apply_device( Op op , const int nbQubits , T* vector ,
+                                      const int offset ) const {
+    auto qubits = this->qubitPair() ;
+    qubits[0] += offset ;
+    qubits[1] += offset ;
+    auto f = lambda_RotationXX( op , this->cos() , this->sin() , vector ) ;
+    apply_device4( nbQubits , qubits[0] , qubits[1] , f ) ;
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void RotationXX< T >::apply( Side side , Op op , const int nbQubits ,
+                               qclab::dense::SquareMatrix< T >& matrix ,
+                               const int offset ) const {
+    QGate2< T >::apply( side , op , nbQubits , matrix , offset ) ;
+  }
+
+  template class RotationXX< std::complex< float > > ;
+  template class RotationXX< std::complex< double > > ;
+
+} // namespace qclab::qgates
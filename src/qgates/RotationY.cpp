@@ -1,5 +1,6 @@
 #include "qclab/qgates/RotationY.hpp"
 #include "apply.hpp"
+#include "simd.hpp"
 
 namespace qclab::qgates {
 
@@ -9,6 +10,9 @@ namespace qclab::qgates {
                               std::vector< T >& vector ,
                               const int offset ) const {
     const int qubit = this->qubit() + offset ;
+    if ( simd_apply2( nbQubits , qubit ,
+                      qclab::dense::operate( op , this->matrix2x2() ) ,
+                      vector.data() ) ) return ;
     auto f = lambda_RotationY( op , this->cos() , this->sin() , vector.data() );
     apply2( nbQubits , qubit , f ) ;
   }
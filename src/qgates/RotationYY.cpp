@@ -0,0 +1,50 @@
+#include "qclab/qgates/RotationYY.hpp"
+#include "apply.hpp"
+#include "simd.hpp"
+
+namespace qclab::qgates {
+
+  // apply
+  template <typename T>
+  void RotationYY< T >::apply( Op op , const int nbQubits ,
+                               std::vector< T >& vector ,
+                               const int offset ) const {
+    auto qubits = this->qubitPair() ;
+    qubits[0] += offset ;
+    qubits[1] += offset ;
+    const T s = T( 0 , op == Op::ConjTrans ? -this->sin() : this->sin() ) ;
+    const T c = this->cos() ;
+    const T m03[4] = { c ,  s ,  s , c } ;
+    const T m12[4] = { c , -s , -s , c } ;
+    if ( simd_applyPairs4( nbQubits , qubits[0] , qubits[1] , m03 , m12 ,
+                           vector.data() ) ) return ;
+    auto f = lambda_RotationYY( op , this->cos() , this->sin() ,
+                                 vector.data() ) ;
+    apply4( nbQubits , qubits[0] , qubits[1] , f ) ;
+  }
+
+#ifdef QCLAB_OMP_OFFLOADING
+  // apply_device
+  template <typename T>
+  void RotationYY< T >::apply_device( Op op , const int nbQubits , T* vector ,
+                                      const int offset ) const {
+    auto qubits = this->qubitPair() ;
+    qubits[0] += offset ;
+    qubits[1] += offset ;
+    auto f = lambda_RotationYY( op , this->cos() , this->sin() , vector ) ;
+    apply_device4( nbQubits , qubits[0] , qubits[1] , f ) ;
+  }
+#endif
+
+  // apply
+  template <typename T>
+  void RotationYY< T >::apply( Side side , Op op , const int nbQubits ,
+                               qclab::dense::SquareMatrix< T >& matrix ,
+                               const int offset ) const {
+    QGate2< T >::apply( side , op , nbQubits , matrix , offset ) ;
+  }
+
+  template class RotationYY< std::complex< float > > ;
+  template class RotationYY< std::complex< double > > ;
+
+} // namespace qclab::qgates
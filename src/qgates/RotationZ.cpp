@@ -1,5 +1,6 @@
 #include "qclab/qgates/RotationZ.hpp"
 #include "apply.hpp"
+#include "simd.hpp"
 
 namespace qclab::qgates {
 
@@ -9,6 +10,9 @@ namespace qclab::qgates {
                               std::vector< T >& vector ,
                               const int offset ) const {
     const int qubit = this->qubit() + offset ;
+    const auto mat1 = qclab::dense::operate( op , this->matrix2x2() ) ;
+    if ( simd_applyDiag2( nbQubits , qubit , mat1(0,0) , mat1(1,1) ,
+                          vector.data() ) ) return ;
     auto f = lambda_RotationZ( op , this->cos() , this->sin() , vector.data() );
     apply2( nbQubits , qubit , f ) ;
   }
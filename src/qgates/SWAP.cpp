@@ -8,7 +8,7 @@ namespace qclab::qgates {
   template <typename T>
   void SWAP< T >::apply( Op op , const int nbQubits , std::vector< T >& vector ,
                          const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     auto f = lambda_SWAP( op , vector.data() ) ;
@@ -20,7 +20,7 @@ namespace qclab::qgates {
   template <typename T>
   void SWAP< T >::apply_device( Op op , const int nbQubits , T* vector ,
                                 const int offset ) const {
-    auto qubits = this->qubits() ;
+    auto qubits = this->qubitPair() ;
     qubits[0] += offset ;
     qubits[1] += offset ;
     auto f = lambda_SWAP( op , vector ) ;
@@ -2,15 +2,18 @@
 
 #pragma once
 
+#include "qclab/dense/SmallMatrix.hpp"
+#include "qclab/parallel.hpp"
+#include <array>
 #include <tuple>
+#include <vector>
 
 namespace qclab::qgates {
 
   // lambda_QGate1
   template <typename T>
-  auto lambda_QGate1( Op op , qclab::dense::SquareMatrix< T > mat1 ,
+  auto lambda_QGate1( Op op , qclab::dense::SmallMatrix< T , 2 > mat1 ,
                       T* vector ) {
-    assert( mat1.size() == 2 ) ;
     // operation
     qclab::dense::operateInPlace( op , mat1 ) ;
     const T m11 = mat1( 0 , 0 ) ; const T m12 = mat1( 0 , 1 ) ;
@@ -167,11 +170,72 @@ namespace qclab::qgates {
     return f ;
   }
 
+  // lambda_RotationXX
+  template <typename T, typename R = qclab::real_t< T >>
+  auto lambda_RotationXX( Op op , const R cos , const R sin , T* vector ) {
+    // operation
+    const R cs = cos ;
+    T sn = T( 0 , -sin ) ;
+    if ( op == Op::ConjTrans ) sn = std::conj( sn ) ;
+    // matvec
+    auto f = [=] ( const uint64_t a , const uint64_t b ,
+                   const uint64_t c , const uint64_t d ) {
+      const T x1 = vector[a] ;
+      const T x2 = vector[b] ;
+      const T x3 = vector[c] ;
+      const T x4 = vector[d] ;
+      vector[a] = cs * x1 + sn * x4 ;
+      vector[b] = cs * x2 + sn * x3 ;
+      vector[c] = sn * x2 + cs * x3 ;
+      vector[d] = sn * x1 + cs * x4 ;
+    } ;
+    return f ;
+  }
+
+  // lambda_RotationYY
+  template <typename T, typename R = qclab::real_t< T >>
+  auto lambda_RotationYY( Op op , const R cos , const R sin , T* vector ) {
+    // operation
+    const R cs = cos ;
+    T sn = T( 0 , sin ) ;
+    if ( op == Op::ConjTrans ) sn = std::conj( sn ) ;
+    // matvec
+    auto f = [=] ( const uint64_t a , const uint64_t b ,
+                   const uint64_t c , const uint64_t d ) {
+      const T x1 = vector[a] ;
+      const T x2 = vector[b] ;
+      const T x3 = vector[c] ;
+      const T x4 = vector[d] ;
+      vector[a] = cs * x1 + sn * x4 ;
+      vector[b] = cs * x2 - sn * x3 ;
+      vector[c] = cs * x3 - sn * x2 ;
+      vector[d] = cs * x4 + sn * x1 ;
+    } ;
+    return f ;
+  }
+
+  // lambda_RotationZZ
+  template <typename T, typename R = qclab::real_t< T >>
+  auto lambda_RotationZZ( Op op , const R cos , const R sin , T* vector ) {
+    // operation
+    T lambda1 = T( cos , -sin ) ;
+    T lambda2 = T( cos ,  sin ) ;
+    if ( op == Op::ConjTrans ) std::swap( lambda1 , lambda2 ) ;
+    // matvec
+    auto f = [=] ( const uint64_t a , const uint64_t b ,
+                   const uint64_t c , const uint64_t d ) {
+      vector[a] *= lambda1 ;
+      vector[b] *= lambda2 ;
+      vector[c] *= lambda2 ;
+      vector[d] *= lambda1 ;
+    } ;
+    return f ;
+  }
+
   // lambda_QGate2
   template <typename T>
-  auto lambda_QGate2( Op op , qclab::dense::SquareMatrix< T > mat2 ,
+  auto lambda_QGate2( Op op , qclab::dense::SmallMatrix< T , 4 > mat2 ,
                       T* vector ) {
-    assert( mat2.size() == 4 ) ;
     // operation
     qclab::dense::operateInPlace( op , mat2 ) ;
     const T m11 = mat2( 0 , 0 ) ; const T m12 = mat2( 0 , 1 ) ;
@@ -197,6 +261,51 @@ namespace qclab::qgates {
     return f ;
   }
 
+  // lambda_QGateK
+  template <int K, typename T>
+  auto lambda_QGateK( Op op , const qclab::dense::SquareMatrix< T >& matK ,
+                      const int nbQubits , const int* qubits , T* vector ) {
+    constexpr int D = 1 << K ;
+    assert( matK.size() == D ) ;
+    // operation, applied while copying the matrix in row-major order
+    std::array< T , D*D > m ;
+    for ( int r = 0; r < D; r++ ) {
+      for ( int c = 0; c < D; c++ ) {
+        m[ r*D + c ] = ( op == Op::NoTrans ) ? matK( r , c ) : matK( c , r ) ;
+      }
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      if ( op == Op::ConjTrans ) {
+        for ( auto& mrc : m ) mrc = std::conj( mrc ) ;
+      }
+    }
+    // offsets of the 2^K amplitudes with respect to the base index
+    std::array< uint64_t , D > o ;
+    for ( int r = 0; r < D; r++ ) {
+      o[r] = 0 ;
+      for ( int i = 0; i < K; i++ ) {
+        if ( r & ( 1 << ( K - i - 1 ) ) ) {
+          o[r] |= 1ULL << ( nbQubits - qubits[i] - 1 ) ;
+        }
+      }
+    }
+    // matvec
+    auto f = [=] ( const uint64_t a ) {
+      T x[D] ;
+      for ( int c = 0; c < D; c++ ) {
+        x[c] = vector[ a | o[c] ] ;
+      }
+      for ( int r = 0; r < D; r++ ) {
+        T y = m[ r*D ] * x[0] ;
+        for ( int c = 1; c < D; c++ ) {
+          y += m[ r*D + c ] * x[c] ;
+        }
+        vector[ a | o[r] ] = y ;
+      }
+    } ;
+    return f ;
+  }
+
   // lambda_SWAP
   template <typename T>
   auto lambda_SWAP( Op op , T* vector ) {
@@ -258,53 +367,53 @@ namespace qclab::qgates {
   template <typename F>
   void apply2( const int nbQubits , const int qubit , F& lambda ) {
     // masks
-    const auto [ mL , mR ] = masks( nbQubits , qubit ) ;
+    uint64_t mL , mR ;
+    std::tie( mL , mR ) = masks( nbQubits , qubit ) ;
     // indices
     const uint64_t n  = 1ULL << ( nbQubits - 1 ) ;
     const uint64_t b1 = 1ULL << ( nbQubits - qubit - 1 ) ;
     // matvec
-    #pragma omp parallel for
-    for ( uint64_t k = 0; k < n; k++ ) {
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
       const uint64_t a = ( (k & mL) << 1 ) | (k & mR) ;
       const uint64_t b = a | b1 ;
       lambda( a , b ) ;
-    }
+    } ) ;
   }
 
   template <typename F>
   void apply2b( const int nbQubits , const int qubit , F& lambda ) {
     // masks
-    const auto [ mL , mR ] = masks( nbQubits , qubit ) ;
+    uint64_t mL , mR ;
+    std::tie( mL , mR ) = masks( nbQubits , qubit ) ;
     // indices
     const uint64_t n  = 1ULL << ( nbQubits - 1 ) ;
     const uint64_t b1 = 1ULL << ( nbQubits - qubit - 1 ) ;
     // matvec
-    #pragma omp parallel for
-    for ( uint64_t k = 0; k < n; k++ ) {
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
       const uint64_t b = ( (k & mL) << 1 ) | b1 | (k & mR) ;
       lambda( b ) ;
-    }
+    } ) ;
   }
 
   template <typename F>
   void apply4( const int nbQubits , const int qubit0 , const int qubit1 ,
                F& lambda ) {
     // masks
-    const auto [ mL , mC , mR ] = masks( nbQubits , qubit0 , qubit1 ) ;
+    uint64_t mL , mC , mR ;
+    std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
     // indices
     const uint64_t  n = 1ULL << ( nbQubits - 2 ) ;
     const uint64_t b1 = 1ULL << ( nbQubits - qubit0 - 1 ) ;
     const uint64_t c1 = 1ULL << ( nbQubits - qubit1 - 1 ) ;
     const uint64_t d1 = b1 | c1 ;
     // matvec
-    #pragma omp parallel for
-    for ( uint64_t k = 0; k < n; k++ ) {
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
       const uint64_t a = (k & mR) + ( (k & mC) << 1 ) + ( (k & mL) << 2 ) ;
       const uint64_t b = a | b1 ;
       const uint64_t c = a | c1 ;
       const uint64_t d = a | d1 ;
       lambda( a , b , c , d ) ;
-    }
+    } ) ;
   }
 
   template <typename F>
@@ -312,7 +421,8 @@ namespace qclab::qgates {
                const int control , const int target , const int controlState ,
                F& lambda ) {
     // masks
-    const auto [ mL , mC , mR ] = masks( nbQubits , qubit0 , qubit1 ) ;
+    uint64_t mL , mC , mR ;
+    std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
     // control / target
     const uint64_t n  = 1ULL << ( nbQubits - 2 ) ;
           uint64_t a1 = 0ULL ;
@@ -322,13 +432,12 @@ namespace qclab::qgates {
       b1 += 1ULL << ( nbQubits - control - 1 ) ;
     }
     // matvec
-    #pragma omp parallel for
-    for ( uint64_t k = 0; k < n; k++ ) {
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
       const uint64_t i = ( (k & mL) << 2 ) | ( (k & mC) << 1 ) | (k & mR) ;
       const uint64_t a = i | a1 ;
       const uint64_t b = i | b1 ;
       lambda( a , b ) ;
-    }
+    } ) ;
   }
 
   template <typename F>
@@ -336,7 +445,8 @@ namespace qclab::qgates {
                 const int control , const int target , const int controlState ,
                 F& lambda ) {
     // masks
-    const auto [ mL , mC , mR ] = masks( nbQubits , qubit0 , qubit1 ) ;
+    uint64_t mL , mC , mR ;
+    std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
     // control / target
     const uint64_t n  = 1ULL << ( nbQubits - 2 ) ;
           uint64_t b1 = 1ULL << ( nbQubits - target - 1 ) ;
@@ -344,30 +454,100 @@ namespace qclab::qgates {
       b1 += 1ULL << ( nbQubits - control - 1 ) ;
     }
     // matvec
-    #pragma omp parallel for
-    for ( uint64_t k = 0; k < n; k++ ) {
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
       const uint64_t b = ( (k & mL) << 2 ) | ( (k & mC) << 1 ) | (k & mR) | b1 ;
       lambda( b ) ;
-    }
+    } ) ;
   }
 
   template <typename F>
   void apply4bc( const int nbQubits , const int qubit0 , const int qubit1 ,
                  F& lambda ) {
     // masks
-    const auto [ mL , mC , mR ] = masks( nbQubits , qubit0 , qubit1 ) ;
+    uint64_t mL , mC , mR ;
+    std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
     // indices
     const uint64_t n  = 1ULL << ( nbQubits - 2 ) ;
     const uint64_t b1 = 1ULL << ( nbQubits - qubit0 - 1 ) ;
     const uint64_t c1 = 1ULL << ( nbQubits - qubit1 - 1 ) ;
     // matvec
-    #pragma omp parallel for
-    for ( uint64_t k = 0; k < n; k++ ) {
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
       const uint64_t a = ( (k & mL) << 2 ) | ( (k & mC) << 1 ) | (k & mR) ;
       const uint64_t b = a | b1 ;
       const uint64_t c = a | c1 ;
       lambda( b , c ) ;
+    } ) ;
+  }
+
+  // positions (from the least significant bit) for K-qubit gates
+  inline
+  std::array< int , 8 > positions( const int nbQubits , const int K ,
+                                   const int* qubits ) {
+    assert( K <= 8 ) ;
+    std::array< int , 8 > pos ;
+    for ( int i = 0; i < K; i++ ) {
+      assert( qubits[K - i - 1] < nbQubits ) ;
+      assert( ( i == 0 ) || ( qubits[K - i] > qubits[K - i - 1] ) ) ;
+      pos[i] = nbQubits - qubits[K - i - 1] - 1 ;  // ascending
+    }
+    return pos ;
+  }
+
+  template <typename F>
+  void applyK( const int nbQubits , const int K , const int* qubits ,
+               F& lambda ) {
+    assert( nbQubits >= K ) ;
+    // positions
+    const auto pos = positions( nbQubits , K , qubits ) ;
+    // indices
+    const uint64_t n = 1ULL << ( nbQubits - K ) ;
+    // matvec
+    qclab::parallel::forEach( n , [&] ( const uint64_t k ) {
+      uint64_t a = k ;
+      for ( int i = 0; i < K; i++ ) {
+        const uint64_t mR = ( 1ULL << pos[i] ) - 1 ;
+        a = ( ( a & ~mR ) << 1 ) | ( a & mR ) ;
+      }
+      lambda( a ) ;
+    } ) ;
+  }
+
+  // multi-controlled gates: calls lambda( a , b ) for all pairs of indices
+  // with the bits of the ascending qubits `qubits` equal to `a1` and `b1`
+  template <typename F>
+  void applyMC( const int nbQubits , const std::vector< int >& qubits ,
+                const uint64_t a1 , const uint64_t b1 , F& lambda ) {
+    const int K = qubits.size() ;
+    assert( K >= 1 ) ; assert( nbQubits >= K ) ;
+    // positions (from the least significant bit), ascending
+    std::vector< int > pos( K ) ;
+    for ( int i = 0; i < K; i++ ) {
+      assert( ( i == 0 ) || ( qubits[K - i] > qubits[K - i - 1] ) ) ;
+      pos[i] = nbQubits - qubits[K - i - 1] - 1 ;
     }
+    // contiguous runs of the qubits below the least significant position
+    const uint64_t m = 1ULL << pos[0] ;
+    const uint64_t n = 1ULL << ( nbQubits - K ) ;
+    // matvec on the subspace of the fixed qubits, split over all indices
+    qclab::parallel::forRange( n , [&] ( const int64_t begin ,
+                                         const int64_t end ) {
+      uint64_t k = begin ;
+      while ( k < uint64_t( end ) ) {
+        const uint64_t l0 = k & ( m - 1 ) ;
+        const uint64_t l1 = std::min( m , l0 + uint64_t( end ) - k ) ;
+        uint64_t i = ( k >> pos[0] ) << ( pos[0] + 1 ) ;
+        for ( int j = 1; j < K; j++ ) {
+          const uint64_t mR = ( 1ULL << pos[j] ) - 1 ;
+          i = ( ( i & ~mR ) << 1 ) | ( i & mR ) ;
+        }
+        const uint64_t a = i | a1 ;
+        const uint64_t b = i | b1 ;
+        for ( uint64_t l = l0; l < l1; l++ ) {
+          lambda( a + l , b + l ) ;
+        }
+        k += l1 - l0 ;
+      }
+    } ) ;
   }
 
 #ifdef QCLAB_OMP_OFFLOADING
@@ -529,7 +709,48 @@ namespace qclab::qgates {
       lambda( b , c ) ;
     }
   }
+
+  template <typename F>
+  void apply_deviceK( const int nbQubits , const int K , const int* qubits ,
+                      F& lambda ) {
+    assert( nbQubits >= K ) ;
+    // positions
+    const auto pos = positions( nbQubits , K , qubits ) ;
+    // indices
+    const uint64_t n = 1ULL << ( nbQubits - K ) ;
+    // matvec
+    #pragma omp target teams distribute parallel for
+    for ( uint64_t k = 0; k < n; k++ ) {
+      uint64_t a = k ;
+      for ( int i = 0; i < K; i++ ) {
+        const uint64_t mR = ( 1ULL << pos[i] ) - 1 ;
+        a = ( ( a & ~mR ) << 1 ) | ( a & mR ) ;
+      }
+      lambda( a ) ;
+    }
+  }
+
+  template <typename F>
+  void apply_deviceMC( const int nbQubits , const std::vector< int >& qubits ,
+                       const uint64_t a1 , const uint64_t b1 , F& lambda ) {
+    const int K = qubits.size() ;
+    assert( K >= 1 ) ; assert( nbQubits >= K ) ;
+    // positions (from the least significant bit), ascending
+    std::array< int , 64 > pos ;
+    for ( int i = 0; i < K; i++ ) pos[i] = nbQubits - qubits[K - i - 1] - 1 ;
+    // indices
+    const uint64_t n = 1ULL << ( nbQubits - K ) ;
+    // matvec on the subspace of the fixed qubits
+    #pragma omp target teams distribute parallel for
+    for ( uint64_t k = 0; k < n; k++ ) {
+      uint64_t i = k ;
+      for ( int j = 0; j < K; j++ ) {
+        const uint64_t mR = ( 1ULL << pos[j] ) - 1 ;
+        i = ( ( i & ~mR ) << 1 ) | ( i & mR ) ;
+      }
+      lambda( i | a1 , i | b1 ) ;
+    }
+  }
 #endif
 
 } // namespace qclab::qgates
-
@@ -0,0 +1,75 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "apply.hpp"
+#include "simd.hpp"
+
+namespace qclab::qgates {
+
+  // swapped: matrix of a 2-qubit gate with its qubits interchanged, apply4
+  // passes the amplitudes to the kernel with the first qubit varying fastest
+  template <typename M>
+  qclab::dense::SmallMatrix< typename M::value_type , 4 > swapped(
+                                                              const M& mat ) {
+    assert( mat.size() == 4 ) ;
+    const int p[] = { 0 , 2 , 1 , 3 } ;
+    qclab::dense::SmallMatrix< typename M::value_type , 4 > matS ;
+    for ( int j = 0; j < 4; j++ ) {
+      for ( int i = 0; i < 4; i++ ) {
+        matS( i , j ) = mat( p[i] , p[j] ) ;
+      }
+    }
+    return matS ;
+  }
+
+  // applyMatrixN
+  template <typename T>
+  void applyMatrixN( Op op , const int nbQubits , const int* qubits ,
+                     const int K , const qclab::dense::SquareMatrix< T >& mat ,
+                     T* vector ) {
+    switch ( K ) {
+      case 1 : {
+        const qclab::dense::SmallMatrix< T , 2 > mat1( mat ) ;
+        if ( simd_apply2( nbQubits , qubits[0] ,
+                          qclab::dense::operate( op , mat1 ) ,
+                          vector ) ) break ;
+        auto f = lambda_QGate1( op , mat1 , vector ) ;
+        apply2( nbQubits , qubits[0] , f ) ;
+        break ;
+      }
+      case 2 : {
+        const auto mat2 = swapped( mat ) ;
+        if ( simd_apply4( nbQubits , qubits[0] , qubits[1] ,
+                          qclab::dense::operate( op , mat2 ) ,
+                          vector ) ) break ;
+        auto f = lambda_QGate2( op , mat2 , vector ) ;
+        apply4( nbQubits , qubits[0] , qubits[1] , f ) ;
+        break ;
+      }
+      case 3 : {
+        auto f = lambda_QGateK< 3 >( op , mat , nbQubits , qubits , vector ) ;
+        applyK( nbQubits , 3 , qubits , f ) ;
+        break ;
+      }
+      case 4 : {
+        auto f = lambda_QGateK< 4 >( op , mat , nbQubits , qubits , vector ) ;
+        applyK( nbQubits , 4 , qubits , f ) ;
+        break ;
+      }
+      case 5 : {
+        auto f = lambda_QGateK< 5 >( op , mat , nbQubits , qubits , vector ) ;
+        applyK( nbQubits , 5 , qubits , f ) ;
+        break ;
+      }
+      case 6 : {
+        auto f = lambda_QGateK< 6 >( op , mat , nbQubits , qubits , vector ) ;
+        applyK( nbQubits , 6 , qubits , f ) ;
+        break ;
+      }
+      default :
+        assert( false ) ;
+    }
+  }
+
+} // namespace qclab::qgates
@@ -0,0 +1,468 @@
+//  (C) Copyright Roel Van Beeumen and Daan Camps 2022.
+
+#pragma once
+
+#include "qclab/simd.hpp"
+#include "apply.hpp"
+#include <algorithm>
+#include <type_traits>
+
+#if defined(QCLAB_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define QCLAB_SIMD_KERNELS
+#include <immintrin.h>
+#define QCLAB_TARGET_AVX2   __attribute__(( target( "avx2,fma" ) ))
+#define QCLAB_TARGET_AVX512 __attribute__(( target( "avx512f" ) ))
+#define QCLAB_INLINE_AVX2   __attribute__(( target( "avx2,fma" ) , \
+                                            always_inline )) inline
+#define QCLAB_INLINE_AVX512 __attribute__(( target( "avx512f" ) , \
+                                            always_inline )) inline
+#endif
+
+namespace qclab::qgates {
+
+#ifdef QCLAB_SIMD_KERNELS
+
+  /*
+   * The vector kernels below operate on contiguous runs of complex numbers,
+   * stored as interleaved (real, imag) pairs. A complex number z = (zr, zi)
+   * is broadcast as two registers (zr, zr, ...) and (zi, zi, ...), such that
+   *   z * x = fmaddsub( zr , x , zi * swap( x ) ) ,
+   * where swap interchanges the real and imaginary parts of every element.
+   */
+
+  namespace avx2 {
+
+    template <typename T> struct Vec ;
+
+    template <>
+    struct Vec< std::complex< double > > {
+      using T   = std::complex< double > ;
+      using reg = __m256d ;
+      static constexpr int width = 2 ;
+      QCLAB_INLINE_AVX2 static reg load( const T* p ) {
+        return _mm256_loadu_pd( reinterpret_cast< const double* >( p ) ) ;
+      }
+      QCLAB_INLINE_AVX2 static void store( T* p , const reg x ) {
+        _mm256_storeu_pd( reinterpret_cast< double* >( p ) , x ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg re( const T z ) {
+        return _mm256_set1_pd( std::real( z ) ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg im( const T z ) {
+        return _mm256_set1_pd( std::imag( z ) ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg mul( const reg zr , const reg zi ,
+                                        const reg x ) {
+        const reg t = _mm256_mul_pd( zi , _mm256_permute_pd( x , 0x5 ) ) ;
+        return _mm256_fmaddsub_pd( zr , x , t ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg add( const reg x , const reg y ) {
+        return _mm256_add_pd( x , y ) ;
+      }
+    } ;
+
+    template <>
+    struct Vec< std::complex< float > > {
+      using T   = std::complex< float > ;
+      using reg = __m256 ;
+      static constexpr int width = 4 ;
+      QCLAB_INLINE_AVX2 static reg load( const T* p ) {
+        return _mm256_loadu_ps( reinterpret_cast< const float* >( p ) ) ;
+      }
+      QCLAB_INLINE_AVX2 static void store( T* p , const reg x ) {
+        _mm256_storeu_ps( reinterpret_cast< float* >( p ) , x ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg re( const T z ) {
+        return _mm256_set1_ps( std::real( z ) ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg im( const T z ) {
+        return _mm256_set1_ps( std::imag( z ) ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg mul( const reg zr , const reg zi ,
+                                        const reg x ) {
+        const reg t = _mm256_mul_ps( zi , _mm256_permute_ps( x , 0xB1 ) ) ;
+        return _mm256_fmaddsub_ps( zr , x , t ) ;
+      }
+      QCLAB_INLINE_AVX2 static reg add( const reg x , const reg y ) {
+        return _mm256_add_ps( x , y ) ;
+      }
+    } ;
+
+    // kernel2: [p0 ; p1] = [m0 m1 ; m2 m3] * [p0 ; p1]
+    template <typename T>
+    QCLAB_TARGET_AVX2 void kernel2( T* p0 , T* p1 , const int64_t len ,
+                                    const T* m ) {
+      using V = Vec< T > ;
+      const auto r0 = V::re( m[0] ) ; const auto i0 = V::im( m[0] ) ;
+      const auto r1 = V::re( m[1] ) ; const auto i1 = V::im( m[1] ) ;
+      const auto r2 = V::re( m[2] ) ; const auto i2 = V::im( m[2] ) ;
+      const auto r3 = V::re( m[3] ) ; const auto i3 = V::im( m[3] ) ;
+      for ( int64_t i = 0; i < len; i += V::width ) {
+        const auto x0 = V::load( p0 + i ) ;
+        const auto x1 = V::load( p1 + i ) ;
+        V::store( p0 + i , V::add( V::mul( r0 , i0 , x0 ) ,
+                                   V::mul( r1 , i1 , x1 ) ) ) ;
+        V::store( p1 + i , V::add( V::mul( r2 , i2 , x0 ) ,
+                                   V::mul( r3 , i3 , x1 ) ) ) ;
+      }
+    }
+
+    // kernelDiag: p *= d
+    template <typename T>
+    QCLAB_TARGET_AVX2 void kernelDiag( T* p , const int64_t len , const T d ) {
+      using V = Vec< T > ;
+      const auto r = V::re( d ) ; const auto s = V::im( d ) ;
+      for ( int64_t i = 0; i < len; i += V::width ) {
+        V::store( p + i , V::mul( r , s , V::load( p + i ) ) ) ;
+      }
+    }
+
+    // kernel4: [p0 ; p1 ; p2 ; p3] = m * [p0 ; p1 ; p2 ; p3]
+    template <typename T>
+    QCLAB_TARGET_AVX2 void kernel4( T* const* p , const int64_t len ,
+                                    const T* m ) {
+      using V = Vec< T > ;
+      typename V::reg mr[16] , mi[16] ;
+      for ( int k = 0; k < 16; k++ ) {
+        mr[k] = V::re( m[k] ) ;
+        mi[k] = V::im( m[k] ) ;
+      }
+      for ( int64_t i = 0; i < len; i += V::width ) {
+        const auto x0 = V::load( p[0] + i ) ;
+        const auto x1 = V::load( p[1] + i ) ;
+        const auto x2 = V::load( p[2] + i ) ;
+        const auto x3 = V::load( p[3] + i ) ;
+        for ( int r = 0; r < 4; r++ ) {
+          auto y = V::add( V::mul( mr[4*r]   , mi[4*r]   , x0 ) ,
+                           V::mul( mr[4*r+1] , mi[4*r+1] , x1 ) ) ;
+          y = V::add( y , V::add( V::mul( mr[4*r+2] , mi[4*r+2] , x2 ) ,
+                                  V::mul( mr[4*r+3] , mi[4*r+3] , x3 ) ) ) ;
+          V::store( p[r] + i , y ) ;
+        }
+      }
+    }
+
+  } // namespace avx2
+
+  namespace avx512 {
+
+    template <typename T> struct Vec ;
+
+    template <>
+    struct Vec< std::complex< double > > {
+      using T   = std::complex< double > ;
+      using reg = __m512d ;
+      static constexpr int width = 4 ;
+      QCLAB_INLINE_AVX512 static reg load( const T* p ) {
+        return _mm512_loadu_pd( reinterpret_cast< const double* >( p ) ) ;
+      }
+      QCLAB_INLINE_AVX512 static void store( T* p , const reg x ) {
+        _mm512_storeu_pd( reinterpret_cast< double* >( p ) , x ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg re( const T z ) {
+        return _mm512_set1_pd( std::real( z ) ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg im( const T z ) {
+        return _mm512_set1_pd( std::imag( z ) ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg mul( const reg zr , const reg zi ,
+                                          const reg x ) {
+        const reg t = _mm512_mul_pd( zi , _mm512_permute_pd( x , 0x55 ) ) ;
+        return _mm512_fmaddsub_pd( zr , x , t ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg add( const reg x , const reg y ) {
+        return _mm512_add_pd( x , y ) ;
+      }
+    } ;
+
+    template <>
+    struct Vec< std::complex< float > > {
+      using T   = std::complex< float > ;
+      using reg = __m512 ;
+      static constexpr int width = 8 ;
+      QCLAB_INLINE_AVX512 static reg load( const T* p ) {
+        return _mm512_loadu_ps( reinterpret_cast< const float* >( p ) ) ;
+      }
+      QCLAB_INLINE_AVX512 static void store( T* p , const reg x ) {
+        _mm512_storeu_ps( reinterpret_cast< float* >( p ) , x ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg re( const T z ) {
+        return _mm512_set1_ps( std::real( z ) ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg im( const T z ) {
+        return _mm512_set1_ps( std::imag( z ) ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg mul( const reg zr , const reg zi ,
+                                          const reg x ) {
+        const reg t = _mm512_mul_ps( zi , _mm512_permute_ps( x , 0xB1 ) ) ;
+        return _mm512_fmaddsub_ps( zr , x , t ) ;
+      }
+      QCLAB_INLINE_AVX512 static reg add( const reg x , const reg y ) {
+        return _mm512_add_ps( x , y ) ;
+      }
+    } ;
+
+    // kernel2: [p0 ; p1] = [m0 m1 ; m2 m3] * [p0 ; p1]
+    template <typename T>
+    QCLAB_TARGET_AVX512 void kernel2( T* p0 , T* p1 , const int64_t len ,
+                                      const T* m ) {
+      using V = Vec< T > ;
+      const auto r0 = V::re( m[0] ) ; const auto i0 = V::im( m[0] ) ;
+      const auto r1 = V::re( m[1] ) ; const auto i1 = V::im( m[1] ) ;
+      const auto r2 = V::re( m[2] ) ; const auto i2 = V::im( m[2] ) ;
+      const auto r3 = V::re( m[3] ) ; const auto i3 = V::im( m[3] ) ;
+      for ( int64_t i = 0; i < len; i += V::width ) {
+        const auto x0 = V::load( p0 + i ) ;
+        const auto x1 = V::load( p1 + i ) ;
+        V::store( p0 + i , V::add( V::mul( r0 , i0 , x0 ) ,
+                                   V::mul( r1 , i1 , x1 ) ) ) ;
+        V::store( p1 + i , V::add( V::mul( r2 , i2 , x0 ) ,
+                                   V::mul( r3 , i3 , x1 ) ) ) ;
+      }
+    }
+
+    // kernelDiag: p *= d
+    template <typename T>
+    QCLAB_TARGET_AVX512 void kernelDiag( T* p , const int64_t len ,
+                                         const T d ) {
+      using V = Vec< T > ;
+      const auto r = V::re( d ) ; const auto s = V::im( d ) ;
+      for ( int64_t i = 0; i < len; i += V::width ) {
+        V::store( p + i , V::mul( r , s , V::load( p + i ) ) ) ;
+      }
+    }
+
+    // kernel4: [p0 ; p1 ; p2 ; p3] = m * [p0 ; p1 ; p2 ; p3]
+    template <typename T>
+    QCLAB_TARGET_AVX512 void kernel4( T* const* p , const int64_t len ,
+                                      const T* m ) {
+      using V = Vec< T > ;
+      typename V::reg mr[16] , mi[16] ;
+      for ( int k = 0; k < 16; k++ ) {
+        mr[k] = V::re( m[k] ) ;
+        mi[k] = V::im( m[k] ) ;
+      }
+      for ( int64_t i = 0; i < len; i += V::width ) {
+        const auto x0 = V::load( p[0] + i ) ;
+        const auto x1 = V::load( p[1] + i ) ;
+        const auto x2 = V::load( p[2] + i ) ;
+        const auto x3 = V::load( p[3] + i ) ;
+        for ( int r = 0; r < 4; r++ ) {
+          auto y = V::add( V::mul( mr[4*r]   , mi[4*r]   , x0 ) ,
+                           V::mul( mr[4*r+1] , mi[4*r+1] , x1 ) ) ;
+          y = V::add( y , V::add( V::mul( mr[4*r+2] , mi[4*r+2] , x2 ) ,
+                                  V::mul( mr[4*r+3] , mi[4*r+3] , x3 ) ) ) ;
+          V::store( p[r] + i , y ) ;
+        }
+      }
+    }
+
+  } // namespace avx512
+
+#endif
+
+  // number of amplitudes per call of a vector kernel
+  constexpr int64_t simdChunk = 2048 ;
+
+  // simdWidth: number of elements of type T per register, 0 if the vector
+  // kernels can not be used for T
+  template <typename T>
+  int simdWidth() {
+  #ifdef QCLAB_SIMD_KERNELS
+    if constexpr ( std::is_same_v< T , std::complex< double > > ||
+                   std::is_same_v< T , std::complex< float > > ) {
+      switch ( qclab::simd::isa() ) {
+        case qclab::simd::Isa::AVX512 : return 64 / sizeof( T ) ;
+        case qclab::simd::Isa::AVX2   : return 32 / sizeof( T ) ;
+        default                       : return 0 ;
+      }
+    }
+  #endif
+    return 0 ;
+  }
+
+  /*
+   * The simd_apply functions below apply a gate with the vector kernels of
+   * the current instruction set and return true, or return false without
+   * touching the vector if the vector kernels can not be used, i.e., for
+   * real types, scalar instruction set, or too small strides.
+   */
+
+  // simd_apply2: 1-qubit gate with matrix `mat1`
+  template <typename T>
+  bool simd_apply2( const int nbQubits , const int qubit ,
+                    const qclab::dense::SmallMatrix< T , 2 >& mat1 ,
+                    T* vector ) {
+  #ifdef QCLAB_SIMD_KERNELS
+    if constexpr ( qclab::is_complex_v< T > ) {
+      const int width = simdWidth< T >() ;
+      const int64_t s = int64_t(1) << ( nbQubits - qubit - 1 ) ;
+      if ( ( width == 0 ) || ( s < width ) ) return false ;
+      const bool avx512 = ( qclab::simd::isa() == qclab::simd::Isa::AVX512 ) ;
+      const T m[4] = { mat1(0,0) , mat1(0,1) , mat1(1,0) , mat1(1,1) } ;
+      const int64_t len = std::min( s , simdChunk ) ;
+      const int64_t n = ( int64_t(1) << ( nbQubits - 1 ) ) / len ;
+      qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+        const int64_t j = k * len ;
+        const int64_t a = ( ( j & ~(s - 1) ) << 1 ) | ( j & (s - 1) ) ;
+        if ( avx512 ) {
+          avx512::kernel2( vector + a , vector + a + s , len , m ) ;
+        } else {
+          avx2::kernel2( vector + a , vector + a + s , len , m ) ;
+        }
+      } , len ) ;
+      return true ;
+    }
+  #endif
+    return false ;
+  }
+
+  // simd_applyDiag2: diagonal 1-qubit gate diag(d0, d1), d0 = 1 is skipped
+  template <typename T>
+  bool simd_applyDiag2( const int nbQubits , const int qubit ,
+                        const T d0 , const T d1 , T* vector ) {
+  #ifdef QCLAB_SIMD_KERNELS
+    if constexpr ( qclab::is_complex_v< T > ) {
+      const int width = simdWidth< T >() ;
+      const int64_t s = int64_t(1) << ( nbQubits - qubit - 1 ) ;
+      if ( ( width == 0 ) || ( s < width ) ) return false ;
+      const bool avx512 = ( qclab::simd::isa() == qclab::simd::Isa::AVX512 ) ;
+      const bool skip0 = ( d0 == T(1) ) ;
+      const int64_t len = std::min( s , simdChunk ) ;
+      const int64_t n = ( int64_t(1) << ( nbQubits - 1 ) ) / len ;
+      qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+        const int64_t j = k * len ;
+        const int64_t a = ( ( j & ~(s - 1) ) << 1 ) | ( j & (s - 1) ) ;
+        if ( avx512 ) {
+          if ( !skip0 ) avx512::kernelDiag( vector + a , len , d0 ) ;
+          avx512::kernelDiag( vector + a + s , len , d1 ) ;
+        } else {
+          if ( !skip0 ) avx2::kernelDiag( vector + a , len , d0 ) ;
+          avx2::kernelDiag( vector + a + s , len , d1 ) ;
+        }
+      } , len ) ;
+      return true ;
+    }
+  #endif
+    return false ;
+  }
+
+  // simd_apply4: 2-qubit gate with matrix `mat2`, with the amplitudes ordered
+  // as in apply4, i.e., (a, a|qubit0, a|qubit1, a|qubit0|qubit1)
+  template <typename T>
+  bool simd_apply4( const int nbQubits , const int qubit0 , const int qubit1 ,
+                    const qclab::dense::SmallMatrix< T , 4 >& mat2 ,
+                    T* vector ) {
+  #ifdef QCLAB_SIMD_KERNELS
+    if constexpr ( qclab::is_complex_v< T > ) {
+      assert( qubit0 < qubit1 ) ;
+      const int width = simdWidth< T >() ;
+      const int64_t s = int64_t(1) << ( nbQubits - qubit1 - 1 ) ;
+      if ( ( width == 0 ) || ( s < width ) ) return false ;
+      const bool avx512 = ( qclab::simd::isa() == qclab::simd::Isa::AVX512 ) ;
+      T m[16] ;
+      for ( int r = 0; r < 4; r++ ) {
+        for ( int c = 0; c < 4; c++ ) {
+          m[4*r + c] = mat2(r,c) ;
+        }
+      }
+      uint64_t mL , mC , mR ;
+      std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
+      const int64_t b1 = int64_t(1) << ( nbQubits - qubit0 - 1 ) ;
+      const int64_t len = std::min( s , simdChunk ) ;
+      const int64_t n = ( int64_t(1) << ( nbQubits - 2 ) ) / len ;
+      qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+        const uint64_t j = k * len ;
+        const uint64_t a = (j & mR) + ( (j & mC) << 1 ) + ( (j & mL) << 2 ) ;
+        T* const p[4] = { vector + a , vector + ( a | b1 ) ,
+                          vector + ( a | s ) , vector + ( a | b1 | s ) } ;
+        if ( avx512 ) {
+          avx512::kernel4( p , len , m ) ;
+        } else {
+          avx2::kernel4( p , len , m ) ;
+        }
+      } , len ) ;
+      return true ;
+    }
+  #endif
+    return false ;
+  }
+
+  // simd_applyPairs4: 2-qubit gate that applies the 2x2 matrix `m03` to the
+  // amplitudes (a, a|qubit0|qubit1) and the 2x2 matrix `m12` to the
+  // amplitudes (a|qubit1, a|qubit0), both given row-major
+  template <typename T>
+  bool simd_applyPairs4( const int nbQubits , const int qubit0 ,
+                         const int qubit1 , const T* m03 , const T* m12 ,
+                         T* vector ) {
+  #ifdef QCLAB_SIMD_KERNELS
+    if constexpr ( qclab::is_complex_v< T > ) {
+      assert( qubit0 < qubit1 ) ;
+      const int width = simdWidth< T >() ;
+      const int64_t s = int64_t(1) << ( nbQubits - qubit1 - 1 ) ;
+      if ( ( width == 0 ) || ( s < width ) ) return false ;
+      const bool avx512 = ( qclab::simd::isa() == qclab::simd::Isa::AVX512 ) ;
+      uint64_t mL , mC , mR ;
+      std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
+      const int64_t b1 = int64_t(1) << ( nbQubits - qubit0 - 1 ) ;
+      const int64_t len = std::min( s , simdChunk ) ;
+      const int64_t n = ( int64_t(1) << ( nbQubits - 2 ) ) / len ;
+      qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+        const uint64_t j = k * len ;
+        const uint64_t a = (j & mR) + ( (j & mC) << 1 ) + ( (j & mL) << 2 ) ;
+        T* const p0 = vector + a ;
+        T* const p1 = vector + ( a | s ) ;
+        T* const p2 = vector + ( a | b1 ) ;
+        T* const p3 = vector + ( a | b1 | s ) ;
+        if ( avx512 ) {
+          avx512::kernel2( p0 , p3 , len , m03 ) ;
+          avx512::kernel2( p1 , p2 , len , m12 ) ;
+        } else {
+          avx2::kernel2( p0 , p3 , len , m03 ) ;
+          avx2::kernel2( p1 , p2 , len , m12 ) ;
+        }
+      } , len ) ;
+      return true ;
+    }
+  #endif
+    return false ;
+  }
+
+  // simd_applyDiag4: diagonal 2-qubit gate diag(d03, d12, d12, d03)
+  template <typename T>
+  bool simd_applyDiag4( const int nbQubits , const int qubit0 ,
+                        const int qubit1 , const T d03 , const T d12 ,
+                        T* vector ) {
+  #ifdef QCLAB_SIMD_KERNELS
+    if constexpr ( qclab::is_complex_v< T > ) {
+      assert( qubit0 < qubit1 ) ;
+      const int width = simdWidth< T >() ;
+      const int64_t s = int64_t(1) << ( nbQubits - qubit1 - 1 ) ;
+      if ( ( width == 0 ) || ( s < width ) ) return false ;
+      const bool avx512 = ( qclab::simd::isa() == qclab::simd::Isa::AVX512 ) ;
+      uint64_t mL , mC , mR ;
+      std::tie( mL , mC , mR ) = masks( nbQubits , qubit0 , qubit1 ) ;
+      const int64_t b1 = int64_t(1) << ( nbQubits - qubit0 - 1 ) ;
+      const int64_t len = std::min( s , simdChunk ) ;
+      const int64_t n = ( int64_t(1) << ( nbQubits - 2 ) ) / len ;
+      qclab::parallel::forEach( n , [&] ( const int64_t k ) {
+        const uint64_t j = k * len ;
+        const uint64_t a = (j & mR) + ( (j & mC) << 1 ) + ( (j & mL) << 2 ) ;
+        T* const p[4] = { vector + a , vector + ( a | s ) ,
+                          vector + ( a | b1 ) , vector + ( a | b1 | s ) } ;
+        const T d[4] = { d03 , d12 , d12 , d03 } ;
+        for ( int i = 0; i < 4; i++ ) {
+          if ( avx512 ) {
+            avx512::kernelDiag( p[i] , len , d[i] ) ;
+          } else {
+            avx2::kernelDiag( p[i] , len , d[i] ) ;
+          }
+        }
+      } , len ) ;
+      return true ;
+    }
+  #endif
+    return false ;
+  }
+
+} // namespace qclab::qgates
@@ -0,0 +1,215 @@
+#include "qclab/sample.hpp"
+#include "qclab/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace qclab {
+
+  namespace {
+
+  /// Number of qubits of the chunks of the probability prefix.
+  constexpr int chunkQubits = 14 ;
+
+  /// Number of qubits of the blocks of the probability prefix.
+  constexpr int blockQubits = 6 ;
+
+  /// Maximum number of measured qubits of the histogram of marginal counts.
+  constexpr int maxHistogramQubits = 20 ;
+
+  /**
+   * \brief Samples `nbShots` measurements of the qubits `qubits` of a state
+   *        of `nbQubits` qubits with probabilities `prob( i )`.
+   */
+  template <typename P>
+  Counts sampleProbabilities( const int nbQubits , P&& prob ,
+                              const int64_t nbShots ,
+                              const std::vector< int >& qubits ,
+                              const uint64_t seed ) {
+    assert( nbShots >= 0 ) ;
+    if ( nbShots == 0 ) return {} ;
+    const int64_t size = int64_t(1) << nbQubits ;
+    const int64_t chunk = int64_t(1) << std::min( chunkQubits , nbQubits ) ;
+    const int64_t nbChunks = size / chunk ;
+
+    // probabilities of the blocks and probability prefix of the chunks
+    const int64_t block = std::min( int64_t(1) << blockQubits , chunk ) ;
+    const int64_t blocksPerChunk = chunk / block ;
+    const int lanes = std::min( block , int64_t(4) ) ;
+    std::vector< double > blocks( size / block ) ;
+    std::vector< double > prefix( nbChunks + 1 , 0.0 ) ;
+    parallel::forEach( nbChunks , [&] ( const int64_t c ) {
+      double sum = 0 ;
+      for ( int64_t b = c * blocksPerChunk; b < ( c + 1 ) * blocksPerChunk;
+            b++ ) {
+        // independent partial sums
+        double partial[4] = { 0 , 0 , 0 , 0 } ;
+        for ( int64_t i = b * block; i < ( b + 1 ) * block; i += lanes ) {
+          for ( int j = 0; j < lanes; j++ ) partial[j] += prob( i + j ) ;
+        }
+        blocks[b] = ( partial[0] + partial[1] ) + ( partial[2] + partial[3] ) ;
+        sum += blocks[b] ;
+      }
+      prefix[ c + 1 ] = sum ;
+    } , chunk ) ;
+    for ( int64_t c = 0; c < nbChunks; c++ ) prefix[ c + 1 ] += prefix[c] ;
+    const double total = prefix[ nbChunks ] ;
+    assert( total > 0 ) ;
+
+    // sorted uniform numbers in (0, total) from exponential spacings
+    const Random random( seed ) ;
+    std::vector< double > u( nbShots ) ;
+    parallel::forRange( nbShots , [&] ( const int64_t begin ,
+                                        const int64_t end ) {
+      for ( int64_t k = begin; k < end; k++ ) {
+        u[k] = -std::log( random.uniform( k ) ) ;
+      }
+    } ) ;
+    for ( int64_t k = 1; k < nbShots; k++ ) u[k] += u[ k - 1 ] ;
+    const double scale = total / ( u[ nbShots - 1 ] -
+                                   std::log( random.uniform( nbShots ) ) ) ;
+    parallel::forRange( nbShots , [&] ( const int64_t begin ,
+                                        const int64_t end ) {
+      for ( int64_t k = begin; k < end; k++ ) u[k] *= scale ;
+    } ) ;
+
+    // outcomes of the shots in the range of every chunk, only the blocks
+    // with a shot are visited
+    std::vector< uint64_t > outcomes( nbShots ) ;
+    parallel::forEach( nbChunks , [&] ( const int64_t c ) {
+      auto first = std::lower_bound( u.begin() , u.end() , prefix[c] ) ;
+      auto last = ( c + 1 == nbChunks ) ? u.end() :
+                  std::lower_bound( first , u.end() , prefix[ c + 1 ] ) ;
+      if ( first == last ) return ;
+      int64_t k = first - u.begin() ;
+      const int64_t end = last - u.begin() ;
+      double cumulative = prefix[c] ;
+      int64_t nonzero = c * chunk ;
+      for ( int64_t b = c * blocksPerChunk;
+            b < ( c + 1 ) * blocksPerChunk && k < end; b++ ) {
+        const double next = cumulative + blocks[b] ;
+        if ( u[k] < next ) {
+          double partial = cumulative ;
+          for ( int64_t i = b * block; i < ( b + 1 ) * block; i++ ) {
+            const double p = prob( i ) ;
+            if ( p == 0 ) continue ;
+            partial += p ;
+            nonzero = i ;
+            while ( k < end && u[k] < partial ) outcomes[ k++ ] = i ;
+          }
+          // rounding errors of the partial sums
+          while ( k < end && u[k] < next ) outcomes[ k++ ] = nonzero ;
+        }
+        cumulative = next ;
+      }
+      while ( k < end ) outcomes[ k++ ] = nonzero ;
+    } , chunk ) ;
+
+    // counts of the sorted outcomes
+    Counts counts ;
+    for ( int64_t k = 0; k < nbShots; k++ ) {
+      if ( counts.empty() || counts.back().first != outcomes[k] ) {
+        counts.push_back( { outcomes[k] , 0 } ) ;
+      }
+      counts.back().second++ ;
+    }
+    if ( qubits.empty() ) return counts ;
+
+    // marginal counts of the measured qubits
+    const int m = qubits.size() ;
+    for ( auto& [ outcome , count ] : counts ) {
+      uint64_t bits = 0 ;
+      for ( int i = 0; i < m; i++ ) {
+        assert( qubits[i] >= 0 && qubits[i] < nbQubits ) ;
+        const uint64_t bit = ( outcome >> ( nbQubits - qubits[i] - 1 ) ) & 1 ;
+        bits |= bit << ( m - i - 1 ) ;
+      }
+      outcome = bits ;
+    }
+    if ( m <= maxHistogramQubits ) {
+      std::vector< int64_t > histogram( size_t(1) << m , 0 ) ;
+      for ( const auto& [ outcome , count ] : counts ) {
+        histogram[ outcome ] += count ;
+      }
+      counts.clear() ;
+      for ( size_t i = 0; i < histogram.size(); i++ ) {
+        if ( histogram[i] > 0 ) counts.push_back( { i , histogram[i] } ) ;
+      }
+      return counts ;
+    }
+    std::sort( counts.begin() , counts.end() ) ;
+    size_t j = 0 ;
+    for ( size_t i = 1; i < counts.size(); i++ ) {
+      if ( counts[i].first == counts[j].first ) {
+        counts[j].second += counts[i].second ;
+      } else {
+        counts[ ++j ] = counts[i] ;
+      }
+    }
+    counts.resize( j + 1 ) ;
+    return counts ;
+  }
+
+  } // namespace
+
+  // sample
+  template <typename T>
+  Counts sample( const std::vector< T >& vector , const int64_t nbShots ,
+                 const std::vector< int >& qubits , const uint64_t seed ) {
+    int nbQubits = 0 ;
+    while ( ( size_t(1) << nbQubits ) < vector.size() ) nbQubits++ ;
+    assert( vector.size() == size_t(1) << nbQubits ) ;
+    const T* data = vector.data() ;
+    return sampleProbabilities( nbQubits ,
+                                [data] ( const int64_t i ) {
+                                  return double( std::norm( data[i] ) ) ;
+                                } , nbShots , qubits , seed ) ;
+  }
+
+  // sample
+  template <typename T>
+  Counts sample( const qclab::StateVector< T >& state , const int64_t nbShots ,
+                 const std::vector< int >& qubits , const uint64_t seed ) {
+    const int n = state.nbQubits() ;
+    if ( state.layout() == Layout::Interleaved ) {
+      const T* data = state.data() ;
+      return sampleProbabilities( n ,
+                                  [data] ( const int64_t i ) {
+                                    return double( std::norm( data[i] ) ) ;
+                                  } , nbShots , qubits , seed ) ;
+    }
+    if constexpr ( qclab::is_complex_v< T > ) {
+      using R = qclab::real_t< T > ;
+      const R* re = state.real() ;
+      const R* im = state.imag() ;
+      return sampleProbabilities( n ,
+                                  [re,im] ( const int64_t i ) {
+                                    return double( re[i] ) * re[i] +
+                                           double( im[i] ) * im[i] ;
+                                  } , nbShots , qubits , seed ) ;
+    }
+    return {} ;
+  }
+
+  template Counts sample( const std::vector< float >& , const int64_t ,
+                          const std::vector< int >& , const uint64_t ) ;
+  template Counts sample( const std::vector< double >& , const int64_t ,
+                          const std::vector< int >& , const uint64_t ) ;
+  template Counts sample( const std::vector< std::complex< float > >& ,
+                          const int64_t , const std::vector< int >& ,
+                          const uint64_t ) ;
+  template Counts sample( const std::vector< std::complex< double > >& ,
+                          const int64_t , const std::vector< int >& ,
+                          const uint64_t ) ;
+
+  template Counts sample( const qclab::StateVector< float >& , const int64_t ,
+                          const std::vector< int >& , const uint64_t ) ;
+  template Counts sample( const qclab::StateVector< double >& , const int64_t ,
+                          const std::vector< int >& , const uint64_t ) ;
+  template Counts sample( const qclab::StateVector< std::complex< float > >& ,
+                          const int64_t , const std::vector< int >& ,
+                          const uint64_t ) ;
+  template Counts sample( const qclab::StateVector< std::complex< double > >& ,
+                          const int64_t , const std::vector< int >& ,
+                          const uint64_t ) ;
+
+} // namespace qclab
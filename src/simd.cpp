@@ -0,0 +1,57 @@
+#include "qclab/simd.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+namespace qclab::simd {
+
+  // detect
+  Isa detect() {
+  #if defined(QCLAB_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+    __builtin_cpu_init() ;
+    if ( __builtin_cpu_supports( "avx512f" ) ) return Isa::AVX512 ;
+    if ( __builtin_cpu_supports( "avx2" ) &&
+         __builtin_cpu_supports( "fma" ) ) return Isa::AVX2 ;
+  #endif
+    return Isa::Scalar ;
+  }
+
+  namespace {
+
+  // supported
+  Isa supported( const Isa isa ) {
+    const Isa best = detect() ;
+    if ( isa == Isa::AVX512 ) return best ;
+    if ( isa == Isa::AVX2 && best != Isa::Scalar ) return Isa::AVX2 ;
+    return Isa::Scalar ;
+  }
+
+  // initial
+  Isa initial() {
+    const char* env = std::getenv( "QCLAB_SIMD" ) ;
+    if ( env == nullptr ) return detect() ;
+    const std::string str( env ) ;
+    if ( str == "scalar" ) return Isa::Scalar ;
+    if ( str == "avx2" ) return supported( Isa::AVX2 ) ;
+    return detect() ;
+  }
+
+  // current
+  std::atomic< Isa >& current() {
+    static std::atomic< Isa > isa( initial() ) ;
+    return isa ;
+  }
+
+  } // namespace
+
+  // isa
+  Isa isa() {
+    return current().load( std::memory_order_relaxed ) ;
+  }
+
+  // setIsa
+  void setIsa( const Isa isa ) {
+    current().store( supported( isa ) , std::memory_order_relaxed ) ;
+  }
+
+} // namespace qclab::simd
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "qclab/MappedStateVector.hpp"
+#include "circuits.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/MCX.hpp"
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+
+template <typename T>
+void check_qclab_MappedStateVector( const qclab::QCircuit< T >& circuit ,
+                                    const int chunkQubits ,
+                                    const qclab::sim::Options& options ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 1000 * std::numeric_limits< R >::epsilon() ;
+  const int n = circuit.nbQubits() ;
+
+  // initial vector
+  std::vector< T > v0( 1 << n ) ;
+  for ( int i = 0; i < v0.size(); i++ ) {
+    v0[i] = T( std::cos( 0.7 * i ) , std::sin( 1.3 * i ) ) ;
+  }
+
+  const std::string filename = testing::TempDir() + "qclab_mapped.bin" ;
+  {
+    qclab::MappedStateVector< T >  psi( filename , n , chunkQubits ) ;
+    psi.assign( v0 ) ;
+    psi.simulate( circuit , options ) ;
+    auto w = v0 ;
+    circuit.simulate( w ) ;
+    for ( int i = 0; i < w.size(); i++ ) {
+      EXPECT_NEAR( std::abs( psi(i) - w[i] ) , 0 , tol ) ;
+    }
+  }
+  std::remove( filename.c_str() ) ;
+
+}
+
+template <typename T>
+void test_qclab_MappedStateVector() {
+
+  using namespace qclab::qgates ;
+  const std::string filename = testing::TempDir() + "qclab_mapped.bin" ;
+
+  // all zero state
+  {
+    qclab::MappedStateVector< T >  psi( filename , 5 , 3 ) ;
+    EXPECT_EQ( psi.nbQubits() , 5 ) ;
+    EXPECT_EQ( psi.chunkQubits() , 3 ) ;
+    EXPECT_EQ( psi.size() , 32 ) ;
+    EXPECT_EQ( psi.filename() , filename ) ;
+    EXPECT_EQ( psi(0) , T(1) ) ;
+    for ( int i = 1; i < psi.size(); i++ ) EXPECT_EQ( psi(i) , T(0) ) ;
+    psi.set( 0 , 0 ) ;
+    psi.set( 31 , 1 ) ;
+    psi.sync() ;
+
+    // the file holds the amplitudes
+    std::ifstream file( filename , std::ios::binary | std::ios::ate ) ;
+    EXPECT_EQ( int64_t( file.tellg() ) , 32 * sizeof( T ) ) ;
+    file.seekg( 31 * sizeof( T ) ) ;
+    T x ;
+    file.read( reinterpret_cast< char* >( &x ) , sizeof( T ) ) ;
+    EXPECT_EQ( x , T(1) ) ;
+
+    // chunks larger than the vector
+    qclab::MappedStateVector< T >  phi( filename , 2 , 5 ) ;
+    EXPECT_EQ( phi.chunkQubits() , 2 ) ;
+    EXPECT_EQ( phi.vector() , std::vector< T >( { 1 , 0 , 0 , 0 } ) ) ;
+  }
+  std::remove( filename.c_str() ) ;
+
+  // file that can not be created
+  {
+    const std::string missing = testing::TempDir() + "qclab_missing/a.bin" ;
+    EXPECT_THROW( qclab::MappedStateVector< T >( missing , 5 , 3 ) ,
+                  std::system_error ) ;
+  }
+
+  // sweeps
+  {
+    const int n = 8 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< Hadamard< T > >( q ) ) ;
+    }
+    qclab::MappedStateVector< T >  psi( filename , n , 3 ) ;
+    psi.simulate( circuit ) ;
+    // H(0), H(1), H(2) and H(3), ..., H(7)
+    EXPECT_EQ( psi.nbSweeps() , 2 ) ;
+    const auto v = psi.vector() ;
+    for ( const auto& x : v ) {
+      EXPECT_NEAR( std::abs( x - T( 1.0 / 16 ) ) , 0 , 1e-6 ) ;
+    }
+    // H(3), ..., H(7), CNOT(4,0) and MCX(0,1,4)
+    circuit.push_back( std::make_unique< CNOT< T > >( 4 , 0 ) ) ;
+    circuit.push_back( std::make_unique< MCX< T > >(
+                         std::vector< int >( { 0 , 1 } ) , 4 ) ) ;
+    psi.simulate( circuit ) ;
+    EXPECT_EQ( psi.nbSweeps() , 3 ) ;
+  }
+  std::remove( filename.c_str() ) ;
+
+  // multi-controlled gates on more than maxGroupQubits high qubits
+  {
+    const int n = 6 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< RotationY< T > >( q , 0.3 + q ) ) ;
+    }
+    circuit.push_back( std::make_unique< MCX< T > >(
+                         std::vector< int >( { 0 , 1 , 2 } ) , 3 ) ) ;
+    circuit.push_back( std::make_unique< CNOT< T > >( 5 , 0 ) ) ;
+    circuit.push_back( std::make_unique< MCX< T > >(
+                         std::vector< int >( { 0 , 2 , 3 , 4 } ) , 1 ,
+                         std::vector< int >( { 1 , 0 , 1 , 1 } ) ) ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< RotationX< T > >( q , 0.1 * q ) ) ;
+    }
+    qclab::MappedStateVector< T >  psi( filename , n , 2 ) ;
+    psi.simulate( circuit ) ;
+    // RY(0), ..., RY(2) and RY(3), ..., RY(5) and MCX(0,1,2,3) and
+    // CNOT(5,0) and MCX(0,2,3,4,1) and RX(0), ..., RX(2) and RX(3), ...
+    EXPECT_EQ( psi.nbSweeps() , 7 ) ;
+    for ( const int chunkQubits : { 1 , 2 , 3 } ) {
+      qclab::sim::Options options ;
+      check_qclab_MappedStateVector( circuit , chunkQubits , options ) ;
+      options.fuseMonomial = true ;
+      options.fuseK = 3 ;
+      check_qclab_MappedStateVector( circuit , chunkQubits , options ) ;
+    }
+  }
+  std::remove( filename.c_str() ) ;
+
+  // gates on high and low qubits
+  for ( int n = 4; n <= 8; n++ ) {
+    const auto circuit = mixed< T >( n , true ) ;
+    for ( const int chunkQubits : { 1 , 2 , 3 , 8 } ) {
+      qclab::sim::Options options ;
+      check_qclab_MappedStateVector( circuit , chunkQubits , options ) ;
+      options.fuseDiagonal = true ;
+      options.fuse1 = true ;
+      check_qclab_MappedStateVector( circuit , chunkQubits , options ) ;
+      options.fuseK = 4 ;
+      options.blockQubits = 2 ;
+      check_qclab_MappedStateVector( circuit , chunkQubits , options ) ;
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_MappedStateVector , complex_float ) {
+  test_qclab_MappedStateVector< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_MappedStateVector , complex_double ) {
+  test_qclab_MappedStateVector< std::complex< double > >() ;
+}
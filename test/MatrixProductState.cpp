@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "qclab/MatrixProductState.hpp"
+#include "circuits.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/CNOT.hpp"
+
+template <typename T>
+void test_qclab_MatrixProductState() {
+
+  using namespace qclab::qgates ;
+  using R = qclab::real_t< T > ;
+  const R tol = 1000 * std::numeric_limits< R >::epsilon() ;
+
+  // all zero state
+  {
+    qclab::MatrixProductState< T >  psi( 3 ) ;
+    EXPECT_EQ( psi.nbQubits() , 3 ) ;
+    EXPECT_EQ( psi.maxBond() , 256 ) ;
+    EXPECT_EQ( psi.maxBondDimension() , 1 ) ;
+    EXPECT_EQ( psi.truncationError() , 0 ) ;
+    EXPECT_EQ( psi(0) , T(1) ) ;
+    EXPECT_EQ( psi(5) , T(0) ) ;
+    EXPECT_EQ( psi.vector() , std::vector< T >( { 1 , 0 , 0 , 0 ,
+                                                 0 , 0 , 0 , 0 } ) ) ;
+  }
+
+  // comparison with the dense vector
+  for ( int n = 2; n <= 8; n++ ) {
+    const auto circuit = mixed< T >( n ) ;
+    std::vector< T > v( 1 << n , T(0) ) ;
+    v[0] = 1 ;
+    circuit.simulate( v ) ;
+
+    qclab::MatrixProductState< T >  psi( n ) ;
+    psi.simulate( circuit ) ;
+    EXPECT_LE( psi.maxBondDimension() , 1 << ( n / 2 ) ) ;
+    EXPECT_LE( psi.truncationError() , tol ) ;
+    // the dense reference and the SVDs of the MPS both accumulate round-off
+    // over the about 4.5 n^2 gates of the circuit, which reaches 1.2 * tol
+    // in single precision for n = 8
+    const R tolN = std::is_same_v< R , float > ? 2 * tol : tol ;
+    const auto w = psi.vector() ;
+    for ( int i = 0; i < v.size(); i++ ) {
+      EXPECT_NEAR( std::abs( v[i] - w[i] ) , 0 , tolN ) ;
+      EXPECT_NEAR( std::abs( v[i] - psi(i) ) , 0 , tolN ) ;
+    }
+
+    // sampled frequencies
+    const int64_t nbShots = 10000 ;
+    const auto counts = psi.sample( nbShots , {} , n ) ;
+    int64_t total = 0 ;
+    for ( const auto& [ outcome , count ] : counts ) {
+      EXPECT_NEAR( double( count ) / nbShots , std::norm( v[ outcome ] ) ,
+                   0.025 ) ;
+      total += count ;
+    }
+    EXPECT_EQ( total , nbShots ) ;
+    EXPECT_EQ( psi.sample( nbShots , {} , n ) , counts ) ;
+    // sampling moves the center without changing the state
+    EXPECT_NEAR( std::abs( v[3] - psi(3) ) , 0 , tolN ) ;
+  }
+
+  // GHZ state on 200 qubits
+  {
+    const int n = 200 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    for ( int q = 0; q < n - 1; q++ ) {
+      circuit.push_back( std::make_unique< CNOT< T > >( q , q + 1 ) ) ;
+    }
+    circuit.push_back( std::make_unique< CNOT< T > >( n - 1 , 0 ) ) ;
+    qclab::MatrixProductState< T >  psi( n ) ;
+    psi.simulate( circuit ) ;
+    EXPECT_EQ( psi.maxBondDimension() , 2 ) ;
+    std::vector< int > bits( n , 0 ) ;
+    EXPECT_NEAR( std::abs( psi.amplitude( bits ) - T( std::sqrt( 0.5 ) ) ) ,
+                 0 , tol ) ;
+    std::fill( bits.begin() , bits.end() , 1 ) ;
+    bits[0] = 0 ;
+    EXPECT_NEAR( std::abs( psi.amplitude( bits ) - T( std::sqrt( 0.5 ) ) ) ,
+                 0 , tol ) ;
+    const auto counts = psi.sample( 1000 , { 199 , 100 , 0 } , 1 ) ;
+    ASSERT_EQ( counts.size() , 2 ) ;
+    EXPECT_EQ( counts[0].first , 0 ) ;
+    EXPECT_EQ( counts[1].first , 6 ) ;
+    EXPECT_GT( counts[0].second , 400 ) ;
+    EXPECT_GT( counts[1].second , 400 ) ;
+  }
+
+  // truncation of an entangled pair of qubits
+  {
+    qclab::QCircuit< T >  circuit( 4 ) ;
+    circuit.push_back( std::make_unique< RotationY< T > >( 0 , 1.0 ) ) ;
+    circuit.push_back( std::make_unique< CNOT< T > >( 0 , 3 ) ) ;
+    qclab::MatrixProductState< T >  psi( 4 ) ;
+    psi.setMaxBond( 1 ) ;
+    EXPECT_EQ( psi.maxBond() , 1 ) ;
+    psi.simulate( circuit ) ;
+    EXPECT_EQ( psi.maxBondDimension() , 1 ) ;
+    const R p = std::pow( std::sin( R( 0.5 ) ) , 2 ) ;
+    EXPECT_NEAR( psi.truncationError() , p , tol ) ;
+    EXPECT_NEAR( std::abs( psi(0) ) , 1 , tol ) ;
+
+    qclab::MatrixProductState< T >  phi( 4 ) ;
+    phi.setTruncation( 0.5 ) ;
+    EXPECT_EQ( phi.truncation() , R( 0.5 ) ) ;
+    phi.simulate( circuit ) ;
+    EXPECT_EQ( phi.maxBondDimension() , 1 ) ;
+    phi.setTruncation( 0.1 ) ;
+    phi.simulate( circuit ) ;
+    EXPECT_EQ( phi.maxBondDimension() , 2 ) ;
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_MatrixProductState , complex_float ) {
+  test_qclab_MatrixProductState< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_MatrixProductState , complex_double ) {
+  test_qclab_MatrixProductState< std::complex< double > >() ;
+}
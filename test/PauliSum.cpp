@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include "qclab/PauliSum.hpp"
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/PauliY.hpp"
+#include "qclab/qgates/PauliZ.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/CNOT.hpp"
+
+/// Applies the Pauli string `paulis` term by term with Pauli gates.
+template <typename T>
+void apply_paulis( const std::string& paulis , std::vector< T >& vector ,
+                   const int offset = 0 ) {
+
+  const int n = paulis.size() + offset ;
+  for ( int q = 0; q < paulis.size(); q++ ) {
+    if ( paulis[q] == 'X' ) {
+      qclab::qgates::PauliX< T >( q + offset ).apply( qclab::Op::NoTrans , n ,
+                                                      vector ) ;
+    } else if ( paulis[q] == 'Y' ) {
+      if constexpr ( qclab::is_complex_v< T > ) {
+        qclab::qgates::PauliY< T >( q + offset ).apply( qclab::Op::NoTrans ,
+                                                        n , vector ) ;
+      }
+    } else if ( paulis[q] == 'Z' ) {
+      qclab::qgates::PauliZ< T >( q + offset ).apply( qclab::Op::NoTrans , n ,
+                                                      vector ) ;
+    }
+  }
+
+}
+
+template <typename T>
+void test_qclab_PauliSum() {
+
+  using R = qclab::real_t< T > ;
+  using V = std::vector< T > ;
+  const R tol = 1000 * std::numeric_limits< R >::epsilon() ;
+
+  const int n = 6 ;
+  std::vector< std::pair< R , std::string > > terms = {
+    { 0.5 , "ZIZIII" } , { -1.2 , "IIIIIZ" } , { 0.7 , "IIIIII" } ,
+    { 0.3 , "XIIIXI" } , { -0.8 , "XZIIXI" } , { 1.1 , "IZXIIZ" } ,
+    { 0.9 , "ZZZZZZ" } , { -0.4 , "XXXXXX" } } ;
+  if constexpr ( qclab::is_complex_v< T > ) {
+    terms.push_back( { 0.6 , "YIIIXI" } ) ;
+    terms.push_back( { -0.2 , "IYIYII" } ) ;
+    terms.push_back( { 1.3 , "ZYXIIY" } ) ;
+    terms.push_back( { 0.25 , "IIIIIY" } ) ;
+  }
+
+  qclab::PauliSum< T > sum( n ) ;
+  for ( const auto& [ c , paulis ] : terms ) sum.add( c , paulis ) ;
+  EXPECT_EQ( sum.nbQubits() , n ) ;
+  EXPECT_EQ( sum.nbTerms() , terms.size() ) ;
+  EXPECT_EQ( sum.terms()[3].xMask , 1 + 16 ) ;
+  EXPECT_EQ( sum.terms()[4].zMask , 2 ) ;
+  sum.print() ;
+
+  // sparse terms
+  {
+    qclab::PauliSum< T > sparse( n ) ;
+    sparse.add( 2.0 , { 4 , 1 } , "XZ" ) ;
+    EXPECT_EQ( sparse.terms()[0].xMask , 16 ) ;
+    EXPECT_EQ( sparse.terms()[0].zMask , 2 ) ;
+  }
+
+  V vector( 1 << n ) ;
+  R nrm = 0 ;
+  for ( int i = 0; i < vector.size(); i++ ) {
+    if constexpr ( qclab::is_complex_v< T > ) {
+      vector[i] = T( std::cos( 3*i + 1 ) , std::sin( 2*i ) ) ;
+    } else {
+      vector[i] = std::cos( 3*i + 1 ) ;
+    }
+    nrm += std::norm( vector[i] ) ;
+  }
+  for ( auto& v : vector ) v /= std::sqrt( nrm ) ;
+
+  // reference: H vector term by term
+  V ref( 1 << n , T(0) ) ;
+  for ( const auto& [ c , paulis ] : terms ) {
+    auto w = vector ;
+    apply_paulis( paulis , w ) ;
+    for ( int i = 0; i < w.size(); i++ ) ref[i] += c * w[i] ;
+  }
+  T e = 0 ;
+  for ( int i = 0; i < ref.size(); i++ ) {
+    if constexpr ( qclab::is_complex_v< T > ) {
+      e += std::conj( vector[i] ) * ref[i] ;
+    } else {
+      e += vector[i] * ref[i] ;
+    }
+  }
+
+  // expectation
+  EXPECT_NEAR( sum.expectation( vector ) , std::real( e ) , tol ) ;
+  for ( auto layout : { qclab::Layout::Interleaved , qclab::Layout::Split } ) {
+    if ( !qclab::is_complex_v< T > && layout == qclab::Layout::Split ) {
+      continue ;
+    }
+    qclab::StateVector< T > state( vector , layout ) ;
+    EXPECT_NEAR( sum.expectation( state ) , std::real( e ) , tol ) ;
+  }
+
+  // expectation inside a persistent team
+  {
+    const int64_t threshold = qclab::parallel::threshold() ;
+    qclab::parallel::setThreshold( 1 ) ;
+    qclab::parallel::run( vector.size() , [&] () {
+      const R value = sum.expectation( vector ) ;
+      EXPECT_NEAR( value , std::real( e ) , tol ) ;
+      EXPECT_EQ( sum.expectation( vector ) , value ) ;
+    } ) ;
+    qclab::parallel::setThreshold( threshold ) ;
+  }
+
+  // apply
+  {
+    auto w = vector ;
+    sum.apply( qclab::Op::NoTrans , n , w ) ;
+    for ( int i = 0; i < w.size(); i++ ) {
+      EXPECT_NEAR( std::abs( w[i] - ref[i] ) , 0 , tol ) ;
+    }
+    // offset
+    V big( 1 << ( n + 2 ) , T(0) ) ;
+    for ( int i = 0; i < vector.size(); i++ ) big[ 4*i + 3 ] = vector[i] ;
+    sum.apply( qclab::Op::ConjTrans , n + 2 , big ) ;
+    for ( int i = 0; i < vector.size(); i++ ) {
+      EXPECT_NEAR( std::abs( big[ 4*i + 3 ] - ref[i] ) , 0 , tol ) ;
+      EXPECT_NEAR( std::abs( big[ 4*i ] ) , 0 , tol ) ;
+    }
+  }
+
+  if constexpr ( qclab::is_complex_v< T > ) {
+    // transpose: H^T v = conj( H conj( v ) )
+    auto w1 = vector ;
+    auto w2 = vector ;
+    for ( auto& v : w2 ) v = std::conj( v ) ;
+    sum.apply( qclab::Op::Trans , n , w1 ) ;
+    sum.apply( qclab::Op::NoTrans , n , w2 ) ;
+    for ( int i = 0; i < w1.size(); i++ ) {
+      EXPECT_NEAR( std::abs( w1[i] - std::conj( w2[i] ) ) , 0 , tol ) ;
+    }
+
+    // gradient with a Pauli sum observable
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int i = 0; i < n; i++ ) {
+      circuit.push_back( std::make_unique< qclab::qgates::Hadamard< T > >(
+                                                                      i ) ) ;
+      circuit.push_back( std::make_unique< qclab::qgates::RotationY< T > >( i ,
+                                                                  0.3 * i ) ) ;
+      circuit.push_back( std::make_unique< qclab::qgates::CNOT< T > >( i ,
+                                                          ( i + 1 ) % n ) ) ;
+    }
+    qclab::PauliSum< T > single( n ) ;
+    single.add( 1 , "ZIXIII" ) ;
+    qclab::QCircuit< T >  pauli( n ) ;
+    pauli.push_back( std::make_unique< qclab::qgates::PauliZ< T > >( 0 ) ) ;
+    pauli.push_back( std::make_unique< qclab::qgates::PauliX< T > >( 2 ) ) ;
+    std::vector< R > grad1 , grad2 ;
+    const R e1 = circuit.gradient( vector , single , grad1 ) ;
+    const R e2 = circuit.gradient( vector , pauli , grad2 ) ;
+    EXPECT_NEAR( e1 , e2 , tol ) ;
+    ASSERT_EQ( grad1.size() , n ) ;
+    for ( int p = 0; p < n; p++ ) EXPECT_NEAR( grad1[p] , grad2[p] , tol ) ;
+
+    // expectation of the simulated circuit
+    auto psi = vector ;
+    circuit.simulate( psi ) ;
+    EXPECT_NEAR( single.expectation( psi ) , e1 , tol ) ;
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_PauliSum , float ) {
+  test_qclab_PauliSum< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_PauliSum , double ) {
+  test_qclab_PauliSum< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_PauliSum , complex_float ) {
+  test_qclab_PauliSum< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_PauliSum , complex_double ) {
+  test_qclab_PauliSum< std::complex< double > >() ;
+}
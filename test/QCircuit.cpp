@@ -6,6 +6,12 @@
 #include "qclab/qgates/PauliZ.hpp"
 #include "qclab/qgates/CNOT.hpp"
 #include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/Measurement.hpp"
+#include "qclab/qgates/Reset.hpp"
+#include "qclab/qgates/Conditional.hpp"
+#include <fstream>
 
 template <typename T>
 void test_qclab_QCircuit() {
@@ -752,12 +758,149 @@ void test_qclab_QCircuit() {
 
 }
 
+template <typename T>
+void test_qclab_QCircuit_dynamic() {
+
+  using namespace qclab::qgates ;
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  // teleportation of qubit 0 to qubit 2, after an error correction round
+  // with a reset ancilla qubit 3
+  const R a = 0.7 ;
+  const R b = -1.1 ;
+  qclab::QCircuit< T >  circuit( 4 ) ;
+  circuit.push_back( std::make_unique< RotationY< T > >( 0 , a ) ) ;
+  circuit.push_back( std::make_unique< RotationZ< T > >( 0 , b ) ) ;
+  circuit.push_back( std::make_unique< Hadamard< T > >( 1 ) ) ;
+  circuit.push_back( std::make_unique< CNOT< T > >( 1 , 2 ) ) ;
+  circuit.push_back( std::make_unique< CNOT< T > >( 0 , 1 ) ) ;
+  circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+  circuit.push_back( std::make_unique< Measurement< T > >( 0 , 0 ) ) ;
+  circuit.push_back( std::make_unique< Measurement< T > >( 1 , 1 ) ) ;
+  circuit.push_back( std::make_unique< Conditional< T > >(
+                     std::make_unique< PauliX< T > >( 2 ) , std::vector< int >(
+                     { 1 } ) , 1 ) ) ;
+  circuit.push_back( std::make_unique< Conditional< T > >(
+                     std::make_unique< PauliZ< T > >( 2 ) , std::vector< int >(
+                     { 0 } ) , 1 ) ) ;
+  circuit.push_back( std::make_unique< Hadamard< T > >( 3 ) ) ;
+  circuit.push_back( std::make_unique< Reset< T > >( 3 ) ) ;
+  EXPECT_TRUE( circuit.dynamic() ) ;
+  EXPECT_THROW( circuit.matrix() , std::logic_error ) ;
+
+  // teleported state
+  std::vector< T > psi = { 1 , 0 } ;
+  RotationY< T >( 0 , a ).apply( qclab::Op::NoTrans , 1 , psi ) ;
+  RotationZ< T >( 0 , b ).apply( qclab::Op::NoTrans , 1 , psi ) ;
+
+  std::vector< T > v0( 16 , T(0) ) ;
+  v0[0] = 1 ;
+  std::vector< int > seen( 4 , 0 ) ;
+  for ( int seed = 0; seed < 32; seed++ ) {
+    auto v = v0 ;
+    qclab::ClassicalRegister creg( 2 , seed ) ;
+    circuit.simulate( v , creg ) ;
+    EXPECT_EQ( creg.counter() , 3 ) ;
+    const int m0 = creg[0] ;
+    const int m1 = creg[1] ;
+    seen[ 2 * m0 + m1 ]++ ;
+    for ( int i = 0; i < 16; i++ ) {
+      const int q0 = ( i >> 3 ) & 1 ;
+      const int q1 = ( i >> 2 ) & 1 ;
+      const int q2 = ( i >> 1 ) & 1 ;
+      const int q3 = i & 1 ;
+      const T expected = ( q0 == m0 && q1 == m1 && q3 == 0 ) ? psi[ q2 ] :
+                                                                T(0) ;
+      EXPECT_NEAR( std::abs( v[i] - expected ) , 0 , tol ) ;
+    }
+
+    // simulation options
+    for ( int blockQubits : { 0 , 2 } ) {
+      qclab::sim::Options options ;
+      options.fuse1 = true ;
+      options.fuseK = 2 ;
+      options.blockQubits = blockQubits ;
+      auto w = v0 ;
+      qclab::ClassicalRegister creg2( 2 , seed ) ;
+      circuit.simulate( w , creg2 , options ) ;
+      EXPECT_EQ( creg2.bits() , creg.bits() ) ;
+      for ( int i = 0; i < 16; i++ ) {
+        EXPECT_NEAR( std::abs( w[i] - v[i] ) , 0 , tol ) ;
+      }
+    }
+  }
+  for ( int k = 0; k < 4; k++ ) EXPECT_GT( seen[k] , 0 ) ;
+
+  // without a classical register
+  {
+    auto v = v0 ;
+    auto w = v0 ;
+    qclab::ClassicalRegister creg ;
+    circuit.simulate( v ) ;
+    circuit.simulate( w , creg ) ;
+    EXPECT_EQ( v , w ) ;
+    std::vector< std::vector< T > > vectors( 3 , v0 ) ;
+    circuit.simulate( vectors ) ;
+    for ( const auto& x : vectors ) EXPECT_EQ( x , w ) ;
+  }
+
+  // QASM
+  const std::string filename = testing::TempDir() + "qclab_dynamic.qasm" ;
+  {
+    std::ofstream file( filename ) ;
+    file << "OPENQASM 2.0;\n"
+         << "include \"qelib1.inc\";\n"
+         << "creg c0[1];\n"
+         << "qreg q[4];\n"
+         << "creg c1[1];\n"
+         << "ry(" << qclab::qasm( a ) << ") q[0];\n"
+         << "rz(" << qclab::qasm( b ) << ") q[0];\n"
+         << "h q[1];\n"
+         << "cx q[1], q[2];\n"
+         << "cx q[0], q[1];\n"
+         << "h q[0];\n"
+         << "measure q[0] -> c0[0];\n"
+         << "measure q[1] -> c1[0];\n"
+         << "if (c1 == 1) x q[2];\n"
+         << "if(c0==1) z q[2];\n"
+         << "h q[3];\n"
+         << "reset q[3];\n" ;
+  }
+  qclab::io::QASMFile qasm( filename ) ;
+  EXPECT_EQ( qasm.nbBits() , 2 ) ;
+  qclab::QCircuit< T > loaded( filename ) ;
+  std::remove( filename.c_str() ) ;
+  ASSERT_EQ( loaded.nbGates() , circuit.nbGates() ) ;
+  for ( int i = 0; i < circuit.nbGates(); i++ ) {
+    if ( i < 2 ) continue ;  // rounded angles
+    EXPECT_TRUE( *loaded[i] == *circuit[i] ) ;
+  }
+  for ( int seed = 0; seed < 8; seed++ ) {
+    auto v = v0 ;
+    auto w = v0 ;
+    qclab::ClassicalRegister creg1( 0 , seed ) , creg2( 0 , seed ) ;
+    circuit.simulate( v , creg1 ) ;
+    loaded.simulate( w , creg2 ) ;
+    EXPECT_EQ( creg1.bits() , creg2.bits() ) ;
+    for ( int i = 0; i < 16; i++ ) {
+      EXPECT_NEAR( std::abs( w[i] - v[i] ) , 0 , 10 * tol ) ;
+    }
+  }
+
+  // toQASM
+  std::stringstream stream ;
+  EXPECT_EQ( circuit.toQASM( stream ) , -1 ) ;  // conditions on single bits
+
+}
+
 
 /*
  * complex float
  */
 TEST( qclab_QCircuit , complex_float ) {
   test_qclab_QCircuit< std::complex< float > >() ;
+  test_qclab_QCircuit_dynamic< std::complex< float > >() ;
 }
 
 /*
@@ -765,5 +908,6 @@ TEST( qclab_QCircuit , complex_float ) {
  */
 TEST( qclab_QCircuit , complex_double ) {
   test_qclab_QCircuit< std::complex< double > >() ;
+  test_qclab_QCircuit_dynamic< std::complex< double > >() ;
 }
 
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "qclab/SparseStateVector.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/PauliY.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+#include "qclab/qgates/MCX.hpp"
+#include "qclab/qgates/MCSWAP.hpp"
+
+template <typename T>
+void test_qclab_SparseStateVector() {
+
+  using namespace qclab::qgates ;
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  // basis states
+  {
+    qclab::SparseStateVector< T >  psi( 3 ) ;
+    EXPECT_EQ( psi.nbQubits() , 3 ) ;
+    EXPECT_FALSE( psi.isDense() ) ;
+    EXPECT_EQ( psi.nbNonzeros() , 1 ) ;
+    EXPECT_EQ( psi(0) , T(1) ) ;
+    EXPECT_EQ( psi(5) , T(0) ) ;
+    EXPECT_EQ( psi.vector() , std::vector< T >( { 1 , 0 , 0 , 0 ,
+                                                 0 , 0 , 0 , 0 } ) ) ;
+    qclab::SparseStateVector< T >  phi( 64 , uint64_t(1) << 63 ) ;
+    EXPECT_EQ( phi( uint64_t(1) << 63 ) , T(1) ) ;
+  }
+
+  // H H: cancelled amplitudes are dropped
+  {
+    qclab::SparseStateVector< T >  psi( 40 ) ;
+    psi.apply( Hadamard< T >( 39 ) ) ;
+    EXPECT_EQ( psi.nbNonzeros() , 2 ) ;
+    EXPECT_NEAR( std::abs( psi(1) - T( 1 / std::sqrt( R(2) ) ) ) , 0 , tol ) ;
+    psi.apply( Hadamard< T >( 39 ) ) ;
+    EXPECT_EQ( psi.nbNonzeros() , 1 ) ;
+    EXPECT_NEAR( std::abs( psi(0) - T(1) ) , 0 , tol ) ;
+  }
+
+  // GHZ state and ripple carry increment on 64 qubits
+  {
+    const int n = 64 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    for ( int q = 0; q < n - 1; q++ ) {
+      circuit.push_back( std::make_unique< CNOT< T > >( q , q + 1 ) ) ;
+    }
+    qclab::SparseStateVector< T >  psi( n ) ;
+    psi.simulate( circuit ) ;
+    EXPECT_EQ( psi.nbNonzeros() , 2 ) ;
+    const auto entries = psi.entries() ;
+    ASSERT_EQ( entries.size() , 2 ) ;
+    EXPECT_EQ( entries[0].first , 0 ) ;
+    EXPECT_EQ( entries[1].first , ~uint64_t(0) ) ;
+
+    // +1 on the 32 least significant qubits: ...0111 -> ...1000
+    qclab::QCircuit< T >  increment( n ) ;
+    for ( int t = 32; t < n; t++ ) {
+      std::vector< int > controls ;
+      for ( int c = t + 1; c < n; c++ ) controls.push_back( c ) ;
+      if ( controls.empty() ) {
+        increment.push_back( std::make_unique< PauliX< T > >( t ) ) ;
+      } else {
+        increment.push_back( std::make_unique< MCX< T > >( controls , t ) ) ;
+      }
+    }
+    qclab::SparseStateVector< T >  phi( n , 0xFFFFFFFF0000FFFFULL ) ;
+    phi.simulate( increment ) ;
+    EXPECT_EQ( phi.nbNonzeros() , 1 ) ;
+    EXPECT_EQ( phi( 0xFFFFFFFF00010000ULL ) , T(1) ) ;
+  }
+
+  // comparison with the dense vector
+  for ( int n = 3; n <= 8; n++ ) {
+    qclab::QCircuit< T >  circuit( n ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    for ( int p = 0; p < n; p++ ) {
+      const int q = ( p + 1 ) % n ;
+      const int r = ( p + 2 ) % n ;
+      circuit.push_back( std::make_unique< CNOT< T > >( p , q , p % 2 ) ) ;
+      circuit.push_back( std::make_unique< RotationX< T > >( q , 0.3 * p ) ) ;
+      circuit.push_back( std::make_unique< CZ< T > >( p , r ) ) ;
+      circuit.push_back( std::make_unique< CPhase< T > >( q , p , 0.7 ) ) ;
+      circuit.push_back( std::make_unique< CRotationY< T > >( r , q , 0.2 ) ) ;
+      circuit.push_back( std::make_unique< RotationZZ< T > >( p , r , 0.4 ) ) ;
+      circuit.push_back( std::make_unique< iSWAP< T > >( std::min( p , q ) ,
+                                                         std::max( p , q ) ) ) ;
+      circuit.push_back( std::make_unique< SWAP< T > >( p , r ) ) ;
+      circuit.push_back( std::make_unique< PauliY< T > >( r ) ) ;
+      std::vector< int > controls = { p , q } ;
+      std::sort( controls.begin() , controls.end() ) ;
+      circuit.push_back( std::make_unique< MCX< T > >( controls , r ,
+                           std::vector< int >( { 1 , 0 } ) ) ) ;
+      circuit.push_back( std::make_unique< MCSWAP< T > >(
+                           std::vector< int >( { p } ) ,
+                           std::min( q , r ) , std::max( q , r ) ) ) ;
+    }
+    std::vector< T > v( 1 << n , T(0) ) ;
+    v[0] = 1 ;
+    circuit.simulate( v ) ;
+
+    // sparse only
+    qclab::SparseStateVector< T >  psi( n ) ;
+    psi.setDensity( 1 ) ;
+    psi.simulate( circuit ) ;
+    EXPECT_FALSE( psi.isDense() ) ;
+    auto w = psi.vector() ;
+    for ( int i = 0; i < v.size(); i++ ) {
+      EXPECT_NEAR( std::abs( v[i] - w[i] ) , 0 , tol ) ;
+    }
+
+    // switch to dense after the first Hadamard gate
+    qclab::SparseStateVector< T >  phi( n ) ;
+    phi.setDensity( 1.0 / ( 1 << n ) ) ;
+    EXPECT_EQ( phi.density() , 1.0 / ( 1 << n ) ) ;
+    phi.simulate( circuit ) ;
+    EXPECT_TRUE( phi.isDense() ) ;
+    EXPECT_EQ( phi.nbNonzeros() , 1 << n ) ;
+    w = phi.vector() ;
+    for ( int i = 0; i < v.size(); i++ ) {
+      EXPECT_NEAR( std::abs( v[i] - w[i] ) , 0 , tol ) ;
+    }
+    phi.apply( Hadamard< T >( 0 ) ) ;
+    Hadamard< T >( 0 ).apply( qclab::Op::NoTrans , n , v ) ;
+    for ( int i = 0; i < v.size(); i++ ) {
+      EXPECT_NEAR( std::abs( v[i] - phi(i) ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_SparseStateVector , complex_float ) {
+  test_qclab_SparseStateVector< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_SparseStateVector , complex_double ) {
+  test_qclab_SparseStateVector< std::complex< double > >() ;
+}
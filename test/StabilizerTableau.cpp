@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "qclab/StabilizerTableau.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/Phase90.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/PauliY.hpp"
+#include "qclab/qgates/PauliZ.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CY.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+#include "qclab/qgates/Measurement.hpp"
+#include "qclab/qgates/Reset.hpp"
+#include "qclab/qgates/Conditional.hpp"
+
+template <typename T>
+void test_qclab_StabilizerTableau() {
+
+  using namespace qclab::qgates ;
+
+  // stabilizers
+  {
+    qclab::StabilizerTableau  tableau( 3 ) ;
+    EXPECT_EQ( tableau.nbQubits() , 3 ) ;
+    EXPECT_EQ( tableau.stabilizers() ,
+               std::vector< std::string >( { "+ZII" , "+IZI" , "+IIZ" } ) ) ;
+    EXPECT_FALSE( tableau.isRandom( 0 ) ) ;
+    tableau.h( 0 ) ;
+    tableau.cx( 0 , 1 ) ;
+    tableau.x( 2 ) ;
+    tableau.s( 2 ) ;
+    EXPECT_EQ( tableau.stabilizers() ,
+               std::vector< std::string >( { "+XXI" , "+ZZI" , "-IIZ" } ) ) ;
+    EXPECT_TRUE( tableau.isRandom( 0 ) ) ;
+    EXPECT_TRUE( tableau.isRandom( 1 ) ) ;
+    EXPECT_FALSE( tableau.isRandom( 2 ) ) ;
+    EXPECT_EQ( tableau.measure( 2 , 0.9 ) , 1 ) ;
+    EXPECT_EQ( tableau.measure( 0 , 0.3 ) , 1 ) ;
+    EXPECT_EQ( tableau.measure( 1 , 0.9 ) , 1 ) ;
+    EXPECT_FALSE( tableau.isRandom( 1 ) ) ;
+  }
+
+  // comparison with the dense vector for random Clifford circuits
+  for ( int n = 2; n <= 6; n++ ) {
+    for ( uint64_t seed = 0; seed < 10; seed++ ) {
+      const qclab::Random random( 100 * n + seed ) ;
+      uint64_t counter = 0 ;
+      auto next = [&] ( const int m ) { return random( counter++ ) % m ; } ;
+      qclab::QCircuit< T >  circuit( n ) ;
+      int bits = 0 ;
+      for ( int k = 0; k < 12 * n; k++ ) {
+        const int p = next( n ) ;
+        const int q = ( p + 1 + next( n - 1 ) ) % n ;
+        const int a = std::min( p , q ) ;
+        const int b = std::max( p , q ) ;
+        switch ( next( 14 ) ) {
+          case 0:
+            circuit.push_back( std::make_unique< Hadamard< T > >( p ) ) ;
+            break ;
+          case 1:
+            circuit.push_back( std::make_unique< Phase90< T > >( p ) ) ;
+            break ;
+          case 2:
+            circuit.push_back( std::make_unique< PauliX< T > >( p ) ) ;
+            break ;
+          case 3:
+            circuit.push_back( std::make_unique< PauliY< T > >( p ) ) ;
+            break ;
+          case 4:
+            circuit.push_back( std::make_unique< PauliZ< T > >( p ) ) ;
+            break ;
+          case 5:
+            circuit.push_back( std::make_unique< CNOT< T > >( p , q ,
+                                                              next( 2 ) ) ) ;
+            break ;
+          case 6:
+            circuit.push_back( std::make_unique< CY< T > >( p , q ,
+                                                            next( 2 ) ) ) ;
+            break ;
+          case 7:
+            circuit.push_back( std::make_unique< CZ< T > >( p , q ,
+                                                            next( 2 ) ) ) ;
+            break ;
+          case 8:
+            circuit.push_back( std::make_unique< SWAP< T > >( a , b ) ) ;
+            break ;
+          case 9:
+            circuit.push_back( std::make_unique< iSWAP< T > >( a , b ) ) ;
+            break ;
+          case 10:
+            circuit.push_back( std::make_unique< Measurement< T > >( p ,
+                                                                     bits ) ) ;
+            bits++ ;
+            break ;
+          case 11:
+            circuit.push_back( std::make_unique< Reset< T > >( p ) ) ;
+            break ;
+          case 12: {
+            const std::vector< int > last = { std::max( bits - 1 , 0 ) } ;
+            circuit.push_back( std::make_unique< Conditional< T > >(
+                                 std::make_unique< Hadamard< T > >( p ) ,
+                                 last , 0 ) ) ;
+            break ;
+          }
+          default:
+            circuit.push_back( std::make_unique< Hadamard< T > >( p ) ) ;
+            circuit.push_back( std::make_unique< Phase90< T > >( q ) ) ;
+        }
+      }
+      // measure all qubits in the X and Z basis
+      for ( int q = 0; q < n; q++ ) {
+        circuit.push_back( std::make_unique< Measurement< T > >( q ,
+                                                                 bits++ ) ) ;
+      }
+      for ( int q = 0; q < n; q++ ) {
+        circuit.push_back( std::make_unique< Hadamard< T > >( q ) ) ;
+        circuit.push_back( std::make_unique< Measurement< T > >( q ,
+                                                                 bits++ ) ) ;
+      }
+      EXPECT_TRUE( qclab::isClifford( circuit ) ) ;
+
+      qclab::ClassicalRegister dense( 0 , seed ) ;
+      std::vector< T > v( 1 << n , T(0) ) ;
+      v[0] = 1 ;
+      circuit.simulate( v , dense ) ;
+      qclab::ClassicalRegister creg( 0 , seed ) ;
+      qclab::StabilizerTableau  tableau( n ) ;
+      tableau.simulate( circuit , creg ) ;
+      EXPECT_EQ( creg.bits() , dense.bits() ) ;
+      EXPECT_EQ( creg.counter() , dense.counter() ) ;
+    }
+  }
+
+  // GHZ state on 1000 qubits
+  {
+    const int n = 1000 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    for ( int q = 0; q < n - 1; q++ ) {
+      circuit.push_back( std::make_unique< CNOT< T > >( q , q + 1 ) ) ;
+    }
+    EXPECT_TRUE( qclab::isClifford( circuit ) ) ;
+    const std::vector< int > qubits = { 0 , 63 , 64 , 500 , 999 } ;
+    const auto counts = qclab::sample( circuit , 1000 , qubits , 7 ) ;
+    ASSERT_EQ( counts.size() , 2 ) ;
+    EXPECT_EQ( counts[0].first , 0 ) ;
+    EXPECT_EQ( counts[1].first , 31 ) ;
+    EXPECT_EQ( counts[0].second + counts[1].second , 1000 ) ;
+    EXPECT_GT( counts[0].second , 400 ) ;
+    EXPECT_GT( counts[1].second , 400 ) ;
+    EXPECT_EQ( qclab::sample( circuit , 1000 , qubits , 7 ) , counts ) ;
+  }
+
+  // dynamic circuit: copy of a random bit by a conditional gate
+  {
+    qclab::QCircuit< T >  circuit( 3 ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    circuit.push_back( std::make_unique< Measurement< T > >( 0 , 0 ) ) ;
+    circuit.push_back( std::make_unique< Conditional< T > >(
+                         std::make_unique< PauliX< T > >( 2 ) ,
+                         std::vector< int >( { 0 } ) , 1 ) ) ;
+    circuit.push_back( std::make_unique< Reset< T > >( 0 ) ) ;
+    const auto counts = qclab::sample( circuit , 200 , {} , 3 ) ;
+    ASSERT_EQ( counts.size() , 2 ) ;
+    EXPECT_EQ( counts[0].first , 0 ) ;
+    EXPECT_EQ( counts[1].first , 1 ) ;
+    EXPECT_EQ( counts[0].second + counts[1].second , 200 ) ;
+  }
+
+  // non-Clifford circuits are sampled from the state vector
+  {
+    qclab::QCircuit< T >  circuit( 3 ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    circuit.push_back( std::make_unique< RotationX< T > >( 1 , 0.7 ) ) ;
+    circuit.push_back( std::make_unique< CNOT< T > >( 1 , 2 ) ) ;
+    EXPECT_FALSE( qclab::isClifford( circuit ) ) ;
+    std::vector< T > v( 8 , T(0) ) ;
+    v[0] = 1 ;
+    circuit.simulate( v ) ;
+    EXPECT_EQ( qclab::sample( circuit , 100 , { 2 , 0 } , 5 ) ,
+               qclab::sample( v , 100 , { 2 , 0 } , 5 ) ) ;
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_StabilizerTableau , complex_float ) {
+  test_qclab_StabilizerTableau< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_StabilizerTableau , complex_double ) {
+  test_qclab_StabilizerTableau< std::complex< double > >() ;
+}
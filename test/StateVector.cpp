@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include "qclab/StateVector.hpp"
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/Phase.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/CX.hpp"
+#include "qclab/qgates/CRotationZ.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+
+template <typename T>
+void check_state( const qclab::QObject< T >& object , const int nbQubits ,
+                  const qclab::Layout layout ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  std::vector< T > vec0( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec0.size(); i++ ) {
+    vec0[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+  }
+  for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                    qclab::Op::ConjTrans } ) {
+    auto vec = vec0 ;
+    object.apply( op , nbQubits , vec ) ;
+    qclab::StateVector< T > state( vec0 , layout ) ;
+    object.apply( op , nbQubits , state ) ;
+    for ( int i = 0; i < vec0.size(); i++ ) {
+      EXPECT_NEAR( std::abs( state(i) - vec[i] ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+template <typename T>
+void test_qclab_StateVector() {
+
+  using R = qclab::real_t< T > ;
+
+  for ( auto layout : { qclab::Layout::Interleaved , qclab::Layout::Split } ) {
+
+    // constructor
+    qclab::StateVector< T > state( 3 , layout ) ;
+    EXPECT_EQ( state.nbQubits() , 3 ) ;
+    EXPECT_EQ( state.size() , 8 ) ;
+    EXPECT_TRUE( state.layout() == layout ) ;
+    EXPECT_EQ( state(0) , T(1) ) ;
+    for ( int i = 1; i < 8; i++ ) {
+      EXPECT_EQ( state(i) , T(0) ) ;
+    }
+
+    // alignment
+    if ( layout == qclab::Layout::Interleaved ) {
+      const auto ptr = reinterpret_cast< std::uintptr_t >( state.data() ) ;
+      EXPECT_EQ( ptr % qclab::StateVector< T >::alignment , 0 ) ;
+    } else {
+      const auto re = reinterpret_cast< std::uintptr_t >( state.real() ) ;
+      const auto im = reinterpret_cast< std::uintptr_t >( state.imag() ) ;
+      EXPECT_EQ( re % qclab::StateVector< T >::alignment , 0 ) ;
+      EXPECT_EQ( im % qclab::StateVector< T >::alignment , 0 ) ;
+    }
+
+    // set
+    state.set( 5 , T(2,-3) ) ;
+    EXPECT_EQ( state(5) , T(2,-3) ) ;
+    if ( layout == qclab::Layout::Split ) {
+      EXPECT_EQ( state.real()[5] , R(2) ) ;
+      EXPECT_EQ( state.imag()[5] , R(-3) ) ;
+    }
+
+    // vector
+    std::vector< T > vec = { T(1) , T(0) , T(0) , T(0) ,
+                             T(0) , T(2,-3) , T(0) , T(0) } ;
+    EXPECT_TRUE( state.vector() == vec ) ;
+
+    // copy
+    qclab::StateVector< T > copy( state ) ;
+    copy.set( 5 , T(0) ) ;
+    EXPECT_EQ( state(5) , T(2,-3) ) ;
+    EXPECT_EQ( copy(5) , T(0) ) ;
+    copy = state ;
+    EXPECT_EQ( copy(5) , T(2,-3) ) ;
+
+    // setLayout
+    state.setLayout( qclab::Layout::Split ) ;
+    EXPECT_TRUE( state.layout() == qclab::Layout::Split ) ;
+    EXPECT_TRUE( state.vector() == vec ) ;
+    state.setLayout( qclab::Layout::Interleaved ) ;
+    EXPECT_TRUE( state.layout() == qclab::Layout::Interleaved ) ;
+    EXPECT_TRUE( state.vector() == vec ) ;
+
+    // gates
+    const int n = 6 ;
+    qclab::dense::SquareMatrix< T > mat1( T(1,2) , T(3,-1) ,
+                                          T(0.5,0) , T(2,1) ) ;
+    qclab::dense::SquareMatrix< T > mat2( 4 ) , mat3( 8 ) ;
+    for ( int j = 0; j < 4; j++ ) {
+      for ( int i = 0; i < 4; i++ ) {
+        mat2(i,j) = T( std::cos( i + 3*j ) , std::sin( 2*i + j ) ) ;
+      }
+    }
+    for ( int j = 0; j < 8; j++ ) {
+      for ( int i = 0; i < 8; i++ ) {
+        mat3(i,j) = T( std::cos( i + 2*j ) , std::sin( 3*i - j ) ) ;
+      }
+    }
+    for ( int q = 0; q < n; q++ ) {
+      check_state( qclab::qgates::Hadamard< T >( q ) , n , layout ) ;
+      check_state( qclab::qgates::RotationX< T >( q , R(0.3) ) , n , layout ) ;
+      check_state( qclab::qgates::RotationZ< T >( q , R(1.1) ) , n , layout ) ;
+      check_state( qclab::qgates::Phase< T >( q , R(-0.4) ) , n , layout ) ;
+      check_state( qclab::qgates::MatrixGate1< T >( q , mat1 ) , n , layout ) ;
+      for ( int q1 = q + 1; q1 < n; q1++ ) {
+        check_state( qclab::qgates::MatrixGateN< T >( { q , q1 } , mat2 ) ,
+                     n , layout ) ;
+        check_state( qclab::qgates::CX< T >( q1 , q ) , n , layout ) ;
+        check_state( qclab::qgates::CRotationZ< T >( q , q1 , R(0.7) ) ,
+                     n , layout ) ;
+        check_state( qclab::qgates::CX< T >( q , q1 , 0 ) , n , layout ) ;
+        check_state( qclab::qgates::CRotationY< T >( q1 , q , R(0.4) , 0 ) ,
+                     n , layout ) ;
+        check_state( qclab::qgates::iSWAP< T >( q , q1 ) , n , layout ) ;
+        if ( q1 < n - 1 ) {
+          check_state( qclab::qgates::MatrixGateN< T >( { q , q1 , n - 1 } ,
+                                                        mat3 ) , n , layout ) ;
+        }
+      }
+      if ( q < n - 1 ) {
+        const int qubits[] = { q , q + 1 } ;
+        check_state( qclab::qgates::RotationXX< T >( qubits , R(0.2) ) ,
+                     n , layout ) ;
+      }
+    }
+
+    // gates applied directly, without a QObject reference
+    {
+      const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+      const qclab::qgates::Hadamard< T > h( 0 ) ;
+      const qclab::qgates::CX< T > cx( 0 , 1 ) ;
+      qclab::StateVector< T > sv( 2 , layout ) ;
+      h.apply( qclab::Op::NoTrans , 2 , sv ) ;
+      cx.apply( qclab::Op::NoTrans , 2 , sv ) ;
+      EXPECT_NEAR( std::abs( sv(0) - T( std::sqrt( R(0.5) ) ) ) , 0 , tol ) ;
+      EXPECT_NEAR( std::abs( sv(3) - T( std::sqrt( R(0.5) ) ) ) , 0 , tol ) ;
+    }
+
+    // circuit
+    using H  = qclab::qgates::Hadamard< T > ;
+    using RX = qclab::qgates::RotationX< T > ;
+    using RZ = qclab::qgates::RotationZ< T > ;
+    using CX = qclab::qgates::CX< T > ;
+    qclab::QCircuit< T > circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< H >( q ) ) ;
+      circuit.push_back( std::make_unique< RZ >( q , R(0.1 * q) ) ) ;
+    }
+    for ( int q = 0; q < n - 1; q++ ) {
+      circuit.push_back( std::make_unique< CX >( q , q + 1 ) ) ;
+      circuit.push_back( std::make_unique< RX >( q + 1 , R(0.2) ) ) ;
+    }
+    check_state( circuit , n , layout ) ;
+
+    // simulate
+    const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+    std::vector< T > vec0( 1 << n ) ;
+    vec0[0] = 1 ;
+    circuit.simulate( vec0 ) ;
+    for ( int level = 0; level < 3; level++ ) {
+      qclab::sim::Options options ;
+      options.fuse1 = ( level >= 1 ) ;
+      options.fuseK = ( level >= 2 ) ? 3 : 0 ;
+      qclab::StateVector< T > sv( n , layout ) ;
+      circuit.simulate( sv , options ) ;
+      for ( int i = 0; i < vec0.size(); i++ ) {
+        EXPECT_NEAR( std::abs( sv(i) - vec0[i] ) , 0 , tol ) ;
+      }
+    }
+    qclab::StateVector< T > sv( n , layout ) ;
+    circuit.simulate( sv ) ;
+    for ( int i = 0; i < vec0.size(); i++ ) {
+      EXPECT_NEAR( std::abs( sv(i) - vec0[i] ) , 0 , tol ) ;
+    }
+
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_StateVector , complex_float ) {
+  test_qclab_StateVector< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_StateVector , complex_double ) {
+  test_qclab_StateVector< std::complex< double > >() ;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/PauliY.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+#include "qclab/qgates/MCX.hpp"
+#include <algorithm>
+
+/**
+ * Returns a circuit on `n` qubits with gates on all pairs of qubits, which
+ * exercises every combination of high and low, or global and local, qubits
+ * of the simulators. If `toffoli` is true, every qubit is also the first
+ * control of a Toffoli gate.
+ */
+template <typename T>
+qclab::QCircuit< T > mixed( const int n , const bool toffoli = false ) {
+  using namespace qclab::qgates ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int q = 0; q < n; q++ ) {
+    circuit.push_back( std::make_unique< RotationY< T > >( q , 0.3 + q ) ) ;
+  }
+  for ( int p = 0; p < n; p++ ) {
+    for ( int q = 0; q < n; q++ ) {
+      if ( p == q ) continue ;
+      circuit.push_back( std::make_unique< CNOT< T > >( p , q , p % 2 ) ) ;
+      circuit.push_back( std::make_unique< RotationX< T > >( q , 0.1 * p ) ) ;
+      if ( p < q ) {
+        circuit.push_back( std::make_unique< CZ< T > >( p , q ) ) ;
+        circuit.push_back( std::make_unique< CRotationY< T > >( q , p ,
+                                                                0.2 ) ) ;
+        circuit.push_back( std::make_unique< RotationZZ< T > >( p , q ,
+                                                                0.2 * q ) ) ;
+        circuit.push_back( std::make_unique< CPhase< T > >( q , p , 0.7 ) ) ;
+        circuit.push_back( std::make_unique< iSWAP< T > >( p , q ) ) ;
+      }
+    }
+    if ( 2 * p + 1 != n ) {
+      circuit.push_back( std::make_unique< SWAP< T > >( p , n - p - 1 ) ) ;
+    }
+    circuit.push_back( std::make_unique< PauliY< T > >( p ) ) ;
+    if ( toffoli && ( n >= 3 ) ) {
+      std::vector< int > controls = { p , ( p + 1 ) % n } ;
+      std::sort( controls.begin() , controls.end() ) ;
+      circuit.push_back( std::make_unique< MCX< T > >( controls ,
+                                                       ( p + 2 ) % n ) ) ;
+    }
+  }
+  return circuit ;
+}
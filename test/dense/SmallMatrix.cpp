@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "qclab/dense/SmallMatrix.hpp"
+#include "qclab/dense/transpose.hpp"
+#include <complex>
+
+template <typename T>
+void test_qclab_dense_SmallMatrix() {
+
+  using M2 = qclab::dense::SmallMatrix< T , 2 > ;
+  using M4 = qclab::dense::SmallMatrix< T , 4 > ;
+  using SM = qclab::dense::SquareMatrix< T > ;
+
+  // default constructor
+  M2  Z ;
+  EXPECT_EQ( Z.size() , 2 ) ;
+  EXPECT_EQ( Z.rows() , 2 ) ;
+  EXPECT_EQ( Z.cols() , 2 ) ;
+  EXPECT_EQ( Z.ld() , 2 ) ;
+  for ( int i = 0; i < 2; i++ ) {
+    for ( int j = 0; j < 2; j++ ) {
+      EXPECT_EQ( Z(i,j) , T(0) ) ;
+    }
+  }
+
+  // 2x2
+  M2  A( 1.0 , 2.0 ,
+         3.0 , 4.0 ) ;
+  EXPECT_EQ( A(0,0) , T(1.0) ) ;
+  EXPECT_EQ( A(1,0) , T(3.0) ) ;
+  EXPECT_EQ( A(0,1) , T(2.0) ) ;
+  EXPECT_EQ( A(1,1) , T(4.0) ) ;
+  EXPECT_EQ( A.ptr()[1] , T(3.0) ) ;  // column-major
+
+  // 4x4
+  M4  B(  1.0 ,  2.0 ,  3.0 ,  4.0 ,
+          5.0 ,  6.0 ,  7.0 ,  8.0 ,
+          9.0 , 10.0 , 11.0 , 12.0 ,
+         13.0 , 14.0 , 15.0 , 16.0 ) ;
+  EXPECT_EQ( B.size() , 4 ) ;
+  for ( int i = 0; i < 4; i++ ) {
+    for ( int j = 0; j < 4; j++ ) {
+      EXPECT_EQ( B(i,j) , T( 4*i + j + 1 ) ) ;
+    }
+  }
+
+  // conversions from and to square matrices
+  const SM S( 1.0 , 2.0 ,
+              3.0 , 4.0 ) ;
+  EXPECT_TRUE( M2( S ) == A ) ;
+  EXPECT_TRUE( SM( A ) == S ) ;
+
+  // operators == and !=
+  M2  C = A ;
+  EXPECT_TRUE( C == A ) ;
+  C(1,0) = 5.0 ;
+  EXPECT_TRUE( C != A ) ;
+
+  // operate: same result as for square matrices
+  const SM SB( B ) ;
+  for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                    qclab::Op::ConjTrans } ) {
+    EXPECT_TRUE( SM( qclab::dense::operate( op , B ) ) ==
+                 qclab::dense::operate( op , SB ) ) ;
+  }
+
+}
+
+/*
+ * float
+ */
+TEST( qclab_dense_SmallMatrix , float ) {
+  test_qclab_dense_SmallMatrix< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_dense_SmallMatrix , double ) {
+  test_qclab_dense_SmallMatrix< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_dense_SmallMatrix , complex_float ) {
+  test_qclab_dense_SmallMatrix< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_dense_SmallMatrix , complex_double ) {
+  test_qclab_dense_SmallMatrix< std::complex< double > >() ;
+}
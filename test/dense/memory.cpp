@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "qclab/dense/memory.hpp"
+#include "qclab/util.hpp"
 #include <complex>
 
 template <typename T>
@@ -48,6 +49,15 @@ void test_qclab_dense_memory() {
     EXPECT_EQ( init10[i] , T(3.14) ) ;
   }
 
+  // alloc_aligned_array
+  using R = qclab::real_t< T > ;
+  auto aligned = qclab::dense::alloc_aligned_array< R >( 10 , 64 ) ;
+  EXPECT_EQ( reinterpret_cast< std::uintptr_t >( aligned.get() ) % 64 , 0 ) ;
+  for ( int64_t i = 0; i < 10; i++ ) {
+    aligned[i] = R(i) ;
+    EXPECT_EQ( aligned[i] , R(i) ) ;
+  }
+
 }
 
 
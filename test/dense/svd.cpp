@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "qclab/dense/svd.hpp"
+#include <complex>
+
+template <typename T>
+void check_qclab_dense_svd( const int64_t m , const int64_t n ,
+                            const std::vector< T >& A ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+  auto conj = [] ( const T& x ) {
+    if constexpr ( qclab::is_complex_v< T > ) {
+      return std::conj( x ) ;
+    } else {
+      return x ;
+    }
+  } ;
+
+  std::vector< T > U , Vh ;
+  std::vector< R > S ;
+  qclab::dense::svd( m , n , A , U , S , Vh ) ;
+  const int64_t k = std::min( m , n ) ;
+  ASSERT_EQ( U.size() , m * k ) ;
+  ASSERT_EQ( S.size() , k ) ;
+  ASSERT_EQ( Vh.size() , k * n ) ;
+
+  // decreasing singular values
+  R norm = 0 ;
+  for ( const T& a : A ) norm += std::norm( a ) ;
+  norm = std::sqrt( norm ) ;
+  for ( int64_t l = 1; l < k; l++ ) EXPECT_GE( S[l-1] , S[l] ) ;
+
+  // A = U S Vh
+  for ( int64_t i = 0; i < m; i++ ) {
+    for ( int64_t j = 0; j < n; j++ ) {
+      T sum = 0 ;
+      for ( int64_t l = 0; l < k; l++ ) {
+        sum += U[ i * k + l ] * S[l] * Vh[ l * n + j ] ;
+      }
+      EXPECT_NEAR( std::abs( sum - A[ i * n + j ] ) , 0 , tol * norm ) ;
+    }
+  }
+
+  // orthonormal singular vectors of nonzero singular values
+  for ( int64_t p = 0; p < k; p++ ) {
+    for ( int64_t q = 0; q < k; q++ ) {
+      if ( S[p] <= tol * norm || S[q] <= tol * norm ) continue ;
+      T u = 0 ;
+      for ( int64_t i = 0; i < m; i++ ) u += conj( U[ i * k + p ] ) *
+                                              U[ i * k + q ] ;
+      T v = 0 ;
+      for ( int64_t j = 0; j < n; j++ ) v += Vh[ p * n + j ] *
+                                              conj( Vh[ q * n + j ] ) ;
+      EXPECT_NEAR( std::abs( u - T( p == q ) ) , 0 , tol ) ;
+      EXPECT_NEAR( std::abs( v - T( p == q ) ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+template <typename T>
+void test_qclab_dense_svd() {
+
+  // diagonal matrix
+  {
+    std::vector< T > U , Vh ;
+    std::vector< qclab::real_t< T > > S ;
+    qclab::dense::svd( 3 , 3 , std::vector< T >( { 1 , 0 , 0 ,
+                                                   0 , 3 , 0 ,
+                                                   0 , 0 , 2 } ) ,
+                       U , S , Vh ) ;
+    EXPECT_EQ( S , std::vector< qclab::real_t< T > >( { 3 , 2 , 1 } ) ) ;
+  }
+
+  // tall, wide and square matrices
+  for ( const auto& [ m , n ] : std::vector< std::pair< int , int > >(
+          { { 1 , 1 } , { 1 , 4 } , { 4 , 1 } , { 5 , 3 } , { 3 , 5 } ,
+            { 8 , 8 } , { 9 , 7 } , { 16 , 32 } } ) ) {
+    std::vector< T > A( m * n ) ;
+    for ( int64_t i = 0; i < A.size(); i++ ) {
+      if constexpr ( qclab::is_complex_v< T > ) {
+        A[i] = T( std::cos( 0.7 * i * i ) , std::sin( 1.3 * i + 0.2 ) ) ;
+      } else {
+        A[i] = std::cos( 0.7 * i * i ) ;
+      }
+    }
+    check_qclab_dense_svd( m , n , A ) ;
+
+    // rank 1
+    for ( int64_t i = 0; i < m; i++ ) {
+      for ( int64_t j = 0; j < n; j++ ) A[ i * n + j ] = T( i + 1 ) * A[j] ;
+    }
+    check_qclab_dense_svd( m , n , A ) ;
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_dense_svd , float ) {
+  test_qclab_dense_svd< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_dense_svd , double ) {
+  test_qclab_dense_svd< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_dense_svd , complex_float ) {
+  test_qclab_dense_svd< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_dense_svd , complex_double ) {
+  test_qclab_dense_svd< std::complex< double > >() ;
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "qclab/mpi/DistributedStateVector.hpp"
+#include "circuits.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/MCX.hpp"
+
+/// Returns the quantum Fourier transform on `n` qubits.
+template <typename T>
+qclab::QCircuit< T > qft( const int n ) {
+  using R = qclab::real_t< T > ;
+  const R pi = 4 * std::atan(1) ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< qclab::qgates::Hadamard< T > >( i ) ) ;
+    for ( int j = 2; j <= n - i; j++ ) {
+      circuit.push_back( std::make_unique< qclab::qgates::CPhase< T > >(
+                           j + i - 1 , i , -2 * pi / ( 1 << j ) ) ) ;
+    }
+  }
+  for ( int i = 0; i < n/2; i++ ) {
+    circuit.push_back( std::make_unique< qclab::qgates::SWAP< T > >(
+                         i , n - i - 1 ) ) ;
+  }
+  return circuit ;
+}
+
+template <typename T>
+void check_qclab_mpi_DistributedStateVector(
+                                  const qclab::QCircuit< T >& circuit ,
+                                  const qclab::sim::Options& options ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 1000 * std::numeric_limits< R >::epsilon() ;
+  const int n = circuit.nbQubits() ;
+
+  // initial vector
+  std::vector< T > v0( 1 << n ) ;
+  for ( int i = 0; i < v0.size(); i++ ) {
+    v0[i] = T( std::cos( 0.7 * i ) , std::sin( 1.3 * i ) ) ;
+  }
+  R nrm = 0 ;
+  for ( const auto& x : v0 ) nrm += std::norm( x ) ;
+  for ( auto& x : v0 ) x /= std::sqrt( nrm ) ;
+
+  // distributed
+  qclab::mpi::DistributedStateVector< T >  psi( n ) ;
+  psi.scatter( v0 ) ;
+  psi.simulate( circuit , options ) ;
+  EXPECT_NEAR( psi.norm2() , 1 , tol ) ;
+  std::vector< T > v ;
+  psi.gather( v ) ;
+
+  // reference
+  if ( psi.rank() == 0 ) {
+    auto w = v0 ;
+    circuit.simulate( w ) ;
+    EXPECT_EQ( v.size() , w.size() ) ;
+    for ( int i = 0; i < w.size(); i++ ) {
+      EXPECT_NEAR( std::abs( v[i] - w[i] ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+template <typename T>
+void test_qclab_mpi_DistributedStateVector() {
+
+  int nbRanks ;
+  MPI_Comm_size( MPI_COMM_WORLD , &nbRanks ) ;
+
+  // all zero state
+  {
+    qclab::mpi::DistributedStateVector< T >  psi( 4 ) ;
+    EXPECT_EQ( psi.nbQubits() , 4 ) ;
+    EXPECT_EQ( 1 << psi.nbGlobalQubits() , nbRanks ) ;
+    EXPECT_EQ( psi.nbLocalQubits() , 4 - psi.nbGlobalQubits() ) ;
+    EXPECT_EQ( psi.local().size() , 1 << psi.nbLocalQubits() ) ;
+    EXPECT_EQ( psi.local()[0] , T( psi.rank() == 0 ? 1 : 0 ) ) ;
+    EXPECT_EQ( psi.norm2() , 1 ) ;
+  }
+
+  // QFT: only the Hadamard gates on global qubits need exchanges, at most
+  // twice per global qubit
+  for ( int n = 4; n <= 9; n++ ) {
+    const auto circuit = qft< T >( n ) ;
+    qclab::mpi::DistributedStateVector< T >  psi( n ) ;
+    psi.simulate( circuit ) ;
+    const int g = psi.nbGlobalQubits() ;
+    EXPECT_LE( psi.timings().nbExchanges , 2 * g ) ;
+    if ( g > 0 ) EXPECT_GT( psi.timings().bytes , 0 ) ;
+    psi.resetTimings() ;
+    EXPECT_EQ( psi.timings().nbExchanges , 0 ) ;
+    check_qclab_mpi_DistributedStateVector( circuit ,
+                                            qclab::sim::Options() ) ;
+  }
+
+  // gates on all pairs of qubits, with fusion and blocking
+  for ( int n = 4; n <= 7; n++ ) {
+    const auto circuit = mixed< T >( n ) ;
+    qclab::sim::Options options ;
+    check_qclab_mpi_DistributedStateVector( circuit , options ) ;
+    options.fuseDiagonal = true ;
+    options.fuse1 = true ;
+    check_qclab_mpi_DistributedStateVector( circuit , options ) ;
+    options.fuseK = 3 ;
+    options.blockQubits = 2 ;
+    check_qclab_mpi_DistributedStateVector( circuit , options ) ;
+  }
+
+  // wide multi-controlled gate after the qubits are permuted, with and
+  // without monomial fusion
+  {
+    using namespace qclab::qgates ;
+    const int n = 10 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< RotationY< T > >( q , 0.3 + q ) ) ;
+    }
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< CNOT< T > >( q , ( q + 3 ) % n ) ) ;
+    }
+    circuit.push_back( std::make_unique< SWAP< T > >( 1 , 8 ) ) ;
+    circuit.push_back( std::make_unique< MCX< T > >(
+                         std::vector< int >( { 0 , 1 , 2 , 3 , 4 , 5 , 6 } ) ,
+                         8 ) ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< RotationX< T > >( q , 0.1 * q ) ) ;
+    }
+    qclab::sim::Options options ;
+    check_qclab_mpi_DistributedStateVector( circuit , options ) ;
+    options.fuseMonomial = true ;
+    check_qclab_mpi_DistributedStateVector( circuit , options ) ;
+  }
+
+  // large messages
+  {
+    const int n = 21 + ( nbRanks > 1 ) ;
+    qclab::mpi::DistributedStateVector< T >  psi( n ) ;
+    using H = qclab::qgates::Hadamard< T > ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< H >( q ) ) ;
+    }
+    psi.simulate( circuit ) ;
+    for ( int q = n - 1; q >= 0; q-- ) {
+      circuit.push_back( std::make_unique< H >( q ) ) ;
+    }
+    psi.simulate( circuit ) ;
+    psi.unpermute() ;
+    using R = qclab::real_t< T > ;
+    const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+    const R amplitude = std::pow( R(2) , -R(n) / 2 ) ;
+    for ( const auto& x : psi.local() ) {
+      if ( std::abs( x - amplitude ) > tol ) {
+        EXPECT_NEAR( std::abs( x - amplitude ) , 0 , tol ) ;
+        break ;
+      }
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_mpi_DistributedStateVector , complex_float ) {
+  test_qclab_mpi_DistributedStateVector< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_mpi_DistributedStateVector , complex_double ) {
+  test_qclab_mpi_DistributedStateVector< std::complex< double > >() ;
+}
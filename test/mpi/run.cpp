@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include <mpi.h>
+
+int main( int argc , char **argv ) {
+
+  int provided ;
+  MPI_Init_thread( &argc , &argv , MPI_THREAD_FUNNELED , &provided ) ;
+  int rank ;
+  MPI_Comm_rank( MPI_COMM_WORLD , &rank ) ;
+
+  // only rank 0 prints the results
+  ::testing::InitGoogleTest( &argc , argv ) ;
+  if ( rank != 0 ) {
+    auto& listeners = ::testing::UnitTest::GetInstance()->listeners() ;
+    delete listeners.Release( listeners.default_result_printer() ) ;
+  }
+  int result = RUN_ALL_TESTS() ;
+
+  // fail if any rank fails
+  int failed ;
+  MPI_Allreduce( &result , &failed , 1 , MPI_INT , MPI_MAX , MPI_COMM_WORLD ) ;
+  MPI_Finalize() ;
+  return failed ;
+
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "qclab/noise/Channel.hpp"
+#include "qclab/noise/NoisyMeasurement.hpp"
+
+template <typename T>
+void test_qclab_noise_Channel() {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  // depolarizing
+  {
+    const auto channel = qclab::noise::depolarizing< T >( 1 , 0.3 ) ;
+
+    EXPECT_EQ( channel.nbQubits() , 1 ) ;   // nbQubits
+    EXPECT_TRUE( channel.fixed() ) ;        // fixed
+    EXPECT_FALSE( channel.controlled() ) ;  // controlled
+    EXPECT_TRUE( channel.dynamic() ) ;      // dynamic
+    EXPECT_EQ( channel.qubit() , 1 ) ;      // qubit
+    EXPECT_EQ( channel.kraus().size() , 4 ) ;
+
+    // no matrix and no apply without a classical register
+    std::vector< T > v( 4 ) ;
+    auto mat = qclab::dense::eye< T >( 4 ) ;
+    EXPECT_THROW( channel.matrix() , std::logic_error ) ;
+    EXPECT_THROW( channel.apply( qclab::Op::NoTrans , 2 , v ) ,
+                  std::logic_error ) ;
+    EXPECT_THROW( channel.apply( qclab::Side::Left , qclab::Op::NoTrans , 2 ,
+                                 mat ) , std::logic_error ) ;
+
+    // mixture of unitaries
+    EXPECT_TRUE( channel.mixedUnitary() ) ;
+    const auto& p = channel.probabilities() ;
+    ASSERT_EQ( p.size() , 4 ) ;
+    EXPECT_NEAR( p[0] , 0.7 , tol ) ;
+    for ( int k = 1; k < 4; k++ ) EXPECT_NEAR( p[k] , 0.1 , tol ) ;
+
+    // print
+    channel.print() ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_NE( channel.toQASM( qasm ) , 0 ) ;
+
+    // operators == and !=
+    EXPECT_TRUE( channel == qclab::noise::depolarizing< T >( 1 , 0.3 ) ) ;
+    EXPECT_TRUE( channel != qclab::noise::depolarizing< T >( 0 , 0.3 ) ) ;
+    EXPECT_TRUE( channel != qclab::noise::depolarizing< T >( 1 , 0.2 ) ) ;
+  }
+
+  // mixtures of unitaries
+  EXPECT_TRUE( qclab::noise::bitFlip< T >( 0 , 0.1 ).mixedUnitary() ) ;
+  EXPECT_TRUE( qclab::noise::phaseFlip< T >( 0 , 0.1 ).mixedUnitary() ) ;
+  EXPECT_FALSE( qclab::noise::amplitudeDamping< T >( 0 , 0.1 ).mixedUnitary() );
+  EXPECT_FALSE( qclab::noise::phaseDamping< T >( 0 , 0.1 ).mixedUnitary() ) ;
+
+  // amplitude damping of a superposition
+  {
+    const double gamma = 0.4 ;
+    const auto channel = qclab::noise::amplitudeDamping< T >( 0 , gamma ) ;
+    const int n = 2 ;
+    const R a = 0.6 ;
+    const R b = 0.8 ;
+    std::vector< T > v0 = { a / std::sqrt( R(2) ) , a / std::sqrt( R(2) ) ,
+                            b / std::sqrt( R(2) ) , b / std::sqrt( R(2) ) } ;
+    int decays = 0 ;
+    const int nbSeeds = 2000 ;
+    for ( int seed = 0; seed < nbSeeds; seed++ ) {
+      auto v = v0 ;
+      qclab::ClassicalRegister creg( 0 , seed ) ;
+      channel.apply( n , v , creg ) ;
+      EXPECT_EQ( creg.counter() , 1 ) ;
+      R nrm = 0 ;
+      for ( const auto& x : v ) nrm += std::norm( x ) ;
+      EXPECT_NEAR( nrm , 1 , tol ) ;
+      // same seed, same Kraus operator
+      auto w = v0 ;
+      qclab::ClassicalRegister creg2( 0 , seed ) ;
+      const int k = qclab::noise::applyKraus( n , 0 , w , creg2 ,
+                                              channel.kraus() , {} ) ;
+      EXPECT_EQ( w , v ) ;
+      if ( k == 1 ) {
+        // decayed to |0>
+        decays++ ;
+        EXPECT_NEAR( std::abs( v[0] - v0[2] / b ) , 0 , tol ) ;
+        EXPECT_NEAR( std::abs( v[1] - v0[3] / b ) , 0 , tol ) ;
+        EXPECT_EQ( v[2] , T(0) ) ;
+        EXPECT_EQ( v[3] , T(0) ) ;
+      } else {
+        const R scale = 1 / std::sqrt( 1 - gamma * b * b ) ;
+        const R c = std::sqrt( 1 - gamma ) ;
+        EXPECT_NEAR( std::abs( v[0] - scale * v0[0] ) , 0 , tol ) ;
+        EXPECT_NEAR( std::abs( v[2] - scale * c * v0[2] ) , 0 , tol ) ;
+      }
+    }
+    const double p = gamma * b * b ;
+    const double sigma = std::sqrt( nbSeeds * p * ( 1 - p ) ) ;
+    EXPECT_NEAR( decays , p * nbSeeds , 5 * sigma ) ;
+  }
+
+  // bit flip with offset
+  {
+    const auto channel = qclab::noise::bitFlip< T >( 0 , 0.25 ) ;
+    const std::vector< T > v0 = { 1 , 2 , 3 , 4 } ;
+    const std::vector< T > flipped = { 2 , 1 , 4 , 3 } ;
+    int flips = 0 ;
+    const int nbSeeds = 2000 ;
+    for ( int seed = 0; seed < nbSeeds; seed++ ) {
+      auto v = v0 ;
+      qclab::ClassicalRegister creg( 0 , seed ) ;
+      channel.apply( 2 , v , creg , 1 ) ;
+      EXPECT_EQ( creg.counter() , 1 ) ;
+      if ( v == flipped ) {
+        flips++ ;
+      } else {
+        EXPECT_EQ( v , v0 ) ;
+      }
+    }
+    const double sigma = std::sqrt( nbSeeds * 0.25 * 0.75 ) ;
+    EXPECT_NEAR( flips , 0.25 * nbSeeds , 5 * sigma ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_noise_NoisyMeasurement() {
+
+  qclab::noise::NoisyMeasurement< T >  M( 0 , 1 , 0.2 , 0 ) ;
+
+  EXPECT_TRUE( M.dynamic() ) ;   // dynamic
+  EXPECT_EQ( M.qubit() , 0 ) ;   // qubit
+  EXPECT_EQ( M.bit() , 1 ) ;     // bit
+  EXPECT_EQ( M.p01() , 0.2 ) ;   // p01
+  EXPECT_EQ( M.p10() , 0 ) ;     // p10
+
+  // print
+  M.print() ;
+
+  // operators == and !=
+  EXPECT_TRUE( M == qclab::noise::NoisyMeasurement< T >( 0 , 1 , 0.2 , 0 ) ) ;
+  EXPECT_TRUE( M != qclab::noise::NoisyMeasurement< T >( 0 , 1 , 0.1 , 0 ) ) ;
+
+  // apply to |0>
+  int ones = 0 ;
+  const int nbSeeds = 2000 ;
+  for ( int seed = 0; seed < nbSeeds; seed++ ) {
+    std::vector< T > v = { 1 , 0 } ;
+    qclab::ClassicalRegister creg( 0 , seed ) ;
+    M.apply( 1 , v , creg ) ;
+    EXPECT_EQ( creg.counter() , 2 ) ;
+    EXPECT_EQ( v , std::vector< T >( { 1 , 0 } ) ) ;
+    ones += creg[1] ;
+  }
+  const double sigma = std::sqrt( nbSeeds * 0.2 * 0.8 ) ;
+  EXPECT_NEAR( ones , 0.2 * nbSeeds , 5 * sigma ) ;
+
+  // apply to |1> without readout error from 1 to 0
+  for ( int seed = 0; seed < 20; seed++ ) {
+    std::vector< T > v = { 0 , 1 } ;
+    qclab::ClassicalRegister creg( 0 , seed ) ;
+    M.apply( 1 , v , creg ) ;
+    EXPECT_EQ( creg[1] , 1 ) ;
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_noise_Channel , float ) {
+  test_qclab_noise_Channel< float >() ;
+  test_qclab_noise_NoisyMeasurement< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_noise_Channel , double ) {
+  test_qclab_noise_Channel< double >() ;
+  test_qclab_noise_NoisyMeasurement< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_noise_Channel , complex_float ) {
+  test_qclab_noise_Channel< std::complex< float > >() ;
+  test_qclab_noise_NoisyMeasurement< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_noise_Channel , complex_double ) {
+  test_qclab_noise_Channel< std::complex< double > >() ;
+  test_qclab_noise_NoisyMeasurement< std::complex< double > >() ;
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "qclab/noise/Trajectories.hpp"
+#include "qclab/PauliSum.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/Measurement.hpp"
+
+template <typename T>
+void test_qclab_noise_Trajectories() {
+
+  using namespace qclab::qgates ;
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  // noise model
+  {
+    qclab::QCircuit< T >  circuit( 3 ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    circuit.push_back( std::make_unique< CNOT< T > >( 0 , 1 ) ) ;
+    circuit.push_back( std::make_unique< PauliX< T > >( 2 ) ) ;
+    circuit.push_back( std::make_unique< Measurement< T > >( 2 , 0 ) ) ;
+
+    qclab::noise::NoiseModel< T >  model ;
+    model.add( qclab::noise::depolarizing< T >( 0 , 0.01 ) ) ;
+    model.template add< CNOT< T > >(
+                          qclab::noise::amplitudeDamping< T >( 0 , 0.1 ) ) ;
+    model.add( 2 , qclab::noise::phaseFlip< T >( 0 , 0.1 ) ) ;
+    model.setReadoutError( 0.1 , 0.2 ) ;
+    EXPECT_EQ( model.nbChannels() , 3 ) ;
+
+    qclab::noise::Trajectories< T >  trajectories( circuit , model ) ;
+    EXPECT_EQ( trajectories.nbQubits() , 3 ) ;
+    const auto& schedule = trajectories.schedule() ;
+    // H, dep(0), CNOT, dep(0), dep(1), amp(0), amp(1), X, dep(2), phase(2),
+    // noisy measurement
+    ASSERT_EQ( schedule.size() , 11 ) ;
+    using C = qclab::noise::Channel< T > ;
+    EXPECT_TRUE( *schedule[1].object ==
+                 qclab::noise::depolarizing< T >( 0 , 0.01 ) ) ;
+    EXPECT_TRUE( *schedule[4].object ==
+                 qclab::noise::depolarizing< T >( 1 , 0.01 ) ) ;
+    EXPECT_TRUE( *schedule[6].object ==
+                 qclab::noise::amplitudeDamping< T >( 1 , 0.1 ) ) ;
+    EXPECT_TRUE( *schedule[9].object ==
+                 qclab::noise::phaseFlip< T >( 2 , 0.1 ) ) ;
+    EXPECT_TRUE( *schedule[10].object ==
+                 qclab::noise::NoisyMeasurement< T >( 2 , 0 , 0.1 , 0.2 ) ) ;
+    EXPECT_TRUE( dynamic_cast< const C* >( schedule[7].object ) == nullptr ) ;
+  }
+
+  // amplitude damping: <Z> = 2 gamma - 1 after X
+  {
+    const double gamma = 0.3 ;
+    qclab::QCircuit< T >  circuit( 2 ) ;
+    circuit.push_back( std::make_unique< PauliX< T > >( 0 ) ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 1 ) ) ;
+    qclab::noise::NoiseModel< T >  model ;
+    model.template add< PauliX< T > >(
+                          qclab::noise::amplitudeDamping< T >( 0 , gamma ) ) ;
+    qclab::noise::Trajectories< T >  trajectories( circuit , model ) ;
+    EXPECT_EQ( trajectories.schedule().size() , 3 ) ;
+
+    std::vector< T > v0( 4 , T(0) ) ;
+    v0[0] = 1 ;
+    qclab::PauliSum< T >  Z( 2 ) ;
+    Z.add( 1 , "ZI" ) ;
+    const int nbTrajectories = 4000 ;
+    const R z = trajectories.expectation( v0 , Z , nbTrajectories , 7 ) ;
+    const double sigma = 2 * std::sqrt( gamma * ( 1 - gamma ) /
+                                        nbTrajectories ) ;
+    EXPECT_NEAR( z , 2 * gamma - 1 , 5 * sigma ) ;
+    R error ;
+    EXPECT_NEAR( trajectories.expectation( v0 , Z , nbTrajectories , 7 ,
+                                           error ) , z , 1e-5 ) ;
+    EXPECT_NEAR( error , sigma , 0.1 * sigma ) ;
+
+    // identical for every number of threads
+  #ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads() ;
+    for ( int t = 1; t <= 4; t++ ) {
+      omp_set_num_threads( t ) ;
+      R errort ;
+      EXPECT_EQ( trajectories.expectation( v0 , Z , nbTrajectories , 7 ,
+                                           errort ) , z ) ;
+      EXPECT_EQ( errort , error ) ;
+    }
+    omp_set_num_threads( maxThreads ) ;
+  #endif
+
+    // sampled outcomes of qubit 0
+    const auto counts = trajectories.sample( v0 , nbTrajectories , 3 , { 0 } ,
+                                             7 ) ;
+    int64_t total = 0 ;
+    for ( const auto& count : counts ) total += count.second ;
+    EXPECT_EQ( total , 3 * nbTrajectories ) ;
+    ASSERT_EQ( counts.size() , 2 ) ;
+    EXPECT_NEAR( R( counts[0].second ) / total , gamma , 5 * sigma ) ;
+  }
+
+  // depolarizing: <X> = 1 - 4 p / 3 after H
+  {
+    const double p = 0.15 ;
+    qclab::QCircuit< T >  circuit( 1 ) ;
+    circuit.push_back( std::make_unique< Hadamard< T > >( 0 ) ) ;
+    qclab::noise::NoiseModel< T >  model ;
+    model.add( qclab::noise::depolarizing< T >( 0 , p ) ) ;
+    qclab::noise::Trajectories< T >  trajectories( circuit , model ) ;
+    qclab::PauliSum< T >  X( 1 ) ;
+    X.add( 1 , "X" ) ;
+    const std::vector< T > v0 = { 1 , 0 } ;
+    const int nbTrajectories = 4000 ;
+    const R x = trajectories.expectation( v0 , X , nbTrajectories , 3 ) ;
+    const double sigma = 2 * std::sqrt( p * 2 / 3 * ( 1 - p * 2 / 3 ) /
+                                        nbTrajectories ) ;
+    EXPECT_NEAR( x , 1 - 4 * p / 3 , 5 * sigma ) ;
+  }
+
+  // readout error and reproducibility
+  {
+    const int n = 6 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< Hadamard< T > >( q ) ) ;
+    }
+    for ( int q = 0; q < n - 1; q++ ) {
+      circuit.push_back( std::make_unique< CNOT< T > >( q , q + 1 ) ) ;
+    }
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< Measurement< T > >( q , q ) ) ;
+    }
+    qclab::noise::NoiseModel< T >  model ;
+    model.add( qclab::noise::depolarizing< T >( 0 , 0.05 ) ) ;
+    model.template add< CNOT< T > >(
+                          qclab::noise::amplitudeDamping< T >( 0 , 0.05 ) ) ;
+    model.setReadoutError( 0.02 , 0.05 ) ;
+    model.setReadoutError( 0 , 1 , 0 ) ;
+    qclab::noise::Trajectories< T >  trajectories( circuit , model ) ;
+
+    std::vector< T > v0( 1 << n , T(0) ) ;
+    v0[0] = 1 ;
+    std::vector< int > bits( n ) ;
+    for ( int q = 0; q < n; q++ ) bits[q] = q ;
+    const int nbTrajectories = 300 ;
+
+    // parallel over the trajectories
+    const auto threshold = qclab::parallel::threshold() ;
+    qclab::parallel::setThreshold( int64_t(1) << 40 ) ;
+    const auto counts1 = trajectories.counts( v0 , nbTrajectories , bits , 5 ) ;
+    // parallel within a trajectory
+    qclab::parallel::setThreshold( 1 ) ;
+    const auto counts2 = trajectories.counts( v0 , nbTrajectories , bits , 5 ) ;
+    qclab::parallel::setThreshold( threshold ) ;
+    EXPECT_EQ( counts1 , counts2 ) ;
+
+    // bit 0 always reads 1
+    int64_t total = 0 ;
+    for ( const auto& count : counts1 ) {
+      EXPECT_EQ( count.first & 1 , 1 ) ;
+      total += count.second ;
+    }
+    EXPECT_EQ( total , nbTrajectories ) ;
+
+    // other seed
+    const auto counts3 = trajectories.counts( v0 , nbTrajectories , bits , 6 ) ;
+    EXPECT_NE( counts1 , counts3 ) ;
+
+    // single trajectory
+    std::vector< T > v = v0 ;
+    qclab::ClassicalRegister creg( 0 , 1 ) ;
+    trajectories.simulate( v , creg ) ;
+    R nrm = 0 ;
+    for ( const auto& x : v ) nrm += std::norm( x ) ;
+    EXPECT_NEAR( nrm , 1 , tol ) ;
+    EXPECT_EQ( creg.nbBits() , n ) ;
+    EXPECT_EQ( creg[0] , 1 ) ;
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_noise_Trajectories , complex_float ) {
+  test_qclab_noise_Trajectories< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_noise_Trajectories , complex_double ) {
+  test_qclab_noise_Trajectories< std::complex< double > >() ;
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "qclab/parallel.hpp"
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include <atomic>
+
+template <typename T>
+void check_parallel( const std::vector< T >& v1 , const std::vector< T >& v2 ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( size_t i = 0; i < v1.size(); ++i ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+
+}
+
+/*
+ * Out-of-tree quantum object that negates every amplitude with a plain loop,
+ * i.e., that is not team aware.
+ */
+template <typename T>
+class Negate : public qclab::QObject< T >
+{
+
+  public:
+    int nbQubits() const override { return 1 ; }
+    bool fixed() const override { return true ; }
+    bool controlled() const override { return false ; }
+    int qubit() const override { return 0 ; }
+    void setQubit( const int ) override { }
+    std::vector< int > qubits() const override { return { 0 } ; }
+    void setQubits( const int* ) override { }
+    qclab::dense::SquareMatrix< T > matrix() const override {
+      return qclab::dense::SquareMatrix< T >( T(-1) , T(0) , T(0) , T(-1) ) ;
+    }
+    void apply( qclab::Op , const int , std::vector< T >& vector ,
+                const int = 0 ) const override {
+      for ( auto& v : vector ) v = -v ;
+    }
+  #ifdef QCLAB_OMP_OFFLOADING
+    void apply_device( qclab::Op , const int , T* ,
+                       const int = 0 ) const override { }
+  #endif
+    void apply( qclab::Side , qclab::Op , const int ,
+                qclab::dense::SquareMatrix< T >& matrix ,
+                const int = 0 ) const override {
+      const int64_t size = matrix.size() * matrix.size() ;
+      for ( int64_t i = 0; i < size; i++ ) matrix.ptr()[i] = -matrix.ptr()[i] ;
+    }
+    void print() const override { }
+    int toQASM( std::ostream& , const int = 0 ) const override { return -1 ; }
+
+  protected:
+    bool equals( const qclab::QObject< T >& ) const override { return false ; }
+
+} ; // class Negate
+
+template <typename T>
+void test_qclab_parallel() {
+
+  using R  = qclab::real_t< T > ;
+  using H  = qclab::qgates::Hadamard< T > ;
+  using RX = qclab::qgates::RotationX< T > ;
+  using RZ = qclab::qgates::RotationZ< T > ;
+  using CX = qclab::qgates::CNOT< T > ;
+  using CP = qclab::qgates::CPhase< T > ;
+  using SW = qclab::qgates::SWAP< T > ;
+  using MN = qclab::qgates::MatrixGateN< T > ;
+
+  const int64_t threshold = qclab::parallel::threshold() ;
+#ifdef _OPENMP
+  const int maxThreads = omp_get_max_threads() ;
+  omp_set_num_threads( 4 ) ;
+#endif
+
+  // setThreshold and nbThreads
+  qclab::parallel::setThreshold( 4 ) ;
+  EXPECT_EQ( qclab::parallel::threshold() , 4 ) ;
+  EXPECT_EQ( qclab::parallel::nbThreads( 0 ) , 1 ) ;
+  EXPECT_EQ( qclab::parallel::nbThreads( 7 ) , 1 ) ;
+#ifdef _OPENMP
+  EXPECT_EQ( qclab::parallel::nbThreads( 8 ) , 2 ) ;
+  EXPECT_EQ( qclab::parallel::nbThreads( 1000 ) , 4 ) ;
+#else
+  EXPECT_EQ( qclab::parallel::nbThreads( 1000 ) , 1 ) ;
+#endif
+  qclab::parallel::setThreshold( 0 ) ;
+  EXPECT_EQ( qclab::parallel::threshold() , 1 ) ;
+
+  // forEach: every iteration exactly once
+  for ( const int64_t n : { 0 , 1 , 5 , 1000 } ) {
+    std::vector< int > count( n , 0 ) ;
+    qclab::parallel::forEach( n , [&] ( const int64_t k ) { count[k]++ ; } ) ;
+    for ( int64_t k = 0; k < n; k++ ) EXPECT_EQ( count[k] , 1 ) ;
+  }
+
+  // run: loops are shared among the team, loop bodies are not team members
+  {
+    EXPECT_FALSE( qclab::parallel::inTeam() ) ;
+    const int64_t n = 1000 ;
+    std::vector< int > count( n , 0 ) ;
+    std::atomic< int > members( 0 ) , bodies( 0 ) ;
+    qclab::parallel::run( n , [&] () {
+      if ( qclab::parallel::inTeam() ) members++ ;
+      for ( int i = 0; i < 3; i++ ) {
+        qclab::parallel::forRange( n , [&] ( const int64_t begin ,
+                                             const int64_t end ) {
+          if ( qclab::parallel::inTeam() ) bodies++ ;
+          for ( int64_t k = begin; k < end; k++ ) count[k]++ ;
+        } ) ;
+      }
+    } ) ;
+    for ( int64_t k = 0; k < n; k++ ) EXPECT_EQ( count[k] , 3 ) ;
+  #ifdef _OPENMP
+    EXPECT_EQ( members , 4 ) ;
+  #endif
+    EXPECT_EQ( bodies , 0 ) ;
+    EXPECT_FALSE( qclab::parallel::inTeam() ) ;
+  }
+
+  // simulate: serial versus persistent team
+  const int n = 8 ;
+  const R pi = 4 * std::atan(1) ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< H >( i ) ) ;
+    for ( int j = 2; j <= n-i; j++ ) {
+      circuit.push_back( std::make_unique< CP >( j + i - 1 , i ,
+                                                 -2*pi / ( 1 << j ) ) ) ;
+    }
+    circuit.push_back( std::make_unique< RZ >( i , R(0.1) * i ) ) ;
+  }
+  for ( int i = 0; i < n/2; i++ ) {
+    circuit.push_back( std::make_unique< SW >( i , n - i - 1 ) ) ;
+    circuit.push_back( std::make_unique< RX >( i , R(0.3) ) ) ;
+    circuit.push_back( std::make_unique< CX >( i , i + 1 ) ) ;
+  }
+  const std::vector< int > qubits = { 1 , 4 , 6 } ;
+  circuit.push_back( std::make_unique< MN >( qubits ,
+                     qclab::dense::kron( RX( R(0.5) ).matrix() ,
+                       qclab::dense::kron( H().matrix() ,
+                                           RZ( R(0.7) ).matrix() ) ) ) ) ;
+
+  std::vector< T > v0( 1 << n ) ;
+  for ( size_t i = 0; i < v0.size(); i++ ) {
+    v0[i] = T( std::cos( i ) , std::sin( 3 * i ) ) / R( 16 ) ;
+  }
+  qclab::sim::Options fused ;
+  fused.fuseDiagonal = true ;
+  fused.fuseK = 3 ;
+  qclab::sim::Options blocked ;
+  blocked.fuse1 = true ;
+  blocked.blockQubits = 4 ;
+  for ( const auto& options : { qclab::sim::Options() , fused , blocked } ) {
+    qclab::parallel::setThreshold( int64_t(1) << 30 ) ;
+    auto v1 = v0 ;
+    circuit.simulate( v1 , options ) ;
+    qclab::parallel::setThreshold( 1 ) ;
+    auto v2 = v0 ;
+    circuit.simulate( v2 , options ) ;
+    check_parallel( v1 , v2 ) ;
+    auto v3 = v0 ;
+    circuit.simulate( v3 ) ;
+    check_parallel( v1 , v3 ) ;
+    // state vector
+    qclab::StateVector< T > state( v0 , qclab::Layout::Split ) ;
+    circuit.simulate( state , options ) ;
+    check_parallel( v1 , state.vector() ) ;
+  }
+
+  // objects that are not team aware are applied once by every team size
+  {
+    qclab::QCircuit< T >  negate( n ) ;
+    negate.push_back( std::make_unique< H >( 0 ) ) ;
+    negate.push_back( std::make_unique< Negate< T > >() ) ;
+    negate.push_back( std::make_unique< CX >( 0 , n - 1 ) ) ;
+    EXPECT_FALSE( negate[1]->teamAware() ) ;
+    EXPECT_TRUE( negate[2]->teamAware() ) ;
+    qclab::parallel::setThreshold( int64_t(1) << 30 ) ;
+    auto v1 = v0 ;
+    negate.simulate( v1 ) ;
+    const auto m1 = negate.matrix() ;
+    qclab::parallel::setThreshold( 1 ) ;
+    for ( int t = 1; t <= 4; t++ ) {
+    #ifdef _OPENMP
+      omp_set_num_threads( t ) ;
+    #endif
+      for ( const auto& options : { qclab::sim::Options() , blocked } ) {
+        auto v2 = v0 ;
+        negate.simulate( v2 , options ) ;
+        check_parallel( v1 , v2 ) ;
+      }
+      qclab::StateVector< T > state( v0 , qclab::Layout::Split ) ;
+      negate.simulate( state ) ;
+      check_parallel( v1 , state.vector() ) ;
+      EXPECT_TRUE( negate.matrix() == m1 ) ;
+    }
+  }
+
+  qclab::parallel::setThreshold( threshold ) ;
+#ifdef _OPENMP
+  omp_set_num_threads( maxThreads ) ;
+#endif
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_parallel , complex_float ) {
+  test_qclab_parallel< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_parallel , complex_double ) {
+  test_qclab_parallel< std::complex< double > >() ;
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "qclab/qgates/CRotationX.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
 #include <numeric>
 
 template <typename T>
@@ -894,6 +895,35 @@ void test_qclab_qgates_CRotationX() {
   #endif
   }
 
+  {
+    // apply: compare with the dense 2-qubit kernel
+    const int n = 6 ;
+    std::vector< T > v0( 1 << n ) ;
+    for ( int i = 0; i < v0.size(); i++ ) {
+      v0[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+    }
+    for ( int control = 0; control < n; control++ ) {
+      for ( int target = 0; target < n; target++ ) {
+        if ( control == target ) continue ;
+        for ( int state : { 0 , 1 } ) {
+          qclab::qgates::CRotationX< T >  C1( control , target , R(0.7) ,
+                                             state ) ;
+          qclab::qgates::MatrixGateN< T >  M1( C1.qubits() , C1.matrix() ) ;
+          for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                            qclab::Op::ConjTrans } ) {
+            auto v1 = v0 ;
+            auto v2 = v0 ;
+            C1.apply( op , n , v1 ) ;
+            M1.apply( op , n , v2 ) ;
+            for ( int i = 0; i < v0.size(); i++ ) {
+              EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , 10 * tol ) ;
+            }
+          }
+        }
+      }
+    }
+  }
+
 }
 
 
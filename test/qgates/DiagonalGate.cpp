@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/DiagonalGate.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+
+template <typename T>
+T value_DiagonalGate( const int k ) {
+  if constexpr ( qclab::is_complex_v< T > ) {
+    return T( std::cos( k ) , std::sin( k ) ) ;
+  } else {
+    return T( 1 + std::cos( k ) / 20 ) ;
+  }
+}
+
+template <typename T>
+std::vector< T > vector_DiagonalGate( const int nbQubits ) {
+  std::vector< T > vec( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec.size(); i++ ) {
+    vec[i] = std::sin( 2*i + 1 ) ;
+  }
+  return vec ;
+}
+
+template <typename T>
+void check_DiagonalGate( const std::vector< T >& v1 ,
+                         const std::vector< T >& v2 ) {
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( int i = 0; i < v1.size(); i++ ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+}
+
+// random diagonal gate and its factors as matrix gates on `nbQubits` qubits
+template <typename T>
+void random_DiagonalGate( const int nbQubits , const int nbFactors ,
+              qclab::qgates::DiagonalGate< T >& D ,
+              std::vector< qclab::qgates::MatrixGateN< T > >& gates ) {
+  for ( int k = 0; k < nbFactors; k++ ) {
+    const int p = ( 7 * k + 3 ) % nbQubits ;
+    const int q = ( 5 * k + 1 ) % nbQubits ;
+    if ( p == q ) {
+      qclab::dense::SquareMatrix< T > mat( 2 , T(0) ) ;
+      for ( int i = 0; i < 2; i++ ) mat(i,i) = value_DiagonalGate< T >( k+i );
+      D.multiply( { p } , mat ) ;
+      gates.emplace_back( std::vector< int >( { p } ) , mat ) ;
+    } else {
+      qclab::dense::SquareMatrix< T > mat( 4 , T(0) ) ;
+      for ( int i = 0; i < 4; i++ ) mat(i,i) = value_DiagonalGate< T >( k+i );
+      const std::vector< int > qubits = { std::min( p , q ) ,
+                                          std::max( p , q ) } ;
+      D.multiply( qubits , mat ) ;
+      gates.emplace_back( qubits , mat ) ;
+    }
+  }
+}
+
+template <typename T>
+void test_qclab_qgates_DiagonalGate() {
+
+  using D  = qclab::qgates::DiagonalGate< T > ;
+  using MN = qclab::qgates::MatrixGateN< T > ;
+  using V  = std::vector< T > ;
+
+  {
+    D diag ;
+    EXPECT_EQ( diag.nbQubits() , 0 ) ;  // nbQubits
+    EXPECT_TRUE( diag.fixed() ) ;       // fixed
+    EXPECT_FALSE( diag.controlled() ) ; // controlled
+
+    // multiply
+    diag.multiply( 2 , { T(2) , T(3) } ) ;
+    diag.multiply( 1 , 3 , { T(1) , T(2) , T(3) , T(4) } ) ;
+    diag.multiply( 2 , { T(5) , T(7) } ) ;
+    EXPECT_EQ( diag.nbQubits() , 3 ) ;
+    EXPECT_EQ( diag.qubit() , 1 ) ;
+    EXPECT_EQ( diag.factors1().size() , 1 ) ;
+    EXPECT_EQ( diag.factors2().size() , 1 ) ;
+    EXPECT_EQ( diag.factors1().at( 2 )[0] , T(10) ) ;
+    EXPECT_EQ( diag.factors1().at( 2 )[1] , T(21) ) ;
+
+    // qubits
+    auto qubits = diag.qubits() ;
+    EXPECT_EQ( qubits.size() , 3 ) ;
+    EXPECT_EQ( qubits[0] , 1 ) ;
+    EXPECT_EQ( qubits[1] , 2 ) ;
+    EXPECT_EQ( qubits[2] , 3 ) ;
+
+    // matrix: qubits 1 2 3 with 2-qubit factor on 1 and 3
+    auto mat = diag.matrix() ;
+    EXPECT_EQ( mat.size() , 8 ) ;
+    const T d[] = { T(10) , T(2*10) , T(21) , T(2*21) ,
+                    T(3*10) , T(4*10) , T(3*21) , T(4*21) } ;
+    for ( int j = 0; j < 8; j++ ) {
+      for ( int i = 0; i < 8; i++ ) {
+        EXPECT_EQ( mat(i,j) , ( i == j ) ? d[i] : T(0) ) ;
+      }
+    }
+
+    // setQubits
+    int qnew[] = { 0 , 2 , 4 } ;
+    diag.setQubits( &qnew[0] ) ;
+    qubits = diag.qubits() ;
+    EXPECT_EQ( qubits[0] , 0 ) ;
+    EXPECT_EQ( qubits[1] , 2 ) ;
+    EXPECT_EQ( qubits[2] , 4 ) ;
+    EXPECT_EQ( diag.factors1().count( 2 ) , 1 ) ;
+    EXPECT_EQ( diag.factors2().count( { 0 , 4 } ) , 1 ) ;
+    EXPECT_TRUE( diag.matrix() == mat ) ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( diag.toQASM( qasm ) , -1 ) ;
+    EXPECT_EQ( qasm.str() , "" ) ;
+
+    // operators == and !=
+    D diag2 ;
+    diag2.multiply( 0 , 4 , { T(1) , T(2) , T(3) , T(4) } ) ;
+    diag2.multiply( 2 , { T(10) , T(21) } ) ;
+    EXPECT_TRUE( diag == diag2 ) ;
+    diag2.multiply( 2 , { T(1) , T(-1) } ) ;
+    EXPECT_TRUE( diag != diag2 ) ;
+  }
+
+  // apply: small and large registers, the latter with 1-qubit and 2-qubit
+  // factors on both sides of the table qubits
+  for ( const int n : { 3 , 13 } ) {
+    D diag ;
+    std::vector< MN > gates ;
+    random_DiagonalGate( n , 3 * n , diag , gates ) ;
+    for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                      qclab::Op::ConjTrans } ) {
+      V v1 = vector_DiagonalGate< T >( n ) ;
+      V v2 = v1 ;
+      for ( const auto& gate : gates ) gate.apply( op , n , v1 ) ;
+      diag.apply( op , n , v2 ) ;
+      check_DiagonalGate( v1 , v2 ) ;
+
+      // state vector
+      for ( auto layout : { qclab::Layout::Interleaved ,
+                            qclab::Layout::Split } ) {
+        if ( !qclab::is_complex_v< T > && layout == qclab::Layout::Split ) {
+          continue ;
+        }
+        qclab::StateVector< T > state( vector_DiagonalGate< T >( n ) ,
+                                       layout ) ;
+        diag.apply( op , n , state ) ;
+        check_DiagonalGate( v1 , state.vector() ) ;
+      }
+    }
+
+    // offset
+    V v1 = vector_DiagonalGate< T >( n + 2 ) ;
+    V v2 = v1 ;
+    for ( const auto& gate : gates ) {
+      gate.apply( qclab::Op::NoTrans , n + 2 , v1 , 1 ) ;
+    }
+    diag.apply( qclab::Op::NoTrans , n + 2 , v2 , 1 ) ;
+    check_DiagonalGate( v1 , v2 ) ;
+  }
+
+  // apply to matrix
+  {
+    D diag ;
+    std::vector< MN > gates ;
+    random_DiagonalGate( 3 , 5 , diag , gates ) ;
+    const MN dense( diag.qubits() , diag.matrix() ) ;
+    for ( auto side : { qclab::Side::Left , qclab::Side::Right } ) {
+      for ( auto op : { qclab::Op::NoTrans , qclab::Op::ConjTrans } ) {
+        qclab::dense::SquareMatrix< T > M1( 16 ) ;
+        for ( int j = 0; j < 16; j++ ) {
+          for ( int i = 0; i < 16; i++ ) {
+            M1(i,j) = value_DiagonalGate< T >( i + 5*j ) ;
+          }
+        }
+        auto M2 = M1 ;
+        dense.apply( side , op , 4 , M1 , 1 ) ;
+        diag.apply( side , op , 4 , M2 , 1 ) ;
+        check_DiagonalGate( V( M1.ptr() , M1.ptr() + 256 ) ,
+                            V( M2.ptr() , M2.ptr() + 256 ) ) ;
+      }
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_DiagonalGate , float ) {
+  test_qclab_qgates_DiagonalGate< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_DiagonalGate , double ) {
+  test_qclab_qgates_DiagonalGate< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_DiagonalGate , complex_float ) {
+  test_qclab_qgates_DiagonalGate< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_DiagonalGate , complex_double ) {
+  test_qclab_qgates_DiagonalGate< std::complex< double > >() ;
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/MCGate.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+
+template <typename T>
+std::vector< T > vector_MCGate( const int nbQubits ) {
+  std::vector< T > vec( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec.size(); i++ ) {
+    vec[i] = std::sin( 3*i + 1 ) ;
+  }
+  return vec ;
+}
+
+template <typename T>
+void check_MCGate( const std::vector< T >& v1 , const std::vector< T >& v2 ) {
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( int i = 0; i < v1.size(); i++ ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+}
+
+template <typename T>
+void test_qclab_qgates_MCGate() {
+
+  using MC = qclab::qgates::MCGate< T > ;
+  using MN = qclab::qgates::MatrixGateN< T > ;
+  using V  = std::vector< T > ;
+
+  // 1-qubit matrix
+  qclab::dense::SquareMatrix< T > U( T(0.6) , T(-0.8) ,
+                                     T(0.8) , T( 0.6) ) ;
+  if constexpr ( qclab::is_complex_v< T > ) {
+    U(0,1) = T( 0 , -0.8 ) ;
+    U(1,0) = T( 0 , -0.8 ) ;
+  }
+
+  {
+    MC gate( { 0 , 2 } , 1 , U , { 1 , 0 } ) ;
+
+    EXPECT_EQ( gate.nbQubits() , 3 ) ;   // nbQubits
+    EXPECT_TRUE( gate.fixed() ) ;        // fixed
+    EXPECT_TRUE( gate.controlled() ) ;   // controlled
+    EXPECT_EQ( gate.qubit() , 0 ) ;      // qubit
+    EXPECT_EQ( gate.target() , 1 ) ;     // target
+    EXPECT_EQ( gate.controls().size() , 2 ) ;
+    EXPECT_EQ( gate.controls()[0] , 0 ) ;
+    EXPECT_EQ( gate.controls()[1] , 2 ) ;
+    EXPECT_EQ( gate.controlStates()[0] , 1 ) ;
+    EXPECT_EQ( gate.controlStates()[1] , 0 ) ;
+    EXPECT_TRUE( gate.targetMatrix() == U ) ;
+
+    // qubits
+    auto qubits = gate.qubits() ;
+    EXPECT_EQ( qubits.size() , 3 ) ;
+    EXPECT_EQ( qubits[0] , 0 ) ;
+    EXPECT_EQ( qubits[1] , 1 ) ;
+    EXPECT_EQ( qubits[2] , 2 ) ;
+
+    // matrix: U on the basis states |1x0>
+    auto mat = qclab::dense::eye< T >( 8 ) ;
+    mat(4,4) = U(0,0) ; mat(4,6) = U(0,1) ;
+    mat(6,4) = U(1,0) ; mat(6,6) = U(1,1) ;
+    EXPECT_TRUE( gate.matrix() == mat ) ;
+
+    // setQubits
+    int qnew[] = { 1 , 3 , 5 } ;
+    gate.setQubits( &qnew[0] ) ;
+    EXPECT_EQ( gate.controls()[0] , 1 ) ;
+    EXPECT_EQ( gate.controls()[1] , 5 ) ;
+    EXPECT_EQ( gate.target() , 3 ) ;
+    EXPECT_TRUE( gate.matrix() == mat ) ;
+    gate.setTarget( 4 ) ;
+    EXPECT_EQ( gate.target() , 4 ) ;
+    EXPECT_EQ( gate.qubits()[1] , 4 ) ;
+
+    // print
+    gate.print() ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( gate.toQASM( qasm ) , -1 ) ;
+
+    // operators == and !=
+    MC gate2( { 1 , 5 } , 4 , U , { 1 , 0 } ) ;
+    EXPECT_TRUE(  gate == gate2 ) ;
+    EXPECT_FALSE( gate != gate2 ) ;
+    gate2.setControlStates( { 1 , 1 } ) ;
+    EXPECT_TRUE(  gate != gate2 ) ;
+    EXPECT_TRUE(  gate == MN( { 1 , 4 , 5 } , gate.matrix() ) ) ;
+  }
+
+  // apply: controls below, between and above the target
+  const std::vector< int > controls = { 1 , 4 , 5 } ;
+  const std::vector< int > states   = { 1 , 0 , 1 } ;
+  for ( const int target : { 0 , 2 , 6 } ) {
+    MC gate( controls , target , U , states ) ;
+    const MN dense( gate.qubits() , gate.matrix() ) ;
+    const int n = 8 ;
+    for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                      qclab::Op::ConjTrans } ) {
+      V v1 = vector_MCGate< T >( n ) ;
+      V v2 = v1 ;
+      dense.apply( op , n , v1 ) ;
+      gate.apply( op , n , v2 ) ;
+      check_MCGate( v1 , v2 ) ;
+
+      // state vector
+      for ( auto layout : { qclab::Layout::Interleaved ,
+                            qclab::Layout::Split } ) {
+        if ( !qclab::is_complex_v< T > && layout == qclab::Layout::Split ) {
+          continue ;
+        }
+        qclab::StateVector< T > state( vector_MCGate< T >( n ) , layout ) ;
+        gate.apply( op , n , state ) ;
+        check_MCGate( v1 , state.vector() ) ;
+      }
+    }
+
+    // offset
+    V v1 = vector_MCGate< T >( n + 1 ) ;
+    V v2 = v1 ;
+    dense.apply( qclab::Op::NoTrans , n + 1 , v1 , 1 ) ;
+    gate.apply( qclab::Op::NoTrans , n + 1 , v2 , 1 ) ;
+    check_MCGate( v1 , v2 ) ;
+  }
+
+  // apply to matrix
+  {
+    MC gate( { 0 , 3 } , 1 , U , { 0 , 1 } ) ;
+    const MN dense( gate.qubits() , gate.matrix() ) ;
+    for ( auto side : { qclab::Side::Left , qclab::Side::Right } ) {
+      for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                        qclab::Op::ConjTrans } ) {
+        qclab::dense::SquareMatrix< T > M1( 32 ) ;
+        for ( int j = 0; j < 32; j++ ) {
+          for ( int i = 0; i < 32; i++ ) {
+            M1(i,j) = std::cos( i + 7*j ) ;
+          }
+        }
+        auto M2 = M1 ;
+        dense.apply( side , op , 5 , M1 , 1 ) ;
+        gate.apply( side , op , 5 , M2 , 1 ) ;
+        check_MCGate( V( M1.ptr() , M1.ptr() + 1024 ) ,
+                      V( M2.ptr() , M2.ptr() + 1024 ) ) ;
+      }
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_MCGate , float ) {
+  test_qclab_qgates_MCGate< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_MCGate , double ) {
+  test_qclab_qgates_MCGate< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_MCGate , complex_float ) {
+  test_qclab_qgates_MCGate< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_MCGate , complex_double ) {
+  test_qclab_qgates_MCGate< std::complex< double > >() ;
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/MCSWAP.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+
+template <typename T>
+void test_qclab_qgates_MCSWAP() {
+
+  using MCSWAP = qclab::qgates::MCSWAP< T > ;
+  using MN     = qclab::qgates::MatrixGateN< T > ;
+  using V      = std::vector< T > ;
+
+  {
+    // Fredkin gate
+    MCSWAP cswap( { 0 } , 2 , 1 ) ;
+
+    EXPECT_EQ( cswap.nbQubits() , 3 ) ;   // nbQubits
+    EXPECT_TRUE( cswap.fixed() ) ;        // fixed
+    EXPECT_TRUE( cswap.controlled() ) ;   // controlled
+    EXPECT_EQ( cswap.targets()[0] , 1 ) ; // targets
+    EXPECT_EQ( cswap.targets()[1] , 2 ) ;
+
+    // matrix
+    auto mat = qclab::dense::eye< T >( 8 ) ;
+    mat(5,5) = 0 ; mat(6,5) = 1 ; mat(5,6) = 1 ; mat(6,6) = 0 ;
+    EXPECT_TRUE( cswap.matrix() == mat ) ;
+
+    // setQubits
+    int qnew[] = { 2 , 4 , 7 } ;
+    cswap.setQubits( &qnew[0] ) ;
+    EXPECT_EQ( cswap.controls()[0] , 2 ) ;
+    EXPECT_EQ( cswap.targets()[0] , 4 ) ;
+    EXPECT_EQ( cswap.targets()[1] , 7 ) ;
+
+    // print
+    cswap.print() ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( cswap.toQASM( qasm ) , 0 ) ;
+    EXPECT_EQ( qasm.str() , "cswap q[2], q[4], q[7];\n" ) ;
+    qasm.str( "" ) ;
+    cswap.setControlStates( { 0 } ) ;
+    EXPECT_EQ( cswap.toQASM( qasm ) , 0 ) ;
+    EXPECT_EQ( qasm.str() , "x q[2];\ncswap q[2], q[4], q[7];\nx q[2];\n" ) ;
+    qasm.str( "" ) ;
+    MCSWAP mcswap( { 0 , 1 } , 2 , 3 ) ;
+    EXPECT_EQ( mcswap.toQASM( qasm ) , -1 ) ;
+
+    // operators == and !=
+    EXPECT_TRUE(  cswap == MCSWAP( { 2 } , 7 , 4 , { 0 } ) ) ;
+    EXPECT_TRUE(  cswap != MCSWAP( { 2 } , 4 , 7 ) ) ;
+  }
+
+  // apply: controls below, between and above the targets
+  const int n = 8 ;
+  for ( const auto& controls : { std::vector< int >( { 0 , 2 } ) ,
+                                 std::vector< int >( { 3 , 6 } ) ,
+                                 std::vector< int >( { 5 , 7 } ) } ) {
+    MCSWAP gate( controls , 4 , 1 , { 1 , 0 } ) ;
+    const MN dense( gate.qubits() , gate.matrix() ) ;
+    V v1( 1 << n ) ;
+    for ( int i = 0; i < v1.size(); i++ ) v1[i] = std::sin( 3*i + 1 ) ;
+    const V v0 = v1 ;
+    V v2 = v1 ;
+    dense.apply( qclab::Op::NoTrans , n , v1 ) ;
+    gate.apply( qclab::Op::Trans , n , v2 ) ;
+    EXPECT_TRUE( v1 == v2 ) ;
+
+    // state vector
+    for ( auto layout : { qclab::Layout::Interleaved ,
+                          qclab::Layout::Split } ) {
+      if ( !qclab::is_complex_v< T > && layout == qclab::Layout::Split ) {
+        continue ;
+      }
+      qclab::StateVector< T > state( v0 , layout ) ;
+      gate.apply( qclab::Op::NoTrans , n , state ) ;
+      EXPECT_TRUE( v1 == state.vector() ) ;
+    }
+
+    // apply to matrix
+    for ( auto side : { qclab::Side::Left , qclab::Side::Right } ) {
+      auto M1 = qclab::dense::eye< T >( 1 << n ) ;
+      auto M2 = M1 ;
+      dense.apply( side , qclab::Op::NoTrans , n , M1 ) ;
+      gate.apply( side , qclab::Op::NoTrans , n , M2 ) ;
+      EXPECT_TRUE( M1 == M2 ) ;
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_MCSWAP , float ) {
+  test_qclab_qgates_MCSWAP< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_MCSWAP , double ) {
+  test_qclab_qgates_MCSWAP< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_MCSWAP , complex_float ) {
+  test_qclab_qgates_MCSWAP< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_MCSWAP , complex_double ) {
+  test_qclab_qgates_MCSWAP< std::complex< double > >() ;
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/MCX.hpp"
+#include "qclab/qgates/CX.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/QCircuit.hpp"
+#include <cstdio>
+
+template <typename T>
+void test_qclab_qgates_MCX() {
+
+  using MCX = qclab::qgates::MCX< T > ;
+  using MC  = qclab::qgates::MCGate< T > ;
+  using MN  = qclab::qgates::MatrixGateN< T > ;
+  using SW  = qclab::qgates::MCSWAP< T > ;
+  using H   = qclab::qgates::Hadamard< T > ;
+  using P   = qclab::qgates::Phase< T > ;
+  using V   = std::vector< T > ;
+
+  {
+    // Toffoli gate
+    MCX ccx( { 0 , 1 } , 2 ) ;
+
+    EXPECT_EQ( ccx.nbQubits() , 3 ) ;    // nbQubits
+    EXPECT_TRUE( ccx.fixed() ) ;         // fixed
+    EXPECT_TRUE( ccx.controlled() ) ;    // controlled
+    EXPECT_EQ( ccx.target() , 2 ) ;      // target
+    EXPECT_EQ( ccx.controlStates()[0] , 1 ) ;
+    EXPECT_EQ( ccx.controlStates()[1] , 1 ) ;
+
+    // matrix
+    auto mat = qclab::dense::eye< T >( 8 ) ;
+    mat(6,6) = 0 ; mat(7,6) = 1 ; mat(6,7) = 1 ; mat(7,7) = 0 ;
+    EXPECT_TRUE( ccx.matrix() == mat ) ;
+
+    // print
+    ccx.print() ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( ccx.toQASM( qasm ) , 0 ) ;
+    EXPECT_EQ( qasm.str() , "ccx q[0], q[1], q[2];\n" ) ;
+    qasm.str( "" ) ;
+    EXPECT_EQ( ccx.toQASM( qasm , 2 ) , 0 ) ;
+    EXPECT_EQ( qasm.str() , "ccx q[2], q[3], q[4];\n" ) ;
+    qasm.str( "" ) ;
+    MCX cx( { 3 } , 1 , { 0 } ) ;
+    EXPECT_EQ( cx.toQASM( qasm ) , 0 ) ;
+    EXPECT_EQ( qasm.str() , "x q[3];\ncx q[3], q[1];\nx q[3];\n" ) ;
+    qasm.str( "" ) ;
+    MCX mcx( { 0 , 2 , 3 } , 1 , { 1 , 0 , 1 } ) ;
+    EXPECT_EQ( mcx.toQASM( qasm ) , 0 ) ;
+    EXPECT_EQ( qasm.str() ,
+               "x q[2];\nmcx q[0], q[2], q[3], q[1];\nx q[2];\n" ) ;
+
+    // operators == and !=
+    EXPECT_TRUE(  cx == qclab::qgates::CX< T >( 3 , 1 , 0 ) ) ;
+    EXPECT_TRUE(  ccx == MC( { 0 , 1 } , 2 , qclab::qgates::PauliX< T >()
+                                                 .matrix() ) ) ;
+    EXPECT_TRUE(  ccx != mcx ) ;
+  }
+
+  // apply
+  {
+    const int n = 9 ;
+    MCX gate( { 0 , 3 , 8 } , 5 , { 1 , 0 , 1 } ) ;
+    const MN dense( gate.qubits() , gate.matrix() ) ;
+    V v1( 1 << n ) ;
+    for ( int i = 0; i < v1.size(); i++ ) v1[i] = std::sin( 3*i + 1 ) ;
+    const V v0 = v1 ;
+    V v2 = v1 ;
+    dense.apply( qclab::Op::NoTrans , n , v1 ) ;
+    gate.apply( qclab::Op::NoTrans , n , v2 ) ;
+    EXPECT_TRUE( v1 == v2 ) ;
+
+    // state vector
+    for ( auto layout : { qclab::Layout::Interleaved ,
+                          qclab::Layout::Split } ) {
+      if ( !qclab::is_complex_v< T > && layout == qclab::Layout::Split ) {
+        continue ;
+      }
+      qclab::StateVector< T > state( v0 , layout ) ;
+      gate.apply( qclab::Op::ConjTrans , n , state ) ;
+      EXPECT_TRUE( v1 == state.vector() ) ;
+    }
+  }
+
+  // QASM file with Toffoli, Fredkin and multi-controlled Pauli-X gates
+  if constexpr ( qclab::is_complex_v< T > ) {
+    const std::string filename = "test_qclab_qgates_MCX.qasm" ;
+    {
+      std::ofstream file( filename ) ;
+      file << "OPENQASM 2.0;\ninclude \"qelib1.inc\";\nqreg q[5];\n"
+           << "ccx q[0], q[3], q[1];\n"
+           << "cswap q[4], q[0], q[2];\n"
+           << "mcx q[3], q[1], q[4], q[2];\n" ;
+    }
+    qclab::QCircuit< T > circuit( filename ) ;
+    std::remove( filename.c_str() ) ;
+    EXPECT_EQ( circuit.nbQubits() , 5 ) ;
+    EXPECT_EQ( circuit.nbGates() , 3 ) ;
+    std::stringstream qasm ;
+    EXPECT_EQ( circuit.toQASM( qasm ) , 0 ) ;
+    EXPECT_EQ( qasm.str() , "ccx q[0], q[3], q[1];\n"
+                            "cswap q[4], q[0], q[2];\n"
+                            "mcx q[1], q[3], q[4], q[2];\n" ) ;
+
+    // simulate with fusion and cache blocking
+    const int n = 10 ;
+    const std::vector< int > controls = { 0 , 4 , 7 } ;
+    qclab::QCircuit< T > circuit2( n ) ;
+    for ( int i = 0; i < n; i++ ) {
+      circuit2.push_back( std::make_unique< H >( i ) ) ;
+      circuit2.push_back( std::make_unique< P >( i , 0.1 * i ) ) ;
+    }
+    circuit2.push_back( std::make_unique< MCX >( controls , 9 ) ) ;
+    circuit2.push_back( std::make_unique< SW >( controls , 2 , 8 ,
+                                      std::vector< int >( { 0 , 1 , 0 } ) ) ) ;
+    circuit2.push_back( std::make_unique< MCX >( std::vector< int >( { 5 } ) ,
+                                                 6 ) ) ;
+    for ( int i = 0; i < n; i++ ) {
+      circuit2.push_back( std::make_unique< H >( i ) ) ;
+    }
+    V v1( 1 << n , T(0) ) ;
+    v1[0] = 1 ;
+    V v2 = v1 ;
+    circuit2.simulate( v1 ) ;
+    qclab::sim::Options options ;
+    options.fuseK = 3 ;
+    options.blockQubits = 6 ;
+    circuit2.simulate( v2 , options ) ;
+    using R = qclab::real_t< T > ;
+    for ( int i = 0; i < v1.size(); i++ ) {
+      EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 ,
+                   100 * std::numeric_limits< R >::epsilon() ) ;
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_MCX , float ) {
+  test_qclab_qgates_MCX< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_MCX , double ) {
+  test_qclab_qgates_MCX< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_MCX , complex_float ) {
+  test_qclab_qgates_MCX< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_MCX , complex_double ) {
+  test_qclab_qgates_MCX< std::complex< double > >() ;
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/PauliX.hpp"
+
+template <typename T>
+void test_qclab_qgates_MatrixGate1() {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 10 * std::numeric_limits< R >::epsilon() ;
+
+  {
+    qclab::qgates::MatrixGate1< T >  M ;
+
+    EXPECT_EQ( M.nbQubits() , 1 ) ;   // nbQubits
+    EXPECT_TRUE( M.fixed() ) ;        // fixed
+    EXPECT_FALSE( M.controlled() ) ;  // controlled
+    EXPECT_EQ( M.qubit() , 0 ) ;      // qubit
+
+    // matrix
+    EXPECT_TRUE( M.matrix() == qclab::dense::eye< T >( 2 ) ) ;
+
+    // qubits
+    M.setQubit( 2 ) ;
+    EXPECT_EQ( M.qubit() , 2 ) ;
+    auto qubits = M.qubits() ;
+    EXPECT_EQ( qubits.size() , 1 ) ;
+    EXPECT_EQ( qubits[0] , 2 ) ;
+
+    // print
+    M.print() ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( M.toQASM( qasm ) , -1 ) ;
+    EXPECT_EQ( qasm.str() , "" ) ;
+  }
+
+  {
+    qclab::qgates::MatrixGate1< T >  M( 1 , 1 , 2 ,
+                                           3 , 4 ) ;
+    EXPECT_EQ( M.qubit() , 1 ) ;
+    EXPECT_EQ( M.matrix()(0,0) , T(1) ) ;
+    EXPECT_EQ( M.matrix()(0,1) , T(2) ) ;
+    EXPECT_EQ( M.matrix()(1,0) , T(3) ) ;
+    EXPECT_EQ( M.matrix()(1,1) , T(4) ) ;
+
+    // leftMultiply
+    M.leftMultiply( qclab::qgates::PauliX< T >().matrix() ) ;
+    EXPECT_EQ( M.matrix()(0,0) , T(3) ) ;
+    EXPECT_EQ( M.matrix()(0,1) , T(4) ) ;
+    EXPECT_EQ( M.matrix()(1,0) , T(1) ) ;
+    EXPECT_EQ( M.matrix()(1,1) , T(2) ) ;
+
+    // apply
+    using V = std::vector< T > ;
+    V vec = { 3 , 5 , 2 , 7 } ;
+    M.apply( qclab::Op::NoTrans , 2 , vec ) ;
+    V check = { T(29) , T(13) , T(34) , T(16) } ;
+    EXPECT_TRUE( vec == check ) ;
+    vec = { 3 , 5 , 2 , 7 } ;
+    M.apply( qclab::Op::Trans , 2 , vec ) ;
+    check = { T(14) , T(22) , T(13) , T(22) } ;
+    EXPECT_TRUE( vec == check ) ;
+  }
+
+  {
+    qclab::qgates::Hadamard< T >  H( 3 ) ;
+    qclab::qgates::MatrixGate1< T >  M( 3 , H.matrix() ) ;
+
+    // operators == and !=
+    EXPECT_TRUE(  M == H ) ;
+    EXPECT_FALSE( M != H ) ;
+    qclab::qgates::PauliX< T >  X( 3 ) ;
+    EXPECT_TRUE(  M != X ) ;
+    EXPECT_FALSE( M == X ) ;
+
+    // apply
+    std::vector< T > vec1 = { 3 , 5 , 2 , 7 } ;
+    std::vector< T > vec2 = vec1 ;
+    qclab::qgates::Hadamard< T >  H1( 1 ) ;
+    qclab::qgates::MatrixGate1< T >  M1( 1 , H.matrix() ) ;
+    H1.apply( qclab::Op::NoTrans , 2 , vec1 ) ;
+    M1.apply( qclab::Op::NoTrans , 2 , vec2 ) ;
+    for ( int i = 0; i < vec1.size(); i++ ) {
+      EXPECT_NEAR( std::abs( vec1[i] - vec2[i] ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_MatrixGate1 , float ) {
+  test_qclab_qgates_MatrixGate1< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_MatrixGate1 , double ) {
+  test_qclab_qgates_MatrixGate1< double >() ;
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_MatrixGate1 , complex_float ) {
+  test_qclab_qgates_MatrixGate1< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_MatrixGate1 , complex_double ) {
+  test_qclab_qgates_MatrixGate1< std::complex< double > >() ;
+}
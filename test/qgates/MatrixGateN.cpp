@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/dense/kron.hpp"
+
+template <typename T>
+qclab::dense::SquareMatrix< T > matrix_MatrixGateN( const int size ,
+                                                    const int seed ) {
+  qclab::dense::SquareMatrix< T > M( size ) ;
+  for ( int j = 0; j < size; j++ ) {
+    for ( int i = 0; i < size; i++ ) {
+      M(i,j) = std::cos( seed + i + 3*j ) ;
+    }
+  }
+  return M ;
+}
+
+template <typename T>
+std::vector< T > vector_MatrixGateN( const int nbQubits ) {
+  std::vector< T > vec( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec.size(); i++ ) {
+    vec[i] = std::sin( 2*i + 1 ) ;
+  }
+  return vec ;
+}
+
+template <typename T>
+void check_MatrixGateN( const std::vector< T >& v1 ,
+                        const std::vector< T >& v2 ) {
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( int i = 0; i < v1.size(); i++ ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+}
+
+template <typename T>
+void test_qclab_qgates_MatrixGateN() {
+
+  using M1 = qclab::qgates::MatrixGate1< T > ;
+  using MN = qclab::qgates::MatrixGateN< T > ;
+  using V  = std::vector< T > ;
+
+  {
+    auto mat = matrix_MatrixGateN< T >( 8 , 1 ) ;
+    MN M( { 0 , 2 , 3 } , mat ) ;
+
+    EXPECT_EQ( M.nbQubits() , 3 ) ;   // nbQubits
+    EXPECT_TRUE( M.fixed() ) ;        // fixed
+    EXPECT_FALSE( M.controlled() ) ;  // controlled
+    EXPECT_EQ( M.qubit() , 0 ) ;      // qubit
+
+    // matrix
+    EXPECT_TRUE( M.matrix() == mat ) ;
+
+    // qubits
+    auto qubits = M.qubits() ;
+    EXPECT_EQ( qubits.size() , 3 ) ;
+    EXPECT_EQ( qubits[0] , 0 ) ;
+    EXPECT_EQ( qubits[1] , 2 ) ;
+    EXPECT_EQ( qubits[2] , 3 ) ;
+    int qnew[] = { 1 , 3 , 4 } ;
+    M.setQubits( &qnew[0] ) ;
+    qubits = M.qubits() ;
+    EXPECT_EQ( qubits[0] , 1 ) ;
+    EXPECT_EQ( qubits[1] , 3 ) ;
+    EXPECT_EQ( qubits[2] , 4 ) ;
+
+    // print
+    M.print() ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( M.toQASM( qasm ) , -1 ) ;
+    EXPECT_EQ( qasm.str() , "" ) ;
+
+    // operators == and !=
+    MN M2( { 0 , 1 , 2 } , mat ) ;
+    EXPECT_TRUE(  M == M2 ) ;
+    MN M3( { 0 , 1 , 2 } , matrix_MatrixGateN< T >( 8 , 2 ) ) ;
+    EXPECT_TRUE(  M != M3 ) ;
+    EXPECT_TRUE(  M != qclab::qgates::Hadamard< T >() ) ;
+  }
+
+  // apply: Kronecker product of 1-qubit gates on non-adjacent qubits
+  for ( int k = 1; k <= MN::maxQubits; k++ ) {
+    const int nbQubits = k + 2 ;
+    std::vector< int > qubits ;
+    for ( int i = 0; i < k; i++ ) {
+      qubits.push_back( i + ( i >= k/2 ) + ( i >= k - 1 ) ) ;
+    }
+    qclab::dense::SquareMatrix< T > mat = matrix_MatrixGateN< T >( 2 , 0 ) ;
+    std::vector< M1 > gates = { M1( qubits[0] , mat ) } ;
+    for ( int i = 1; i < k; i++ ) {
+      auto mati = matrix_MatrixGateN< T >( 2 , i ) ;
+      mat = qclab::dense::kron( mat , mati ) ;
+      gates.push_back( M1( qubits[i] , mati ) ) ;
+    }
+    MN M( qubits , mat ) ;
+
+    for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                      qclab::Op::ConjTrans } ) {
+      V vec1 = vector_MatrixGateN< T >( nbQubits ) ;
+      V vec2 = vec1 ;
+      for ( const auto& gate : gates ) gate.apply( op , nbQubits , vec1 ) ;
+      M.apply( op , nbQubits , vec2 ) ;
+      check_MatrixGateN( vec1 , vec2 ) ;
+    }
+
+    // offset
+    V vec1 = vector_MatrixGateN< T >( nbQubits + 1 ) ;
+    V vec2 = vec1 ;
+    for ( const auto& gate : gates ) {
+      gate.apply( qclab::Op::NoTrans , nbQubits + 1 , vec1 , 1 ) ;
+    }
+    M.apply( qclab::Op::NoTrans , nbQubits + 1 , vec2 , 1 ) ;
+    check_MatrixGateN( vec1 , vec2 ) ;
+  }
+
+  // apply: general matrix on adjacent qubits
+  for ( int k = 1; k <= MN::maxQubits; k++ ) {
+    const int nbQubits = k + 1 ;
+    std::vector< int > qubits ;
+    for ( int i = 0; i < k; i++ ) qubits.push_back( i + 1 ) ;
+    auto mat = matrix_MatrixGateN< T >( 1 << k , k ) ;
+    MN M( qubits , mat ) ;
+    V vec1 = vector_MatrixGateN< T >( nbQubits ) ;
+    V vec2( vec1.size() , T(0) ) ;
+    const auto full = qclab::dense::kron( qclab::dense::eye< T >( 2 ) , mat ) ;
+    for ( int j = 0; j < vec1.size(); j++ ) {
+      for ( int i = 0; i < vec1.size(); i++ ) {
+        vec2[i] += full(i,j) * vec1[j] ;
+      }
+    }
+    M.apply( qclab::Op::NoTrans , nbQubits , vec1 ) ;
+    check_MatrixGateN( vec1 , vec2 ) ;
+  }
+
+  // apply: controlled gate on non-adjacent qubits
+  {
+    qclab::qgates::CNOT< T >  CX( 3 , 1 ) ;
+    MN M( CX.qubits() , CX.matrix() ) ;
+    V vec1 = vector_MatrixGateN< T >( 4 ) ;
+    V vec2 = vec1 ;
+    CX.apply( qclab::Op::NoTrans , 4 , vec1 ) ;
+    M.apply( qclab::Op::NoTrans , 4 , vec2 ) ;
+    check_MatrixGateN( vec1 , vec2 ) ;
+  }
+
+  // apply: side
+  {
+    const int nbQubits = 4 ;
+    const int size = 1 << nbQubits ;
+    MN M( { 0 , 2 , 3 } , matrix_MatrixGateN< T >( 8 , 3 ) ) ;
+
+    // full matrix
+    auto full = qclab::dense::eye< T >( size ) ;
+    M.apply( qclab::Side::Right , qclab::Op::NoTrans , nbQubits , full ) ;
+    for ( int j = 0; j < size; j++ ) {
+      V vec( size , T(0) ) ;
+      vec[j] = 1 ;
+      M.apply( qclab::Op::NoTrans , nbQubits , vec ) ;
+      for ( int i = 0; i < size; i++ ) {
+        EXPECT_NEAR( std::abs( full(i,j) - vec[i] ) , 0 ,
+                     100 * std::numeric_limits< qclab::real_t< T > >::epsilon()
+                   ) ;
+      }
+    }
+
+    const auto A = matrix_MatrixGateN< T >( size , 4 ) ;
+    for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                      qclab::Op::ConjTrans } ) {
+      const auto fullOp = qclab::dense::operate( op , full ) ;
+      // left
+      auto B = A ;
+      M.apply( qclab::Side::Left , op , nbQubits , B ) ;
+      auto C = A * fullOp ;
+      check_MatrixGateN( V( B.ptr() , B.ptr() + size*size ) ,
+                         V( C.ptr() , C.ptr() + size*size ) ) ;
+      // right
+      B = A ;
+      M.apply( qclab::Side::Right , op , nbQubits , B ) ;
+      C = fullOp * A ;
+      check_MatrixGateN( V( B.ptr() , B.ptr() + size*size ) ,
+                         V( C.ptr() , C.ptr() + size*size ) ) ;
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_MatrixGateN , float ) {
+  test_qclab_qgates_MatrixGateN< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_MatrixGateN , double ) {
+  test_qclab_qgates_MatrixGateN< double >() ;
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_MatrixGateN , complex_float ) {
+  test_qclab_qgates_MatrixGateN< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_MatrixGateN , complex_double ) {
+  test_qclab_qgates_MatrixGateN< std::complex< double > >() ;
+}
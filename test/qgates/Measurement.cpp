@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/Measurement.hpp"
+#include "qclab/qgates/Reset.hpp"
+#include "qclab/qgates/Conditional.hpp"
+#include "qclab/qgates/PauliX.hpp"
+
+template <typename T>
+void test_qclab_qgates_Measurement() {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 10 * std::numeric_limits< R >::epsilon() ;
+
+  qclab::qgates::Measurement< T >  M( 1 , 2 ) ;
+
+  EXPECT_EQ( M.nbQubits() , 1 ) ;   // nbQubits
+  EXPECT_TRUE( M.fixed() ) ;        // fixed
+  EXPECT_FALSE( M.controlled() ) ;  // controlled
+  EXPECT_TRUE( M.dynamic() ) ;      // dynamic
+  EXPECT_EQ( M.qubit() , 1 ) ;      // qubit
+  EXPECT_EQ( M.bit() , 2 ) ;        // bit
+
+  // no matrix and no apply without a classical register
+  {
+    std::vector< T > v( 8 ) ;
+    auto mat = qclab::dense::eye< T >( 8 ) ;
+    EXPECT_THROW( M.matrix() , std::logic_error ) ;
+    EXPECT_THROW( M.apply( qclab::Op::NoTrans , 3 , v ) ,
+                  std::logic_error ) ;
+    EXPECT_THROW( M.apply( qclab::Side::Left , qclab::Op::NoTrans , 3 ,
+                               mat ) , std::logic_error ) ;
+  }
+
+  // print
+  M.print() ;
+
+  // toQASM
+  std::stringstream qasm ;
+  EXPECT_EQ( M.toQASM( qasm ) , 0 ) ;
+  EXPECT_EQ( qasm.str() , "measure q[1] -> c[2];\n" ) ;
+
+  // operators == and !=
+  EXPECT_TRUE( M == qclab::qgates::Measurement< T >( 1 , 2 ) ) ;
+  EXPECT_TRUE( M != qclab::qgates::Measurement< T >( 1 , 0 ) ) ;
+  EXPECT_TRUE( M != qclab::qgates::Reset< T >( 1 ) ) ;
+
+  // state with probability 0.3 of outcome 1 for qubit 1
+  const int n = 3 ;
+  std::vector< T > v0( 1 << n ) ;
+  for ( int i = 0; i < v0.size(); i++ ) {
+    const bool one = ( i >> 1 ) & 1 ;
+    v0[i] = std::sqrt( ( one ? 0.3 : 0.7 ) / 4 ) * ( ( i % 3 ) ? 1 : -1 ) ;
+  }
+
+  // apply
+  int ones = 0 ;
+  const int nbSeeds = 2000 ;
+  for ( int seed = 0; seed < nbSeeds; seed++ ) {
+    auto v = v0 ;
+    qclab::ClassicalRegister creg( 1 , seed ) ;
+    M.apply( n , v , creg ) ;
+    EXPECT_EQ( creg.nbBits() , 3 ) ;
+    EXPECT_EQ( creg.counter() , 1 ) ;
+    const int outcome = creg[2] ;
+    ones += outcome ;
+    R nrm = 0 ;
+    for ( int i = 0; i < v.size(); i++ ) {
+      const bool one = ( i >> 1 ) & 1 ;
+      if ( one != outcome ) {
+        EXPECT_EQ( v[i] , T(0) ) ;
+      } else {
+        const R p = outcome ? 0.3 : 0.7 ;
+        EXPECT_NEAR( std::abs( v[i] - v0[i] / std::sqrt( p ) ) , 0 , tol ) ;
+      }
+      nrm += std::norm( v[i] ) ;
+    }
+    EXPECT_NEAR( nrm , 1 , tol ) ;
+    // same seed, same outcome
+    auto w = v0 ;
+    qclab::ClassicalRegister creg2( 0 , seed ) ;
+    qclab::qgates::measure( n , 1 , w , creg2 ) ;
+    EXPECT_EQ( creg2.counter() , 1 ) ;
+    EXPECT_EQ( w , v ) ;
+  }
+  const double sigma = std::sqrt( nbSeeds * 0.3 * 0.7 ) ;
+  EXPECT_NEAR( ones , 0.3 * nbSeeds , 5 * sigma ) ;
+
+  // offset
+  {
+    std::vector< T > v( 1 << ( n + 1 ) , T(0) ) ;
+    for ( int i = 0; i < v0.size(); i++ ) v[ 2*i ] = v0[i] ;
+    auto w = v0 ;
+    qclab::ClassicalRegister creg1( 0 , 5 ) , creg2( 0 , 5 ) ;
+    qclab::qgates::Measurement< T >( 0 , 0 ).apply( n + 1 , v , creg1 , 1 ) ;
+    M.apply( n , w , creg2 ) ;
+    EXPECT_EQ( creg1[0] , creg2[2] ) ;
+    for ( int i = 0; i < w.size(); i++ ) EXPECT_EQ( v[ 2*i ] , w[i] ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_qgates_Reset() {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 10 * std::numeric_limits< R >::epsilon() ;
+
+  qclab::qgates::Reset< T >  reset( 2 ) ;
+
+  EXPECT_EQ( reset.nbQubits() , 1 ) ;   // nbQubits
+  EXPECT_TRUE( reset.fixed() ) ;        // fixed
+  EXPECT_TRUE( reset.dynamic() ) ;      // dynamic
+  EXPECT_EQ( reset.qubit() , 2 ) ;      // qubit
+
+  // no matrix and no apply without a classical register
+  {
+    std::vector< T > v( 8 ) ;
+    auto mat = qclab::dense::eye< T >( 8 ) ;
+    EXPECT_THROW( reset.matrix() , std::logic_error ) ;
+    EXPECT_THROW( reset.apply( qclab::Op::NoTrans , 3 , v ) ,
+                  std::logic_error ) ;
+    EXPECT_THROW( reset.apply( qclab::Side::Left , qclab::Op::NoTrans , 3 ,
+                               mat ) , std::logic_error ) ;
+  }
+
+  // print
+  reset.print() ;
+
+  // toQASM
+  std::stringstream qasm ;
+  EXPECT_EQ( reset.toQASM( qasm , 1 ) , 0 ) ;
+  EXPECT_EQ( qasm.str() , "reset q[3];\n" ) ;
+
+  // operators == and !=
+  EXPECT_TRUE( reset == qclab::qgates::Reset< T >( 2 ) ) ;
+  EXPECT_TRUE( reset != qclab::qgates::Reset< T >( 1 ) ) ;
+
+  // apply
+  const int n = 3 ;
+  std::vector< T > v0( 1 << n ) ;
+  for ( int i = 0; i < v0.size(); i++ ) v0[i] = R( i + 1 ) / std::sqrt( 204 ) ;
+  for ( int seed = 0; seed < 20; seed++ ) {
+    auto v = v0 ;
+    qclab::ClassicalRegister creg( 0 , seed ) ;
+    reset.apply( n , v , creg ) ;
+    EXPECT_EQ( creg.counter() , 1 ) ;
+    EXPECT_EQ( creg.nbBits() , 0 ) ;
+    // same trajectory as a measurement
+    auto w = v0 ;
+    qclab::ClassicalRegister creg2( 0 , seed ) ;
+    const int outcome = qclab::qgates::measure( n , 2 , w , creg2 ) ;
+    if ( outcome ) {
+      qclab::qgates::PauliX< T >( 2 ).apply( qclab::Op::NoTrans , n , w ) ;
+    }
+    R nrm = 0 ;
+    for ( int i = 0; i < v.size(); i++ ) {
+      if ( i & 1 ) EXPECT_EQ( v[i] , T(0) ) ;
+      EXPECT_NEAR( std::abs( v[i] - w[i] ) , 0 , tol ) ;
+      nrm += std::norm( v[i] ) ;
+    }
+    EXPECT_NEAR( nrm , 1 , tol ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_qgates_Conditional() {
+
+  using C = qclab::qgates::Conditional< T > ;
+  C cond( std::make_unique< qclab::qgates::PauliX< T > >( 1 ) , { 0 , 1 } ,
+          2 ) ;
+
+  EXPECT_EQ( cond.nbQubits() , 1 ) ;   // nbQubits
+  EXPECT_TRUE( cond.fixed() ) ;        // fixed
+  EXPECT_FALSE( cond.controlled() ) ;  // controlled
+  EXPECT_TRUE( cond.dynamic() ) ;      // dynamic
+  EXPECT_EQ( cond.qubit() , 1 ) ;      // qubit
+  EXPECT_EQ( cond.value() , 2 ) ;      // value
+  EXPECT_EQ( cond.bits().size() , 2 ) ;
+
+  // no matrix and no apply without a classical register
+  {
+    std::vector< T > v( 8 ) ;
+    auto mat = qclab::dense::eye< T >( 8 ) ;
+    EXPECT_THROW( cond.matrix() , std::logic_error ) ;
+    EXPECT_THROW( cond.apply( qclab::Op::NoTrans , 3 , v ) ,
+                  std::logic_error ) ;
+    EXPECT_THROW( cond.apply( qclab::Side::Left , qclab::Op::NoTrans , 3 ,
+                               mat ) , std::logic_error ) ;
+  }
+
+  // print
+  cond.print() ;
+
+  // toQASM
+  std::stringstream qasm ;
+  EXPECT_EQ( cond.toQASM( qasm ) , 0 ) ;
+  EXPECT_EQ( qasm.str() , "if(c==2) x q[1];\n" ) ;
+  C cond2( std::make_unique< qclab::qgates::PauliX< T > >( 1 ) , { 1 } , 1 ) ;
+  std::stringstream qasm2 ;
+  EXPECT_NE( cond2.toQASM( qasm2 ) , 0 ) ;
+
+  // operators == and !=
+  EXPECT_TRUE( cond == C( std::make_unique< qclab::qgates::PauliX< T > >( 1 ) ,
+                          { 0 , 1 } , 2 ) ) ;
+  EXPECT_TRUE( cond != cond2 ) ;
+
+  // apply
+  const std::vector< T > v0 = { 1 , 2 , 3 , 4 } ;
+  for ( int value = 0; value < 4; value++ ) {
+    auto v = v0 ;
+    qclab::ClassicalRegister creg( 2 ) ;
+    creg.set( 0 , value & 1 ) ;
+    creg.set( 1 , value >> 1 ) ;
+    cond.apply( 2 , v , creg ) ;
+    const std::vector< T > flipped = { 2 , 1 , 4 , 3 } ;
+    EXPECT_EQ( v , ( value == 2 ) ? flipped : v0 ) ;
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_Measurement , float ) {
+  test_qclab_qgates_Measurement< float >() ;
+  test_qclab_qgates_Reset< float >() ;
+  test_qclab_qgates_Conditional< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_Measurement , double ) {
+  test_qclab_qgates_Measurement< double >() ;
+  test_qclab_qgates_Reset< double >() ;
+  test_qclab_qgates_Conditional< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_Measurement , complex_float ) {
+  test_qclab_qgates_Measurement< std::complex< float > >() ;
+  test_qclab_qgates_Reset< std::complex< float > >() ;
+  test_qclab_qgates_Conditional< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_Measurement , complex_double ) {
+  test_qclab_qgates_Measurement< std::complex< double > >() ;
+  test_qclab_qgates_Reset< std::complex< double > >() ;
+  test_qclab_qgates_Conditional< std::complex< double > >() ;
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include "qclab/qgates/MonomialGate.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include <numeric>
+
+template <typename T>
+T value_MonomialGate( const int k ) {
+  if constexpr ( qclab::is_complex_v< T > ) {
+    return T( std::cos( k ) , std::sin( k ) ) ;
+  } else {
+    return T( ( k % 2 ) ? -1 : 1 ) ;
+  }
+}
+
+template <typename T>
+std::vector< T > vector_MonomialGate( const int nbQubits ) {
+  std::vector< T > vec( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec.size(); i++ ) {
+    vec[i] = std::sin( 2*i + 1 ) ;
+  }
+  return vec ;
+}
+
+template <typename T>
+void check_MonomialGate( const std::vector< T >& v1 ,
+                         const std::vector< T >& v2 ) {
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( int i = 0; i < v1.size(); i++ ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+}
+
+// random monomial 1-qubit and 2-qubit matrix with seed `k`
+template <typename T>
+qclab::dense::SquareMatrix< T > matrix_MonomialGate( const int size ,
+                                                     const int k ) {
+  qclab::dense::SquareMatrix< T > mat( size , T(0) ) ;
+  std::vector< int > rows( size ) ;
+  std::iota( rows.begin() , rows.end() , 0 ) ;
+  for ( int j = 0; j < k; j++ ) {
+    std::next_permutation( rows.begin() , rows.end() ) ;
+  }
+  for ( int j = 0; j < size; j++ ) {
+    mat( rows[j] , j ) = value_MonomialGate< T >( k + j ) ;
+  }
+  return mat ;
+}
+
+// random monomial gate and its factors as matrix gates on `nbQubits` qubits
+template <typename T>
+void random_MonomialGate( const int nbQubits , const int nbFactors ,
+              qclab::qgates::MonomialGate< T >& M ,
+              std::vector< qclab::qgates::MatrixGateN< T > >& gates ) {
+  for ( int k = 0; k < nbFactors; k++ ) {
+    const int p = ( 7 * k + 3 ) % nbQubits ;
+    const int q = ( 5 * k + 1 ) % nbQubits ;
+    if ( p == q ) {
+      const auto mat = matrix_MonomialGate< T >( 2 , k ) ;
+      M.multiply( { p } , mat ) ;
+      gates.emplace_back( std::vector< int >( { p } ) , mat ) ;
+    } else {
+      const auto mat = matrix_MonomialGate< T >( 4 , k ) ;
+      const std::vector< int > qubits = { std::min( p , q ) ,
+                                          std::max( p , q ) } ;
+      M.multiply( qubits , mat ) ;
+      gates.emplace_back( qubits , mat ) ;
+    }
+  }
+}
+
+template <typename T>
+void test_qclab_qgates_MonomialGate() {
+
+  using M  = qclab::qgates::MonomialGate< T > ;
+  using MN = qclab::qgates::MatrixGateN< T > ;
+  using V  = std::vector< T > ;
+
+  {
+    M gate ;
+    EXPECT_EQ( gate.nbQubits() , 0 ) ;  // nbQubits
+    EXPECT_TRUE( gate.fixed() ) ;       // fixed
+    EXPECT_FALSE( gate.controlled() ) ; // controlled
+
+    // multiply: X on qubit 3, then CNOT with control 1 and target 3
+    const qclab::dense::SquareMatrix< T > X( 0 , 1 ,
+                                             1 , 0 ) ;
+    qclab::dense::SquareMatrix< T > CX( 4 , T(0) ) ;
+    CX(0,0) = 1 ; CX(1,1) = 1 ; CX(3,2) = 1 ; CX(2,3) = 1 ;
+    const qclab::dense::SquareMatrix< T > Z( 1 ,  0 ,
+                                             0 , -1 ) ;
+    gate.multiply( { 3 } , X ) ;
+    gate.multiply( { 1 , 3 } , CX ) ;
+    gate.multiply( { 2 } , Z ) ;
+    EXPECT_EQ( gate.nbQubits() , 3 ) ;
+    EXPECT_EQ( gate.qubit() , 1 ) ;
+
+    // qubits
+    auto qubits = gate.qubits() ;
+    EXPECT_EQ( qubits.size() , 3 ) ;
+    EXPECT_EQ( qubits[0] , 1 ) ;
+    EXPECT_EQ( qubits[1] , 2 ) ;
+    EXPECT_EQ( qubits[2] , 3 ) ;
+
+    // perm and phase: |abc> -> (-1)^b |a b c^1^a>
+    for ( int x = 0; x < 8; x++ ) {
+      const int a = x >> 2 , b = ( x >> 1 ) & 1 , c = x & 1 ;
+      EXPECT_EQ( gate.perm()[x] , ( a << 2 ) | ( b << 1 ) | ( c ^ 1 ^ a ) ) ;
+      EXPECT_EQ( gate.phase()[x] , T( b ? -1 : 1 ) ) ;
+    }
+
+    // matrix
+    auto mat = gate.matrix() ;
+    EXPECT_EQ( mat.size() , 8 ) ;
+    MN dense( qubits , mat ) ;
+    const std::vector< int > q3 = { 3 } , q13 = { 1 , 3 } , q2 = { 2 } ;
+    V v1 = vector_MonomialGate< T >( 4 ) ;
+    V v2 = v1 ;
+    MN( q3 , X ).apply( qclab::Op::NoTrans , 4 , v1 ) ;
+    MN( q13 , CX ).apply( qclab::Op::NoTrans , 4 , v1 ) ;
+    MN( q2 , Z ).apply( qclab::Op::NoTrans , 4 , v1 ) ;
+    dense.apply( qclab::Op::NoTrans , 4 , v2 ) ;
+    check_MonomialGate( v1 , v2 ) ;
+
+    // setQubits
+    int qnew[] = { 0 , 2 , 4 } ;
+    gate.setQubits( &qnew[0] ) ;
+    qubits = gate.qubits() ;
+    EXPECT_EQ( qubits[0] , 0 ) ;
+    EXPECT_EQ( qubits[1] , 2 ) ;
+    EXPECT_EQ( qubits[2] , 4 ) ;
+    EXPECT_TRUE( gate.matrix() == mat ) ;
+
+    // toQASM
+    std::stringstream qasm ;
+    EXPECT_EQ( gate.toQASM( qasm ) , -1 ) ;
+    EXPECT_EQ( qasm.str() , "" ) ;
+
+    // operators == and !=
+    M gate2 ;
+    gate2.multiply( { 0 , 2 , 4 } , mat ) ;
+    EXPECT_TRUE( gate == gate2 ) ;
+    gate2.multiply( { 2 } , Z ) ;
+    EXPECT_TRUE( gate != gate2 ) ;
+  }
+
+  // apply: small and large registers, the latter with chunks of the local
+  // qubits and the least significant other qubits
+  for ( const int n : { 3 , 15 } ) {
+    M gate ;
+    std::vector< MN > gates ;
+    random_MonomialGate( std::min( n , M::maxQubits ) , 3 * n , gate ,
+                         gates ) ;
+    for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                      qclab::Op::ConjTrans } ) {
+      V v1 = vector_MonomialGate< T >( n ) ;
+      V v2 = v1 ;
+      if ( op == qclab::Op::NoTrans ) {
+        for ( auto it = gates.begin(); it != gates.end(); ++it ) {
+          it->apply( op , n , v1 ) ;
+        }
+      } else {
+        for ( auto it = gates.rbegin(); it != gates.rend(); ++it ) {
+          it->apply( op , n , v1 ) ;
+        }
+      }
+      gate.apply( op , n , v2 ) ;
+      check_MonomialGate( v1 , v2 ) ;
+
+      // state vector
+      for ( auto layout : { qclab::Layout::Interleaved ,
+                            qclab::Layout::Split } ) {
+        if ( !qclab::is_complex_v< T > && layout == qclab::Layout::Split ) {
+          continue ;
+        }
+        qclab::StateVector< T > state( vector_MonomialGate< T >( n ) ,
+                                       layout ) ;
+        gate.apply( op , n , state ) ;
+        check_MonomialGate( v1 , state.vector() ) ;
+      }
+    }
+
+    // offset
+    V v1 = vector_MonomialGate< T >( n + 2 ) ;
+    V v2 = v1 ;
+    for ( const auto& g : gates ) {
+      g.apply( qclab::Op::NoTrans , n + 2 , v1 , 1 ) ;
+    }
+    gate.apply( qclab::Op::NoTrans , n + 2 , v2 , 1 ) ;
+    check_MonomialGate( v1 , v2 ) ;
+  }
+
+  // apply to matrix
+  {
+    M gate ;
+    std::vector< MN > gates ;
+    random_MonomialGate( 3 , 5 , gate , gates ) ;
+    const MN dense( gate.qubits() , gate.matrix() ) ;
+    for ( auto side : { qclab::Side::Left , qclab::Side::Right } ) {
+      for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                        qclab::Op::ConjTrans } ) {
+        qclab::dense::SquareMatrix< T > M1( 16 ) ;
+        for ( int j = 0; j < 16; j++ ) {
+          for ( int i = 0; i < 16; i++ ) {
+            M1(i,j) = value_MonomialGate< T >( i + 5*j ) ;
+          }
+        }
+        auto M2 = M1 ;
+        dense.apply( side , op , 4 , M1 , 1 ) ;
+        gate.apply( side , op , 4 , M2 , 1 ) ;
+        check_MonomialGate( V( M1.ptr() , M1.ptr() + 256 ) ,
+                            V( M2.ptr() , M2.ptr() + 256 ) ) ;
+      }
+    }
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_qgates_MonomialGate , float ) {
+  test_qclab_qgates_MonomialGate< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_qgates_MonomialGate , double ) {
+  test_qclab_qgates_MonomialGate< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_qgates_MonomialGate , complex_float ) {
+  test_qclab_qgates_MonomialGate< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_qgates_MonomialGate , complex_double ) {
+  test_qclab_qgates_MonomialGate< std::complex< double > >() ;
+}
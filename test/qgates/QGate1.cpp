@@ -303,6 +303,18 @@ void test_qclab_qgates_QGate1() {
                            qclab::dense::kron( Ytrans , I1 ) ) ) ;
   }
 
+  // matrix2x2
+  {
+    qclab::qgates::PauliX< T >  X( 0 ) ;
+    EXPECT_TRUE( M( X.matrix2x2() ) == X.matrix() ) ;
+    if constexpr ( qclab::is_complex_v< T > ) {
+      qclab::qgates::RotationY< T >  Y( 0 , R(0.3) ) ;
+      EXPECT_TRUE( M( Y.matrix2x2() ) == Y.matrix() ) ;
+      const qclab::qgates::QGate1< T >& G = Y ;
+      EXPECT_TRUE( G.matrix2x2() == Y.matrix2x2() ) ;
+    }
+  }
+
 }
 
 
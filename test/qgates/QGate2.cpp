@@ -465,6 +465,17 @@ void test_qclab_qgates_QGate2() {
                            qclab::dense::kron( YYconjConjTrans , I1 ) ) ) ;
   }
 
+  // qubitPair and matrix4x4
+  {
+    qclab::qgates::RotationXX< T >  XX( 3 , 1 , R(0.3) ) ;
+    const auto qubits = XX.qubitPair() ;
+    EXPECT_EQ( qubits[0] , 1 ) ;
+    EXPECT_EQ( qubits[1] , 3 ) ;
+    EXPECT_TRUE( M( XX.matrix4x4() ) == XX.matrix() ) ;
+    qclab::qgates::RotationYY< T >  YY( 0 , 2 , R(0.3) ) ;
+    EXPECT_TRUE( M( YY.matrix4x4() ) == YY.matrix() ) ;
+  }
+
 }
 
 
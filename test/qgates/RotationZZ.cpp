@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
 
 template <typename T>
 void test_qclab_qgates_RotationZZ() {
@@ -387,6 +388,32 @@ void test_qclab_qgates_RotationZZ() {
     EXPECT_NEAR( R2.theta() , -theta , tol ) ;  // theta
   }
 
+  {
+    // apply: compare with the dense 2-qubit kernel
+    const int n = 6 ;
+    std::vector< T > v0( 1 << n ) ;
+    for ( int i = 0; i < v0.size(); i++ ) {
+      v0[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+    }
+    for ( int q0 = 0; q0 < n; q0++ ) {
+      for ( int q1 = q0 + 1; q1 < n; q1++ ) {
+        const int qubits[] = { q0 , q1 } ;
+        qclab::qgates::RotationZZ< T >  R1( qubits , R(0.7) ) ;
+        qclab::qgates::MatrixGateN< T >  M1( { q0 , q1 } , R1.matrix() ) ;
+        for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                          qclab::Op::ConjTrans } ) {
+          auto v1 = v0 ;
+          auto v2 = v0 ;
+          R1.apply( op , n , v1 ) ;
+          M1.apply( op , n , v2 ) ;
+          for ( int i = 0; i < v0.size(); i++ ) {
+            EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , 10 * tol ) ;
+          }
+        }
+      }
+    }
+  }
+
 }
 
 
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "qclab/sample.hpp"
+#include "qclab/parallel.hpp"
+
+TEST( qclab_sample , Random ) {
+
+  const qclab::Random random( 7 ) ;
+  EXPECT_EQ( random( 3 ) , qclab::Random( 7 )( 3 ) ) ;
+  EXPECT_NE( random( 3 ) , random( 4 ) ) ;
+  EXPECT_NE( random( 3 ) , qclab::Random( 8 )( 3 ) ) ;
+
+  const int n = 100000 ;
+  double mean = 0 ;
+  for ( int k = 0; k < n; k++ ) {
+    const double u = random.uniform( k ) ;
+    EXPECT_GT( u , 0 ) ;
+    EXPECT_LT( u , 1 ) ;
+    mean += u ;
+  }
+  EXPECT_NEAR( mean / n , 0.5 , 5 * std::sqrt( 1.0 / ( 12 * n ) ) ) ;
+
+}
+
+template <typename T>
+void test_qclab_sample() {
+
+  // basis state
+  {
+    std::vector< T > vector( 1 << 5 , T(0) ) ;
+    vector[ 13 ] = T(-1) ;
+    const auto counts = qclab::sample( vector , 1000 ) ;
+    ASSERT_EQ( counts.size() , 1 ) ;
+    EXPECT_EQ( counts[0].first , 13 ) ;
+    EXPECT_EQ( counts[0].second , 1000 ) ;
+    const auto marginal = qclab::sample( vector , 1000 , { 4 , 0 , 1 } ) ;
+    ASSERT_EQ( marginal.size() , 1 ) ;
+    EXPECT_EQ( marginal[0].first , 5 ) ;  // qubits 4, 0, 1 of 01101
+    EXPECT_EQ( qclab::sample( vector , 0 ).size() , 0 ) ;
+    // single qubit
+    const std::vector< T > single = { T(0.6) , T(0.8) } ;
+    const auto counts1 = qclab::sample( single , 10000 ) ;
+    ASSERT_EQ( counts1.size() , 2 ) ;
+    EXPECT_EQ( counts1[0].second + counts1[1].second , 10000 ) ;
+    EXPECT_NEAR( counts1[1].second , 6400 , 5 * std::sqrt( 10000 * 0.16 ) ) ;
+  }
+
+  // distribution of an unnormalized state over several chunks
+  const int n = 16 ;
+  const int64_t nbShots = 200000 ;
+  std::vector< T > vector( 1 << n , T(0) ) ;
+  std::vector< double > prob( 1 << n , 0.0 ) ;
+  double total = 0 ;
+  for ( int i = 0; i < vector.size(); i += 97 ) {
+    vector[i] = T( 1 + ( i % 5 ) ) ;
+    prob[i] = std::norm( vector[i] ) ;
+    total += prob[i] ;
+  }
+  for ( auto& p : prob ) p /= total ;
+
+  const auto counts = qclab::sample( vector , nbShots , {} , 11 ) ;
+  int64_t sum = 0 ;
+  for ( size_t k = 0; k < counts.size(); k++ ) {
+    const auto [ outcome , count ] = counts[k] ;
+    if ( k > 0 ) EXPECT_LT( counts[ k - 1 ].first , outcome ) ;
+    EXPECT_GT( prob[ outcome ] , 0 ) ;
+    sum += count ;
+  }
+  EXPECT_EQ( sum , nbShots ) ;
+
+  // marginal distribution of qubits 3 and 1
+  const auto marginal = qclab::sample( vector , nbShots , { 3 , 1 } , 11 ) ;
+  ASSERT_EQ( marginal.size() , 4 ) ;
+  for ( int k = 0; k < 4; k++ ) EXPECT_EQ( marginal[k].first , k ) ;
+  for ( const auto& [ outcome , count ] : marginal ) {
+    double p = 0 ;
+    for ( int i = 0; i < prob.size(); i++ ) {
+      const int b3 = ( i >> ( n - 4 ) ) & 1 ;
+      const int b1 = ( i >> ( n - 2 ) ) & 1 ;
+      if ( 2 * b3 + b1 == outcome ) p += prob[i] ;
+    }
+    const double sigma = std::sqrt( nbShots * p * ( 1 - p ) ) ;
+    EXPECT_NEAR( count , nbShots * p , 5 * sigma ) ;
+  }
+
+  // marginal counts are consistent with the full counts
+  {
+    const auto many = qclab::sample( vector , nbShots , { 15 , 0 , 14 , 13 ,
+                                     1 , 12 , 2 , 11 , 3 , 10 , 4 , 9 , 5 ,
+                                     8 , 6 , 7 , 15 , 0 , 14 , 13 , 1 } , 11 ) ;
+    int64_t sum = 0 ;
+    for ( size_t k = 0; k < many.size(); k++ ) {
+      if ( k > 0 ) EXPECT_LT( many[ k - 1 ].first , many[k].first ) ;
+      sum += many[k].second ;
+    }
+    EXPECT_EQ( sum , nbShots ) ;
+    EXPECT_EQ( many.size() , counts.size() ) ;
+  }
+  {
+    std::vector< int64_t > reduced( 4 , 0 ) ;
+    for ( const auto& [ outcome , count ] : counts ) {
+      const int b3 = ( outcome >> ( n - 4 ) ) & 1 ;
+      const int b1 = ( outcome >> ( n - 2 ) ) & 1 ;
+      reduced[ 2 * b3 + b1 ] += count ;
+    }
+    for ( const auto& [ outcome , count ] : marginal ) {
+      EXPECT_EQ( reduced[ outcome ] , count ) ;
+    }
+  }
+
+  // reproducible for any number of threads and any layout
+  {
+    const int64_t threshold = qclab::parallel::threshold() ;
+    qclab::parallel::setThreshold( 1 ) ;
+    EXPECT_EQ( qclab::sample( vector , nbShots , {} , 11 ) , counts ) ;
+    qclab::parallel::setThreshold( int64_t(1) << 40 ) ;
+    EXPECT_EQ( qclab::sample( vector , nbShots , {} , 11 ) , counts ) ;
+    qclab::parallel::setThreshold( threshold ) ;
+    EXPECT_NE( qclab::sample( vector , nbShots , {} , 12 ) , counts ) ;
+    if constexpr ( qclab::is_complex_v< T > ) {
+      qclab::StateVector< T > state( vector , qclab::Layout::Split ) ;
+      EXPECT_EQ( qclab::sample( state , nbShots , {} , 11 ) , counts ) ;
+    }
+    qclab::StateVector< T > state( vector ) ;
+    EXPECT_EQ( qclab::sample( state , nbShots , {} , 11 ) , counts ) ;
+  }
+
+}
+
+
+/*
+ * float
+ */
+TEST( qclab_sample , float ) {
+  test_qclab_sample< float >() ;
+}
+
+/*
+ * double
+ */
+TEST( qclab_sample , double ) {
+  test_qclab_sample< double >() ;
+}
+
+/*
+ * complex float
+ */
+TEST( qclab_sample , complex_float ) {
+  test_qclab_sample< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sample , complex_double ) {
+  test_qclab_sample< std::complex< double > >() ;
+}
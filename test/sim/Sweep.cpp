@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "qclab/sim/Sweep.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include <mutex>
+
+template <typename T>
+qclab::QCircuit< T > sweep_circuit( const std::vector< qclab::real_t< T > >&
+                                      thetas ) {
+
+  using H   = qclab::qgates::Hadamard< T > ;
+  using CX  = qclab::qgates::CNOT< T > ;
+  using RX  = qclab::qgates::RotationX< T > ;
+  using RY  = qclab::qgates::RotationY< T > ;
+  using RZZ = qclab::qgates::RotationZZ< T > ;
+  using P   = qclab::qgates::Phase< T > ;
+  using CP  = qclab::qgates::CPhase< T > ;
+  using CRY = qclab::qgates::CRotationY< T > ;
+
+  const int n = 6 ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< H >( i ) ) ;
+  }
+  circuit.push_back( std::make_unique< RX >( 2 , 0.4 , true ) ) ;
+  circuit.push_back( std::make_unique< RY >( 0 , thetas[0] ) ) ;
+  circuit.push_back( std::make_unique< CX >( 0 , 5 ) ) ;
+  auto sub = std::make_unique< qclab::QCircuit< T > >( 3 , 2 ) ;
+  sub->push_back( std::make_unique< RZZ >( 0 , 2 , thetas[1] ) ) ;
+  sub->push_back( std::make_unique< CRY >( 1 , 0 , thetas[2] , 0 ) ) ;
+  circuit.push_back( std::move( sub ) ) ;
+  circuit.push_back( std::make_unique< P >( 3 , thetas[3] ) ) ;
+  circuit.push_back( std::make_unique< RX >( 1 , 0.9 , true ) ) ;
+  circuit.push_back( std::make_unique< CP >( 4 , 1 , thetas[4] ) ) ;
+  return circuit ;
+
+}
+
+template <typename T>
+void test_qclab_sim_Sweep() {
+
+  using R   = qclab::real_t< T > ;
+  using V   = std::vector< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  const std::vector< R > thetas0 = { 0.1 , 0.2 , 0.3 , 0.4 , 0.5 } ;
+  const auto circuit = sweep_circuit< T >( thetas0 ) ;
+  qclab::sim::Sweep< T > sweep( circuit ) ;
+  EXPECT_EQ( sweep.nbQubits() , 6 ) ;
+  EXPECT_EQ( sweep.nbParameters() , 5 ) ;
+  const auto thetas = sweep.parameters() ;
+  for ( int p = 0; p < 5; p++ ) EXPECT_NEAR( thetas[p] , thetas0[p] , tol ) ;
+
+  // parameter sets
+  const int nbSets = 13 ;
+  std::vector< std::vector< R > > parameters( nbSets ) ;
+  for ( int s = 0; s < nbSets; s++ ) {
+    for ( int p = 0; p < 5; p++ ) {
+      parameters[s].push_back( std::sin( 3*s + p ) ) ;
+    }
+  }
+  V initial( 1 << 6 , T(0) ) ;
+  initial[5] = 1 ;
+
+  // reference
+  std::vector< V > ref( nbSets , initial ) ;
+  for ( int s = 0; s < nbSets; s++ ) {
+    sweep_circuit< T >( parameters[s] ).simulate( ref[s] ) ;
+  }
+
+  // simulate
+  std::vector< V > vectors ;
+  sweep.simulate( initial , parameters , vectors ) ;
+  EXPECT_EQ( vectors.size() , nbSets ) ;
+  for ( int s = 0; s < nbSets; s++ ) {
+    for ( int i = 0; i < ( 1 << 6 ); i++ ) {
+      EXPECT_NEAR( std::abs( vectors[s][i] - ref[s][i] ) , 0 , tol ) ;
+    }
+  }
+
+  // run
+  std::vector< V > vectors2( nbSets ) ;
+  std::mutex mutex ;
+  sweep.run( initial , parameters , [&] ( const size_t set , const V& v ) {
+    std::lock_guard< std::mutex > lock( mutex ) ;
+    vectors2[ set ] = v ;
+  } ) ;
+  for ( int s = 0; s < nbSets; s++ ) {
+    for ( int i = 0; i < ( 1 << 6 ); i++ ) {
+      EXPECT_NEAR( std::abs( vectors2[s][i] - ref[s][i] ) , 0 , tol ) ;
+    }
+  }
+
+  // run inside a parallel region
+  std::vector< V > vectors3( nbSets ) ;
+  #pragma omp parallel num_threads( 3 )
+  {
+    #pragma omp single
+    sweep.run( initial , parameters , [&] ( const size_t set , const V& v ) {
+      vectors3[ set ] = v ;
+    } ) ;
+  }
+  for ( int s = 0; s < nbSets; s++ ) {
+    for ( int i = 0; i < ( 1 << 6 ); i++ ) {
+      EXPECT_NEAR( std::abs( vectors3[s][i] - ref[s][i] ) , 0 , tol ) ;
+    }
+  }
+
+  // circuit is not modified
+  const auto thetas2 = sweep.parameters() ;
+  for ( int p = 0; p < 5; p++ ) EXPECT_EQ( thetas2[p] , thetas[p] ) ;
+
+  // unsupported variable gate
+  struct VariableHadamard : public qclab::qgates::Hadamard< T > {
+    VariableHadamard( const int qubit )
+    : qclab::qgates::Hadamard< T >( qubit ) { }
+    bool fixed() const override { return false ; }
+  } ;
+  qclab::QCircuit< T > other( 2 ) ;
+  other.push_back( std::make_unique< VariableHadamard >( 1 ) ) ;
+  EXPECT_THROW( qclab::sim::Sweep< T >{ other } , std::invalid_argument ) ;
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_Sweep , complex_float ) {
+  test_qclab_sim_Sweep< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_Sweep , complex_double ) {
+  test_qclab_sim_Sweep< std::complex< double > >() ;
+}
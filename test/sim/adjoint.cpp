@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/PauliZ.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+
+template <typename T>
+qclab::QCircuit< T > adjoint_circuit( const std::vector< qclab::real_t< T > >&
+                                        thetas ) {
+
+  using namespace qclab::qgates ;
+
+  const int n = 5 ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< Hadamard< T > >( i ) ) ;
+  }
+  circuit.push_back( std::make_unique< RotationX< T > >( 0 , thetas[0] ) ) ;
+  circuit.push_back( std::make_unique< RotationY< T > >( 1 , thetas[1] ) ) ;
+  circuit.push_back( std::make_unique< CNOT< T > >( 1 , 3 ) ) ;
+  circuit.push_back( std::make_unique< RotationZ< T > >( 3 , thetas[2] ) ) ;
+  circuit.push_back( std::make_unique< RotationX< T > >( 4 , 0.3 , true ) ) ;
+  auto sub = std::make_unique< qclab::QCircuit< T > >( 3 , 1 ) ;
+  sub->push_back( std::make_unique< RotationXX< T > >( 0 , 2 , thetas[3] ) ) ;
+  sub->push_back( std::make_unique< RotationYY< T > >( 1 , 2 , thetas[4] ) ) ;
+  sub->push_back( std::make_unique< CRotationX< T > >( 2 , 0 , thetas[5] ) ) ;
+  circuit.push_back( std::move( sub ) ) ;
+  circuit.push_back( std::make_unique< RotationZZ< T > >( 0 , 4 , thetas[6] ) ) ;
+  circuit.push_back( std::make_unique< CRotationY< T > >( 4 , 2 , thetas[7] ,
+                                                          0 ) ) ;
+  circuit.push_back( std::make_unique< CRotationZ< T > >( 0 , 1 ,
+                                                          thetas[8] ) ) ;
+  circuit.push_back( std::make_unique< Phase< T > >( 2 , thetas[9] ) ) ;
+  circuit.push_back( std::make_unique< CPhase< T > >( 3 , 0 , thetas[10] ) ) ;
+  circuit.push_back( std::make_unique< Hadamard< T > >( 2 ) ) ;
+  return circuit ;
+
+}
+
+template <typename T>
+qclab::real_t< T > adjoint_expectation( const qclab::QCircuit< T >& circuit ,
+                                        const qclab::QObject< T >& observable ,
+                                        const std::vector< T >& vector ) {
+
+  auto psi = vector ;
+  circuit.simulate( psi ) ;
+  auto lambda = psi ;
+  observable.apply( qclab::Op::NoTrans , circuit.nbQubits() , lambda ) ;
+  T dot = 0 ;
+  for ( size_t i = 0; i < psi.size(); i++ ) dot += std::conj( psi[i] ) *
+                                                  lambda[i] ;
+  return std::real( dot ) ;
+
+}
+
+template <typename T>
+void test_qclab_sim_adjoint() {
+
+  using R = qclab::real_t< T > ;
+  using V = std::vector< T > ;
+  const R h   = std::is_same_v< R , float > ? 1e-2 : 1e-6 ;
+  const R tol = std::is_same_v< R , float > ? 1e-3 : 1e-8 ;
+
+  std::vector< R > thetas ;
+  for ( int p = 0; p < 11; p++ ) thetas.push_back( std::cos( 2*p + 1 ) ) ;
+  const auto circuit = adjoint_circuit< T >( thetas ) ;
+
+  V vector( 1 << 5 ) ;
+  for ( int i = 0; i < vector.size(); i++ ) {
+    vector[i] = T( std::sin( i + 1 ) , std::cos( 3*i ) ) / R(4) ;
+  }
+
+  // observables: Pauli string and Hermitian matrix
+  qclab::QCircuit< T >  pauli( 5 ) ;
+  pauli.push_back( std::make_unique< qclab::qgates::PauliZ< T > >( 0 ) ) ;
+  pauli.push_back( std::make_unique< qclab::qgates::PauliX< T > >( 2 ) ) ;
+  qclab::dense::SquareMatrix< T > mat( 4 ) ;
+  for ( int j = 0; j < 4; j++ ) {
+    for ( int i = 0; i < 4; i++ ) {
+      mat(i,j) = T( std::cos( i + j ) , std::sin( i - j ) ) ;
+    }
+  }
+  const qclab::qgates::MatrixGateN< T > hermitian( { 1 , 4 } , mat ) ;
+
+  for ( const qclab::QObject< T >* observable :
+        { static_cast< const qclab::QObject< T >* >( &pauli ) ,
+          static_cast< const qclab::QObject< T >* >( &hermitian ) } ) {
+    std::vector< R > grad ;
+    const R e = circuit.gradient( vector , *observable , grad ) ;
+    EXPECT_NEAR( e , adjoint_expectation( circuit , *observable , vector ) ,
+                 tol ) ;
+    ASSERT_EQ( grad.size() , thetas.size() ) ;
+    for ( size_t p = 0; p < thetas.size(); p++ ) {
+      auto thetasP = thetas ;
+      auto thetasM = thetas ;
+      thetasP[p] += h ;
+      thetasM[p] -= h ;
+      const R eP = adjoint_expectation( adjoint_circuit< T >( thetasP ) ,
+                                        *observable , vector ) ;
+      const R eM = adjoint_expectation( adjoint_circuit< T >( thetasM ) ,
+                                        *observable , vector ) ;
+      EXPECT_NEAR( grad[p] , ( eP - eM ) / ( 2 * h ) , tol ) ;
+    }
+  }
+
+  // vector is restored by sim::adjoint
+  {
+    qclab::sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    auto work = vector ;
+    std::vector< R > grad ;
+    qclab::sim::adjoint( schedule , 5 , pauli , work , grad ) ;
+    for ( int i = 0; i < vector.size(); i++ ) {
+      EXPECT_NEAR( std::abs( work[i] - vector[i] ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_adjoint , complex_float ) {
+  test_qclab_sim_adjoint< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_adjoint , complex_double ) {
+  test_qclab_sim_adjoint< std::complex< double > >() ;
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/MCX.hpp"
+
+template <typename T>
+void check_batch( const std::vector< T >& v1 , const std::vector< T >& v2 ) {
+
+  using R   = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( size_t i = 0; i < v1.size(); ++i ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_sim_batch() {
+
+  using H   = qclab::qgates::Hadamard< T > ;
+  using RX  = qclab::qgates::RotationX< T > ;
+  using CX  = qclab::qgates::CNOT< T > ;
+  using CP  = qclab::qgates::CPhase< T > ;
+  using SW  = qclab::qgates::SWAP< T > ;
+  using MCX = qclab::qgates::MCX< T > ;
+  using V   = std::vector< T > ;
+
+  EXPECT_EQ( qclab::sim::batchQubits( 1 ) , 0 ) ;
+  EXPECT_EQ( qclab::sim::batchQubits( 2 ) , 1 ) ;
+  EXPECT_EQ( qclab::sim::batchQubits( 5 ) , 3 ) ;
+  EXPECT_EQ( qclab::sim::batchQubits( 8 ) , 3 ) ;
+
+  const int n = 7 ;
+  const int nb = 5 ;
+  std::vector< V > vectors( nb , V( 1 << n ) ) ;
+  for ( int b = 0; b < nb; b++ ) {
+    for ( int i = 0; i < ( 1 << n ); i++ ) {
+      vectors[b][i] = T( std::cos( i + 5*b ) , std::sin( 2*i - b ) ) ;
+    }
+  }
+
+  // pack and unpack
+  {
+    V batch ;
+    qclab::sim::pack( n , nb , vectors.data() , batch ) ;
+    EXPECT_EQ( batch.size() , 8 << n ) ;
+    EXPECT_EQ( batch[ 8*3 + 2 ] , vectors[2][3] ) ;
+    EXPECT_EQ( batch[ 8*3 + 6 ] , T(0) ) ;
+    std::vector< V > vectors2( nb ) ;
+    qclab::sim::unpack( n , batch , nb , vectors2.data() ) ;
+    for ( int b = 0; b < nb; b++ ) {
+      EXPECT_TRUE( vectors2[b] == vectors[b] ) ;
+    }
+  }
+
+  // circuit
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< H >( i ) ) ;
+    circuit.push_back( std::make_unique< CP >( i , ( i + 3 ) % n ,
+                                               0.2 * i + 0.1 ) ) ;
+  }
+  auto sub = std::make_unique< qclab::QCircuit< T > >( 3 , n - 3 ) ;
+  sub->push_back( std::make_unique< RX >( 0 , 0.3 ) ) ;
+  sub->push_back( std::make_unique< CX >( 2 , 0 ) ) ;
+  sub->push_back( std::make_unique< SW >( 1 , 2 ) ) ;
+  circuit.push_back( std::move( sub ) ) ;
+  circuit.push_back( std::make_unique< MCX >( std::vector< int >( { 0 , 4 } ) ,
+                                              2 ) ) ;
+  circuit.push_back( std::make_unique< RX >( 6 , 0.9 ) ) ;
+
+  // reference: vector by vector
+  std::vector< V > ref = vectors ;
+  for ( auto& vector : ref ) circuit.simulate( vector ) ;
+
+  // simulate
+  {
+    auto vectors2 = vectors ;
+    circuit.simulate( vectors2 ) ;
+    for ( int b = 0; b < nb; b++ ) check_batch( ref[b] , vectors2[b] ) ;
+  }
+
+  // simulate with options
+  for ( int blockQubits : { 0 , 5 , 8 } ) {
+    for ( int window : { 0 , 4 } ) {
+      qclab::sim::Options options ;
+      options.fuseDiagonal = true ;
+      options.fuseK = 2 ;
+      options.blockQubits = blockQubits ;
+      options.remapWindow = window ;
+      auto vectors2 = vectors ;
+      circuit.simulate( vectors2 , options ) ;
+      for ( int b = 0; b < nb; b++ ) check_batch( ref[b] , vectors2[b] ) ;
+    }
+  }
+
+  // simulate: batches split at sim::maxBatchQubits
+  {
+    const int m = qclab::sim::maxBatchQubits - 2 ;
+    qclab::QCircuit< T >  circuit2( m ) ;
+    for ( int i = 0; i < m; i++ ) {
+      circuit2.push_back( std::make_unique< H >( i ) ) ;
+      circuit2.push_back( std::make_unique< CP >( i , ( i + 1 ) % m , 0.4 ) ) ;
+    }
+    std::vector< V > vectors2( nb , V( 1 << m ) ) ;
+    for ( int b = 0; b < nb; b++ ) {
+      for ( int i = 0; i < ( 1 << m ); i++ ) {
+        vectors2[b][i] = T( std::sin( 3*i - b ) , std::cos( i + 2*b ) ) ;
+      }
+    }
+    auto ref2 = vectors2 ;
+    for ( auto& vector : ref2 ) circuit2.simulate( vector ) ;
+    circuit2.simulate( vectors2 ) ;
+    for ( int b = 0; b < nb; b++ ) check_batch( ref2[b] , vectors2[b] ) ;
+  }
+
+  // matrix: columns are the simulated unit vectors
+  {
+    const auto mat = circuit.matrix() ;
+    for ( int j = 0; j < ( 1 << n ); j += 9 ) {
+      V e( 1 << n , T(0) ) ;
+      e[j] = 1 ;
+      circuit.simulate( e ) ;
+      V col( mat.ptr() + ( j << n ) , mat.ptr() + ( ( j + 1 ) << n ) ) ;
+      check_batch( e , col ) ;
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_batch , complex_float ) {
+  test_qclab_sim_batch< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_batch , complex_double ) {
+  test_qclab_sim_batch< std::complex< double > >() ;
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/SWAP.hpp"
+
+template <typename T>
+void check_blocking( const std::vector< T >& v1 , const std::vector< T >& v2 ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  assert( v1.size() == v2.size() ) ;
+  for ( size_t i = 0; i < v1.size(); ++i ) {
+    EXPECT_NEAR( std::real( v1[i] ) , std::real( v2[i] ) , tol ) ;
+    EXPECT_NEAR( std::imag( v1[i] ) , std::imag( v2[i] ) , tol ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_sim_blocking() {
+
+  using R  = qclab::real_t< T > ;
+  using H  = qclab::qgates::Hadamard< T > ;
+  using RX = qclab::qgates::RotationX< T > ;
+  using CX = qclab::qgates::CNOT< T > ;
+  using CP = qclab::qgates::CPhase< T > ;
+  using SW = qclab::qgates::SWAP< T > ;
+
+  const int n = 7 ;
+
+  // QFT circuit
+  const R pi = 4 * std::atan(1) ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< H >( i ) ) ;
+    for ( int j = 2; j <= n-i; j++ ) {
+      const int control = j + i - 1 ;
+      const R theta = -2*pi / ( 1 << j ) ;
+      circuit.push_back( std::make_unique< CP >( control , i , theta ) ) ;
+    }
+  }
+  for ( int i = 0; i < n/2; i++ ) {
+    circuit.push_back( std::make_unique< SW >( i , n - i - 1 ) ) ;
+  }
+
+  // sub-circuit with offset on the least significant qubits
+  auto sub = std::make_unique< qclab::QCircuit< T > >( 3 , n - 3 ) ;
+  sub->push_back( std::make_unique< RX >( 0 , 0.3 ) ) ;
+  sub->push_back( std::make_unique< CX >( 2 , 0 ) ) ;
+  sub->push_back( std::make_unique< RX >( 1 , 0.7 ) ) ;
+  circuit.push_back( std::move( sub ) ) ;
+  circuit.push_back( std::make_unique< CX >( 0 , n - 1 ) ) ;
+
+  // isLocal
+  qclab::sim::Schedule< T >  schedule ;
+  circuit.flatten( schedule ) ;
+  const auto& last = schedule[ schedule.size() - 1 ] ;
+  EXPECT_FALSE( qclab::sim::isLocal< T >( last , n , n - 1 ) ) ;
+  const auto& rx = schedule[ schedule.size() - 2 ] ;
+  EXPECT_TRUE(  qclab::sim::isLocal< T >( rx , n , 3 ) ) ;
+  EXPECT_FALSE( qclab::sim::isLocal< T >( rx , n , 1 ) ) ;
+
+  // simulate
+  std::vector< T > vec0( 1 << n ) ;
+  for ( int i = 0; i < vec0.size(); i++ ) {
+    vec0[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+  }
+  auto vec1 = vec0 ;
+  circuit.simulate( vec1 ) ;
+  for ( int blockQubits = 0; blockQubits <= n; blockQubits++ ) {
+    for ( int fuseK = 0; fuseK <= 3; fuseK += 3 ) {
+      auto vec2 = vec0 ;
+      qclab::sim::Options options ;
+      options.fuseK = fuseK ;
+      options.blockQubits = blockQubits ;
+      circuit.simulate( vec2 , options ) ;
+      check_blocking( vec1 , vec2 ) ;
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_blocking , complex_float ) {
+  test_qclab_sim_blocking< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_blocking , complex_double ) {
+  test_qclab_sim_blocking< std::complex< double > >() ;
+}
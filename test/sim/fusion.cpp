@@ -0,0 +1,497 @@
+#include <gtest/gtest.h>
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/Phase.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/PauliZ.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/CRotationZ.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/PauliY.hpp"
+#include "qclab/qgates/Phase45.hpp"
+#include "qclab/qgates/Phase90.hpp"
+#include "qclab/qgates/CY.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/iSWAP.hpp"
+
+template <typename T>
+void check_fusion( const std::vector< T >& v1 , const std::vector< T >& v2 ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  assert( v1.size() == v2.size() ) ;
+  for ( size_t i = 0; i < v1.size(); ++i ) {
+    EXPECT_NEAR( std::real( v1[i] ) , std::real( v2[i] ) , tol ) ;
+    EXPECT_NEAR( std::imag( v1[i] ) , std::imag( v2[i] ) , tol ) ;
+  }
+
+}
+
+template <typename T>
+std::vector< T > init_fusion( const int nbQubits ) {
+  std::vector< T > vec( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec.size(); i++ ) {
+    vec[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+  }
+  return vec ;
+}
+
+template <typename T>
+void test_qclab_sim_fuse1() {
+
+  using H  = qclab::qgates::Hadamard< T > ;
+  using X  = qclab::qgates::PauliX< T > ;
+  using RX = qclab::qgates::RotationX< T > ;
+  using RZ = qclab::qgates::RotationZ< T > ;
+  using P  = qclab::qgates::Phase< T > ;
+  using CX = qclab::qgates::CNOT< T > ;
+
+  {
+    // only 1-qubit gates
+    qclab::QCircuit< T >  circuit( 3 ) ;
+    circuit.push_back( std::make_unique< H  >( 0 ) ) ;
+    circuit.push_back( std::make_unique< RX >( 1 , 0.3 ) ) ;
+    circuit.push_back( std::make_unique< RZ >( 0 , 0.7 ) ) ;
+    circuit.push_back( std::make_unique< P  >( 0 , 1.1 ) ) ;
+    circuit.push_back( std::make_unique< X  >( 2 ) ) ;
+    circuit.push_back( std::make_unique< RZ >( 1 , -0.4 ) ) ;
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    EXPECT_EQ( schedule.size() , 6 ) ;
+    qclab::sim::fuse1( schedule ) ;
+    EXPECT_EQ( schedule.size() , 3 ) ;
+    EXPECT_EQ( schedule[0].object->qubit() , 0 ) ;
+    EXPECT_EQ( schedule[1].object->qubit() , 1 ) ;
+    EXPECT_EQ( schedule[2].object->qubit() , 2 ) ;
+    EXPECT_TRUE( *schedule[2].object == X( 2 ) ) ;  // single gate is kept
+
+    auto vec1 = init_fusion< T >( 3 ) ;
+    auto vec2 = vec1 ;
+    circuit.simulate( vec1 ) ;
+    qclab::sim::Options options ;
+    options.fuse1 = true ;
+    circuit.simulate( vec2 , options ) ;
+    check_fusion( vec1 , vec2 ) ;
+  }
+
+  {
+    // 1-qubit gates interleaved with CNOTs
+    qclab::QCircuit< T >  circuit( 3 ) ;
+    circuit.push_back( std::make_unique< H  >( 0 ) ) ;
+    circuit.push_back( std::make_unique< RX >( 0 , 0.3 ) ) ;
+    circuit.push_back( std::make_unique< RX >( 2 , 0.5 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 0 , 1 ) ) ;
+    circuit.push_back( std::make_unique< RZ >( 0 , 0.7 ) ) ;
+    circuit.push_back( std::make_unique< RZ >( 2 , 0.9 ) ) ;
+    circuit.push_back( std::make_unique< RX >( 1 , 0.2 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 1 , 2 ) ) ;
+    circuit.push_back( std::make_unique< RX >( 2 , 0.1 ) ) ;
+    circuit.push_back( std::make_unique< P  >( 0 , 0.6 ) ) ;
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuse1( schedule ) ;
+    EXPECT_EQ( schedule.size() , 7 ) ;
+
+    auto vec1 = init_fusion< T >( 3 ) ;
+    auto vec2 = vec1 ;
+    circuit.simulate( vec1 ) ;
+    qclab::sim::Options options ;
+    options.fuse1 = true ;
+    circuit.simulate( vec2 , options ) ;
+    check_fusion( vec1 , vec2 ) ;
+  }
+
+  {
+    // sub-circuit with offset
+    auto sub = std::make_unique< qclab::QCircuit< T > >( 2 , 1 ) ;
+    sub->push_back( std::make_unique< RX >( 0 , 0.3 ) ) ;
+    sub->push_back( std::make_unique< CX >( 0 , 1 ) ) ;
+    sub->push_back( std::make_unique< RZ >( 1 , 0.4 ) ) ;
+    qclab::QCircuit< T >  circuit( 4 ) ;
+    circuit.push_back( std::make_unique< H  >( 1 ) ) ;
+    circuit.push_back( std::move( sub ) ) ;
+    circuit.push_back( std::make_unique< RX >( 2 , 0.8 ) ) ;
+    circuit.push_back( std::make_unique< H  >( 3 ) ) ;
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    EXPECT_EQ( schedule.size() , 6 ) ;
+    EXPECT_EQ( schedule[1].offset , 1 ) ;
+    qclab::sim::fuse1( schedule ) ;
+    EXPECT_EQ( schedule.size() , 4 ) ;
+
+    auto vec1 = init_fusion< T >( 4 ) ;
+    auto vec2 = vec1 ;
+    circuit.simulate( vec1 ) ;
+    qclab::sim::Options options ;
+    options.fuse1 = true ;
+    circuit.simulate( vec2 , options ) ;
+    check_fusion( vec1 , vec2 ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_sim_fuseK() {
+
+  using H  = qclab::qgates::Hadamard< T > ;
+  using RX = qclab::qgates::RotationX< T > ;
+  using RZ = qclab::qgates::RotationZ< T > ;
+  using P  = qclab::qgates::Phase< T > ;
+  using CX = qclab::qgates::CNOT< T > ;
+  using MN = qclab::qgates::MatrixGateN< T > ;
+
+  {
+    // 3-qubit circuit
+    qclab::QCircuit< T >  circuit( 3 ) ;
+    circuit.push_back( std::make_unique< H  >( 0 ) ) ;
+    circuit.push_back( std::make_unique< RX >( 1 , 0.3 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 0 , 1 ) ) ;
+    circuit.push_back( std::make_unique< RZ >( 2 , 0.9 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 2 , 1 ) ) ;
+    circuit.push_back( std::make_unique< P  >( 0 , 0.6 ) ) ;
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuseK( schedule , 3 ) ;
+    EXPECT_EQ( schedule.size() , 1 ) ;
+    EXPECT_EQ( schedule[0].object->nbQubits() , 3 ) ;
+
+    schedule = qclab::sim::Schedule< T >() ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuseK( schedule , 2 ) ;
+    EXPECT_EQ( schedule.size() , 4 ) ;  // {0,1} , {1,2} , {2} , {0}
+
+    for ( int k = 1; k <= 3; k++ ) {
+      auto vec1 = init_fusion< T >( 3 ) ;
+      auto vec2 = vec1 ;
+      circuit.simulate( vec1 ) ;
+      qclab::sim::Options options ;
+      options.fuseK = k ;
+      circuit.simulate( vec2 , options ) ;
+      check_fusion( vec1 , vec2 ) ;
+    }
+  }
+
+  {
+    // sub-circuits with offset and a gate larger than the blocks
+    auto sub = std::make_unique< qclab::QCircuit< T > >( 3 , 2 ) ;
+    sub->push_back( std::make_unique< RX >( 0 , 0.3 ) ) ;
+    sub->push_back( std::make_unique< CX >( 0 , 2 ) ) ;
+    sub->push_back( std::make_unique< RZ >( 1 , 0.4 ) ) ;
+    qclab::dense::SquareMatrix< T > mat( 8 ) ;
+    for ( int j = 0; j < 8; j++ ) {
+      for ( int i = 0; i < 8; i++ ) {
+        mat(i,j) = T( std::cos( i + 3*j ) , std::sin( 2*i + j ) ) ;
+      }
+    }
+    qclab::QCircuit< T >  circuit( 6 ) ;
+    circuit.push_back( std::make_unique< H  >( 1 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 1 , 3 ) ) ;
+    circuit.push_back( std::move( sub ) ) ;
+    circuit.push_back( std::make_unique< MN >( std::vector< int >( {0,2,5} ) ,
+                                               mat ) ) ;
+    circuit.push_back( std::make_unique< RX >( 2 , 0.8 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 5 , 0 ) ) ;
+    circuit.push_back( std::make_unique< H  >( 3 ) ) ;
+    circuit.push_back( std::make_unique< CX >( 3 , 4 ) ) ;
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    EXPECT_EQ( schedule.size() , 10 ) ;
+    qclab::sim::fuseK( schedule , 2 ) ;
+    int large = 0 ;
+    for ( const auto& item : schedule ) {
+      EXPECT_LE( item.object->nbQubits() , 3 ) ;
+      if ( item.object->nbQubits() == 3 ) ++large ;
+    }
+    EXPECT_EQ( large , 1 ) ;  // gate on 3 qubits is passed through
+
+    for ( int k = 2; k <= MN::maxQubits; k++ ) {
+      auto vec1 = init_fusion< T >( 6 ) ;
+      auto vec2 = vec1 ;
+      circuit.simulate( vec1 ) ;
+      qclab::sim::Options options ;
+      options.fuse1 = ( k % 2 == 0 ) ;
+      options.fuseK = k ;
+      circuit.simulate( vec2 , options ) ;
+      check_fusion( vec1 , vec2 ) ;
+    }
+  }
+
+}
+template <typename T>
+void test_qclab_sim_fuseDiagonal() {
+
+  using R   = qclab::real_t< T > ;
+  using H   = qclab::qgates::Hadamard< T > ;
+  using Z   = qclab::qgates::PauliZ< T > ;
+  using RZ  = qclab::qgates::RotationZ< T > ;
+  using P   = qclab::qgates::Phase< T > ;
+  using CX  = qclab::qgates::CNOT< T > ;
+  using CZ  = qclab::qgates::CZ< T > ;
+  using CP  = qclab::qgates::CPhase< T > ;
+  using CRZ = qclab::qgates::CRotationZ< T > ;
+  using RZZ = qclab::qgates::RotationZZ< T > ;
+  using D   = qclab::qgates::DiagonalGate< T > ;
+
+  {
+    // diagonal gates interleaved with gates on other qubits
+    qclab::QCircuit< T >  circuit( 4 ) ;
+    circuit.push_back( std::make_unique< H   >( 0 ) ) ;
+    circuit.push_back( std::make_unique< RZ  >( 1 , 0.3 ) ) ;
+    circuit.push_back( std::make_unique< CP  >( 1 , 2 , 0.7 ) ) ;
+    circuit.push_back( std::make_unique< H   >( 0 ) ) ;  // moved to front
+    circuit.push_back( std::make_unique< CZ  >( 2 , 3 ) ) ;
+    circuit.push_back( std::make_unique< CRZ >( 3 , 1 , -0.4 ) ) ;
+    circuit.push_back( std::make_unique< H   >( 2 ) ) ;  // ends run
+    circuit.push_back( std::make_unique< P   >( 0 , 1.1 ) ) ;
+    const int qubits[] = { 1 , 3 } ;
+    circuit.push_back( std::make_unique< RZZ >( qubits , 0.9 ) ) ;
+    circuit.push_back( std::make_unique< Z   >( 2 ) ) ;
+    circuit.push_back( std::make_unique< CX  >( 0 , 1 ) ) ;  // ends run
+    circuit.push_back( std::make_unique< Z   >( 3 ) ) ;      // single gate
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    EXPECT_EQ( schedule.size() , 12 ) ;
+    qclab::sim::fuseDiagonal( schedule ) ;
+    EXPECT_EQ( schedule.size() , 7 ) ;
+    EXPECT_TRUE( *schedule[0].object == H( 0 ) ) ;
+    EXPECT_TRUE( *schedule[1].object == H( 0 ) ) ;
+    EXPECT_TRUE( dynamic_cast< const D* >( schedule[2].object ) ) ;
+    EXPECT_EQ( schedule[2].object->nbQubits() , 3 ) ;
+    EXPECT_TRUE( *schedule[3].object == H( 2 ) ) ;
+    EXPECT_TRUE( dynamic_cast< const D* >( schedule[4].object ) ) ;
+    EXPECT_EQ( schedule[4].object->nbQubits() , 4 ) ;
+    EXPECT_TRUE( *schedule[5].object == CX( 0 , 1 ) ) ;
+    EXPECT_TRUE( *schedule[6].object == Z( 3 ) ) ;  // single gate is kept
+
+    auto vec1 = init_fusion< T >( 4 ) ;
+    auto vec2 = vec1 ;
+    circuit.simulate( vec1 ) ;
+    qclab::sim::Options options ;
+    options.fuseDiagonal = true ;
+    circuit.simulate( vec2 , options ) ;
+    check_fusion( vec1 , vec2 ) ;
+  }
+
+  {
+    // QFT-like circuit with a CPhase ladder, combined with other passes
+    const int n = 12 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int i = 0; i < n; i++ ) {
+      circuit.push_back( std::make_unique< H >( i ) ) ;
+      for ( int j = i + 1; j < n; j++ ) {
+        circuit.push_back( std::make_unique< CP >( j , i , R(1) / ( j - i ) ) );
+      }
+    }
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuseDiagonal( schedule ) ;
+    EXPECT_EQ( schedule.size() , 2 * n - 1 ) ;
+
+    auto vec1 = init_fusion< T >( n ) ;
+    circuit.simulate( vec1 ) ;
+    for ( int level = 0; level < 4; level++ ) {
+      qclab::sim::Options options ;
+      options.fuseDiagonal = true ;
+      options.fuse1 = ( level == 1 ) ;
+      options.fuseK = ( level == 2 ) ? 4 : 0 ;
+      options.blockQubits = ( level == 3 ) ? 5 : 0 ;
+      auto vec2 = init_fusion< T >( n ) ;
+      circuit.simulate( vec2 , options ) ;
+      check_fusion( vec1 , vec2 ) ;
+    }
+  }
+
+}
+
+
+template <typename T>
+void test_qclab_sim_fuseMonomial() {
+
+  using R   = qclab::real_t< T > ;
+  using H   = qclab::qgates::Hadamard< T > ;
+  using X   = qclab::qgates::PauliX< T > ;
+  using Y   = qclab::qgates::PauliY< T > ;
+  using Z   = qclab::qgates::PauliZ< T > ;
+  using S   = qclab::qgates::Phase90< T > ;
+  using TT  = qclab::qgates::Phase45< T > ;
+  using RX  = qclab::qgates::RotationX< T > ;
+  using CX  = qclab::qgates::CNOT< T > ;
+  using CY  = qclab::qgates::CY< T > ;
+  using CZ  = qclab::qgates::CZ< T > ;
+  using CP  = qclab::qgates::CPhase< T > ;
+  using SW  = qclab::qgates::SWAP< T > ;
+  using iSW = qclab::qgates::iSWAP< T > ;
+  using M   = qclab::qgates::MonomialGate< T > ;
+
+  // isMonomial
+  EXPECT_TRUE( qclab::sim::isMonomial( Y( 0 ) ) ) ;
+  EXPECT_TRUE( qclab::sim::isMonomial( CY( 0 , 1 ) ) ) ;
+  EXPECT_TRUE( qclab::sim::isMonomial( iSW( 0 , 1 ) ) ) ;
+  EXPECT_TRUE( qclab::sim::isMonomial( CZ( 0 , 1 ) ) ) ;
+  EXPECT_TRUE( qclab::sim::isMonomial( CP( 0 , 1 , 0.3 ) ) ) ;
+  EXPECT_FALSE( qclab::sim::isMonomial( H( 0 ) ) ) ;
+  EXPECT_FALSE( qclab::sim::isMonomial( RX( 0 , 0.3 ) ) ) ;
+
+  {
+    // monomial gates interleaved with gates on other qubits
+    qclab::QCircuit< T >  circuit( 5 ) ;
+    circuit.push_back( std::make_unique< H   >( 0 ) ) ;
+    circuit.push_back( std::make_unique< X   >( 1 ) ) ;
+    circuit.push_back( std::make_unique< CY  >( 1 , 3 , 0 ) ) ;
+    circuit.push_back( std::make_unique< H   >( 0 ) ) ;  // moved to front
+    circuit.push_back( std::make_unique< iSW >( 2 , 3 ) ) ;
+    circuit.push_back( std::make_unique< S   >( 2 ) ) ;
+    circuit.push_back( std::make_unique< CX  >( 3 , 1 ) ) ;
+    circuit.push_back( std::make_unique< H   >( 2 ) ) ;  // ends run
+    circuit.push_back( std::make_unique< TT  >( 0 ) ) ;
+    circuit.push_back( std::make_unique< SW  >( 0 , 4 ) ) ;
+    circuit.push_back( std::make_unique< CY  >( 1 , 4 ) ) ;
+    circuit.push_back( std::make_unique< RX  >( 1 , 0.2 ) ) ;  // ends run
+    circuit.push_back( std::make_unique< Z   >( 3 ) ) ;  // single permutation
+    circuit.push_back( std::make_unique< X   >( 4 ) ) ;
+
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    EXPECT_EQ( schedule.size() , 14 ) ;
+    qclab::sim::fuseMonomial( schedule ) ;
+    EXPECT_EQ( schedule.size() , 8 ) ;
+    EXPECT_TRUE( *schedule[0].object == H( 0 ) ) ;
+    EXPECT_TRUE( *schedule[1].object == H( 0 ) ) ;
+    EXPECT_TRUE( dynamic_cast< const M* >( schedule[2].object ) ) ;
+    EXPECT_EQ( schedule[2].object->nbQubits() , 3 ) ;
+    EXPECT_TRUE( *schedule[3].object == H( 2 ) ) ;
+    EXPECT_TRUE( dynamic_cast< const M* >( schedule[4].object ) ) ;
+    EXPECT_EQ( schedule[4].object->nbQubits() , 3 ) ;
+    EXPECT_TRUE( *schedule[5].object == RX( 1 , 0.2 ) ) ;
+    EXPECT_TRUE( *schedule[6].object == Z( 3 ) ) ;  // gates are kept
+    EXPECT_TRUE( *schedule[7].object == X( 4 ) ) ;
+
+    auto vec1 = init_fusion< T >( 5 ) ;
+    auto vec2 = vec1 ;
+    circuit.simulate( vec1 ) ;
+    qclab::sim::Options options ;
+    options.fuseMonomial = true ;
+    circuit.simulate( vec2 , options ) ;
+    check_fusion( vec1 , vec2 ) ;
+  }
+
+  {
+    // QFT with its swap network and CNOT layers, combined with other passes
+    const int n = 16 ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int i = 0; i < n; i++ ) {
+      circuit.push_back( std::make_unique< H >( i ) ) ;
+      for ( int j = i + 1; j < n; j++ ) {
+        circuit.push_back( std::make_unique< CP >( j , i , R(1) / ( j - i ) ) );
+      }
+    }
+    for ( int i = 0; i < n/2; i++ ) {
+      circuit.push_back( std::make_unique< SW >( i , n - i - 1 ) ) ;
+    }
+    for ( int i = 0; i < n - 1; i += 2 ) {
+      circuit.push_back( std::make_unique< CX >( i , i + 1 ) ) ;
+    }
+
+    // the swap network and the CNOT layer need 3 monomial gates
+    qclab::sim::Schedule< T >  schedule ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuseDiagonal( schedule ) ;
+    const int size = schedule.size() ;
+    qclab::sim::fuseMonomial( schedule ) ;
+    EXPECT_EQ( schedule.size() , size - n/2 - n/2 + 3 ) ;
+
+    auto vec0 = init_fusion< T >( n ) ;
+    for ( auto& v : vec0 ) v /= R( 1 << n/2 ) ;
+    auto vec1 = vec0 ;
+    circuit.simulate( vec1 ) ;
+    for ( int level = 0; level < 4; level++ ) {
+      qclab::sim::Options options ;
+      options.fuseDiagonal = ( level != 1 ) ;
+      options.fuseMonomial = true ;
+      options.fuse1 = ( level == 1 ) ;
+      options.fuseK = ( level == 2 ) ? 4 : 0 ;
+      options.blockQubits = ( level == 3 ) ? 12 : 0 ;
+      auto vec2 = vec0 ;
+      circuit.simulate( vec2 , options ) ;
+      check_fusion( vec1 , vec2 ) ;
+      // state vector
+      qclab::StateVector< T > state( vec0 , qclab::Layout::Split ) ;
+      circuit.simulate( state , options ) ;
+      check_fusion( vec1 , state.vector() ) ;
+    }
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_fuse1 , complex_float ) {
+  test_qclab_sim_fuse1< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_fuse1 , complex_double ) {
+  test_qclab_sim_fuse1< std::complex< double > >() ;
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_fuseK , complex_float ) {
+  test_qclab_sim_fuseK< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_fuseK , complex_double ) {
+  test_qclab_sim_fuseK< std::complex< double > >() ;
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_fuseDiagonal , complex_float ) {
+  test_qclab_sim_fuseDiagonal< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_fuseDiagonal , complex_double ) {
+  test_qclab_sim_fuseDiagonal< std::complex< double > >() ;
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_fuseMonomial , complex_float ) {
+  test_qclab_sim_fuseMonomial< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_fuseMonomial , complex_double ) {
+  test_qclab_sim_fuseMonomial< std::complex< double > >() ;
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include "qclab/QCircuit.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/CNOT.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/PauliX.hpp"
+#include "qclab/qgates/CZ.hpp"
+#include "qclab/qgates/MCX.hpp"
+#include "qclab/qgates/MCSWAP.hpp"
+
+template <typename T>
+void check_remap( const std::vector< T >& v1 , const std::vector< T >& v2 ) {
+
+  using R   = qclab::real_t< T > ;
+  const R tol = 100 * std::numeric_limits< R >::epsilon() ;
+
+  EXPECT_EQ( v1.size() , v2.size() ) ;
+  for ( size_t i = 0; i < v1.size(); ++i ) {
+    EXPECT_NEAR( std::abs( v1[i] - v2[i] ) , 0 , tol ) ;
+  }
+
+}
+
+template <typename T>
+void test_qclab_sim_remap() {
+
+  using R   = qclab::real_t< T > ;
+  using H   = qclab::qgates::Hadamard< T > ;
+  using RX  = qclab::qgates::RotationX< T > ;
+  using RZ  = qclab::qgates::RotationZ< T > ;
+  using CX  = qclab::qgates::CNOT< T > ;
+  using CP  = qclab::qgates::CPhase< T > ;
+  using SW  = qclab::qgates::SWAP< T > ;
+  using MN  = qclab::qgates::MatrixGateN< T > ;
+  using CRY = qclab::qgates::CRotationY< T > ;
+  using RZZ = qclab::qgates::RotationZZ< T > ;
+
+  const int n = 8 ;
+  std::vector< T > vec0( 1 << n ) ;
+  for ( int i = 0; i < vec0.size(); i++ ) {
+    vec0[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+  }
+
+  // swapQubits: same result as SWAP gates
+  {
+    auto vec1 = vec0 ;
+    auto vec2 = vec0 ;
+    const std::vector< std::pair< int , int > > pairs = { { 0 , 6 } ,
+                                                          { 5 , 1 } ,
+                                                          { 2 , 7 } } ;
+    for ( const auto& [ p , q ] : pairs ) {
+      SW( p , q ).apply( qclab::Op::NoTrans , n , vec1 ) ;
+    }
+    qclab::sim::swapQubits( n , pairs , vec2 ) ;
+    check_remap( vec1 , vec2 ) ;
+  }
+
+  // unpermute: inverse of a sequence of swaps
+  {
+    auto vec1 = vec0 ;
+    std::vector< int > perm( n ) ;
+    std::iota( perm.begin() , perm.end() , 0 ) ;
+    const std::pair< int , int > swaps[] = { { 0 , 7 } , { 3 , 7 } ,
+                                             { 1 , 2 } , { 4 , 0 } } ;
+    for ( const auto& [ a , b ] : swaps ) {
+      qclab::sim::swapQubits( n , { { a , b } } , vec1 ) ;
+      for ( auto& p : perm ) {
+        if ( p == a ) { p = b ; } else if ( p == b ) { p = a ; }
+      }
+    }
+    qclab::sim::unpermute( n , vec1 , perm ) ;
+    for ( int q = 0; q < n; q++ ) EXPECT_EQ( perm[q] , q ) ;
+    check_remap( vec0 , vec1 ) ;
+  }
+
+  // remap: relabeled items act on the physical qubits
+  {
+    const std::vector< int > perm = { 7 , 6 , 5 , 4 , 3 , 2 , 1 , 0 } ;
+    qclab::dense::SquareMatrix< T > mat( 8 ) ;
+    for ( int j = 0; j < 8; j++ ) {
+      for ( int i = 0; i < 8; i++ ) {
+        mat(i,j) = T( std::cos( i + 3*j ) , std::sin( 2*i + j ) ) ;
+      }
+    }
+    qclab::QCircuit< T >  circuit( n ) ;
+    circuit.push_back( std::make_unique< CX >( 1 , 6 ) ) ;
+    circuit.push_back( std::make_unique< MN >( std::vector< int >( { 0 , 2 ,
+                                                                 5 } ) ,
+                                               mat ) ) ;
+    circuit.push_back( std::make_unique< RX >( 3 , R(0.4) ) ) ;
+    circuit.push_back( std::make_unique< CP >( 2 , 4 , R(0.9) ) ) ;
+    circuit.push_back( std::make_unique< RZ >( 7 , R(0.3) ) ) ;
+    circuit.push_back( std::make_unique< CRY >( 5 , 1 , R(0.6) , 0 ) ) ;
+    circuit.push_back( std::make_unique< RZZ >( 0 , 3 , R(0.8) ) ) ;
+    circuit.push_back( std::make_unique< SW >( 2 , 6 ) ) ;
+    qclab::sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuseDiagonal( schedule ) ;
+    // reference: permute, apply relabeled items, unpermute
+    auto vec1 = vec0 ;
+    circuit.simulate( vec1 ) ;
+    auto vec2 = vec0 ;
+    for ( int q = 0; q < n/2; q++ ) {
+      qclab::sim::swapQubits( n , { { q , n - q - 1 } } , vec2 ) ;
+    }
+    qclab::sim::Schedule< T > relabeled ;
+    for ( const auto& item : schedule ) {
+      const auto r = qclab::sim::remap( item , perm , relabeled ) ;
+      ASSERT_NE( r.object , nullptr ) ;
+      r.object->apply( qclab::Op::NoTrans , n , vec2 , r.offset ) ;
+    }
+    auto perm2 = perm ;
+    qclab::sim::unpermute( n , vec2 , perm2 ) ;
+    check_remap( vec1 , vec2 ) ;
+  }
+
+  // remap: wide multi-controlled and monomial gates
+  {
+    using X   = qclab::qgates::PauliX< T > ;
+    using CZ  = qclab::qgates::CZ< T > ;
+    using MCX = qclab::qgates::MCX< T > ;
+    using MCS = qclab::qgates::MCSWAP< T > ;
+    using MCG = qclab::qgates::MCGate< T > ;
+    const std::vector< int > perm = { 3 , 6 , 0 , 7 , 1 , 5 , 2 , 4 } ;
+    qclab::QCircuit< T >  circuit( n ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< RX >( q , R(0.3 + q) ) ) ;
+    }
+    circuit.push_back( std::make_unique< MCX >(
+                         std::vector< int >( { 0 , 1 , 2 , 4 , 5 , 6 } ) , 7 ,
+                         std::vector< int >( { 1 , 0 , 1 , 1 , 0 , 1 } ) ) ) ;
+    circuit.push_back( std::make_unique< MCS >(
+                         std::vector< int >( { 1 , 2 , 3 , 4 , 7 } ) , 6 , 0 ,
+                         std::vector< int >( { 0 , 1 , 1 , 0 , 1 } ) ) ) ;
+    circuit.push_back( std::make_unique< MCG >(
+                         std::vector< int >( { 0 , 3 , 5 , 6 , 7 } ) , 2 ,
+                         RX( 0 , R(0.7) ).matrix() ,
+                         std::vector< int >( { 1 , 1 , 0 , 1 , 0 } ) ) ) ;
+    for ( int q = 0; q < n; q++ ) {
+      circuit.push_back( std::make_unique< CX >( q , ( q + 3 ) % n ) ) ;
+      circuit.push_back( std::make_unique< CZ >( q , ( q + 5 ) % n ) ) ;
+      circuit.push_back( std::make_unique< X >( q ) ) ;
+    }
+    qclab::sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    qclab::sim::fuseMonomial( schedule ) ;
+    EXPECT_EQ( schedule[ schedule.size() - 1 ].object->nbQubits() , n ) ;
+    auto vec1 = vec0 ;
+    circuit.simulate( vec1 ) ;
+    // reference: permute, apply relabeled items, unpermute
+    auto vec2 = vec0 ;
+    std::vector< int > inv( n ) ;
+    for ( int q = 0; q < n; q++ ) inv[ perm[q] ] = q ;
+    qclab::sim::unpermute( n , vec2 , inv ) ;
+    qclab::sim::Schedule< T > relabeled ;
+    for ( const auto& item : schedule ) {
+      const auto r = qclab::sim::remap( item , perm , relabeled ) ;
+      ASSERT_NE( r.object , nullptr ) ;
+      r.object->apply( qclab::Op::NoTrans , n , vec2 , r.offset ) ;
+    }
+    auto perm2 = perm ;
+    qclab::sim::unpermute( n , vec2 , perm2 ) ;
+    check_remap( vec1 , vec2 ) ;
+  }
+
+  // simulate: QFT with a final layer on the leading qubits
+  const R pi = 4 * std::atan(1) ;
+  qclab::QCircuit< T >  circuit( n ) ;
+  for ( int i = 0; i < n; i++ ) {
+    circuit.push_back( std::make_unique< H >( i ) ) ;
+    for ( int j = 2; j <= n-i; j++ ) {
+      circuit.push_back( std::make_unique< CP >( j + i - 1 , i ,
+                                                 -2*pi / ( 1 << j ) ) ) ;
+    }
+  }
+  for ( int k = 0; k < 3; k++ ) {
+    for ( int i = 0; i < 3; i++ ) {
+      circuit.push_back( std::make_unique< RX >( i , R(0.2) * ( k + i ) ) ) ;
+      circuit.push_back( std::make_unique< CX >( i , ( i + 1 ) % 3 ) ) ;
+    }
+  }
+  auto vec1 = vec0 ;
+  circuit.simulate( vec1 ) ;
+  for ( int blockQubits = 1; blockQubits < n; blockQubits++ ) {
+    for ( int window : { 1 , 4 , 16 } ) {
+      for ( bool fuse : { false , true } ) {
+        auto vec2 = vec0 ;
+        qclab::sim::Options options ;
+        options.fuseDiagonal = fuse ;
+        options.fuseK = fuse ? 3 : 0 ;
+        options.blockQubits = blockQubits ;
+        options.remapWindow = window ;
+        circuit.simulate( vec2 , options ) ;
+        check_remap( vec1 , vec2 ) ;
+      }
+    }
+  }
+
+  // applyRemapped: exposes the final permutation
+  {
+    qclab::sim::Schedule< T > schedule ;
+    circuit.flatten( schedule ) ;
+    std::vector< int > perm( n ) ;
+    std::iota( perm.begin() , perm.end() , 0 ) ;
+    auto vec2 = vec0 ;
+    qclab::sim::applyRemapped( schedule , n , vec2 , 3 , 9 , perm ) ;
+    EXPECT_NE( perm[0] , 0 ) ;  // leading qubits moved into the block
+    qclab::sim::unpermute( n , vec2 , perm ) ;
+    check_remap( vec1 , vec2 ) ;
+  }
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_sim_remap , complex_float ) {
+  test_qclab_sim_remap< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_sim_remap , complex_double ) {
+  test_qclab_sim_remap< std::complex< double > >() ;
+}
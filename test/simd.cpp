@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "qclab/simd.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/PauliZ.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/Phase.hpp"
+#include "qclab/qgates/Phase45.hpp"
+#include "qclab/qgates/Phase90.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/RotationYY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+
+template <typename T>
+void check_simd( const qclab::QObject< T >& gate , const int nbQubits ,
+                 const qclab::simd::Isa isa ) {
+
+  using R = qclab::real_t< T > ;
+  const R tol = 10 * std::numeric_limits< R >::epsilon() ;
+
+  std::vector< T > vec0( 1 << nbQubits ) ;
+  for ( int i = 0; i < vec0.size(); i++ ) {
+    vec0[i] = T( std::cos( i + 1 ) , std::sin( 2 * i ) ) ;
+  }
+  for ( auto op : { qclab::Op::NoTrans , qclab::Op::Trans ,
+                    qclab::Op::ConjTrans } ) {
+    auto vec1 = vec0 ;
+    qclab::simd::setIsa( qclab::simd::Isa::Scalar ) ;
+    gate.apply( op , nbQubits , vec1 ) ;
+    auto vec2 = vec0 ;
+    qclab::simd::setIsa( isa ) ;
+    gate.apply( op , nbQubits , vec2 ) ;
+    for ( int i = 0; i < vec0.size(); i++ ) {
+      EXPECT_NEAR( std::abs( vec1[i] - vec2[i] ) , 0 , tol ) ;
+    }
+  }
+
+}
+
+template <typename T>
+void test_qclab_simd() {
+
+  using R = qclab::real_t< T > ;
+  const qclab::simd::Isa best = qclab::simd::detect() ;
+
+  // setIsa
+  qclab::simd::setIsa( qclab::simd::Isa::Scalar ) ;
+  EXPECT_EQ( qclab::simd::isa() , qclab::simd::Isa::Scalar ) ;
+  qclab::simd::setIsa( qclab::simd::Isa::AVX512 ) ;
+  EXPECT_EQ( qclab::simd::isa() , best ) ;
+  EXPECT_STREQ( qclab::simd::name( qclab::simd::Isa::AVX2 ) , "avx2" ) ;
+
+  // kernels
+  const int n = 7 ;
+  qclab::dense::SquareMatrix< T > mat1( T(1,2) , T(3,-1) , T(0.5,0) , T(2,1) );
+  qclab::dense::SquareMatrix< T > mat2( 4 ) ;
+  for ( int j = 0; j < 4; j++ ) {
+    for ( int i = 0; i < 4; i++ ) {
+      mat2(i,j) = T( std::cos( i + 3*j ) , std::sin( 2*i + j ) ) ;
+    }
+  }
+  for ( auto isa : { qclab::simd::Isa::AVX2 , qclab::simd::Isa::AVX512 } ) {
+    for ( int q = 0; q < n; q++ ) {
+      check_simd( qclab::qgates::Hadamard< T >( q ) , n , isa ) ;
+      check_simd( qclab::qgates::PauliZ< T >( q ) , n , isa ) ;
+      check_simd( qclab::qgates::RotationX< T >( q , R(0.3) ) , n , isa ) ;
+      check_simd( qclab::qgates::RotationY< T >( q , R(0.7) ) , n , isa ) ;
+      check_simd( qclab::qgates::RotationZ< T >( q , R(1.1) ) , n , isa ) ;
+      check_simd( qclab::qgates::Phase< T >( q , R(-0.4) ) , n , isa ) ;
+      check_simd( qclab::qgates::Phase45< T >( q ) , n , isa ) ;
+      check_simd( qclab::qgates::Phase90< T >( q ) , n , isa ) ;
+      check_simd( qclab::qgates::MatrixGate1< T >( q , mat1 ) , n , isa ) ;
+      check_simd( qclab::qgates::MatrixGateN< T >( { q } , mat1 ) , n , isa );
+      for ( int q1 = q + 1; q1 < n; q1++ ) {
+        check_simd( qclab::qgates::MatrixGateN< T >( { q , q1 } , mat2 ) ,
+                    n , isa ) ;
+      }
+      if ( q < n - 1 ) {
+        const int qubits[] = { q , q + 1 } ;
+        check_simd( qclab::qgates::RotationXX< T >( qubits , R(0.2) ) ,
+                    n , isa ) ;
+        check_simd( qclab::qgates::RotationYY< T >( qubits , R(0.9) ) ,
+                    n , isa ) ;
+        check_simd( qclab::qgates::RotationZZ< T >( qubits , R(1.3) ) ,
+                    n , isa ) ;
+      }
+    }
+  }
+
+  qclab::simd::setIsa( best ) ;
+
+}
+
+
+/*
+ * complex float
+ */
+TEST( qclab_simd , complex_float ) {
+  test_qclab_simd< std::complex< float > >() ;
+}
+
+/*
+ * complex double
+ */
+TEST( qclab_simd , complex_double ) {
+  test_qclab_simd< std::complex< double > >() ;
+}
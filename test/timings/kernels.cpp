@@ -0,0 +1,174 @@
+#include "run.hpp"
+#include "qclab/simd.hpp"
+#include "qclab/StateVector.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationY.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/Phase.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/RotationYY.hpp"
+#include "qclab/qgates/RotationZZ.hpp"
+#include "qclab/qgates/CRotationX.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/dense/kron.hpp"
+#include <numeric>
+
+// minimal time of applying `gate` to all qubits of a vector of `nbQubits`
+template <typename T>
+double time_kernel( qclab::QObject< T >& gate , const int nbQubits ,
+                    std::vector< T >& vector , const int IMAX ) {
+  const int nbGateQubits = gate.nbQubits() ;
+  double t_min = 9999 ;
+  TP time ;
+  for ( int i = 0; i < IMAX; i++ ) {
+    tic( time ) ;
+    for ( int q = 0; q <= nbQubits - nbGateQubits; q++ ) {
+      std::vector< int > qubits( nbGateQubits ) ;
+      std::iota( qubits.begin() , qubits.end() , q ) ;
+      gate.setQubits( qubits.data() ) ;
+      gate.apply( qclab::Op::NoTrans , nbQubits , vector ) ;
+    }
+    t_min = std::min( t_min , toc( time ) ) ;
+  }
+  return t_min ;
+}
+
+// minimal time of applying `gate` to all qubits of a state vector
+template <typename T>
+double time_kernel( qclab::QObject< T >& gate , const int nbQubits ,
+                    qclab::StateVector< T >& state , const int IMAX ) {
+  const int nbGateQubits = gate.nbQubits() ;
+  double t_min = 9999 ;
+  TP time ;
+  for ( int i = 0; i < IMAX; i++ ) {
+    tic( time ) ;
+    for ( int q = 0; q <= nbQubits - nbGateQubits; q++ ) {
+      std::vector< int > qubits( nbGateQubits ) ;
+      std::iota( qubits.begin() , qubits.end() , q ) ;
+      gate.setQubits( qubits.data() ) ;
+      gate.apply( qclab::Op::NoTrans , nbQubits , state ) ;
+    }
+    t_min = std::min( t_min , toc( time ) ) ;
+  }
+  return t_min ;
+}
+
+template <typename T>
+int kernels( const int nbQubits , const int IMAX ) {
+
+  using R = qclab::real_t< T > ;
+  using isa_type = qclab::simd::Isa ;
+
+  // gates
+  const auto mat2 = qclab::dense::kron(
+                      qclab::qgates::RotationY< T >( R(0.3) ).matrix() ,
+                      qclab::qgates::RotationX< T >( R(0.5) ).matrix() ) ;
+  const int qubits[] = { 0 , 1 } ;
+  using G = std::unique_ptr< qclab::QObject< T > > ;
+  std::vector< std::pair< std::string , G > > gates ;
+  gates.emplace_back( "QGate1" , G( new qclab::qgates::MatrixGate1< T >( 0 ,
+                      qclab::qgates::RotationY< T >( R(0.3) ).matrix() ) ) ) ;
+  gates.emplace_back( "Hadamard" , G( new qclab::qgates::Hadamard< T >() ) ) ;
+  gates.emplace_back( "RotationX" ,
+                      G( new qclab::qgates::RotationX< T >( 0 , R(0.3) ) ) ) ;
+  gates.emplace_back( "RotationZ" ,
+                      G( new qclab::qgates::RotationZ< T >( 0 , R(0.3) ) ) ) ;
+  gates.emplace_back( "Phase" ,
+                      G( new qclab::qgates::Phase< T >( 0 , R(0.3) ) ) ) ;
+  gates.emplace_back( "RotationXX" ,
+                      G( new qclab::qgates::RotationXX< T >( qubits , 0.3 ) ) );
+  gates.emplace_back( "RotationYY" ,
+                      G( new qclab::qgates::RotationYY< T >( qubits , 0.3 ) ) );
+  gates.emplace_back( "RotationZZ" ,
+                      G( new qclab::qgates::RotationZZ< T >( qubits , 0.3 ) ) );
+  gates.emplace_back( "CRotationX" ,
+                      G( new qclab::qgates::CRotationX< T >( 0 , 1 ,
+                                                            R(0.3) ) ) ) ;
+  gates.emplace_back( "CRotationY" ,
+                      G( new qclab::qgates::CRotationY< T >( 0 , 1 ,
+                                                            R(0.3) ) ) ) ;
+  gates.emplace_back( "MatrixGateN" , G( new qclab::qgates::MatrixGateN< T >(
+                      std::vector< int >( { 0 , 1 } ) , mat2 ) ) ) ;
+
+  // instruction sets
+  const isa_type best = qclab::simd::detect() ;
+  std::vector< isa_type > isas = { isa_type::Scalar } ;
+  if ( best != isa_type::Scalar ) isas.push_back( isa_type::AVX2 ) ;
+  if ( best == isa_type::AVX512 ) isas.push_back( isa_type::AVX512 ) ;
+
+  // vector
+  std::vector< T > vector( size_t(1) << nbQubits ) ;
+  for ( size_t i = 0; i < vector.size(); i++ ) {
+    vector[i] = T( std::cos( i ) , std::sin( i ) ) ;
+  }
+
+  // timings
+  std::printf( "  %-12s" , "kernel" ) ;
+  for ( auto isa : isas ) std::printf( " | %10s" , qclab::simd::name( isa ) ) ;
+  std::printf( " | speedup\n" ) ;
+  for ( const auto& [ name , gate ] : gates ) {
+    std::printf( "  %-12s" , name.c_str() ) ;
+    double t_scalar = 0 ;
+    double t = 0 ;
+    for ( auto isa : isas ) {
+      qclab::simd::setIsa( isa ) ;
+      t = time_kernel( *gate , nbQubits , vector , IMAX ) ;
+      if ( isa == isa_type::Scalar ) t_scalar = t ;
+      std::printf( " | %9.6fs" , t ) ;
+    }
+    std::printf( " | %6.2fx\n" , t_scalar / t ) ;
+  }
+  qclab::simd::setIsa( best ) ;
+
+  // state vector layouts
+  qclab::StateVector< T > interleaved( vector , qclab::Layout::Interleaved ) ;
+  qclab::StateVector< T > split( vector , qclab::Layout::Split ) ;
+  std::printf( "\n  %-12s | %10s | %11s | %10s\n" , "kernel" , "vector" ,
+               "interleaved" , "split" ) ;
+  for ( const auto& [ name , gate ] : gates ) {
+    std::printf( "  %-12s" , name.c_str() ) ;
+    std::printf( " | %9.6fs" , time_kernel( *gate , nbQubits , vector ,
+                                            IMAX ) ) ;
+    std::printf( " | %10.6fs" , time_kernel( *gate , nbQubits , interleaved ,
+                                             IMAX ) ) ;
+    std::printf( " | %9.6fs\n" , time_kernel( *gate , nbQubits , split ,
+                                              IMAX ) ) ;
+  }
+
+  // successful
+  return 0 ;
+
+}
+
+
+int main( int argc , char *argv[] ) {
+
+  // defaults
+  char type = 'd' ;
+  int  nbQubits = 20 ;
+  int  imax = 5 ;
+
+  // arguments
+  if ( argc > 1 ) type = argv[1][0] ;
+  if ( argc > 2 ) nbQubits = std::stoi( argv[2] ) ;
+  if ( argc > 3 ) imax = std::stoi( argv[3] ) ;
+  std::cout << "nb qubits = " << nbQubits ;
+
+  int r = 0 ;
+  if ( type == 's' ) {
+    // float
+    std::cout << ", T = std::complex<float>" << std::endl ;
+    r = kernels< std::complex< float > >( nbQubits , imax ) ;
+  } else if ( type == 'd' ) {
+    // double
+    std::cout << ", T = std::complex<double>" << std::endl ;
+    r = kernels< std::complex< double > >( nbQubits , imax ) ;
+  } else {
+    r = -100 ;
+  }
+  return r ;
+
+}
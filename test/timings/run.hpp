@@ -18,11 +18,31 @@ double toc( TP& t_bgn ) {
   return time ;
 }
 
+// fusion level: 0 = none, 1 = fuse1, k >= 2 = fuseK with k qubits
+inline void setFusion( qclab::sim::Options& options , const int level ) {
+  options.fuse1 = ( level == 1 ) ;
+  options.fuseK = ( level >= 2 ) ? level : 0 ;
+}
+
+inline void printOptions( const qclab::sim::Options& options ) {
+  if ( options.fuseDiagonal ) std::cout << ", fuseDiagonal" ;
+  if ( options.fuseMonomial ) std::cout << ", fuseMonomial" ;
+  if ( options.fuse1 ) std::cout << ", fuse1" ;
+  if ( options.fuseK >= 2 ) std::cout << ", fuseK = " << options.fuseK ;
+  if ( options.blockQubits > 0 ) {
+    std::cout << ", blockQubits = " << options.blockQubits ;
+  }
+  if ( options.remapWindow > 0 ) {
+    std::cout << ", remapWindow = " << options.remapWindow ;
+  }
+}
+
 
 template <typename T, typename F>
 int run( const int nbQubits , const int test ,
          double& t_cpu , double& t_gpu , F& lambda ,
-         const int IMAX_CPU = 3 , const int IMAX_GPU = 3 ) {
+         const int IMAX_CPU = 3 , const int IMAX_GPU = 3 ,
+         const qclab::sim::Options& options = qclab::sim::Options() ) {
 
   using R = qclab::real_t< T > ;
   const R tol = 10 * std::numeric_limits< R >::epsilon() ;
@@ -52,7 +72,7 @@ int run( const int nbQubits , const int test ,
       psi[0] = 1 ;
       // simulate
       tic( time ) ;
-      circuit.simulate( psi ) ;
+      circuit.simulate( psi , options ) ;
       auto t = toc( time ) ;
       if ( t < t_cpu ) t_cpu = t ;
       // increment
@@ -141,7 +161,8 @@ int run( const int nbQubits , const int test ,
 
 template <typename T, typename F>
 int timings( const int qmin , const int qmax , const int qstep , const int test,
-             F& lambda , const int IMAX_CPU = 3 , const int IMAX_GPU = 3 ) {
+             F& lambda , const int IMAX_CPU = 3 , const int IMAX_GPU = 3 ,
+             const qclab::sim::Options& options = qclab::sim::Options() ) {
 
   // omp
 #ifdef _OPENMP
@@ -158,7 +179,7 @@ int timings( const int qmin , const int qmax , const int qstep , const int test,
   // run
   for ( int q = qmin; q <= qmax; q += qstep ) {
     int r = run< T , F >( q , test , t_cpu , t_gpu ,
-                          lambda , IMAX_CPU , IMAX_GPU ) ;
+                          lambda , IMAX_CPU , IMAX_GPU , options ) ;
     qubits.push_back( q ) ;
     T_cpu.push_back( t_cpu ) ;
     T_gpu.push_back( t_gpu ) ;
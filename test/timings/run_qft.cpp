@@ -43,6 +43,7 @@ int main( int argc , char *argv[] ) {
   int  qmax = 20 ;
   int  qstp = 2 ;
   int  test = 3 ;
+  qclab::sim::Options options ;
 
   // arguments
   if ( argc > 1 ) type = argv[1][0] ;
@@ -50,7 +51,13 @@ int main( int argc , char *argv[] ) {
   if ( argc > 3 ) qmax = std::stoi( argv[3] ) ;
   if ( argc > 4 ) qstp = std::stoi( argv[4] ) ;
   if ( argc > 5 ) test = std::stoi( argv[5] ) ;
+  if ( argc > 6 ) setFusion( options , std::stoi( argv[6] ) ) ;
+  if ( argc > 7 ) options.blockQubits = std::stoi( argv[7] ) ;
+  if ( argc > 8 ) options.fuseDiagonal = ( std::stoi( argv[8] ) != 0 ) ;
+  if ( argc > 9 ) options.remapWindow = std::stoi( argv[9] ) ;
+  if ( argc > 10 ) options.fuseMonomial = ( std::stoi( argv[10] ) != 0 ) ;
   std::cout << "nb qubits = " << qmin << ":" << qstp << ":" << qmax ;
+  printOptions( options ) ;
 
   int r = 0 ;
   if ( type == 's' ) {
@@ -58,13 +65,13 @@ int main( int argc , char *argv[] ) {
     std::cout << ", T = std::complex<float>" << std::endl ;
     using T = std::complex< float > ;
     auto f = [&] ( qclab::QCircuit< T >& circuit ) { qft( circuit ) ; } ;
-    r = timings< T >( qmin , qmax , qstp , test , f ) ;
+    r = timings< T >( qmin , qmax , qstp , test , f , 3 , 3 , options ) ;
   } else if ( type == 'd' ) {
     // double
     using T = std::complex< double > ;
     auto f = [&] ( qclab::QCircuit< T >& circuit ) { qft( circuit ) ; } ;
     std::cout << ", T = std::complex<double>" << std::endl ;
-    r = timings< T >( qmin , qmax , qstp , test , f ) ;
+    r = timings< T >( qmin , qmax , qstp , test , f , 3 , 3 , options ) ;
   } else {
     r = -100 ;
   }
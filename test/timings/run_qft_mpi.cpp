@@ -0,0 +1,148 @@
+#include "run.hpp"
+#include "qclab/mpi/DistributedStateVector.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/CPhase.hpp"
+#include "qclab/qgates/SWAP.hpp"
+
+template <typename T>
+void qft( qclab::QCircuit< T >& circuit ) {
+
+  using R  = qclab::real_t< T > ;
+  using H  = qclab::qgates::Hadamard< T > ;
+  using CP = qclab::qgates::CPhase< T > ;
+  using SW = qclab::qgates::SWAP< T > ;
+
+  // constants
+  const R pi = 4 * std::atan(1) ;
+  const int n = circuit.nbQubits() ;
+
+  // B blocks
+  for ( int i = 0; i < n; i++ ) {
+    // Hadamard
+    circuit.push_back( std::make_unique< H >( i ) ) ;
+    // diagonal blocks
+    for ( int j = 2; j <= n-i; j++ ) {
+      const int control = j + i - 1 ;
+      const R theta = -2*pi / ( 1 << j ) ;
+      circuit.push_back( std::make_unique< CP >( control , i , theta ) ) ;
+    }
+  }
+
+  // swaps
+  for ( int i = 0; i < n/2; i++ ) {
+    circuit.push_back( std::make_unique< SW >( i , n - i - 1 ) ) ;
+  }
+
+}
+
+
+template <typename T>
+void timingsMPI( const int qmin , const int qmax , const int qstp ,
+                  const int imax , const qclab::sim::Options& options ) {
+
+  int rank , nbRanks ;
+  MPI_Comm_rank( MPI_COMM_WORLD , &rank ) ;
+  MPI_Comm_size( MPI_COMM_WORLD , &nbRanks ) ;
+  if ( rank == 0 ) {
+    std::cout << std::setw(8)  << "qubits"
+              << std::setw(12) << "total [s]"
+              << std::setw(12) << "compute [s]"
+              << std::setw(12) << "comm [s]"
+              << std::setw(12) << "exchanges"
+              << std::setw(12) << "sent [MB]" << std::endl ;
+  }
+
+  TP time ;
+  for ( int n = qmin; n <= qmax; n += qstp ) {
+    // quantum circuit
+    qclab::QCircuit< T >  circuit( n ) ;
+    qft( circuit ) ;
+
+    // best of imax runs
+    double best[3] = { 9999 , 9999 , 9999 } ;
+    int64_t stats[2] = { 0 , 0 } ;
+    for ( int i = 0; i < imax; i++ ) {
+      qclab::mpi::DistributedStateVector< T >  psi( n ) ;
+      MPI_Barrier( MPI_COMM_WORLD ) ;
+      tic( time ) ;
+      psi.simulate( circuit , options ) ;
+      MPI_Barrier( MPI_COMM_WORLD ) ;
+      double local[3] = { toc( time ) , psi.timings().compute ,
+                          psi.timings().communication } ;
+      // slowest rank
+      double t[3] ;
+      MPI_Reduce( local , t , 3 , MPI_DOUBLE , MPI_MAX , 0 , MPI_COMM_WORLD ) ;
+      if ( t[0] < best[0] ) {
+        for ( int j = 0; j < 3; j++ ) best[j] = t[j] ;
+        stats[0] = psi.timings().nbExchanges ;
+        stats[1] = psi.timings().bytes ;
+      }
+    }
+    int64_t bytes ;
+    MPI_Reduce( &stats[1] , &bytes , 1 , MPI_INT64_T , MPI_SUM , 0 ,
+                MPI_COMM_WORLD ) ;
+
+    if ( rank == 0 ) {
+      std::cout << std::setw(8)  << n
+                << std::setw(12) << std::setprecision(4) << best[0]
+                << std::setw(12) << std::setprecision(4) << best[1]
+                << std::setw(12) << std::setprecision(4) << best[2]
+                << std::setw(12) << stats[0]
+                << std::setw(12) << std::setprecision(4) << bytes / 1.0e6
+                << std::endl ;
+    }
+  }
+
+}
+
+
+int main( int argc , char *argv[] ) {
+
+  int provided ;
+  MPI_Init_thread( &argc , &argv , MPI_THREAD_FUNNELED , &provided ) ;
+  int rank , nbRanks ;
+  MPI_Comm_rank( MPI_COMM_WORLD , &rank ) ;
+  MPI_Comm_size( MPI_COMM_WORLD , &nbRanks ) ;
+
+  // defaults
+  char type = 'd' ;
+  int  qmin = 10 ;
+  int  qmax = 20 ;
+  int  qstp = 2 ;
+  int  imax = 3 ;
+  qclab::sim::Options options ;
+
+  // arguments
+  if ( argc > 1 ) type = argv[1][0] ;
+  if ( argc > 2 ) qmin = std::stoi( argv[2] ) ;
+  if ( argc > 3 ) qmax = std::stoi( argv[3] ) ;
+  if ( argc > 4 ) qstp = std::stoi( argv[4] ) ;
+  if ( argc > 5 ) imax = std::stoi( argv[5] ) ;
+  if ( argc > 6 ) setFusion( options , std::stoi( argv[6] ) ) ;
+  if ( argc > 7 ) options.blockQubits = std::stoi( argv[7] ) ;
+  if ( argc > 8 ) options.fuseDiagonal = ( std::stoi( argv[8] ) != 0 ) ;
+  if ( rank == 0 ) {
+    std::cout << "nb qubits = " << qmin << ":" << qstp << ":" << qmax
+              << ", nb ranks = " << nbRanks ;
+    printOptions( options ) ;
+  }
+
+  int r = 0 ;
+  if ( type == 's' ) {
+    // float
+    if ( rank == 0 ) std::cout << ", T = std::complex<float>" << std::endl ;
+    using T = std::complex< float > ;
+    timingsMPI< T >( qmin , qmax , qstp , imax , options ) ;
+  } else if ( type == 'd' ) {
+    // double
+    if ( rank == 0 ) std::cout << ", T = std::complex<double>" << std::endl ;
+    using T = std::complex< double > ;
+    timingsMPI< T >( qmin , qmax , qstp , imax , options ) ;
+  } else {
+    r = -100 ;
+  }
+
+  MPI_Finalize() ;
+  return r ;
+
+}
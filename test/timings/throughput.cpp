@@ -0,0 +1,116 @@
+#include "run.hpp"
+#include "qclab/qgates/Hadamard.hpp"
+#include "qclab/qgates/RotationX.hpp"
+#include "qclab/qgates/RotationZ.hpp"
+#include "qclab/qgates/MatrixGate1.hpp"
+#include "qclab/qgates/CX.hpp"
+#include "qclab/qgates/CRotationY.hpp"
+#include "qclab/qgates/RotationXX.hpp"
+#include "qclab/qgates/SWAP.hpp"
+#include "qclab/qgates/MatrixGateN.hpp"
+
+// gates per second of gates applied one by one to a small register, where
+// the cost of a gate is dominated by its overhead rather than by its kernel
+template <typename T>
+double gate_rate( const qclab::QObject< T >& gate , const int nbQubits ,
+                  std::vector< T >& vector , const int nbGates ,
+                  const int IMAX ) {
+  double t_min = 9999 ;
+  TP time ;
+  for ( int i = 0; i < IMAX; i++ ) {
+    tic( time ) ;
+    for ( int k = 0; k < nbGates; k++ ) {
+      gate.apply( qclab::Op::NoTrans , nbQubits , vector ) ;
+    }
+    t_min = std::min( t_min , toc( time ) ) ;
+  }
+  return nbGates / t_min ;
+}
+
+template <typename T>
+int throughput( const int qmin , const int qmax , const int nbGates ,
+                const int IMAX ) {
+
+  using R = qclab::real_t< T > ;
+
+  // gates
+  const int qubits[] = { 0 , 1 } ;
+  using G = std::unique_ptr< qclab::QObject< T > > ;
+  std::vector< std::pair< std::string , G > > gates ;
+  gates.emplace_back( "Hadamard" , G( new qclab::qgates::Hadamard< T >() ) ) ;
+  gates.emplace_back( "RotationX" ,
+                      G( new qclab::qgates::RotationX< T >( 0 , R(0.3) ) ) ) ;
+  gates.emplace_back( "RotationZ" ,
+                      G( new qclab::qgates::RotationZ< T >( 0 , R(0.3) ) ) ) ;
+  gates.emplace_back( "QGate1" , G( new qclab::qgates::MatrixGate1< T >( 0 ,
+                      qclab::qgates::RotationX< T >( R(0.3) ).matrix() ) ) ) ;
+  gates.emplace_back( "CX" , G( new qclab::qgates::CX< T >( 0 , 1 ) ) ) ;
+  gates.emplace_back( "CRotationY" ,
+                      G( new qclab::qgates::CRotationY< T >( 0 , 1 ,
+                                                            R(0.3) ) ) ) ;
+  gates.emplace_back( "RotationXX" ,
+                      G( new qclab::qgates::RotationXX< T >( qubits ,
+                                                            R(0.3) ) ) ) ;
+  gates.emplace_back( "SWAP" , G( new qclab::qgates::SWAP< T >( 0 , 1 ) ) ) ;
+  gates.emplace_back( "MatrixGateN" , G( new qclab::qgates::MatrixGateN< T >(
+                      std::vector< int >( { 0 , 1 } ) ,
+                      qclab::qgates::RotationXX< T >( R(0.3) ).matrix() ) ) ) ;
+
+  // header
+  std::printf( "  %-12s" , "gates/s" ) ;
+  for ( int q = qmin; q <= qmax; q += 2 ) std::printf( " | %8i q" , q ) ;
+  std::printf( "\n" ) ;
+
+  // timings
+  for ( const auto& [ name , gate ] : gates ) {
+    std::printf( "  %-12s" , name.c_str() ) ;
+    for ( int q = qmin; q <= qmax; q += 2 ) {
+      std::vector< T > vector( size_t(1) << q ) ;
+      for ( size_t i = 0; i < vector.size(); i++ ) {
+        vector[i] = T( std::cos( i ) , std::sin( i ) ) ;
+      }
+      std::printf( " | %9.3e" , gate_rate( *gate , q , vector , nbGates ,
+                                           IMAX ) ) ;
+    }
+    std::printf( "\n" ) ;
+  }
+
+  // successful
+  return 0 ;
+
+}
+
+
+int main( int argc , char *argv[] ) {
+
+  // defaults
+  char type = 'd' ;
+  int  qmin = 2 ;
+  int  qmax = 10 ;
+  int  nbGates = 100000 ;
+  int  imax = 3 ;
+
+  // arguments
+  if ( argc > 1 ) type = argv[1][0] ;
+  if ( argc > 2 ) qmin = std::stoi( argv[2] ) ;
+  if ( argc > 3 ) qmax = std::stoi( argv[3] ) ;
+  if ( argc > 4 ) nbGates = std::stoi( argv[4] ) ;
+  if ( argc > 5 ) imax = std::stoi( argv[5] ) ;
+  std::cout << "nb qubits = " << qmin << ":2:" << qmax
+            << ", nb gates = " << nbGates ;
+
+  int r = 0 ;
+  if ( type == 's' ) {
+    // float
+    std::cout << ", T = std::complex<float>" << std::endl ;
+    r = throughput< std::complex< float > >( qmin , qmax , nbGates , imax ) ;
+  } else if ( type == 'd' ) {
+    // double
+    std::cout << ", T = std::complex<double>" << std::endl ;
+    r = throughput< std::complex< double > >( qmin , qmax , nbGates , imax ) ;
+  } else {
+    r = -100 ;
+  }
+  return r ;
+
+}